@@ -0,0 +1,283 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "juego.h"
+
+/**
+ * @file bench_geometria.c
+ * @brief Benchmark de las funciones de colisión y geometría de juego.c.
+ *
+ * Se compila con make bench y no abre ventana ni inicializa Allegro: las funciones medidas
+ * solo hacen cuentas sobre sus parámetros y el tilemap. Las entradas salen de un generador
+ * con semilla fija, así que dos corridas sobre commits distintos miden exactamente los
+ * mismos casos. Con --csv la salida queda lista para comparar con diff o una planilla.
+ *
+ * Cada función se corre REPETICIONES_BENCH veces durante al menos TIEMPO_MINIMO_BENCH
+ * segundos y se informa la mejor repetición, que es la menos afectada por el sistema.
+ * El costo incluye la llamada por puntero; la fila "vacio" muestra cuánto es.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/**
+ * @def NUM_ENTRADAS_BENCH
+ * @brief Cantidad de entradas distintas que se recorren en cada vuelta, debe ser potencia de dos.
+ */
+#define NUM_ENTRADAS_BENCH 4096
+
+/**
+ * @def TIEMPO_MINIMO_BENCH
+ * @brief Segundos que dura como mínimo cada repetición.
+ */
+#define TIEMPO_MINIMO_BENCH 0.2
+
+/**
+ * @def REPETICIONES_BENCH
+ * @brief Repeticiones de cada función, se informa la más rápida.
+ */
+#define REPETICIONES_BENCH 5
+
+/**
+ * @def SEMILLA_BENCH
+ * @brief Semilla fija de las entradas.
+ */
+#define SEMILLA_BENCH 20250117
+
+/**
+ * @struct EntradaBench
+ * @brief Dos rectángulos (o círculos) y un segmento al azar.
+ */
+typedef struct
+{
+    float x1, y1, ancho1, alto1;
+    float x2, y2, ancho2, alto2;
+} EntradaBench;
+
+/**
+ * @struct KernelBench
+ * @brief Función medida con su nombre.
+ */
+typedef struct
+{
+    const char *nombre;
+    int (*ejecutar)(int i); /**< Corre la función sobre la entrada i y devuelve el resultado */
+} KernelBench;
+
+static EntradaBench entradas[NUM_ENTRADAS_BENCH];
+static DisparoLaser lasers[NUM_ENTRADAS_BENCH];
+static Tilemap tilemap;
+static volatile int sumidero; /**< Evita que el compilador descarte los resultados */
+
+
+/**
+ * @brief Genera un float uniforme entre minimo y maximo.
+ */
+static float aleatorio_float(GeneradorAleatorio *gen, float minimo, float maximo)
+{
+    return minimo + (maximo - minimo) * (siguiente_aleatorio(gen) / 4294967296.0f);
+}
+
+
+/**
+ * @brief Llena las entradas, los láseres y el tilemap con datos al azar.
+ *
+ * El tilemap tiene asteroides, escudos y muros mezclados en proporciones parecidas a
+ * las de los niveles.
+ */
+static void generar_entradas(void)
+{
+    GeneradorAleatorio gen;
+    int i;
+    int f;
+    int c;
+    int r;
+
+    sembrar_generador(&gen, SEMILLA_BENCH, 0);
+
+    for (i = 0; i < NUM_ENTRADAS_BENCH; i++)
+    {
+        entradas[i].x1 = aleatorio_float(&gen, 0, 800);
+        entradas[i].y1 = aleatorio_float(&gen, 0, 600);
+        entradas[i].ancho1 = aleatorio_float(&gen, 5, 60);
+        entradas[i].alto1 = aleatorio_float(&gen, 5, 60);
+        entradas[i].x2 = entradas[i].x1 + aleatorio_float(&gen, -120, 120);
+        entradas[i].y2 = entradas[i].y1 + aleatorio_float(&gen, -120, 120);
+        entradas[i].ancho2 = aleatorio_float(&gen, 5, 60);
+        entradas[i].alto2 = aleatorio_float(&gen, 5, 60);
+
+        memset(&lasers[i], 0, sizeof(DisparoLaser));
+        lasers[i].x_nave = aleatorio_float(&gen, 0, 800);
+        lasers[i].y_nave = aleatorio_float(&gen, 0, 600);
+        lasers[i].angulo = aleatorio_float(&gen, 0, 2 * ALLEGRO_PI);
+        lasers[i].alcance = aleatorio_float(&gen, 100, 600);
+    }
+
+    for (f = 0; f < MAPA_FILAS; f++)
+    {
+        for (c = 0; c < MAPA_COLUMNAS; c++)
+        {
+            r = aleatorio_entero(&gen, 100);
+            tilemap.celdas[f][c].tipo = r < 15 ? 1 : r < 20 ? 2 : r < 25 ? 3 : 0;
+            tilemap.celdas[f][c].vida = tilemap.celdas[f][c].tipo == 2 ? 3 : 0;
+        }
+    }
+
+    actualizar_mascaras_tilemap(&tilemap);
+}
+
+
+static int kernel_vacio(int i)
+{
+    return i & 1;
+}
+
+static int kernel_colision_generica(int i)
+{
+    const EntradaBench *e = &entradas[i];
+    return detectar_colision_generica(e->x1, e->y1, e->ancho1, e->alto1, e->x2, e->y2, e->ancho2, e->alto2);
+}
+
+static int kernel_colision_circular(int i)
+{
+    const EntradaBench *e = &entradas[i];
+    return detectar_colision_circular(e->x1, e->y1, e->ancho1, e->x2, e->y2, e->ancho2);
+}
+
+static int kernel_linea_rectangulo(int i)
+{
+    const EntradaBench *e = &entradas[i];
+    const EntradaBench *r = &entradas[(i + 1) & (NUM_ENTRADAS_BENCH - 1)];
+    return linea_intersecta_rectangulo(e->x1, e->y1, e->x2, e->y2, r->x1, r->y1, r->x1 + r->ancho1, r->y1 + r->alto1);
+}
+
+static int kernel_linea_linea(int i)
+{
+    const EntradaBench *e = &entradas[i];
+    const EntradaBench *o = &entradas[(i + 1) & (NUM_ENTRADAS_BENCH - 1)];
+    return linea_intersecta_linea(e->x1, e->y1, e->x2, e->y2, o->x1, o->y1, o->x2, o->y2);
+}
+
+static int kernel_laser_enemigo(int i)
+{
+    const EntradaBench *e = &entradas[i];
+    return laser_intersecta_enemigo_limitado(lasers[i], e->x1, e->y1, e->ancho1, e->alto1, lasers[i].alcance);
+}
+
+static int kernel_nave_muro(int i)
+{
+    const EntradaBench *e = &entradas[i];
+    return verificar_colision_nave_muro(e->x1, e->y1, e->ancho1, e->alto1, &tilemap);
+}
+
+static int kernel_laser_tilemap(int i)
+{
+    return verificar_colision_laser_tilemap(lasers[i], &tilemap) < lasers[i].alcance;
+}
+
+
+/**
+ * @brief Segundos de un reloj monótono, sin depender de Allegro.
+ */
+static double reloj_bench(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/**
+ * @brief Mide una función y devuelve los nanosegundos por llamada de la mejor repetición.
+ *
+ * @param kernel Función a medir.
+ * @param aciertos Fracción de llamadas que devolvieron distinto de cero.
+ * @return Nanosegundos por llamada.
+ */
+static double medir_kernel(const KernelBench *kernel, double *aciertos)
+{
+    double mejor = -1;
+    double inicio;
+    double duracion;
+    long llamadas;
+    long positivos;
+    int repeticion;
+    int i;
+
+    for (repeticion = 0; repeticion < REPETICIONES_BENCH; repeticion++)
+    {
+        llamadas = 0;
+        positivos = 0;
+        inicio = reloj_bench();
+
+        do
+        {
+            for (i = 0; i < NUM_ENTRADAS_BENCH; i++)
+            {
+                positivos += kernel->ejecutar(i) != 0;
+            }
+            llamadas += NUM_ENTRADAS_BENCH;
+            duracion = reloj_bench() - inicio;
+        } while (duracion < TIEMPO_MINIMO_BENCH);
+
+        sumidero += (int)positivos;
+
+        if (mejor < 0 || duracion * 1e9 / llamadas < mejor)
+        {
+            mejor = duracion * 1e9 / llamadas;
+        }
+        *aciertos = (double)positivos / llamadas;
+    }
+
+    return mejor;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const KernelBench kernels[] =
+    {
+        {"vacio", kernel_vacio},
+        {"detectar_colision_generica", kernel_colision_generica},
+        {"detectar_colision_circular", kernel_colision_circular},
+        {"linea_intersecta_rectangulo", kernel_linea_rectangulo},
+        {"linea_intersecta_linea", kernel_linea_linea},
+        {"laser_intersecta_enemigo_limitado", kernel_laser_enemigo},
+        {"verificar_colision_nave_muro", kernel_nave_muro},
+        {"verificar_colision_laser_tilemap", kernel_laser_tilemap},
+    };
+    int num_kernels = sizeof(kernels) / sizeof(kernels[0]);
+    bool csv = argc > 1 && strcmp(argv[1], "--csv") == 0;
+    double ns;
+    double aciertos;
+    int k;
+
+    generar_entradas();
+
+    if (csv)
+    {
+        printf("funcion,ns_por_llamada,millones_por_segundo,aciertos\n");
+    }
+    else
+    {
+        printf("%-36s %10s %12s %9s\n", "funcion", "ns/llamada", "Mllamadas/s", "aciertos");
+    }
+
+    for (k = 0; k < num_kernels; k++)
+    {
+        ns = medir_kernel(&kernels[k], &aciertos);
+
+        if (csv)
+        {
+            printf("%s,%.3f,%.3f,%.4f\n", kernels[k].nombre, ns, 1000.0 / ns, aciertos);
+        }
+        else
+        {
+            printf("%-36s %10.2f %12.1f %8.1f%%\n", kernels[k].nombre, ns, 1000.0 / ns, aciertos * 100.0);
+        }
+        fflush(stdout);
+    }
+
+    return 0;
+}
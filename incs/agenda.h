@@ -0,0 +1,101 @@
+#ifndef AGENDA_H
+#define AGENDA_H
+
+/**
+ * @file agenda.h
+ * @brief Biblioteca con una rueda de tiempos jerárquica para eventos programados.
+ *
+ * Los eventos se programan a una cantidad de pasos de simulación y la agenda avanza un
+ * paso por vez. El primer nivel tiene una ranura por paso; el segundo, una ranura por
+ * cada AGENDA_RANURAS_NIVEL0 pasos, que se reparte en el primero cuando llega su turno.
+ * Los eventos más lejanos esperan en una lista aparte que se revisa una vez por vuelta
+ * del primer nivel. Avanzar cuesta lo mismo que los eventos que vencen, sin importar
+ * cuántos haya esperando.
+ *
+ * La agenda no sabe qué hace cada evento: guarda un tipo y un dato, y al vencer se los
+ * pasa a la función que recibe avanzar_agenda.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @def AGENDA_BITS_NIVEL0
+ * @brief Bits del paso que indexan el primer nivel.
+ */
+#define AGENDA_BITS_NIVEL0 8
+
+/**
+ * @def AGENDA_RANURAS_NIVEL0
+ * @brief Ranuras del primer nivel, una por paso (algo más de 4 segundos a 60 pasos por segundo).
+ */
+#define AGENDA_RANURAS_NIVEL0 (1 << AGENDA_BITS_NIVEL0)
+
+/**
+ * @def AGENDA_BITS_NIVEL1
+ * @brief Bits del paso, por encima de los del primer nivel, que indexan el segundo.
+ */
+#define AGENDA_BITS_NIVEL1 6
+
+/**
+ * @def AGENDA_RANURAS_NIVEL1
+ * @brief Ranuras del segundo nivel; entre los dos cubren 16384 pasos (unos 4,5 minutos).
+ */
+#define AGENDA_RANURAS_NIVEL1 (1 << AGENDA_BITS_NIVEL1)
+
+/**
+ * @def MAX_EVENTOS_AGENDA
+ * @brief Eventos que pueden estar programados a la vez.
+ *
+ * Alcanza para un evento por enemigo, más los de enemigos que murieron y todavía no
+ * vencieron, más los del jefe.
+ */
+#define MAX_EVENTOS_AGENDA 2048
+
+/**
+ * @struct EventoAgenda
+ * @brief Evento programado.
+ */
+typedef struct
+{
+    uint32_t vence; /**< Paso en el que se ejecuta */
+    int tipo; /**< Qué hacer, lo interpreta quien avanza la agenda */
+    int dato; /**< Dato del evento, por ejemplo un manejador de enemigo */
+    int siguiente; /**< Siguiente evento de la misma lista, -1 al final */
+} EventoAgenda;
+
+/**
+ * @struct AgendaEventos
+ * @brief Rueda de tiempos de dos niveles con sus eventos.
+ *
+ * Las ranuras guardan el primer evento de una lista enlazada por índices dentro de
+ * eventos, o -1 si están vacías.
+ */
+typedef struct
+{
+    EventoAgenda eventos[MAX_EVENTOS_AGENDA];
+    int nivel0[AGENDA_RANURAS_NIVEL0];
+    int nivel1[AGENDA_RANURAS_NIVEL1];
+    int lejanos; /**< Eventos que vencen después de lo que cubre el segundo nivel */
+    int libres; /**< Eventos sin usar */
+    uint32_t paso; /**< Último paso ejecutado */
+    int num_eventos; /**< Eventos programados */
+} AgendaEventos;
+
+/**
+ * @brief Función que ejecuta un evento vencido.
+ *
+ * Puede programar eventos nuevos en la misma agenda.
+ */
+typedef void (*AccionAgenda)(void *contexto, int tipo, int dato);
+
+/*Funciones*/
+void init_agenda(AgendaEventos *agenda);
+bool programar_evento(AgendaEventos *agenda, int pasos, int tipo, int dato);
+int avanzar_agenda(AgendaEventos *agenda, AccionAgenda accion, void *contexto);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef ALEATORIO_H
+#define ALEATORIO_H
+
+/**
+ * @file aleatorio.h
+ * @brief Biblioteca con un generador de números aleatorios explícito (PCG32).
+ *
+ * A diferencia de rand(), el estado vive en la partida y cada subsistema tiene su propio
+ * flujo. Con la misma semilla y las mismas entradas dos partidas son idénticas, y agregar
+ * una llamada en un subsistema no altera la secuencia de los demás.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include <stdint.h>
+
+/**
+ * @enum FlujoAleatorio
+ * @brief Subsistemas que tienen su propio flujo de números aleatorios.
+ */
+typedef enum
+{
+    ALEATORIO_ASTEROIDES, /**< Posiciones de aparición de los asteroides */
+    ALEATORIO_POWERUPS, /**< Probabilidad y tipo de los powerups */
+    ALEATORIO_ENEMIGOS, /**< Intervalos de disparo de los enemigos del mapa */
+    ALEATORIO_JEFE, /**< Ataques e invocaciones del jefe */
+    NUM_FLUJOS_ALEATORIOS
+} FlujoAleatorio;
+
+/**
+ * @struct GeneradorAleatorio
+ * @brief Estado de un generador PCG32.
+ */
+typedef struct
+{
+    uint64_t estado; /**< Estado interno, avanza en cada número generado */
+    uint64_t incremento; /**< Identifica el flujo, siempre impar */
+} GeneradorAleatorio;
+
+/*Funciones*/
+void sembrar_generador(GeneradorAleatorio *generador, uint64_t semilla, uint64_t flujo);
+uint32_t siguiente_aleatorio(GeneradorAleatorio *generador);
+int aleatorio_entero(GeneradorAleatorio *generador, int limite);
+
+#endif
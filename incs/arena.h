@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+/**
+ * @file arena.h
+ * @brief Biblioteca con la memoria temporal de cada frame.
+ *
+ * Es un bloque fijo del que se reserva avanzando un puntero y que se vacía entero con
+ * reiniciar_arena_frame al comienzo de cada tick del temporizador. Sirve para listas de
+ * contactos, listas de dibujo, resultados de consultas y textos del HUD que solo se usan
+ * durante el frame, sin malloc ni free en el bucle del juego. Nada de lo reservado debe
+ * guardarse de un frame a otro.
+ *
+ * Si un frame pide más de ARENA_FRAME_BYTES la reserva devuelve NULL y se cuenta como
+ * desborde; escribir_resumen_arena informa el máximo usado en un frame y los desbordes.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include <stdio.h>
+#include <stddef.h>
+
+/**
+ * @def ARENA_FRAME_BYTES
+ * @brief Bytes disponibles en cada frame.
+ */
+#define ARENA_FRAME_BYTES (64 * 1024)
+
+/**
+ * @def ARENA_ALINEACION
+ * @brief Alineación de cada reserva, alcanza para cualquier tipo del juego.
+ */
+#define ARENA_ALINEACION 16
+
+/*Funciones*/
+void reiniciar_arena_frame(void);
+void *reservar_arena_frame(size_t bytes);
+char *formatear_arena_frame(const char *formato, ...);
+size_t usado_arena_frame(void);
+void escribir_resumen_arena(FILE *salida);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+/**
+ * @file atlas.h
+ * @brief Biblioteca con un atlas de sprites: un solo bitmap que contiene todas las imágenes del juego.
+ *
+ * Cada imagen se copia al atlas ya escalada a su tamaño en pantalla y se reemplaza por un
+ * sub-bitmap del atlas. Como todos los sprites comparten la misma textura, Allegro puede
+ * juntar en un solo lote los dibujos hechos entre al_hold_bitmap_drawing(true) y (false).
+ *
+ * Las imágenes que no entran en el atlas, y las que van aparte como los fondos, se
+ * reemplazan por una copia suelta del tamaño en pantalla. Así todos los dibujos del
+ * juego son copias sin escalar. El atlas y las copias se crean en la memoria de video y,
+ * si no se puede, en memoria común.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include <stdbool.h>
+#include <allegro5/allegro.h>
+
+/**
+ * @def ATLAS_SEPARACION
+ * @brief Pixeles transparentes entre sprites, evita que el filtrado mezcle sprites vecinos.
+ */
+#define ATLAS_SEPARACION 1
+
+/**
+ * @struct AtlasSprites
+ * @brief Bitmap del atlas y posición donde se coloca el próximo sprite.
+ *
+ * Los sprites se acomodan en filas de izquierda a derecha; cuando uno no cabe se abre una
+ * fila nueva debajo de la más alta de la fila actual.
+ */
+typedef struct
+{
+    ALLEGRO_BITMAP *bitmap; /**< Bitmap del atlas, NULL si no se pudo crear */
+    int x_libre; /**< Columna donde se coloca el próximo sprite */
+    int y_libre; /**< Fila superior de la fila de sprites actual */
+    int alto_fila; /**< Alto del sprite más alto de la fila actual */
+} AtlasSprites;
+
+/*Funciones*/
+bool crear_atlas_sprites(AtlasSprites *atlas, int ancho, int alto);
+ALLEGRO_BITMAP *agregar_sprite_atlas(AtlasSprites *atlas, ALLEGRO_BITMAP *imagen, int ancho, int alto);
+ALLEGRO_BITMAP *crear_imagen_escalada(ALLEGRO_BITMAP *imagen, int ancho, int alto);
+bool escalar_imagen(ALLEGRO_BITMAP **imagen, int ancho, int alto);
+bool mover_imagen_a_atlas(AtlasSprites *atlas, ALLEGRO_BITMAP **imagen, int ancho, int alto);
+void destruir_atlas_sprites(AtlasSprites *atlas);
+
+#endif
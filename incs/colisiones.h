@@ -0,0 +1,101 @@
+#ifndef COLISIONES_H
+#define COLISIONES_H
+
+/**
+ * @file colisiones.h
+ * @brief Biblioteca con la etapa de colisiones de cada paso de simulación.
+ *
+ * Después de mover todo, detectar_contactos recorre una sola vez cada proyectil contra
+ * los blancos que puede golpear (bloques, enemigos, asteroides, el jefe y la nave) y
+ * anota cada impacto en una lista de contactos, sin cambiar nada del estado. Después
+ * resolver_contactos aplica el daño, el puntaje y los efectos de cada contacto en el
+ * orden en que se anotaron. Así cada par proyectil-blanco se prueba una vez por paso y
+ * todas las reglas de daño quedan en un solo lugar.
+ *
+ * Cada proyectil anota a lo sumo un contacto, el primero que encuentra. Si al
+ * resolverlo su blanco ya no está (un enemigo que mató otro proyectil en el mismo paso,
+ * un asteroide que ya reapareció arriba), el contacto se descarta y el proyectil sigue
+ * volando: en el paso siguiente se vuelve a probar.
+ *
+ * Los asteroides que caen resuelven sus propios choques con la nave, los bloques y los
+ * powerups en actualizar_asteroide, porque no son proyectiles de nadie.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include "simulacion.h"
+
+/**
+ * @def MAX_CONTACTOS_NAVE
+ * @brief Enemigos que pueden chocar con la nave en un mismo paso.
+ *
+ * Los que no entran se anotan en el paso siguiente, porque siguen tocando la nave.
+ */
+#define MAX_CONTACTOS_NAVE 16
+
+/**
+ * @def MAX_CONTACTOS
+ * @brief Contactos de un paso: uno por proyectil vivo más los choques con la nave.
+ */
+#define MAX_CONTACTOS (MAX_DISPAROS + MAX_LASERS + MAX_EXPLOSIVOS + MAX_MISILES + NUM_DISPAROS_ENEMIGOS + MAX_ATAQUES_JEFE + MAX_CONTACTOS_NAVE)
+
+/**
+ * @enum TipoProyectil
+ * @brief Lo que golpea en un contacto.
+ */
+typedef enum
+{
+    PROYECTIL_DISPARO = 0,
+    PROYECTIL_LASER,
+    PROYECTIL_EXPLOSIVO,
+    PROYECTIL_MISIL,
+    PROYECTIL_DISPARO_ENEMIGO,
+    PROYECTIL_ATAQUE_JEFE,
+    PROYECTIL_CUERPO_ENEMIGO, /**< Un enemigo que choca con la nave */
+    NUM_TIPOS_PROYECTIL
+} TipoProyectil;
+
+/**
+ * @enum TipoBlanco
+ * @brief Lo que recibe el golpe en un contacto.
+ */
+typedef enum
+{
+    BLANCO_ENEMIGO = 0,
+    BLANCO_JEFE,
+    BLANCO_ASTEROIDE,
+    BLANCO_TILE,
+    BLANCO_NAVE,
+    NUM_TIPOS_BLANCO
+} TipoBlanco;
+
+/**
+ * @struct Contacto
+ * @brief Impacto de un proyectil contra un blanco, encontrado en detectar_contactos.
+ */
+typedef struct
+{
+    TipoProyectil proyectil;
+    TipoBlanco blanco;
+    int indice; /**< Posición del proyectil en su arreglo, o del enemigo si choca con la nave */
+    int objetivo; /**< Índice del enemigo o del asteroide, fila * MAPA_COLUMNAS + col del tile, o 0 */
+} Contacto;
+
+/**
+ * @struct ListaContactos
+ * @brief Contactos de un paso, en el orden en que se resuelven.
+ */
+typedef struct
+{
+    Contacto contactos[MAX_CONTACTOS];
+    int num_contactos;
+} ListaContactos;
+
+/*Funciones*/
+void detectar_contactos(Simulacion *sim, ListaContactos *lista);
+void resolver_contactos(Simulacion *sim, const ListaContactos *lista);
+void procesar_colisiones(Simulacion *sim);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef ESTRES_H
+#define ESTRES_H
+
+/**
+ * @file estres.h
+ * @brief Biblioteca que genera niveles sintéticos en el peor caso y los corre sin ventana.
+ *
+ * Cada escenario escribe un mapa con el mismo formato que los NivelN.txt, lo carga con
+ * iniciar_partida_archivo y avanza una cantidad fija de pasos con todas las armas
+ * disparando en cada paso. Al final se informa el tiempo por fase del perfil, así un
+ * cambio que haga crecer mal el costo de actualizar_juego con la cantidad de entidades
+ * se nota comparando dos corridas con la misma semilla.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include "simulacion.h"
+
+/**
+ * @def TICKS_ESTRES_DEFECTO
+ * @brief Pasos de simulación de cada escenario si no se indica otra cantidad.
+ */
+#define TICKS_ESTRES_DEFECTO 1800
+
+/**
+ * @def NIVEL_ESTRES
+ * @brief Número de nivel que se le da a los mapas generados; el 1 tiene asteroides.
+ */
+#define NIVEL_ESTRES 1
+
+/**
+ * @def VIDA_JEFE_ESTRES
+ * @brief Vida con la que se mantiene al jefe para que no muera durante la medición.
+ */
+#define VIDA_JEFE_ESTRES 1000000.0f
+
+/**
+ * @def ARCHIVO_NIVEL_ESTRES
+ * @brief Archivo temporal donde se escribe el mapa generado, se borra al terminar.
+ */
+#define ARCHIVO_NIVEL_ESTRES "NivelEstres.txt"
+
+/**
+ * @enum EscenarioEstres
+ * @brief Mapas sintéticos disponibles.
+ */
+typedef enum
+{
+    ESTRES_ENEMIGOS = 0, /**< Todas las celdas con enemigos de tipos mezclados */
+    ESTRES_ESCUDOS, /**< Enemigos arriba y el resto del mapa cubierto de escudos */
+    ESTRES_JEFE, /**< Jefe Supremo con la mitad de las celdas libres para sus invocaciones */
+    NUM_ESCENARIOS_ESTRES
+} EscenarioEstres;
+
+/*Funciones*/
+const char *nombre_escenario_estres(EscenarioEstres escenario);
+int buscar_escenario_estres(const char *nombre);
+bool generar_nivel_estres(EscenarioEstres escenario, const char *ruta, uint64_t semilla);
+double ejecutar_estres(EscenarioEstres escenario, int ticks, uint64_t semilla);
+
+#endif
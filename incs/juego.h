@@ -24,6 +24,13 @@
 #include <allegro5/joystick.h>
 #include <allegro5/allegro_audio.h>
 #include <allegro5/allegro_acodec.h>
+#include "pool.h"
+#include "atlas.h"
+#include "traza.h"
+#include "aleatorio.h"
+#include "perfil.h"
+#include "agenda.h"
+#include "arena.h"
 
 /**
  * @def NUM_ASTEROIDES
@@ -35,6 +42,19 @@
  * @brief Frames por segundo del juego.
  */
 #define FPS 60
+/**
+ * @def DT_SIMULACION
+ * @brief Duración fija de un paso de simulación, en segundos.
+ */
+#define DT_SIMULACION (1.0 / FPS)
+/**
+ * @def TIEMPO_INICIAL_SIMULACION
+ * @brief Valor del reloj de juego al empezar una partida.
+ *
+ * Los temporizadores que arrancan en 0 (último disparo, último uso de un arma) quedan
+ * vencidos desde el primer paso, igual que cuando se usaba al_get_time().
+ */
+#define TIEMPO_INICIAL_SIMULACION 10.0
 /**
  * @def MAX_JUGADORES
  * @brief Numero maximo de jugadores en el ranking.
@@ -65,12 +85,48 @@
  */
 #define MAX_DISPAROS 15
 
+/**
+ * @def MAX_LASERS
+ * @brief Cantidad de lasers que pueden estar activos a la vez.
+ */
+#define MAX_LASERS 5
+
+/**
+ * @def MAX_EXPLOSIVOS
+ * @brief Cantidad de disparos explosivos que pueden estar activos a la vez.
+ */
+#define MAX_EXPLOSIVOS 8
+
+/**
+ * @def MAX_MISILES
+ * @brief Cantidad de misiles teledirigidos que pueden estar activos a la vez.
+ */
+#define MAX_MISILES 6
+
 /**
  * @def NUM_ENEMIGOS
  * @brief Número de enemigos en el juego.
  */
 #define NUM_ENEMIGOS (MAPA_FILAS * MAPA_COLUMNAS)
 
+/**
+ * @def CUBETAS_IA
+ * @brief Un enemigo lejano decide hacia dónde moverse una vez cada CUBETAS_IA pasos (potencia de dos).
+ *
+ * Cada enemigo cae en una cubeta según su índice de manejador, así en cada paso decide
+ * solo una fracción de los lejanos.
+ */
+#define CUBETAS_IA 4
+
+/**
+ * @def DISTANCIA_IA_COMPLETA
+ * @brief Distancia a la nave por debajo de la cual un enemigo en pantalla decide en todos los pasos.
+ *
+ * Supera el rango de visión del perseguidor (250) por más de lo que la nave y un enemigo
+ * pueden acercarse en CUBETAS_IA pasos, así ninguno entra en rango sin estar ya a pleno.
+ */
+#define DISTANCIA_IA_COMPLETA 400.0f
+
 /**
  * @def NUM_DISPAROS_ENEMIGOS
  * @brief Número máximo de disparos de enemigos.
@@ -137,6 +193,18 @@
  */
 #define NUM_TIPOS_JEFES 2
 
+/**
+ * @def ANCHO_ATLAS
+ * @brief Ancho del atlas de sprites, alcanza para todas las imágenes del juego a su tamaño en pantalla.
+ */
+#define ANCHO_ATLAS 512
+
+/**
+ * @def ALTO_ATLAS
+ * @brief Alto del atlas de sprites.
+ */
+#define ALTO_ATLAS 256
+
 /**
  * @def MAX_ENEMIGOS_JEFE
  * @brief Número máximo de enemigos que puede invocar un jefe.
@@ -155,6 +223,66 @@
  */
 #define DEADZONE_JOYSTICK 0.2f
 
+/**
+ * @def MAX_ACCIONES_PASO
+ * @brief Cantidad máxima de acciones del jugador que se guardan entre dos pasos de simulación.
+ */
+#define MAX_ACCIONES_PASO 32
+
+/**
+ * @def NUM_TECLAS_MOVIMIENTO
+ * @brief Teclas de movimiento que usa actualizar_nave (arriba, abajo, izquierda y derecha).
+ */
+#define NUM_TECLAS_MOVIMIENTO 4
+
+/**
+ * @def GRID_COLUMNAS
+ * @brief Numero de columnas de la grilla espacial de colisiones (cubre el ancho de la ventana).
+ */
+#define GRID_COLUMNAS (800 / TILE_ANCHO)
+
+/**
+ * @def GRID_FILAS
+ * @brief Numero de filas de la grilla espacial de colisiones (cubre el alto de la ventana).
+ */
+#define GRID_FILAS (600 / TILE_ALTO)
+
+/**
+ * @def GRID_MAX_CELDAS_ENEMIGO
+ * @brief Maximo de celdas que puede ocupar un enemigo en la grilla; los mas grandes van a la lista de fuera.
+ */
+#define GRID_MAX_CELDAS_ENEMIGO 25
+
+/**
+ * @def GRID_MARGEN
+ * @brief Margen en pixeles con que se inserta cada enemigo (margen del laser mas un pixel de holgura).
+ */
+#define GRID_MARGEN 6.0f
+
+/**
+ * @def MASCARA_TILE_ASTEROIDE
+ * @brief Bit de los asteroides fijos (tipo 1) para las consultas de tiles.
+ */
+#define MASCARA_TILE_ASTEROIDE (1 << 1)
+
+/**
+ * @def MASCARA_TILE_ESCUDO
+ * @brief Bit de los escudos destructibles (tipo 2) con vida para las consultas de tiles.
+ */
+#define MASCARA_TILE_ESCUDO (1 << 2)
+
+/**
+ * @def MASCARA_TILE_MURO
+ * @brief Bit de los muros indestructibles (tipo 3) para las consultas de tiles.
+ */
+#define MASCARA_TILE_MURO (1 << 3)
+
+/**
+ * @def MASCARA_TILE_SOLIDO
+ * @brief Tiles que ningun proyectil puede atravesar (asteroides fijos y muros).
+ */
+#define MASCARA_TILE_SOLIDO (MASCARA_TILE_ASTEROIDE | MASCARA_TILE_MURO)
+
 /**
  * @enum TipoArma
  * @brief Enumeración que define los tipos de armas disponibles en el juego.
@@ -191,6 +319,9 @@ typedef enum
 /**
  * @struct SistemaArma
  * @brief Estructura que representa un sistema de arma en el juego.
+ *
+ * Solo guarda el estado que cambia durante la partida; el nombre y la descripción de
+ * cada tipo de arma se leen con nombre_arma y descripcion_arma.
  */
 typedef struct
 {
@@ -200,8 +331,6 @@ typedef struct
     int kills_necesarias;
     bool desbloqueado;
     double ultimo_uso;
-    char nombre[30];
-    char descripcion[100];
 } SistemaArma;
 
 /**
@@ -224,6 +353,7 @@ typedef struct
     double ultimo_dano;
     int poder;
     float alcance;
+    float alcance_real; /**< Alcance hasta el primer bloque sólido, se calcula una vez por paso en actualizar_lasers */
     float dano_por_segundo;
     ALLEGRO_COLOR color;
 } DisparoLaser;
@@ -265,7 +395,7 @@ typedef struct
     float alto;
     float vel_max;
     float fuerza_giro;
-    int enemigo_objetivo;
+    int enemigo_objetivo; /**< Manejador del enemigo perseguido, ver manejador_enemigo */
     bool activo;
     bool tiene_objetivo;
     double tiempo_vida;
@@ -400,13 +530,65 @@ typedef struct
  * 
  * @brief Estructura que representa un tile en el mapa del juego.
  * 
- * Los tiles tienen un tipo (que puede ser un asteroide, un enemigo, etc.) y una vida (para asteroides o enemigos).
+ * Los tiles tienen un tipo (0 vacío, 1 asteroide fijo, 2 escudo destructible, 3 muro) y una
+ * vida, que solo usan los escudos. Ocupa dos bytes por celda.
  */
 typedef struct {
-    int tipo;
-    int vida;
+    uint8_t tipo;
+    int8_t vida; /**< Golpes que le quedan a un escudo; el resto de los tipos la deja en 0 */
 } Tile;
 
+#if MAPA_COLUMNAS > 64
+#error "Las máscaras por fila del Tilemap usan un bit por columna en un uint64_t"
+#endif
+
+/**
+ * @struct Tilemap
+ * 
+ * @brief Tiles del nivel con una máscara de bits por fila de los sólidos y de los escudos.
+ * 
+ * El bit col de filas_solidas[fila] está prendido si la celda es un asteroide fijo o un
+ * muro, y el de filas_escudo[fila] si es un escudo con vida. Así las consultas de un
+ * rectángulo o un rayo contra el mapa revisan una fila entera con una operación de bits.
+ * Las máscaras se rehacen con actualizar_mascaras_tilemap al cargar un mapa, y
+ * destruir_tile las mantiene al día; cualquier otro cambio de tipo o de vida que haga
+ * pasar un tile de bloqueante a libre tiene que llamar a actualizar_mascara_tile.
+ */
+typedef struct {
+    Tile celdas[MAPA_FILAS][MAPA_COLUMNAS];
+    uint64_t filas_solidas[MAPA_FILAS];
+    uint64_t filas_escudo[MAPA_FILAS];
+} Tilemap;
+
+/**
+ * @struct TilesSucios
+ * 
+ * @brief Lista de tiles que cambiaron desde la última vez que se actualizó la capa del tilemap.
+ * 
+ * La simulación marca los tiles que daña y el dibujo solo vuelve a pintar esos. El arreglo
+ * marcado evita repetir un tile, así la lista nunca pasa de MAPA_FILAS * MAPA_COLUMNAS.
+ */
+typedef struct
+{
+    bool mapa_completo; /**< Se cargó un mapa nuevo y hay que redibujarlo entero */
+    int num_tiles; /**< Cantidad de tiles en la lista */
+    int filas[MAPA_FILAS * MAPA_COLUMNAS]; /**< Fila de cada tile cambiado */
+    int columnas[MAPA_FILAS * MAPA_COLUMNAS]; /**< Columna de cada tile cambiado */
+    bool marcado[MAPA_FILAS][MAPA_COLUMNAS]; /**< Indica si el tile ya está en la lista */
+    int tiles_destruidos; /**< Tiles destruidos en total, lo incrementa destruir_tile */
+} TilesSucios;
+
+/**
+ * @struct CapaTilemap
+ * 
+ * @brief Bitmap fuera de pantalla con el tilemap ya dibujado, para mostrarlo con un solo blit.
+ */
+typedef struct
+{
+    ALLEGRO_BITMAP *bitmap; /**< Tilemap dibujado, NULL si no se pudo crear */
+    ALLEGRO_BITMAP *imagen_asteroide; /**< Imagen de los tiles de tipo asteroide, del tamaño de un tile */
+} CapaTilemap;
+
 /**
  * @struct Enemigo
  * 
@@ -430,6 +612,68 @@ typedef struct
     int tipo; /*Tipo de enemigo: 0 enemigo normal/ 1 enemigo perseguidor*/
 } Enemigo;
 
+/**
+ * @struct DatosEnemigo
+ * 
+ * @brief Datos de un enemigo que no se leen en los recorridos de cada frame (parte fria del pool).
+ */
+typedef struct
+{
+    float vida_max;
+    double ultimo_disparo;
+    double intervalo_disparo;
+    ALLEGRO_BITMAP* imagen;
+    bool disparo_listo; /**< Perseguidor que ya puede disparar y espera tener la nave cerca */
+} DatosEnemigo;
+
+/**
+ * @struct EstadoIAEnemigo
+ * 
+ * @brief Última decisión de movimiento de un perseguidor o kamikaze.
+ * 
+ * Entre dos decisiones de un enemigo lejano se repite el mismo desplazamiento por paso.
+ */
+typedef struct
+{
+    float vx; /**< Desplazamiento por paso en x */
+    float vy; /**< Desplazamiento por paso en y */
+    float distancia_nave; /**< Distancia a la nave en la última decisión, 0 si todavía no decidió */
+} EstadoIAEnemigo;
+
+/**
+ * @struct PoolEnemigos
+ * 
+ * @brief Enemigos en juego guardados como estructura de arreglos.
+ * 
+ * Los campos que se recorren cada frame (posicion, tamaño, velocidad, vida, tipo y estado activo)
+ * estan en arreglos contiguos separados, y el resto queda en la tabla datos. El enemigo i
+ * ocupa la posicion i de todos los arreglos. Enemigo se sigue usando para leer los niveles.
+ * 
+ * Los enemigos ocupan siempre las posiciones [0, num_enemigos). Al morir solo se marcan
+ * inactivos, porque la grilla y los recorridos en curso guardan posiciones, y al comienzo
+ * del paso siguiente compactar_pool_enemigos llena los huecos con los últimos enemigos.
+ * Como las posiciones cambian, quien necesite seguir a un enemigo entre pasos (los misiles)
+ * guarda su manejador, que no cambia mientras el enemigo viva.
+ */
+typedef struct
+{
+    float x[NUM_ENEMIGOS];
+    float y[NUM_ENEMIGOS];
+    float ancho[NUM_ENEMIGOS];
+    float alto[NUM_ENEMIGOS];
+    float velocidad[NUM_ENEMIGOS];
+    float vida[NUM_ENEMIGOS];
+    int tipo[NUM_ENEMIGOS];
+    bool activo[NUM_ENEMIGOS];
+    DatosEnemigo datos[NUM_ENEMIGOS];
+    EstadoIAEnemigo ia[NUM_ENEMIGOS];
+    int manejador[NUM_ENEMIGOS]; /**< Índice de manejador del enemigo de cada posición; desde num_enemigos, los libres */
+    int posicion[NUM_ENEMIGOS]; /**< Posición del enemigo de cada índice de manejador */
+    uint16_t generacion[NUM_ENEMIGOS]; /**< Cambia cada vez que un índice de manejador se libera */
+    int num_enemigos; /**< Cantidad de posiciones usadas (activas o muertas en este paso) */
+    int num_activos; /**< Enemigos vivos */
+} PoolEnemigos;
+
 typedef struct
 {
     char texto[100];
@@ -472,7 +716,7 @@ typedef struct
 
 typedef struct
 {
-    Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS];
+    Tilemap *tilemap;
     ALLEGRO_BITMAP *imagen_juego;
 } ContextoJuego;
 
@@ -505,6 +749,7 @@ typedef struct
 
     // Sistema de ataques de los jefes
     AtaqueJefe ataques[MAX_ATAQUES_JEFE];
+    PoolIndices pool_ataques; /**< Posiciones libres y vivas de ataques[] */
     double ultimo_ataque;
     double intervalo_ataque;
     TipoAtaqueJefe ataque_actual;
@@ -540,6 +785,70 @@ typedef struct
     char nombre_joystick[100];
 } ConfiguracionControl;
 
+/**
+ * @enum TipoEventoAgenda
+ * @brief Eventos que se programan en la agenda de la simulación.
+ */
+typedef enum
+{
+    EVENTO_DISPARO_ENEMIGO = 0, /**< El dato es el manejador del enemigo */
+    EVENTO_ATAQUE_JEFE,
+    EVENTO_INVOCACION_JEFE,
+    NUM_TIPOS_EVENTO
+} TipoEventoAgenda;
+
+/**
+ * @enum TipoAccion
+ * @brief Acciones del jugador que se aplican a la simulación al comienzo de un paso.
+ */
+typedef enum
+{
+    ACCION_DISPARAR = 0,
+    ACCION_SOLTAR_DISPARO,
+    ACCION_CAMBIAR_ARMA, /**< El dato es el TipoArma elegido */
+    ACCION_PRESIONAR_TECLA, /**< El dato es la posición en el arreglo de teclas */
+    ACCION_SOLTAR_TECLA,
+    NUM_TIPOS_ACCION
+} TipoAccion;
+
+/**
+ * @struct AccionEntrada
+ * @brief Una acción del jugador con su dato asociado.
+ */
+typedef struct
+{
+    uint8_t tipo; /**< Un TipoAccion */
+    uint8_t dato;
+} AccionEntrada;
+
+/**
+ * @struct EjesJoystick
+ * @brief Estado del joystick que usa actualizar_nave_joystick, leído una vez por paso.
+ */
+typedef struct
+{
+    float stick_x; /**< Horizontal del stick izquierdo */
+    float stick_y; /**< Vertical del stick izquierdo */
+    float stick_rx; /**< Horizontal del stick derecho */
+    bool boton_l; /**< L1/LB */
+    bool boton_r; /**< R1/RB */
+} EjesJoystick;
+
+/**
+ * @struct EntradaPaso
+ * @brief Entrada del jugador que recibe un paso de simulación.
+ *
+ * Las acciones se guardan en el orden en que ocurrieron desde el paso anterior y se
+ * descartan al aplicarse; los ejes del joystick se mantienen hasta la próxima lectura.
+ * Es lo único que se graba para repetir una partida.
+ */
+typedef struct
+{
+    AccionEntrada acciones[MAX_ACCIONES_PASO];
+    int num_acciones;
+    EjesJoystick ejes;
+} EntradaPaso;
+
 /**
  * @struct EfectosSonido
  * @brief Estructura que maneja todos los efectos de sonido del juego.
@@ -556,21 +865,78 @@ typedef struct
     float volumen_general;
 } EfectosSonido;
 
+/**
+ * @struct GridEspacial
+ * @brief Grilla uniforme de celdas del tamaño de un tile donde se reparten los enemigos cada frame.
+ *
+ * Los indices de cada celda quedan contiguos en el arreglo indices, entre inicio_celda[c]
+ * e inicio_celda[c + 1]. Los enemigos que salen de la ventana o que ocupan demasiadas celdas
+ * se guardan en la lista fuera, que se revisa en todas las consultas.
+ */
+typedef struct
+{
+    int inicio_celda[GRID_FILAS * GRID_COLUMNAS + 1];
+    int siguiente[GRID_FILAS * GRID_COLUMNAS]; /**< Posicion de escritura de cada celda al construir */
+    int indices[NUM_ENEMIGOS * GRID_MAX_CELDAS_ENEMIGO];
+    int fuera[NUM_ENEMIGOS];
+    int num_fuera;
+    int marca[NUM_ENEMIGOS]; /**< Ultima consulta en que se devolvio cada enemigo, evita repetidos */
+    int marca_actual;
+} GridEspacial;
+
+/**
+ * @struct CampoFlujo
+ * @brief Distancia en tiles de cada celda del mapa hasta la nave y hacia dónde moverse.
+ *
+ * Se calcula con una búsqueda en anchura desde la celda de la nave, sin pasar por
+ * asteroides, muros ni escudos. Todos los enemigos que persiguen a la nave leen la
+ * dirección de su celda, así el costo por enemigo no depende del tamaño del mapa. Solo
+ * se vuelve a calcular cuando la nave cambia de celda o se destruye un tile.
+ */
+typedef struct
+{
+    int16_t distancia[MAPA_FILAS][MAPA_COLUMNAS]; /**< Pasos hasta la celda de la nave, -1 si no se llega */
+    float direccion_x[MAPA_FILAS][MAPA_COLUMNAS]; /**< Dirección normalizada hacia la siguiente celda del camino */
+    float direccion_y[MAPA_FILAS][MAPA_COLUMNAS];
+    int cola[MAPA_FILAS * MAPA_COLUMNAS]; /**< Cola de la búsqueda, fila * MAPA_COLUMNAS + columna */
+    int fila_nave; /**< Celda de la nave con la que se calculó */
+    int col_nave;
+    int tiles_destruidos; /**< Valor de TilesSucios::tiles_destruidos con el que se calculó */
+    bool valido; /**< false si hay que calcularlo aunque nada haya cambiado, por ejemplo al cargar un nivel */
+} CampoFlujo;
+
+
+/**
+ * @struct TamanoSprite
+ * @brief Tamaño en pantalla de un sprite, en pixeles.
+ *
+ * Los sprites se escalan a este tamaño una sola vez al cargarlos y después se dibujan sin
+ * escalar, así que init_enemigo_tipo, init_jefe y empaquetar_sprites_juego leen las mismas tablas.
+ */
+typedef struct
+{
+    int ancho;
+    int alto;
+} TamanoSprite;
+
+extern const TamanoSprite tamanos_enemigos[NUM_TIPOS_ENEMIGOS];
+extern const TamanoSprite tamanos_jefes[NUM_TIPOS_JEFES];
 
 /*Funciones*/
 Nave init_nave(float x, float y, float ancho, float largo, float vida, double tiempo_invulnerable, ALLEGRO_BITMAP* imagen_nave);
-void init_asteroides(Asteroide asteroides[], int num_asteroides, int ancho_ventana, ALLEGRO_BITMAP* imagen_asteroide);
-void actualizar_asteroide(Asteroide* asteroide, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Nave* nave, Powerup powerups[], int max_powerups);
-void manejar_eventos(ALLEGRO_EVENT evento, Nave* nave, bool teclas[]);
-void dibujar_juego(Nave nave, Asteroide asteroides[], int num_asteroides, int nivel_actual, ALLEGRO_BITMAP *imagen_fondo);
-void actualizar_nave(Nave* nave, bool teclas[], Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS]);
-void dibujar_barra_vida(Nave nave, ALLEGRO_FONT *fuente);
-void init_disparos(Disparo disparos[], int num_disparos);
-void actualizar_disparos(Disparo disparos[], int num_disparos, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS]);
-void dibujar_disparos(Disparo disparos[], int num_disparos);
-void disparar(Disparo disparos[], int num_disparos, Nave nave);
+void init_asteroides(Asteroide asteroides[], int num_asteroides, int ancho_ventana, ALLEGRO_BITMAP* imagen_asteroide, GeneradorAleatorio *aleatorio);
+void actualizar_asteroide(Asteroide* asteroide, Tilemap *tilemap, TilesSucios *tiles_sucios, Nave* nave, Powerup powerups[], PoolIndices *pool_powerups, GeneradorAleatorio *aleatorio);
+void manejar_eventos(ALLEGRO_EVENT evento, EntradaPaso *entrada);
+void agregar_accion_entrada(EntradaPaso *entrada, TipoAccion tipo, int dato);
+void dibujar_juego(const Nave *nave, Asteroide asteroides[], int num_asteroides, int nivel_actual, ALLEGRO_BITMAP *imagen_fondo);
+void actualizar_nave(Nave* nave, bool teclas[], Tilemap *tilemap);
+void dibujar_barra_vida(const Nave *nave, ALLEGRO_FONT *fuente);
+void init_disparos(Disparo disparos[], int num_disparos, PoolIndices *pool_disparos);
+void actualizar_disparos(Disparo disparos[], PoolIndices *pool_disparos);
+void dibujar_disparos(Disparo disparos[], PoolIndices *pool_disparos);
+void disparar(Disparo disparos[], PoolIndices *pool_disparos, const Nave *nave);
 bool detectar_colision_disparo(Asteroide asteroide, Disparo disparo);
-void actualizar_juego(Nave* nave, bool teclas[], Asteroide asteroides[], int num_asteroides, Disparo disparos[], int num_disparos, int* puntaje, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Enemigo enemigos[], int num_enemigos, Disparo disparos_enemigos[], int num_disparos_enemigos, ColaMensajes *cola_mensajes, EstadoJuego* estado_nivel, double tiempo_actual, Powerup powerups[], int max_powerups);
+void actualizar_juego(Nave* nave, bool teclas[], Asteroide asteroides[], int num_asteroides, Disparo disparos[], PoolIndices *pool_disparos, Tilemap *tilemap, TilesSucios *tiles_sucios, PoolEnemigos *enemigos, GridEspacial *grid, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, ColaMensajes *cola_mensajes, EstadoJuego* estado_nivel, double tiempo_actual, Powerup powerups[], PoolIndices *pool_powerups, GeneradorAleatorio aleatorio[NUM_FLUJOS_ALEATORIOS], AgendaEventos *agenda, CampoFlujo *campo);
 void dibujar_puntaje(int puntaje, ALLEGRO_FONT* fuente);
 void init_botones(Boton botones[]);
 void dibujar_botones(Boton botones[], int num_botones, ALLEGRO_FONT* fuente, int cursor_x, int cursor_y);
@@ -582,119 +948,160 @@ void capturar_nombre(ALLEGRO_FONT* fuente, char* nombre, ALLEGRO_EVENT_QUEUE* co
 int comparar_puntajes(const void* a, const void* b);
 bool cursor_sobre_boton(Boton boton, int x, int y);
 bool detectar_colision_circular(float x1, float y1, float r1, float x2, float y2, float r2);
-void cargar_tilemap(const char* filename, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Enemigo enemigos[], int* num_enemigos, ALLEGRO_BITMAP* imagen_enemigo, float *nave_x, float *nave_y);
-void dibujar_tilemap(Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], ALLEGRO_BITMAP* imagen_asteroide);
-void init_enemigos(Enemigo enemigos[], int num_enemigos, ALLEGRO_BITMAP* imagen_enemigo);
-void actualizar_enemigos(Enemigo enemigos[], int num_enemigos, Disparo disparos_enemigos[], int num_disparos_enemigos, double tiempo_actual, Nave nave);
-void dibujar_enemigos(Enemigo enemigos[], int num_enemigos);
-void actualizar_disparos_enemigos(Disparo disparos[], int num_disparos);
-void dibujar_disparos_enemigos(Disparo disparos[], int num_disparos);
-bool detectar_colision_disparo_enemigo_nave(Nave nave, Disparo disparo);
-void enemigo_disparar(Disparo disparos[], int num_disparos, Enemigo enemigo);
-bool detectar_colision_disparo_enemigo(Disparo disparo, Enemigo enemigo);
-bool detectar_colision_nave_enemigo(Nave nave, Enemigo enemigo);
+void cargar_tilemap(const char* filename, Tilemap *tilemap, Enemigo enemigos[], int* num_enemigos, ALLEGRO_BITMAP* imagen_enemigo, float *nave_x, float *nave_y, GeneradorAleatorio *aleatorio);
+void dibujar_tilemap(Tilemap *tilemap, ALLEGRO_BITMAP* imagen_asteroide);
+void marcar_tile_sucio(TilesSucios *tiles_sucios, int fila, int col);
+void marcar_mapa_sucio(TilesSucios *tiles_sucios);
+bool crear_capa_tilemap(CapaTilemap *capa, ALLEGRO_BITMAP *imagen_asteroide);
+void actualizar_capa_tilemap(CapaTilemap *capa, Tilemap *tilemap, TilesSucios *tiles_sucios);
+void dibujar_capa_tilemap(CapaTilemap *capa, Tilemap *tilemap);
+void destruir_capa_tilemap(CapaTilemap *capa);
+void init_enemigos(Enemigo enemigos[], int num_enemigos, ALLEGRO_BITMAP* imagen_enemigo, GeneradorAleatorio *aleatorio);
+void vaciar_pool_enemigos(PoolEnemigos *enemigos);
+int agregar_enemigo_pool(PoolEnemigos *enemigos, const Enemigo *enemigo);
+void eliminar_enemigo_pool(PoolEnemigos *enemigos, int i);
+void compactar_pool_enemigos(PoolEnemigos *enemigos);
+int manejador_enemigo(const PoolEnemigos *enemigos, int i);
+int buscar_enemigo_manejador(const PoolEnemigos *enemigos, int manejador);
+void actualizar_enemigos(PoolEnemigos *enemigos, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, double tiempo_actual, const Nave *nave, AgendaEventos *agenda, const CampoFlujo *campo);
+void programar_disparo_enemigo(AgendaEventos *agenda, PoolEnemigos *enemigos, int i, double tiempo_actual);
+void programar_disparos_enemigos(AgendaEventos *agenda, PoolEnemigos *enemigos, int desde, double tiempo_actual);
+void disparo_programado_enemigo(AgendaEventos *agenda, PoolEnemigos *enemigos, int i, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, const Nave *nave, double tiempo_actual);
+void dibujar_enemigos(PoolEnemigos *enemigos);
+void actualizar_disparos_enemigos(Disparo disparos[], PoolIndices *pool_disparos);
+void dibujar_disparos_enemigos(Disparo disparos[], PoolIndices *pool_disparos);
+bool detectar_colision_disparo_enemigo_nave(const Nave *nave, Disparo disparo);
+void enemigo_disparar(Disparo disparos[], PoolIndices *pool_disparos, PoolEnemigos *enemigos, int e);
+bool detectar_colision_disparo_enemigo(Disparo disparo, PoolEnemigos *enemigos, int e);
+bool detectar_colision_nave_enemigo(const Nave *nave, PoolEnemigos *enemigos, int e);
 bool detectar_colision_generica(float x1, float y1, float ancho1, float alto1, float x2, float y2, float ancho2, float alto2);
-void disparar_radial(Disparo disparos[], int num_disparos, Nave nave);
+void construir_grid_enemigos(GridEspacial *grid, PoolEnemigos *enemigos);
+int consultar_grid_area(GridEspacial *grid, float x1, float y1, float x2, float y2, int resultados[], int max_resultados);
+int consultar_grid_objeto(GridEspacial *grid, float x, float y, float ancho, float alto, int resultados[], int max_resultados);
+int consultar_grid_segmento(GridEspacial *grid, float x1, float y1, float x2, float y2, int resultados[], int max_resultados);
+bool obtener_rango_tiles(float x, float y, float ancho, float alto, int *fila_ini, int *col_ini, int *fila_fin, int *col_fin);
+bool tile_coincide_mascara(Tile tile, int mascara);
+void actualizar_mascara_tile(Tilemap *tilemap, int fila, int col);
+void actualizar_mascaras_tilemap(Tilemap *tilemap);
+uint64_t mascara_fila_tilemap(const Tilemap *tilemap, int fila, int mascara);
+bool buscar_tile_en_area(Tilemap *tilemap, float x, float y, float ancho, float alto, int mascara, int *fila, int *col);
+void danar_tile(Tilemap *tilemap, int fila, int col, int dano);
+void destruir_tile(Tilemap *tilemap, TilesSucios *tiles_sucios, int fila, int col);
+void invalidar_campo_flujo(CampoFlujo *campo);
+bool actualizar_campo_flujo(CampoFlujo *campo, Tilemap *tilemap, const TilesSucios *tiles_sucios, const Nave *nave);
+bool direccion_campo_flujo(const CampoFlujo *campo, float x, float y, float *direccion_x, float *direccion_y);
+void disparar_radial(Disparo disparos[], PoolIndices *pool_disparos, const Nave *nave);
 void verificar_mejora_disparo_radial(Nave *nave, ColaMensajes *cola_mensajes);
-void dibujar_nivel_powerup(Nave nave, ALLEGRO_FONT* fuente);
+void dibujar_nivel_powerup(const Nave *nave, ALLEGRO_FONT* fuente);
 void init_mensaje(Mensaje* mensaje);
+double tiempo_juego(void);
+void fijar_tiempo_juego(double tiempo);
 void mostrar_mensaje(Mensaje* mensaje, const char* texto, float x, float y, double duracion, ALLEGRO_COLOR color);
 void actualizar_mensaje(Mensaje* mensaje, double tiempo_actual);
 void dibujar_mensaje(Mensaje mensaje, ALLEGRO_FONT* fuente);
 void init_estado_juego(EstadoJuego* estado);
-bool verificar_nivel_completado(Enemigo enemigos[], int num_enemigos, bool hay_jefe_en_nivel, Jefe *jefe);
+bool verificar_nivel_completado(PoolEnemigos *enemigos, bool hay_jefe_en_nivel, Jefe *jefe);
 void mostrar_pantalla_transicion(int nivel_completado, int nivel_siguiente, ALLEGRO_FONT* fuente, double tiempo_transcurrido, double duracion_total);
-bool cargar_siguiente_nivel(int nivel, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Enemigo enemigos_mapa[], int* num_enemigos_cargados, ALLEGRO_BITMAP* imagen_enemigo, float* nave_x, float* nave_y);
-void actualizar_estado_nivel(EstadoJuego* estado, Enemigo enemigos[], int num_enemigos, double tiempo_actual, bool hay_jefe_en_nivel, Jefe *jefe);
+bool cargar_nivel_archivo(const char *nombre_archivo, Tilemap *tilemap, Enemigo enemigos_mapa[], int* num_enemigos_cargados, ALLEGRO_BITMAP* imagen_enemigo, float* nave_x, float* nave_y, GeneradorAleatorio *aleatorio);
+bool cargar_siguiente_nivel(int nivel, Tilemap *tilemap, Enemigo enemigos_mapa[], int* num_enemigos_cargados, ALLEGRO_BITMAP* imagen_enemigo, float* nave_x, float* nave_y, GeneradorAleatorio *aleatorio);
+void actualizar_estado_nivel(EstadoJuego* estado, PoolEnemigos *enemigos, double tiempo_actual, bool hay_jefe_en_nivel, Jefe *jefe);
 bool asteroides_activados(int nivel_actual);
-void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BITMAP* imagen_enemigo);
-void francotirador_disparar(Disparo disparos[], int num_disparos, Enemigo enemigo, Nave nave);
-void tanque_disparar(Disparo disparos[], int num_disparos, Enemigo enemigo);
+void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BITMAP* imagen_enemigo, GeneradorAleatorio *aleatorio);
+void francotirador_disparar(Disparo disparos[], PoolIndices *pool_disparos, PoolEnemigos *enemigos, int e, const Nave *nave);
+void tanque_disparar(Disparo disparos[], PoolIndices *pool_disparos, PoolEnemigos *enemigos, int e);
 bool detectar_colision_disparo_enemigo_escudo(Disparo disparo, float tile_x, float tile_y);
 void init_powerup(Powerup* powerup);
-void crear_powerup_escudo(Powerup powerups[], int max_powerups, float x, float y);
-void actualizar_powerups(Powerup powerups[], int max_powerups, double tiempo_actual);
-void dibujar_powerups(Powerup powerups[], int max_powerups, int *contador_parpadeo, int *contador_debug, ALLEGRO_FONT *fuente);
-bool detectar_colision_powerup(Nave nave, Powerup powerup);
+void crear_powerup_escudo(Powerup powerups[], PoolIndices *pool_powerups, float x, float y);
+void actualizar_powerups(Powerup powerups[], PoolIndices *pool_powerups, double tiempo_actual);
+void dibujar_powerups(Powerup powerups[], PoolIndices *pool_powerups, int *contador_parpadeo, int *contador_debug, ALLEGRO_FONT *fuente);
+bool detectar_colision_powerup(const Nave *nave, Powerup powerup);
 void recoger_powerup(Nave* nave, Powerup* powerup, ColaMensajes *cola_mensajes);
 void init_escudo(Escudo* escudo);
 void actualizar_escudo(Escudo* escudo, double tiempo_actual);
-void dibujar_escudo(Nave nave);
-bool escudo_activo(Nave nave);
+void dibujar_escudo(const Nave *nave);
+bool escudo_activo(const Nave *nave);
 void init_powerup(Powerup* powerup);
-void crear_powerup_escudo(Powerup powerups[], int max_powerups, float x, float y);
-void actualizar_powerups(Powerup powerups[], int max_powerups, double tiempo_actual);
-bool detectar_colision_powerup(Nave nave, Powerup powerup);
+void crear_powerup_escudo(Powerup powerups[], PoolIndices *pool_powerups, float x, float y);
+void actualizar_powerups(Powerup powerups[], PoolIndices *pool_powerups, double tiempo_actual);
+bool detectar_colision_powerup(const Nave *nave, Powerup powerup);
 void recoger_powerup(Nave* nave, Powerup* powerup, ColaMensajes *cola_mensajes);
 void init_escudo(Escudo* escudo);
 void activar_escudo(Escudo* escudo, int hits_maximos);
 void actualizar_escudo(Escudo* escudo, double tiempo_actual);
-void dibujar_escudo(Nave nave);
-bool escudo_activo(Nave nave);
+void dibujar_escudo(const Nave *nave);
+bool escudo_activo(const Nave *nave);
 bool escudo_recibir_dano(Escudo* escudo);
-bool verificar_colision_nave_muro(float x, float y, float ancho, float largo, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS]);
+bool verificar_colision_nave_muro(float x, float y, float ancho, float largo, Tilemap *tilemap);
 void init_cola_mensajes(ColaMensajes* cola);
 void agregar_mensaje_cola(ColaMensajes* cola, const char* texto, double duracion, ALLEGRO_COLOR color, bool centrado);
 void actualizar_cola_mensajes(ColaMensajes* cola, double tiempo_actual);
 void dibujar_cola_mensajes(ColaMensajes cola, ALLEGRO_FONT* fuente);
 void mostrar_mensaje_centrado(Mensaje* mensaje, const char* texto, double duracion, ALLEGRO_COLOR color);
-void dibujar_hitboxes_debug(Nave nave, Enemigo enemigos[], int num_enemigos, Disparo disparos[], int num_disparos, Disparo disparos_enemigos[], int num_disparos_enemigos, Asteroide asteroides[], int num_asteroides, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], ALLEGRO_FONT *fuente);
-void limpiar_memoria_juego(Disparo disparos[], int num_disparos, Disparo disparos_enemigos[], int num_disparos_enemigos, Powerup powerups[], int max_powerups, Enemigo enemigos[], int num_enemigos, ColaMensajes* cola_mensajes);
-void crear_powerup_vida(Powerup powerups[], int max_powerups, float x, float y);
-void crear_powerup_aleatorio(Powerup powerups[], int max_powerups, float x, float y);
-float obtener_radio_nave(Nave nave);
-void obtener_centro_nave(Nave nave, float* centro_x, float* centro_y);
+void dibujar_hitboxes_debug(const Nave *nave, PoolEnemigos *enemigos, Disparo disparos[], PoolIndices *pool_disparos, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, Asteroide asteroides[], int num_asteroides, Tilemap *tilemap, ALLEGRO_FONT *fuente);
+void limpiar_memoria_juego(Disparo disparos[], PoolIndices *pool_disparos, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, Powerup powerups[], PoolIndices *pool_powerups, PoolEnemigos *enemigos, ColaMensajes* cola_mensajes);
+void crear_powerup_vida(Powerup powerups[], PoolIndices *pool_powerups, float x, float y);
+void crear_powerup_aleatorio(Powerup powerups[], PoolIndices *pool_powerups, float x, float y, GeneradorAleatorio *aleatorio);
+float obtener_radio_nave(const Nave *nave);
+void obtener_centro_nave(const Nave *nave, float* centro_x, float* centro_y);
 void init_sistema_armas(Nave* nave);
+const char *nombre_arma(TipoArma tipo);
+const char *descripcion_arma(TipoArma tipo);
 void cambiar_arma(Nave *nave, TipoArma nueva_arma);
 void actualizar_progreso_arma(Nave* nave, TipoArma tipo_arma);
 void verificar_mejora_arma(Nave* nave, TipoArma tipo_arma, ColaMensajes* cola_mensajes);
-void dibujar_info_armas(Nave nave, ALLEGRO_FONT* fuente);
-void disparar_laser(DisparoLaser lasers[], int max_lasers, Nave nave);
-void actualizar_lasers(DisparoLaser lasers[], int max_lasers, Enemigo enemigos[], int num_enemigos, int* puntaje, Nave *nave, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], int *contador_debug, Powerup powerups[], int max_powerups, ColaMensajes *cola_mensajes);
-void dibujar_lasers(DisparoLaser lasers[], int max_lasers, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS]);
-void crear_powerup_aleatorio(Powerup powerups[], int max_powerups, float x, float y);
-void crear_powerup_laser(Powerup powerups[], int max_powerups, float x, float y);
-void disparar_segun_arma(Nave nave, Disparo disparos[], int num_disparos, DisparoLaser lasers[], int max_lasers, DisparoExplosivo explosivos[], int max_explosivos, MisilTeledirigido misiles[], int max_misiles, Enemigo enemigos[], int num_enemigos);
-void crear_powerup_explosivo(Powerup powerups[], int max_powerups, float x, float y);
-void disparar_explosivo(DisparoExplosivo explosivos[], int max_explosivos, Nave nave);
-void actualizar_explosivos(DisparoExplosivo explosivos[], int max_explosivos, Enemigo enemigos[], int num_enemigos, int* puntaje, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Nave *nave, ColaMensajes *cola_mensajes);
-void dibujar_explosivos(DisparoExplosivo explosivos[], int max_explosivos);
-void crear_powerup_misil(Powerup powerups[], int max_powerups, float x, float y);
-void disparar_misil(MisilTeledirigido misiles[], int max_misiles, Nave nave, Enemigo enemigos[], int num_enemigos);
-void actualizar_misiles(MisilTeledirigido misiles[], int max_misiles, Enemigo enemigos[], int num_enemigos, int* puntaje);
-void dibujar_misiles(MisilTeledirigido misiles[], int max_misiles);
+void dibujar_info_armas(const Nave *nave, ALLEGRO_FONT* fuente);
+void disparar_laser(DisparoLaser lasers[], PoolIndices *pool_lasers, const Nave *nave);
+void actualizar_lasers(DisparoLaser lasers[], PoolIndices *pool_lasers, const Nave *nave, Tilemap *tilemap, int *contador_debug);
+void dibujar_lasers(DisparoLaser lasers[], PoolIndices *pool_lasers);
+void crear_powerup_aleatorio(Powerup powerups[], PoolIndices *pool_powerups, float x, float y, GeneradorAleatorio *aleatorio);
+void crear_powerup_laser(Powerup powerups[], PoolIndices *pool_powerups, float x, float y);
+void disparar_segun_arma(const Nave *nave, Disparo disparos[], PoolIndices *pool_disparos, DisparoLaser lasers[], PoolIndices *pool_lasers, DisparoExplosivo explosivos[], PoolIndices *pool_explosivos, MisilTeledirigido misiles[], PoolIndices *pool_misiles, PoolEnemigos *enemigos);
+void crear_powerup_explosivo(Powerup powerups[], PoolIndices *pool_powerups, float x, float y);
+void disparar_explosivo(DisparoExplosivo explosivos[], PoolIndices *pool_explosivos, const Nave *nave);
+void actualizar_explosivos(DisparoExplosivo explosivos[], PoolIndices *pool_explosivos, PoolEnemigos *enemigos, GridEspacial *grid, int* puntaje, Tilemap *tilemap, TilesSucios *tiles_sucios, Nave *nave, ColaMensajes *cola_mensajes);
+void dibujar_explosivos(DisparoExplosivo explosivos[], PoolIndices *pool_explosivos);
+void crear_powerup_misil(Powerup powerups[], PoolIndices *pool_powerups, float x, float y);
+void disparar_misil(MisilTeledirigido misiles[], PoolIndices *pool_misiles, const Nave *nave, PoolEnemigos *enemigos);
+void actualizar_misiles(MisilTeledirigido misiles[], PoolIndices *pool_misiles, PoolEnemigos *enemigos, GridEspacial *grid);
+void dibujar_misiles(MisilTeledirigido misiles[], PoolIndices *pool_misiles);
 bool punto_en_linea_laser(float x1, float y1, float x2, float y2, float px, float py, float tolerancia);
 bool laser_intersecta_enemigo(DisparoLaser laser, Enemigo enemigo);
 bool linea_intersecta_rectangulo(float x1, float y1, float x2, float y2, float rect_x1, float rect_y1, float rect_x2, float rect_y2);
 bool linea_intersecta_linea(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
-float verificar_colision_laser_tilemap(DisparoLaser laser, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS]);
-bool laser_intersecta_enemigo_limitado(DisparoLaser laser, Enemigo enemigo, float alcance_real);
-bool verificar_linea_vista_explosion(float x1, float y1, float x2, float y2, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS]);
+bool trazar_rayo_tilemap(Tilemap *tilemap, float x, float y, float dir_x, float dir_y, float distancia_max, int mascara, bool incluir_inicio, float *distancia, int *fila, int *col);
+float verificar_colision_laser_tilemap(DisparoLaser laser, Tilemap *tilemap);
+bool laser_intersecta_enemigo_limitado(DisparoLaser laser, float x, float y, float ancho, float alto, float alcance_real);
+bool verificar_linea_vista_explosion(float x1, float y1, float x2, float y2, Tilemap *tilemap);
 bool cargar_imagenes_enemigos(ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS]);
 void asignar_imagen_enemigo(Enemigo *enemigo, ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS]);
 void liberar_imagenes_enemigos(ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS]);
 void init_jefe(Jefe* jefe, int tipo, float x, float y, ALLEGRO_BITMAP* imagen);
-void actualizar_jefe(Jefe* jefe, Nave nave, Enemigo enemigos[], int* num_enemigos, ALLEGRO_BITMAP* imagenes_enemigos[NUM_TIPOS_ENEMIGOS], double tiempo_actual);
+void actualizar_jefe(Jefe* jefe, const Nave *nave, double tiempo_actual);
+void programar_eventos_jefe(AgendaEventos *agenda, Jefe *jefe, double tiempo_actual);
+void ataque_programado_jefe(AgendaEventos *agenda, Jefe *jefe, const Nave *nave, double tiempo_actual, GeneradorAleatorio *aleatorio);
+void invocacion_programada_jefe(AgendaEventos *agenda, Jefe *jefe, PoolEnemigos *enemigos, ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS], double tiempo_actual, GeneradorAleatorio *aleatorio);
 void dibujar_jefe(Jefe jefe);
-void jefe_atacar(Jefe* jefe, Nave nave, double tiempo_actual);
-void dibujar_ataques_jefe(AtaqueJefe ataques[], int max_ataques);
-bool detectar_colision_ataque_jefe_nave(AtaqueJefe ataque, Nave nave);
-void jefe_invocar_enemigos(Jefe* jefe, Enemigo enemigos[], int* num_enemigos, ALLEGRO_BITMAP* imagenes_enemigos[NUM_TIPOS_ENEMIGOS]);
+void jefe_atacar(Jefe* jefe, const Nave *nave, double tiempo_actual, GeneradorAleatorio *aleatorio);
+void dibujar_ataques_jefe(AtaqueJefe ataques[], PoolIndices *pool_ataques);
+bool detectar_colision_ataque_jefe_nave(AtaqueJefe ataque, const Nave *nave);
+void jefe_invocar_enemigos(Jefe* jefe, PoolEnemigos *enemigos, ALLEGRO_BITMAP* imagenes_enemigos[NUM_TIPOS_ENEMIGOS], GeneradorAleatorio *aleatorio);
 bool jefe_recibir_dano(Jefe* jefe, float dano, ColaMensajes* cola_mensajes);
-void actualizar_estado_nivel_sin_jefe(EstadoJuego* estado, Enemigo enemigos[], int num_enemigos, double tiempo_actual);
+void actualizar_estado_nivel_sin_jefe(EstadoJuego* estado, PoolEnemigos *enemigos, double tiempo_actual);
 void dibujar_boton_individual(Boton boton, ALLEGRO_FONT* fuente, int cursor_x, int cursor_y);
-void dibujar_info_escudo(Nave nave, ALLEGRO_FONT *fuente);
+void dibujar_info_escudo(const Nave *nave, ALLEGRO_FONT *fuente);
 void init_configuracion_control(ConfiguracionControl *config);
 bool detectar_joysticks(ConfiguracionControl *config);
 void mostrar_menu_seleccion_control(ALLEGRO_FONT *fuente, ConfiguracionControl *config, ALLEGRO_EVENT_QUEUE *cola_eventos);
 void manejar_eventos_joystick(ALLEGRO_EVENT evento);
-void actualizar_nave_joystick(Nave* nave, ALLEGRO_JOYSTICK *joystick, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS]);
+void leer_ejes_joystick(ALLEGRO_JOYSTICK *joystick, EjesJoystick *ejes);
+void actualizar_nave_joystick(Nave* nave, const EjesJoystick *ejes, Tilemap *tilemap);
 bool obtener_boton_joystick_disparar(ALLEGRO_JOYSTICK *joystick);
-void cambiar_arma_joystick(Nave *nave, ALLEGRO_JOYSTICK *joystick);
+void cambiar_arma_joystick(EntradaPaso *entrada, ALLEGRO_JOYSTICK *joystick);
 void dibujar_indicador_control(ConfiguracionControl config, ALLEGRO_FONT *fuente);
 void debug_joystick_estado(ALLEGRO_JOYSTICK *joystick);
 bool cargar_imagenes_jefes(ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES]);
 void liberar_imagenes_jefes(ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES]);
+bool empaquetar_sprites_juego(AtlasSprites *atlas, ALLEGRO_BITMAP **imagen_nave, ALLEGRO_BITMAP **imagen_asteroide, ALLEGRO_BITMAP **imagen_tile_asteroide, ALLEGRO_BITMAP **imagen_enemigo, ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS], ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES]);
 void asignar_imagen_jefe(Jefe *jefe, ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES]);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#ifndef PERFIL_H
+#define PERFIL_H
+
+/**
+ * @file perfil.h
+ * @brief Biblioteca para medir cuánto tarda cada fase del frame y mostrarlo en pantalla.
+ *
+ * Cada fase se mide con el par PERFIL_INICIO / PERFIL_FIN. Lo medido durante un frame se
+ * suma y al cerrar el frame se guarda en una ventana de PERFIL_VENTANA frames, de la que
+ * salen el mínimo, el promedio y el percentil 99 que se muestran con el modo debug (F1).
+ *
+ * escribir_resumen_perfil da además el promedio y el máximo de toda una medición, para
+ * las corridas sin ventana.
+ *
+ * Compilando con -DSIN_PERFIL (make RELEASE=1) las macros no generan código.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include <stdio.h>
+#include <stdbool.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+
+/**
+ * @def PERFIL_VENTANA
+ * @brief Cantidad de frames que se usan para las estadísticas de cada fase.
+ */
+#define PERFIL_VENTANA 128
+
+/**
+ * @def PERFIL_FRAMES_REFRESCO
+ * @brief Cada cuántos frames se recalculan las estadísticas que se muestran.
+ */
+#define PERFIL_FRAMES_REFRESCO 30
+
+/**
+ * @enum FasePerfil
+ * @brief Fases del frame que se miden.
+ */
+typedef enum
+{
+    PERFIL_PASO = 0, /**< Un paso completo de actualizar_simulacion */
+    PERFIL_NAVE,
+    PERFIL_ENEMIGOS,
+    PERFIL_COLISIONES,
+    PERFIL_LASERS,
+    PERFIL_EXPLOSIVOS,
+    PERFIL_MISILES,
+    PERFIL_JEFE,
+    PERFIL_AGENDA, /**< Eventos programados que vencen en el paso */
+    PERFIL_DIBUJAR_JUEGO,
+    PERFIL_DIBUJAR_TILEMAP,
+    PERFIL_DIBUJAR_DISPAROS,
+    PERFIL_DIBUJAR_LASERS,
+    PERFIL_DIBUJAR_EXPLOSIVOS,
+    PERFIL_DIBUJAR_MISILES,
+    PERFIL_DIBUJAR_ENEMIGOS,
+    PERFIL_DIBUJAR_DISPAROS_ENEMIGOS,
+    PERFIL_DIBUJAR_JEFE,
+    PERFIL_DIBUJAR_POWERUPS,
+    PERFIL_DIBUJAR_HITBOXES,
+    PERFIL_DIBUJAR_HUD,
+    PERFIL_FLIP,
+    NUM_FASES_PERFIL
+} FasePerfil;
+
+/**
+ * @struct ConteoPerfil
+ * @brief Cantidad de entidades vivas de un tipo, se muestra junto a los tiempos.
+ */
+typedef struct
+{
+    const char *nombre;
+    int cantidad;
+} ConteoPerfil;
+
+#ifndef SIN_PERFIL
+
+/**
+ * @def PERFIL_INICIO
+ * @brief Empieza a medir una fase. Debe cerrarse con PERFIL_FIN en el mismo bloque.
+ */
+#define PERFIL_INICIO(fase) double inicio_##fase = al_get_time()
+
+/**
+ * @def PERFIL_FIN
+ * @brief Termina de medir una fase y suma el tiempo al frame actual.
+ */
+#define PERFIL_FIN(fase) registrar_tiempo_perfil((fase), al_get_time() - inicio_##fase)
+
+#else
+
+#define PERFIL_INICIO(fase) do { } while (0)
+#define PERFIL_FIN(fase) do { } while (0)
+
+#endif
+
+/*Funciones*/
+void registrar_tiempo_perfil(FasePerfil fase, double segundos);
+void cerrar_frame_perfil(void);
+void reiniciar_perfil(void);
+void escribir_resumen_perfil(FILE *salida);
+void dibujar_perfil(const ConteoPerfil conteos[], int num_conteos);
+void destruir_perfil(void);
+
+#endif
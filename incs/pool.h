@@ -0,0 +1,48 @@
+#ifndef POOL_H
+#define POOL_H
+
+/**
+ * @file pool.h
+ * @brief Biblioteca con un pool genérico de índices de capacidad fija.
+ *
+ * El pool no guarda los objetos: acompaña a un arreglo ya existente (disparos, láseres,
+ * powerups, etc.) y lleva una pila de posiciones libres y una lista compacta de posiciones
+ * vivas. Así activar y liberar un objeto cuesta O(1) y los recorridos solo visitan los vivos.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include <stdbool.h>
+
+/**
+ * @def POOL_CAPACIDAD_MAX
+ * @brief Capacidad máxima de un pool, debe ser mayor o igual al arreglo más grande que acompaña.
+ */
+#define POOL_CAPACIDAD_MAX 32
+
+/**
+ * @struct PoolIndices
+ * @brief Lleva la cuenta de qué posiciones de un arreglo están libres y cuáles vivas.
+ *
+ * Para recorrer los objetos vivos se itera vivos[] desde el final hacia el inicio, de modo que
+ * liberar la posición actual dentro del recorrido no salte ningún elemento.
+ */
+typedef struct
+{
+    int capacidad; /**< Cantidad de posiciones del arreglo asociado */
+    int num_vivos; /**< Cantidad de posiciones en uso */
+    int vivos[POOL_CAPACIDAD_MAX]; /**< Posiciones en uso, empaquetadas al inicio */
+    int posicion_viva[POOL_CAPACIDAD_MAX]; /**< Lugar de cada posición dentro de vivos[], -1 si está libre */
+    int num_libres; /**< Cantidad de posiciones libres */
+    int libres[POOL_CAPACIDAD_MAX]; /**< Pila de posiciones libres */
+} PoolIndices;
+
+/*Funciones*/
+void init_pool_indices(PoolIndices *pool, int capacidad);
+int obtener_indice_pool(PoolIndices *pool);
+void liberar_indice_pool(PoolIndices *pool, int indice);
+bool pool_tiene_vivos(const PoolIndices *pool);
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef REPETICION_H
+#define REPETICION_H
+
+/**
+ * @file repeticion.h
+ * @brief Biblioteca para grabar la entrada de una partida y repetirla después.
+ *
+ * Como la simulación avanza con paso fijo y números aleatorios sembrados, alcanza con
+ * guardar la semilla, el nivel inicial y la EntradaPaso de cada paso para volver a jugar
+ * exactamente la misma partida, con o sin ventana.
+ *
+ * El archivo empieza con un EncabezadoRepeticion y sigue con registros de un byte de tipo
+ * más sus datos. Solo se escribe lo que cambia: las acciones de cada paso, los ejes del
+ * joystick cuando se mueven y una cuenta para las rachas de pasos sin cambios.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "juego.h"
+
+/**
+ * @def VERSION_REPETICION
+ * @brief Versión del formato del archivo de repetición.
+ */
+#define VERSION_REPETICION 1
+
+/**
+ * @def MAX_PASOS_VACIOS_REGISTRO
+ * @brief Mayor racha de pasos sin cambios que entra en un solo registro.
+ */
+#define MAX_PASOS_VACIOS_REGISTRO 0xFFFF
+
+/**
+ * @enum TipoRegistroRepeticion
+ * @brief Tipo de cada registro del archivo de repetición.
+ */
+typedef enum
+{
+    REGISTRO_PASOS_VACIOS = 0, /**< Sigue un uint16_t con la cantidad de pasos sin cambios */
+    REGISTRO_ACCION, /**< Siguen el tipo y el dato de la acción, un byte cada uno */
+    REGISTRO_EJES, /**< Siguen tres float y un byte con los botones de hombro */
+    REGISTRO_FIN_PASO, /**< Termina un paso que tuvo acciones o ejes nuevos */
+    REGISTRO_FIN /**< No hay más pasos */
+} TipoRegistroRepeticion;
+
+/**
+ * @struct EncabezadoRepeticion
+ * @brief Encabezado del archivo de repetición.
+ */
+typedef struct
+{
+    char magia[4]; /**< "RPLY" */
+    uint32_t version; /**< VERSION_REPETICION */
+    uint64_t semilla; /**< Semilla con la que se jugó la partida */
+    int32_t nivel; /**< Nivel con el que empezó la partida */
+    uint32_t control_joystick; /**< 1 si la nave se movía con joystick */
+    uint32_t num_pasos; /**< Pasos grabados, se completa al terminar la grabación */
+    uint32_t reservado;
+} EncabezadoRepeticion;
+
+/**
+ * @struct Repeticion
+ * @brief Archivo de repetición abierto para grabar o para leer.
+ */
+typedef struct
+{
+    FILE *archivo; /**< NULL si no hay grabación ni repetición en curso */
+    EncabezadoRepeticion encabezado;
+    EjesJoystick ejes; /**< Últimos ejes escritos o leídos */
+    uint32_t pasos_vacios; /**< Pasos sin cambios pendientes de escribir o de entregar */
+    uint32_t pasos_leidos;
+} Repeticion;
+
+/*Funciones*/
+bool iniciar_grabacion(Repeticion *repeticion, const char *ruta, uint64_t semilla, int nivel, bool control_joystick);
+void grabar_paso(Repeticion *repeticion, const EntradaPaso *entrada);
+void terminar_grabacion(Repeticion *repeticion);
+bool abrir_repeticion(Repeticion *repeticion, const char *ruta);
+bool leer_paso(Repeticion *repeticion, EntradaPaso *entrada);
+void cerrar_repeticion(Repeticion *repeticion);
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef SIMULACION_H
+#define SIMULACION_H
+
+/**
+ * @file simulacion.h
+ * @brief Biblioteca que agrupa el estado de una partida y permite avanzar la simulación.
+ *
+ * La simulación no depende de la ventana, de la fuente ni de los bitmaps, por lo que
+ * puede ejecutarse sin display (modo headless) para pruebas de carga y mediciones.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include "juego.h"
+#include "repeticion.h"
+#include "telemetria.h"
+
+/**
+ * @def FRAMES_HEADLESS_DEFECTO
+ * @brief Cantidad de frames que se simulan en modo headless si no se indica otra.
+ */
+#define FRAMES_HEADLESS_DEFECTO 10000
+
+/**
+ * @def NUM_NIVELES
+ * @brief Cantidad de niveles que tiene el juego.
+ */
+#define NUM_NIVELES 5
+
+/**
+ * @def MAX_PASOS_POR_FRAME
+ * @brief Máximo de pasos de simulación que se recuperan en un frame después de una demora.
+ *
+ * Si el juego se traba más tiempo que esto, el resto se descarta y la partida se frena
+ * un instante en vez de quedar atrapada intentando ponerse al día.
+ */
+#define MAX_PASOS_POR_FRAME 5
+
+/**
+ * @def SALTO_MAXIMO_INTERPOLACION
+ * @brief Distancia en pixeles a partir de la cual un movimiento se considera un salto.
+ *
+ * Los objetos que reaparecen en otro lugar (asteroides, enemigos al cargar un nivel) se
+ * dibujan en su posición nueva en lugar de interpolarse a través de la pantalla.
+ */
+#define SALTO_MAXIMO_INTERPOLACION 100.0f
+
+/**
+ * @def NUM_CONTEOS_SIMULACION
+ * @brief Tipos de entidades que se cuentan para el overlay de debug.
+ */
+#define NUM_CONTEOS_SIMULACION 9
+
+/**
+ * @struct PosicionesSimulacion
+ * @brief Posiciones de los objetos que se mueven, usadas para interpolar al dibujar.
+ *
+ * También se anota qué posiciones estaban ocupadas: un disparo o un enemigo que aparece
+ * durante el paso usa una posición cuyo valor previo es de otro objeto, y se dibuja
+ * directamente donde nació.
+ */
+typedef struct
+{
+    float nave_x;
+    float nave_y;
+    float asteroides_x[NUM_ASTEROIDES];
+    float asteroides_y[NUM_ASTEROIDES];
+    int num_enemigos; /**< Enemigos en el pool al guardar, los que se agregan después van al final */
+    float enemigos_x[NUM_ENEMIGOS];
+    float enemigos_y[NUM_ENEMIGOS];
+    float disparos_x[MAX_DISPAROS];
+    float disparos_y[MAX_DISPAROS];
+    bool disparos_activos[MAX_DISPAROS];
+    float disparos_enemigos_x[NUM_DISPAROS_ENEMIGOS];
+    float disparos_enemigos_y[NUM_DISPAROS_ENEMIGOS];
+    bool disparos_enemigos_activos[NUM_DISPAROS_ENEMIGOS];
+    float jefe_x;
+    float jefe_y;
+} PosicionesSimulacion;
+
+/**
+ * @struct Simulacion
+ * @brief Estructura que contiene todo el estado de una partida en curso.
+ *
+ * Los bitmaps son opcionales: en modo headless todos quedan en NULL y la simulación
+ * funciona igual, ya que solo se usan al dibujar.
+ */
+typedef struct
+{
+    Nave nave; /**< Nave del jugador */
+    Tilemap tilemap; /**< Mapa del nivel actual */
+    TilesSucios tiles_sucios; /**< Tiles cambiados desde el último redibujo de la capa del mapa */
+    Enemigo enemigos_mapa[NUM_ENEMIGOS]; /**< Enemigos tal como se leyeron del archivo del nivel */
+    PoolEnemigos enemigos; /**< Enemigos en juego */
+    int num_enemigos_cargados; /**< Cantidad de enemigos leidos del archivo del nivel */
+    GridEspacial grid_enemigos; /**< Grilla para buscar enemigos cercanos en las colisiones */
+    Asteroide asteroides[NUM_ASTEROIDES];
+    Disparo disparos[MAX_DISPAROS];
+    Disparo disparos_enemigos[NUM_DISPAROS_ENEMIGOS];
+    DisparoLaser lasers[MAX_LASERS];
+    DisparoExplosivo explosivos[MAX_EXPLOSIVOS];
+    MisilTeledirigido misiles[MAX_MISILES];
+    Powerup powerups[MAX_POWERUPS];
+    PoolIndices pool_disparos; /**< Posiciones libres y vivas de cada arreglo de proyectiles */
+    PoolIndices pool_disparos_enemigos;
+    PoolIndices pool_lasers;
+    PoolIndices pool_explosivos;
+    PoolIndices pool_misiles;
+    PoolIndices pool_powerups;
+    Jefe jefe_nivel;
+    bool hay_jefe_en_nivel;
+    AgendaEventos agenda; /**< Disparos de enemigos y ataques e invocaciones del jefe programados */
+    CampoFlujo campo_flujo; /**< Camino hacia la nave que siguen perseguidores y kamikazes */
+    EstadoJuego estado_nivel;
+    ColaMensajes cola_mensajes;
+    bool teclas[ALLEGRO_KEY_MAX]; /**< Estado de las teclas de movimiento */
+    int puntaje;
+    float nave_x_inicial; /**< Posicion inicial de la nave en el nivel */
+    float nave_y_inicial;
+    bool recargar_nivel; /**< Indica que hay que cargar el siguiente nivel */
+    bool juego_terminado; /**< Indica que se completaron todos los niveles */
+    int contador_debug_lasers;
+    bool control_joystick; /**< La nave se mueve con joystick en lugar de teclado */
+    EjesJoystick ejes_joystick; /**< Ejes del joystick recibidos en el último paso */
+    double tiempo; /**< Reloj de la partida, avanza DT_SIMULACION por paso */
+    PosicionesSimulacion posiciones_previas; /**< Posiciones al comienzo del último paso */
+    uint64_t semilla; /**< Semilla de la partida, se vuelve a usar en cada iniciar_partida */
+    GeneradorAleatorio aleatorio[NUM_FLUJOS_ALEATORIOS]; /**< Un flujo de números aleatorios por subsistema */
+
+    // Recursos graficos (NULL en modo headless)
+    ALLEGRO_BITMAP *imagen_nave;
+    ALLEGRO_BITMAP *imagen_asteroide;
+    ALLEGRO_BITMAP *imagen_enemigo;
+    ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS];
+    ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES];
+} Simulacion;
+
+/*Funciones*/
+void init_simulacion(Simulacion *sim, ALLEGRO_BITMAP *imagen_nave, ALLEGRO_BITMAP *imagen_asteroide, ALLEGRO_BITMAP *imagen_enemigo, ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS], ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES], uint64_t semilla);
+bool iniciar_partida(Simulacion *sim, int nivel);
+bool iniciar_partida_archivo(Simulacion *sim, int nivel, const char *nombre_archivo);
+bool avanzar_nivel(Simulacion *sim);
+void disparar_simulacion(Simulacion *sim);
+void soltar_disparo_simulacion(Simulacion *sim);
+void aplicar_entrada_simulacion(Simulacion *sim, EntradaPaso *entrada);
+void actualizar_simulacion(Simulacion *sim);
+void interpolar_simulacion(Simulacion *sim, float alfa, PosicionesSimulacion *posiciones_actuales);
+void restaurar_simulacion(Simulacion *sim, const PosicionesSimulacion *posiciones_actuales);
+int contar_enemigos_activos(Simulacion *sim);
+int contar_entidades_simulacion(Simulacion *sim, ConteoPerfil conteos[NUM_CONTEOS_SIMULACION]);
+void registrar_telemetria_simulacion(Simulacion *sim, uint32_t frame, double inicio, double segundos_simulacion, double segundos_dibujo);
+double ejecutar_simulacion_headless(int nivel, int frames, uint64_t semilla);
+double ejecutar_repeticion_headless(const char *ruta);
+
+#endif
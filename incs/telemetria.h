@@ -0,0 +1,53 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+/**
+ * @file telemetria.h
+ * @brief Biblioteca que guarda en disco un registro por frame para analizar sesiones largas.
+ *
+ * El bucle del juego solo copia cada registro a un buffer circular; un hilo aparte los
+ * escribe en el archivo. Si el hilo se atrasa y el buffer se llena, los registros nuevos
+ * se descartan y se cuentan, pero el juego nunca espera al disco.
+ *
+ * Si el archivo termina en ".json" se escribe en el formato de eventos de Chrome
+ * (chrome://tracing, Perfetto); en cualquier otro caso se escribe CSV.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @def TAMANO_TELEMETRIA
+ * @brief Cantidad de registros que entran en el buffer entre el juego y el hilo escritor.
+ */
+#define TAMANO_TELEMETRIA 4096
+
+/**
+ * @struct RegistroTelemetria
+ * @brief Datos de un frame.
+ */
+typedef struct
+{
+    uint32_t frame; /**< Número de frame desde que empezó la telemetría */
+    int32_t nivel; /**< Nivel en juego */
+    double inicio; /**< Segundos desde que empezó la telemetría hasta el comienzo del frame */
+    float segundos_simulacion; /**< Tiempo de los pasos de simulación del frame */
+    float segundos_dibujo; /**< Tiempo de dibujo, incluido al_flip_display */
+    uint16_t disparos; /**< Disparos vivos de la nave */
+    uint16_t disparos_enemigos; /**< Disparos vivos de los enemigos */
+    uint16_t enemigos; /**< Enemigos activos */
+    uint16_t ataques_jefe; /**< Ataques del jefe vivos */
+} RegistroTelemetria;
+
+/*Funciones*/
+bool iniciar_telemetria(const char *ruta);
+bool telemetria_activa(void);
+double tiempo_telemetria(void);
+void registrar_telemetria(const RegistroTelemetria *registro);
+void terminar_telemetria(void);
+
+#endif
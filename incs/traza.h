@@ -0,0 +1,186 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+
+/**
+ * @file traza.h
+ * @brief Biblioteca de trazas binarias: los eventos frecuentes del juego se guardan en un buffer circular.
+ *
+ * Los mensajes que antes se imprimían en cada frame o en cada colisión ahora se registran como
+ * eventos de 16 bytes en memoria. Cada categoría tiene su propio nivel; con el nivel apagado
+ * (lo normal si no se pasa --trace) registrar un evento cuesta una comparación.
+ *
+ * El archivo volcado empieza con un EncabezadoTraza y sigue con los eventos del más antiguo
+ * al más nuevo.
+ *
+ * @version 0.1
+ * @date 2025-01-17
+ */
+
+/*Bibliotecas usadas*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @def TAMANO_TRAZA
+ * @brief Cantidad de eventos que guarda el buffer circular, debe ser potencia de dos.
+ */
+#define TAMANO_TRAZA 65536
+
+/**
+ * @def VERSION_TRAZA
+ * @brief Versión del formato del archivo de trazas.
+ */
+#define VERSION_TRAZA 2
+
+/**
+ * @enum CategoriaTraza
+ * @brief Subsistema que generó el evento, cada uno con su propio nivel.
+ */
+typedef enum
+{
+    TRAZA_NAVE,
+    TRAZA_ASTEROIDES,
+    TRAZA_TILES,
+    TRAZA_ENEMIGOS,
+    TRAZA_POWERUPS,
+    TRAZA_MENSAJES,
+    TRAZA_ARMAS,
+    TRAZA_JEFE,
+    TRAZA_NIVEL,
+    NUM_CATEGORIAS_TRAZA
+} CategoriaTraza;
+
+/**
+ * @enum NivelTraza
+ * @brief Nivel de detalle de una categoría. Se registran los eventos con nivel menor o igual.
+ */
+typedef enum
+{
+    NIVEL_TRAZA_APAGADO,
+    NIVEL_TRAZA_EVENTO, /**< Hechos puntuales: daños, destrucciones, disparos */
+    NIVEL_TRAZA_DETALLE /**< Estado que se repite en cada frame */
+} NivelTraza;
+
+/**
+ * @enum CodigoTraza
+ * @brief Identifica qué pasó. El significado de los valores a y b se indica en cada código.
+ */
+typedef enum
+{
+    TRAZA_NAVE_IZQUIERDA, /**< a, b: posición */
+    TRAZA_NAVE_DERECHA, /**< a, b: posición */
+    TRAZA_NAVE_ROTAR_IZQUIERDA, /**< a: ángulo */
+    TRAZA_NAVE_ROTAR_DERECHA, /**< a: ángulo */
+    TRAZA_NAVE_AVANZAR, /**< a, b: posición */
+    TRAZA_NAVE_ROTAR_STICK, /**< a: valor del stick */
+    TRAZA_NAVE_ROTAR_L1,
+    TRAZA_NAVE_ROTAR_R1,
+    TRAZA_NAVE_AVANZAR_STICK, /**< a: valor del stick */
+    TRAZA_NAVE_DANO, /**< a: daño, b: vida restante */
+    TRAZA_NAVE_ESCUDO_ABSORBE,
+    TRAZA_ESCUDO_NO_DISPONIBLE,
+    TRAZA_ESCUDO_DANO, /**< a: hits restantes */
+    TRAZA_ESCUDO_DESTRUIDO,
+    TRAZA_ASTEROIDE_DESTRUYE_POWERUP,
+    TRAZA_ASTEROIDE_REBOTE_SOLIDO,
+    TRAZA_ASTEROIDE_REBOTE_ASTEROIDE,
+    TRAZA_TILE_DANO, /**< a: columna, b: fila */
+    TRAZA_TILE_DESTRUIDO, /**< a: columna, b: fila */
+    TRAZA_TILE_REBOTE_MURO, /**< a: columna, b: fila */
+    TRAZA_TILE_IMPACTO_ASTEROIDE, /**< a: columna, b: fila */
+    TRAZA_TILE_IMPACTO_SOLIDO, /**< a: columna, b: fila */
+    TRAZA_ENEMIGO_CREADO, /**< a: tipo, b: vida */
+    TRAZA_ENEMIGO_KAMIKAZE, /**< a: vida restante de la nave */
+    TRAZA_ENEMIGO_DANO_EXPLOSION, /**< a: daño, b: distancia */
+    TRAZA_ENEMIGO_ELIMINADO_EXPLOSION,
+    TRAZA_ENEMIGO_IMPACTO_MISIL, /**< a: enemigo, b: daño */
+    TRAZA_ENEMIGO_ELIMINADO_MISIL,
+    TRAZA_POWERUP_SORTEO, /**< a: valor sorteado entre 0 y 99 */
+    TRAZA_POWERUP_CREADO, /**< a: tipo, b: posición en el arreglo */
+    TRAZA_POWERUP_SIN_ESPACIO, /**< a: tipo */
+    TRAZA_POWERUP_RECOGIDO, /**< a: tipo */
+    TRAZA_POWERUP_PERDIDO,
+    TRAZA_POWERUP_EXPIRADO,
+    TRAZA_POWERUP_ACTIVO, /**< a: posición en el arreglo, b: tiempo restante */
+    TRAZA_POWERUPS_ACTIVOS, /**< a: cantidad */
+    TRAZA_MENSAJE_COLA_LLENA,
+    TRAZA_MENSAJE_AGREGADO, /**< a: mensajes en cola */
+    TRAZA_MENSAJE_PROCESADO, /**< a: mensajes restantes */
+    TRAZA_ARMA_PROGRESO, /**< a: kills, b: kills necesarias */
+    TRAZA_ARMA_DESBLOQUEADA, /**< a: TipoArma */
+    TRAZA_LASER_SIN_ESPACIO,
+    TRAZA_LASER_DISPARADO, /**< a: nivel, b: poder */
+    TRAZA_LASER_YA_ACTIVO,
+    TRAZA_LASER_SOLTADO,
+    TRAZA_LASERS_ACTIVOS, /**< a: cantidad */
+    TRAZA_EXPLOSIVO_SIN_ESPACIO,
+    TRAZA_EXPLOSIVO_DISPARADO, /**< a: radio, b: daño directo */
+    TRAZA_EXPLOSIVO_IMPACTO_ENEMIGO, /**< a: tipo de enemigo */
+    TRAZA_EXPLOSIVO_FUERA_PANTALLA,
+    TRAZA_EXPLOSIVO_TIEMPO_LIMITE,
+    TRAZA_EXPLOSION_AREA,
+    TRAZA_EXPLOSION_TERMINADA,
+    TRAZA_MISIL_DISPARADO, /**< a: nivel, b: enemigo objetivo */
+    TRAZA_JEFE_ATAQUE_FURIA, /**< a: fase */
+    TRAZA_JEFE_DANO, /**< a: daño, b: vida restante */
+    TRAZA_JEFE_IMPACTO_NAVE, /**< a: daño, b: vida restante de la nave */
+    TRAZA_JEFE_INVOCACION, /**< a: enemigos invocados, b: total invocados por el jefe */
+    TRAZA_NIVEL_JEFE_ACTIVO, /**< a: 1 si el jefe sigue activo */
+    TRAZA_NIVEL_PENDIENTE, /**< a: enemigos restantes */
+    TRAZA_NIVEL_COMPLETADO,
+    NUM_CODIGOS_TRAZA
+} CodigoTraza;
+
+/**
+ * @struct EventoTraza
+ * @brief Evento registrado, ocupa 16 bytes.
+ */
+typedef struct
+{
+    uint32_t frame; /**< Frame de simulación en que ocurrió */
+    uint8_t categoria; /**< CategoriaTraza */
+    uint8_t nivel; /**< NivelTraza */
+    uint16_t codigo; /**< CodigoTraza */
+    float a; /**< Primer valor, depende del código */
+    float b; /**< Segundo valor, depende del código */
+} EventoTraza;
+
+/**
+ * @struct EncabezadoTraza
+ * @brief Encabezado del archivo de trazas.
+ */
+typedef struct
+{
+    char magia[4]; /**< "TRZA" */
+    uint32_t version; /**< VERSION_TRAZA */
+    uint32_t num_eventos; /**< Eventos que siguen al encabezado */
+    uint32_t eventos_perdidos; /**< Eventos pisados por la vuelta del buffer */
+} EncabezadoTraza;
+
+/**
+ * @brief Nivel de cada categoría, lo consulta la macro TRAZA antes de registrar.
+ */
+extern uint8_t niveles_traza[NUM_CATEGORIAS_TRAZA];
+
+/**
+ * @def TRAZA
+ * @brief Registra un evento si la categoría tiene el nivel suficiente.
+ */
+#define TRAZA(categoria, nivel, codigo, a, b) \
+    do \
+    { \
+        if (niveles_traza[(categoria)] >= (nivel)) \
+        { \
+            registrar_traza((categoria), (nivel), (codigo), (float)(a), (float)(b)); \
+        } \
+    } while (0)
+
+/*Funciones*/
+void activar_traza(const char *ruta, NivelTraza nivel);
+void configurar_nivel_traza(CategoriaTraza categoria, NivelTraza nivel);
+bool traza_activa(void);
+void avanzar_frame_traza(void);
+void registrar_traza(CategoriaTraza categoria, NivelTraza nivel, CodigoTraza codigo, float a, float b);
+bool volcar_traza(void);
+
+#endif
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include "agenda.h"
+
+/**
+ * @file agenda.c
+ * @brief Este archivo contiene la rueda de tiempos de los eventos programados.
+ */
+
+
+/**
+ * @brief Deja la agenda vacía en el paso 0.
+ *
+ * @param agenda Agenda a inicializar.
+ */
+void init_agenda(AgendaEventos *agenda)
+{
+    int i;
+
+    for (i = 0; i < AGENDA_RANURAS_NIVEL0; i++)
+    {
+        agenda->nivel0[i] = -1;
+    }
+
+    for (i = 0; i < AGENDA_RANURAS_NIVEL1; i++)
+    {
+        agenda->nivel1[i] = -1;
+    }
+
+    for (i = 0; i < MAX_EVENTOS_AGENDA - 1; i++)
+    {
+        agenda->eventos[i].siguiente = i + 1;
+    }
+    agenda->eventos[MAX_EVENTOS_AGENDA - 1].siguiente = -1;
+
+    agenda->lejanos = -1;
+    agenda->libres = 0;
+    agenda->paso = 0;
+    agenda->num_eventos = 0;
+}
+
+
+/**
+ * @brief Pone un evento en la lista que le corresponde según cuánto falta para que venza.
+ *
+ * Si falta menos de una vuelta del primer nivel va a la ranura de su paso; si falta
+ * menos de lo que cubre el segundo nivel, a la ranura de su bloque de pasos. Como un
+ * evento del segundo nivel vence al menos un bloque después del actual, su ranura no
+ * se reparte hasta que llega su bloque.
+ *
+ * @param agenda Agenda.
+ * @param e Índice del evento.
+ */
+static void ubicar_evento(AgendaEventos *agenda, int e)
+{
+    uint32_t faltan = agenda->eventos[e].vence - agenda->paso;
+    int *lista;
+
+    if (faltan < AGENDA_RANURAS_NIVEL0)
+    {
+        lista = &agenda->nivel0[agenda->eventos[e].vence & (AGENDA_RANURAS_NIVEL0 - 1)];
+    }
+    else if (faltan < AGENDA_RANURAS_NIVEL0 * AGENDA_RANURAS_NIVEL1)
+    {
+        lista = &agenda->nivel1[(agenda->eventos[e].vence >> AGENDA_BITS_NIVEL0) & (AGENDA_RANURAS_NIVEL1 - 1)];
+    }
+    else
+    {
+        lista = &agenda->lejanos;
+    }
+
+    agenda->eventos[e].siguiente = *lista;
+    *lista = e;
+}
+
+
+/**
+ * @brief Programa un evento para dentro de una cantidad de pasos.
+ *
+ * @param agenda Agenda.
+ * @param pasos Pasos que faltan, se ejecuta en el avanzar_agenda número pasos desde ahora (mínimo 1).
+ * @param tipo Tipo del evento.
+ * @param dato Dato del evento.
+ * @return true si se programó, false si la agenda está llena.
+ */
+bool programar_evento(AgendaEventos *agenda, int pasos, int tipo, int dato)
+{
+    int e = agenda->libres;
+
+    if (e < 0)
+    {
+        printf("Agenda llena: se descarta un evento de tipo %d\n", tipo);
+        return false;
+    }
+
+    if (pasos < 1)
+    {
+        pasos = 1;
+    }
+
+    agenda->libres = agenda->eventos[e].siguiente;
+    agenda->eventos[e].vence = agenda->paso + (uint32_t)pasos;
+    agenda->eventos[e].tipo = tipo;
+    agenda->eventos[e].dato = dato;
+    ubicar_evento(agenda, e);
+    agenda->num_eventos++;
+
+    return true;
+}
+
+
+/**
+ * @brief Vuelve a ubicar todos los eventos de una lista, que queda vacía.
+ *
+ * @param agenda Agenda.
+ * @param lista Primer evento de la lista.
+ */
+static void repartir_lista(AgendaEventos *agenda, int *lista)
+{
+    int e = *lista;
+    int siguiente;
+
+    *lista = -1;
+    while (e >= 0)
+    {
+        siguiente = agenda->eventos[e].siguiente;
+        ubicar_evento(agenda, e);
+        e = siguiente;
+    }
+}
+
+
+/**
+ * @brief Avanza un paso y ejecuta los eventos que vencen en él.
+ *
+ * Al comenzar cada vuelta del primer nivel se reparte en él la ranura del segundo nivel
+ * del bloque que empieza, y se revisan los eventos lejanos.
+ *
+ * @param agenda Agenda.
+ * @param accion Función que ejecuta cada evento.
+ * @param contexto Se pasa a accion sin cambios.
+ * @return Cantidad de eventos ejecutados.
+ */
+int avanzar_agenda(AgendaEventos *agenda, AccionAgenda accion, void *contexto)
+{
+    int e;
+    int siguiente;
+    int ejecutados = 0;
+    EventoAgenda evento;
+
+    agenda->paso++;
+
+    if ((agenda->paso & (AGENDA_RANURAS_NIVEL0 - 1)) == 0)
+    {
+        if (agenda->lejanos >= 0)
+        {
+            repartir_lista(agenda, &agenda->lejanos);
+        }
+        repartir_lista(agenda, &agenda->nivel1[(agenda->paso >> AGENDA_BITS_NIVEL0) & (AGENDA_RANURAS_NIVEL1 - 1)]);
+    }
+
+    // La ranura se separa antes de ejecutar: lo que se programe ahora vence en otro paso
+    e = agenda->nivel0[agenda->paso & (AGENDA_RANURAS_NIVEL0 - 1)];
+    agenda->nivel0[agenda->paso & (AGENDA_RANURAS_NIVEL0 - 1)] = -1;
+
+    while (e >= 0)
+    {
+        evento = agenda->eventos[e];
+        siguiente = evento.siguiente;
+
+        agenda->eventos[e].siguiente = agenda->libres;
+        agenda->libres = e;
+        agenda->num_eventos--;
+
+        accion(contexto, evento.tipo, evento.dato);
+        ejecutados++;
+        e = siguiente;
+    }
+
+    return ejecutados;
+}
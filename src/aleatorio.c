@@ -0,0 +1,85 @@
+#include "aleatorio.h"
+
+/**
+ * @file aleatorio.c
+ * @brief Este archivo contiene el generador PCG32 usado por la simulación.
+ */
+
+
+/**
+ * @brief Inicializa un generador a partir de una semilla y un número de flujo.
+ *
+ * Generadores con la misma semilla y distinto flujo producen secuencias independientes.
+ *
+ * @param generador Generador a inicializar.
+ * @param semilla Semilla de la partida.
+ * @param flujo Número de flujo, normalmente un FlujoAleatorio.
+ */
+void sembrar_generador(GeneradorAleatorio *generador, uint64_t semilla, uint64_t flujo)
+{
+    generador->estado = 0;
+    generador->incremento = (flujo << 1u) | 1u;
+    siguiente_aleatorio(generador);
+    generador->estado += semilla;
+    siguiente_aleatorio(generador);
+}
+
+
+/**
+ * @brief Genera el siguiente número de 32 bits.
+ *
+ * @param generador Generador a usar.
+ * @return Número aleatorio uniforme en todo el rango de uint32_t.
+ */
+uint32_t siguiente_aleatorio(GeneradorAleatorio *generador)
+{
+    uint64_t anterior = generador->estado;
+    uint32_t mezcla;
+    uint32_t rotacion;
+
+    generador->estado = anterior * 6364136223846793005ULL + generador->incremento;
+
+    mezcla = (uint32_t)(((anterior >> 18u) ^ anterior) >> 27u);
+    rotacion = (uint32_t)(anterior >> 59u);
+
+    return (mezcla >> rotacion) | (mezcla << ((-rotacion) & 31u));
+}
+
+
+/**
+ * @brief Genera un entero entre 0 y limite - 1, reemplazo de rand() % limite.
+ *
+ * Usa una multiplicación en lugar del módulo (método de Lemire). Los pocos productos
+ * que caerían en la franja que sobra cuando 2^32 no es múltiplo de limite se descartan
+ * y se vuelve a sortear, así todos los valores tienen la misma probabilidad. El
+ * descarte ocurre con probabilidad menor a limite / 2^32 y casi nunca hace falta el
+ * módulo.
+ *
+ * @param generador Generador a usar.
+ * @param limite Cantidad de valores posibles.
+ * @return Entero en [0, limite), o 0 si limite no es positivo.
+ */
+int aleatorio_entero(GeneradorAleatorio *generador, int limite)
+{
+    uint32_t rango = (uint32_t)limite;
+    uint32_t umbral;
+    uint64_t producto;
+
+    if (limite <= 0)
+    {
+        return 0;
+    }
+
+    producto = (uint64_t)siguiente_aleatorio(generador) * rango;
+
+    if ((uint32_t)producto < rango)
+    {
+        umbral = (0u - rango) % rango; // 2^32 mod rango
+        while ((uint32_t)producto < umbral)
+        {
+            producto = (uint64_t)siguiente_aleatorio(generador) * rango;
+        }
+    }
+
+    return (int)(producto >> 32);
+}
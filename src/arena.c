@@ -0,0 +1,141 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include "arena.h"
+
+/**
+ * @file arena.c
+ * @brief Este archivo contiene la memoria temporal de cada frame y su control de uso.
+ */
+
+static _Alignas(ARENA_ALINEACION) unsigned char memoria_arena[ARENA_FRAME_BYTES];
+static size_t usado = 0; /**< Bytes reservados en el frame actual */
+static size_t maximo_usado = 0; /**< Mayor uso de un frame desde que empezó el programa */
+static long frames_arena = 0; /**< Frames cerrados con reiniciar_arena_frame */
+static long desbordes = 0; /**< Reservas que no entraron */
+static size_t mayor_desborde = 0; /**< Bytes que hubiera necesitado el peor frame desbordado */
+static int desbordes_frame = 0; /**< Reservas que no entraron en el frame actual */
+
+
+/**
+ * @brief Vacía la arena para el frame que empieza y actualiza el máximo usado.
+ *
+ * Todo lo reservado antes deja de ser válido.
+ */
+void reiniciar_arena_frame(void)
+{
+    if (usado > maximo_usado)
+    {
+        maximo_usado = usado;
+    }
+
+    usado = 0;
+    desbordes_frame = 0;
+    frames_arena++;
+}
+
+
+/**
+ * @brief Reserva memoria que dura hasta el próximo reiniciar_arena_frame.
+ *
+ * La memoria no se inicializa. Si no entra se avisa una vez por frame y se devuelve NULL,
+ * así que quien reserva debe tener un camino para ese caso.
+ *
+ * @param bytes Cantidad de bytes.
+ * @return Puntero alineado a ARENA_ALINEACION, o NULL si la arena está llena.
+ */
+void *reservar_arena_frame(size_t bytes)
+{
+    size_t tamano = (bytes + ARENA_ALINEACION - 1) & ~(size_t)(ARENA_ALINEACION - 1);
+    void *memoria;
+
+    if (tamano > ARENA_FRAME_BYTES - usado)
+    {
+        if (desbordes_frame == 0)
+        {
+            printf("Arena del frame llena: se pidieron %zu bytes con %zu de %d usados\n", bytes, usado, ARENA_FRAME_BYTES);
+        }
+        desbordes_frame++;
+        desbordes++;
+
+        if (usado + tamano > mayor_desborde)
+        {
+            mayor_desborde = usado + tamano;
+        }
+        return NULL;
+    }
+
+    memoria = memoria_arena + usado;
+    usado += tamano;
+
+    return memoria;
+}
+
+
+/**
+ * @brief Escribe un texto con formato de printf en la arena del frame.
+ *
+ * Pensado para los textos del HUD que se arman y se dibujan en el mismo frame.
+ *
+ * @param formato Formato de printf.
+ * @return El texto, o una cadena vacía si no entra en la arena.
+ */
+char *formatear_arena_frame(const char *formato, ...)
+{
+    static char vacio[1] = "";
+    va_list argumentos;
+    char *texto;
+    int largo;
+
+    va_start(argumentos, formato);
+    largo = vsnprintf(NULL, 0, formato, argumentos);
+    va_end(argumentos);
+
+    if (largo < 0)
+    {
+        return vacio;
+    }
+
+    texto = reservar_arena_frame((size_t)largo + 1);
+    if (texto == NULL)
+    {
+        return vacio;
+    }
+
+    va_start(argumentos, formato);
+    vsnprintf(texto, (size_t)largo + 1, formato, argumentos);
+    va_end(argumentos);
+
+    return texto;
+}
+
+
+/**
+ * @brief Devuelve los bytes reservados en el frame actual.
+ *
+ * @return Bytes usados, contando el relleno de alineación.
+ */
+size_t usado_arena_frame(void)
+{
+    return usado;
+}
+
+
+/**
+ * @brief Escribe el máximo usado en un frame y los desbordes desde que empezó el programa.
+ *
+ * @param salida Archivo donde se escribe, por ejemplo stderr.
+ */
+void escribir_resumen_arena(FILE *salida)
+{
+    size_t maximo = usado > maximo_usado ? usado : maximo_usado;
+
+    fprintf(salida, "Arena del frame: máximo %zu de %d bytes (%.1f%%) en %ld frames",
+            maximo, ARENA_FRAME_BYTES, maximo * 100.0 / ARENA_FRAME_BYTES, frames_arena);
+
+    if (desbordes > 0)
+    {
+        fprintf(salida, ", %ld desbordes (el peor frame pedía %zu bytes)", desbordes, mayor_desborde);
+    }
+
+    fprintf(salida, "\n");
+}
@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include "atlas.h"
+
+/**
+ * @file atlas.c
+ * @brief Este archivo contiene las funciones del atlas de sprites.
+ */
+
+
+/**
+ * @brief Crea un bitmap en la memoria de video, o en memoria común si no se puede.
+ *
+ * Los bitmaps de video se dibujan en la placa sin pasar por la CPU. Si no hay display
+ * o la placa no tiene lugar, se usa un bitmap de memoria: se ve igual pero es más lento.
+ * Las banderas de bitmap nuevo quedan como estaban.
+ *
+ * @param ancho Ancho en pixeles.
+ * @param alto Alto en pixeles.
+ * @return El bitmap, o NULL si no se pudo crear de ninguna forma.
+ */
+static ALLEGRO_BITMAP *crear_bitmap_video(int ancho, int alto)
+{
+    int banderas = al_get_new_bitmap_flags();
+    ALLEGRO_BITMAP *bitmap;
+
+    al_set_new_bitmap_flags((banderas & ~ALLEGRO_MEMORY_BITMAP) | ALLEGRO_VIDEO_BITMAP);
+    bitmap = al_create_bitmap(ancho, alto);
+
+    if (!bitmap)
+    {
+        printf("No se pudo crear un bitmap de video de %dx%d, se usa uno en memoria\n", ancho, alto);
+        al_set_new_bitmap_flags((banderas & ~ALLEGRO_VIDEO_BITMAP) | ALLEGRO_MEMORY_BITMAP);
+        bitmap = al_create_bitmap(ancho, alto);
+    }
+
+    al_set_new_bitmap_flags(banderas);
+
+    return bitmap;
+}
+
+
+
+/**
+ * @brief Crea el bitmap del atlas vacío y transparente.
+ *
+ * @param atlas Puntero al atlas.
+ * @param ancho Ancho del atlas en pixeles.
+ * @param alto Alto del atlas en pixeles.
+ * @return true si se pudo crear el bitmap.
+ */
+bool crear_atlas_sprites(AtlasSprites *atlas, int ancho, int alto)
+{
+    ALLEGRO_BITMAP *destino_anterior;
+
+    atlas->x_libre = 0;
+    atlas->y_libre = 0;
+    atlas->alto_fila = 0;
+    atlas->bitmap = crear_bitmap_video(ancho, alto);
+
+    if (!atlas->bitmap)
+    {
+        printf("No se pudo crear el atlas de sprites de %dx%d\n", ancho, alto);
+        return false;
+    }
+
+    destino_anterior = al_get_target_bitmap();
+    al_set_target_bitmap(atlas->bitmap);
+    al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+    al_set_target_bitmap(destino_anterior);
+
+    return true;
+}
+
+
+/**
+ * @brief Copia una imagen al atlas escalada al tamaño indicado.
+ *
+ * La imagen original no se modifica.
+ *
+ * @param atlas Puntero al atlas.
+ * @param imagen Imagen a copiar.
+ * @param ancho Ancho del sprite dentro del atlas.
+ * @param alto Alto del sprite dentro del atlas.
+ * @return Sub-bitmap del atlas con el sprite, o NULL si no hay espacio.
+ */
+ALLEGRO_BITMAP *agregar_sprite_atlas(AtlasSprites *atlas, ALLEGRO_BITMAP *imagen, int ancho, int alto)
+{
+    ALLEGRO_BITMAP *destino_anterior;
+    ALLEGRO_BITMAP *sprite;
+    int ancho_atlas;
+    int alto_atlas;
+
+    if (!atlas->bitmap || !imagen)
+    {
+        return NULL;
+    }
+
+    ancho_atlas = al_get_bitmap_width(atlas->bitmap);
+    alto_atlas = al_get_bitmap_height(atlas->bitmap);
+
+    // Si no cabe en la fila actual se abre una nueva
+    if (atlas->x_libre + ancho > ancho_atlas)
+    {
+        atlas->x_libre = 0;
+        atlas->y_libre += atlas->alto_fila + ATLAS_SEPARACION;
+        atlas->alto_fila = 0;
+    }
+
+    if (ancho > ancho_atlas || atlas->y_libre + alto > alto_atlas)
+    {
+        printf("El atlas de sprites está lleno, no cabe un sprite de %dx%d\n", ancho, alto);
+        return NULL;
+    }
+
+    sprite = al_create_sub_bitmap(atlas->bitmap, atlas->x_libre, atlas->y_libre, ancho, alto);
+    if (!sprite)
+    {
+        return NULL;
+    }
+
+    destino_anterior = al_get_target_bitmap();
+    al_set_target_bitmap(atlas->bitmap);
+    al_draw_scaled_bitmap(imagen, 0, 0, al_get_bitmap_width(imagen), al_get_bitmap_height(imagen), atlas->x_libre, atlas->y_libre, ancho, alto, 0);
+    al_set_target_bitmap(destino_anterior);
+
+    atlas->x_libre += ancho + ATLAS_SEPARACION;
+    if (alto > atlas->alto_fila)
+    {
+        atlas->alto_fila = alto;
+    }
+
+    return sprite;
+}
+
+
+/**
+ * @brief Crea una copia de una imagen escalada al tamaño indicado, fuera del atlas.
+ *
+ * La copia es un bitmap de video si se puede, si no uno de memoria. La imagen original
+ * no se modifica.
+ *
+ * @param imagen Imagen a copiar.
+ * @param ancho Ancho de la copia.
+ * @param alto Alto de la copia.
+ * @return La copia, o NULL si no se pudo crear.
+ */
+ALLEGRO_BITMAP *crear_imagen_escalada(ALLEGRO_BITMAP *imagen, int ancho, int alto)
+{
+    ALLEGRO_BITMAP *destino_anterior;
+    ALLEGRO_BITMAP *copia;
+
+    if (!imagen)
+    {
+        return NULL;
+    }
+
+    copia = crear_bitmap_video(ancho, alto);
+    if (!copia)
+    {
+        printf("No se pudo crear la copia escalada de %dx%d\n", ancho, alto);
+        return NULL;
+    }
+
+    destino_anterior = al_get_target_bitmap();
+    al_set_target_bitmap(copia);
+    al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+    al_draw_scaled_bitmap(imagen, 0, 0, al_get_bitmap_width(imagen), al_get_bitmap_height(imagen), 0, 0, ancho, alto, 0);
+    al_set_target_bitmap(destino_anterior);
+
+    return copia;
+}
+
+
+/**
+ * @brief Reemplaza una imagen por una copia suya escalada al tamaño en pantalla.
+ *
+ * Si la imagen ya es un bitmap de video de ese tamaño se deja como está. Si la copia no
+ * se puede crear la imagen original queda sin cambios.
+ *
+ * @param imagen Puntero a la imagen a reemplazar.
+ * @param ancho Ancho en pantalla.
+ * @param alto Alto en pantalla.
+ * @return true si la imagen quedó del tamaño indicado.
+ */
+bool escalar_imagen(ALLEGRO_BITMAP **imagen, int ancho, int alto)
+{
+    ALLEGRO_BITMAP *copia;
+
+    if (!*imagen)
+    {
+        return false;
+    }
+
+    if (al_get_bitmap_width(*imagen) == ancho && al_get_bitmap_height(*imagen) == alto && !(al_get_bitmap_flags(*imagen) & ALLEGRO_MEMORY_BITMAP))
+    {
+        return true;
+    }
+
+    copia = crear_imagen_escalada(*imagen, ancho, alto);
+    if (!copia)
+    {
+        return false;
+    }
+
+    al_destroy_bitmap(*imagen);
+    *imagen = copia;
+
+    return true;
+}
+
+
+/**
+ * @brief Reemplaza una imagen suelta por su sprite dentro del atlas.
+ *
+ * Si la copia sale bien se destruye la imagen original. Si el atlas no existe o está
+ * lleno, la imagen se reemplaza por una copia suelta ya escalada con escalar_imagen, así
+ * el juego la dibuja igual sin escalar en cada frame.
+ *
+ * @param atlas Puntero al atlas.
+ * @param imagen Puntero a la imagen a reemplazar.
+ * @param ancho Ancho del sprite en pantalla.
+ * @param alto Alto del sprite en pantalla.
+ * @return true si la imagen quedó dentro del atlas.
+ */
+bool mover_imagen_a_atlas(AtlasSprites *atlas, ALLEGRO_BITMAP **imagen, int ancho, int alto)
+{
+    ALLEGRO_BITMAP *sprite;
+
+    sprite = agregar_sprite_atlas(atlas, *imagen, ancho, alto);
+    if (!sprite)
+    {
+        escalar_imagen(imagen, ancho, alto);
+        return false;
+    }
+
+    al_destroy_bitmap(*imagen);
+    *imagen = sprite;
+
+    return true;
+}
+
+
+/**
+ * @brief Libera el bitmap del atlas.
+ *
+ * Los sub-bitmaps entregados deben destruirse antes, por quien los usa.
+ *
+ * @param atlas Puntero al atlas.
+ */
+void destruir_atlas_sprites(AtlasSprites *atlas)
+{
+    if (atlas->bitmap)
+    {
+        al_destroy_bitmap(atlas->bitmap);
+        atlas->bitmap = NULL;
+    }
+}
@@ -0,0 +1,788 @@
+#include <stdio.h>
+#include "colisiones.h"
+
+/**
+ * @file colisiones.c
+ * @brief Este archivo contiene la detección de contactos de cada paso y las reglas de daño.
+ */
+
+
+/**
+ * @brief Anota un contacto al final de la lista.
+ *
+ * @param lista Lista de contactos.
+ * @param proyectil Lo que golpea.
+ * @param indice Posición del proyectil en su arreglo.
+ * @param blanco Lo que recibe el golpe.
+ * @param objetivo Índice del blanco dentro de su tipo.
+ * @return false si la lista está llena.
+ */
+static bool agregar_contacto(ListaContactos *lista, TipoProyectil proyectil, int indice, TipoBlanco blanco, int objetivo)
+{
+    Contacto *contacto;
+
+    if (lista->num_contactos >= MAX_CONTACTOS)
+    {
+        return false;
+    }
+
+    contacto = &lista->contactos[lista->num_contactos++];
+    contacto->proyectil = proyectil;
+    contacto->blanco = blanco;
+    contacto->indice = indice;
+    contacto->objetivo = objetivo;
+
+    return true;
+}
+
+
+/**
+ * @brief Indica si el jefe del nivel puede recibir golpes.
+ *
+ * @param sim Puntero a la simulación.
+ * @return true si hay jefe y sigue activo.
+ */
+static bool jefe_golpeable(const Simulacion *sim)
+{
+    return sim->hay_jefe_en_nivel && sim->jefe_nivel.activo;
+}
+
+
+/**
+ * @brief Indica si un rectángulo toca al jefe.
+ *
+ * @param sim Puntero a la simulación.
+ * @return true si el jefe está activo y se superpone con el rectángulo.
+ */
+static bool toca_jefe(const Simulacion *sim, float x, float y, float ancho, float alto)
+{
+    const Jefe *jefe = &sim->jefe_nivel;
+
+    return jefe_golpeable(sim) && detectar_colision_generica(x, y, ancho, alto, jefe->x, jefe->y, jefe->ancho, jefe->alto);
+}
+
+
+/**
+ * @brief Busca el primer enemigo de la grilla que toca un rectángulo.
+ *
+ * @param sim Puntero a la simulación.
+ * @param candidatos Espacio para los candidatos de la grilla, de NUM_ENEMIGOS elementos.
+ * @return Índice del enemigo, o -1 si no toca ninguno.
+ */
+static int buscar_enemigo_en_rectangulo(Simulacion *sim, int candidatos[], float x, float y, float ancho, float alto)
+{
+    PoolEnemigos *enemigos = &sim->enemigos;
+    int num_candidatos;
+    int c;
+    int j;
+
+    num_candidatos = consultar_grid_objeto(&sim->grid_enemigos, x, y, ancho, alto, candidatos, NUM_ENEMIGOS);
+    for (c = 0; c < num_candidatos; c++)
+    {
+        j = candidatos[c];
+        if (j < enemigos->num_enemigos && enemigos->activo[j] && detectar_colision_generica(x, y, ancho, alto, enemigos->x[j], enemigos->y[j], enemigos->ancho[j], enemigos->alto[j]))
+        {
+            return j;
+        }
+    }
+
+    return -1;
+}
+
+
+/**
+ * @brief Anota el primer impacto de cada disparo normal.
+ *
+ * Se prueban en orden los bloques sólidos, los enemigos, los asteroides y el jefe. Los
+ * escudos no detienen el disparo, solo quedan en la traza.
+ */
+static void detectar_disparos(Simulacion *sim, ListaContactos *lista, int candidatos[])
+{
+    const Disparo *disparo;
+    int fila, col;
+    int i;
+    int j;
+    int v;
+
+    for (v = 0; v < sim->pool_disparos.num_vivos; v++)
+    {
+        i = sim->pool_disparos.vivos[v];
+        disparo = &sim->disparos[i];
+        if (!disparo->activo) continue;
+
+        // Los disparos normales NO pueden atravesar bloques sólidos (tipo 1) ni indestructibles (tipo 3)
+        if (buscar_tile_en_area(&sim->tilemap, disparo->x, disparo->y, 5, 10, MASCARA_TILE_SOLIDO, &fila, &col)) // 5x10 es el tamaño del disparo
+        {
+            agregar_contacto(lista, PROYECTIL_DISPARO, i, BLANCO_TILE, fila * MAPA_COLUMNAS + col);
+            continue;
+        }
+
+        // Los disparos pueden atravesar escudos destructibles (tipo 2)
+        if (buscar_tile_en_area(&sim->tilemap, disparo->x, disparo->y, 5, 10, MASCARA_TILE_ESCUDO, &fila, &col))
+        {
+            TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_DANO, col, fila);
+        }
+
+        j = buscar_enemigo_en_rectangulo(sim, candidatos, disparo->x, disparo->y, 5, 10);
+        if (j >= 0)
+        {
+            agregar_contacto(lista, PROYECTIL_DISPARO, i, BLANCO_ENEMIGO, j);
+            continue;
+        }
+
+        if (asteroides_activados(sim->estado_nivel.nivel_actual))
+        {
+            for (j = 0; j < NUM_ASTEROIDES; j++)
+            {
+                if (detectar_colision_disparo(sim->asteroides[j], *disparo))
+                {
+                    break;
+                }
+            }
+
+            if (j < NUM_ASTEROIDES)
+            {
+                agregar_contacto(lista, PROYECTIL_DISPARO, i, BLANCO_ASTEROIDE, j);
+                continue;
+            }
+        }
+
+        if (toca_jefe(sim, disparo->x, disparo->y, 5, 10))
+        {
+            agregar_contacto(lista, PROYECTIL_DISPARO, i, BLANCO_JEFE, 0);
+        }
+    }
+}
+
+
+/**
+ * @brief Anota el primer enemigo, o el jefe, que alcanza cada láser listo para dañar.
+ *
+ * Un láser daña como mucho una vez cada 0.1 segundos, así que los que dañaron hace menos
+ * no se prueban. El alcance es el que calculó actualizar_lasers en el mismo paso.
+ */
+static void detectar_lasers(Simulacion *sim, ListaContactos *lista, int candidatos[])
+{
+    const DisparoLaser *laser;
+    PoolEnemigos *enemigos = &sim->enemigos;
+    int num_candidatos;
+    float final_x;
+    float final_y;
+    bool golpeo;
+    int c;
+    int i;
+    int j;
+    int v;
+
+    for (v = 0; v < sim->pool_lasers.num_vivos; v++)
+    {
+        i = sim->pool_lasers.vivos[v];
+        laser = &sim->lasers[i];
+        if (!laser->activo || sim->tiempo - laser->ultimo_dano < 0.1) continue;
+
+        final_x = laser->x_nave + cos(laser->angulo) * laser->alcance_real;
+        final_y = laser->y_nave + sin(laser->angulo) * laser->alcance_real;
+        golpeo = false;
+
+        num_candidatos = consultar_grid_segmento(&sim->grid_enemigos, laser->x_nave, laser->y_nave, final_x, final_y, candidatos, NUM_ENEMIGOS);
+        for (c = 0; c < num_candidatos && !golpeo; c++)
+        {
+            j = candidatos[c];
+            if (j < enemigos->num_enemigos && enemigos->activo[j] && laser_intersecta_enemigo_limitado(*laser, enemigos->x[j], enemigos->y[j], enemigos->ancho[j], enemigos->alto[j], laser->alcance_real))
+            {
+                golpeo = agregar_contacto(lista, PROYECTIL_LASER, i, BLANCO_ENEMIGO, j);
+            }
+        }
+
+        if (!golpeo && jefe_golpeable(sim) && laser_intersecta_enemigo_limitado(*laser, sim->jefe_nivel.x, sim->jefe_nivel.y, sim->jefe_nivel.ancho, sim->jefe_nivel.alto, laser->alcance_real))
+        {
+            agregar_contacto(lista, PROYECTIL_LASER, i, BLANCO_JEFE, 0);
+        }
+    }
+}
+
+
+/**
+ * @brief Anota el primer impacto de cada explosivo que todavía no explotó.
+ *
+ * Se prueban en orden los enemigos, cualquier bloque (incluidos los escudos) y el jefe.
+ */
+static void detectar_explosivos(Simulacion *sim, ListaContactos *lista, int candidatos[])
+{
+    const DisparoExplosivo *explosivo;
+    int fila, col;
+    int i;
+    int j;
+    int v;
+
+    for (v = 0; v < sim->pool_explosivos.num_vivos; v++)
+    {
+        i = sim->pool_explosivos.vivos[v];
+        explosivo = &sim->explosivos[i];
+        if (!explosivo->activo || explosivo->exploto) continue;
+
+        j = buscar_enemigo_en_rectangulo(sim, candidatos, explosivo->x, explosivo->y, explosivo->ancho, explosivo->alto);
+        if (j >= 0)
+        {
+            agregar_contacto(lista, PROYECTIL_EXPLOSIVO, i, BLANCO_ENEMIGO, j);
+        }
+        else if (buscar_tile_en_area(&sim->tilemap, explosivo->x, explosivo->y, explosivo->ancho, explosivo->alto, MASCARA_TILE_SOLIDO | MASCARA_TILE_ESCUDO, &fila, &col))
+        {
+            agregar_contacto(lista, PROYECTIL_EXPLOSIVO, i, BLANCO_TILE, fila * MAPA_COLUMNAS + col);
+        }
+        else if (toca_jefe(sim, explosivo->x, explosivo->y, explosivo->ancho, explosivo->alto))
+        {
+            agregar_contacto(lista, PROYECTIL_EXPLOSIVO, i, BLANCO_JEFE, 0);
+        }
+    }
+}
+
+
+/**
+ * @brief Anota el primer enemigo, o el jefe, que toca cada misil.
+ */
+static void detectar_misiles(Simulacion *sim, ListaContactos *lista, int candidatos[])
+{
+    const MisilTeledirigido *misil;
+    int i;
+    int j;
+    int v;
+
+    for (v = 0; v < sim->pool_misiles.num_vivos; v++)
+    {
+        i = sim->pool_misiles.vivos[v];
+        misil = &sim->misiles[i];
+        if (!misil->activo) continue;
+
+        j = buscar_enemigo_en_rectangulo(sim, candidatos, misil->x, misil->y, misil->ancho, misil->alto);
+        if (j >= 0)
+        {
+            agregar_contacto(lista, PROYECTIL_MISIL, i, BLANCO_ENEMIGO, j);
+        }
+        else if (toca_jefe(sim, misil->x, misil->y, misil->ancho, misil->alto))
+        {
+            agregar_contacto(lista, PROYECTIL_MISIL, i, BLANCO_JEFE, 0);
+        }
+    }
+}
+
+
+/**
+ * @brief Anota lo que golpea a la nave: enemigos, disparos enemigos y ataques del jefe.
+ *
+ * Los disparos enemigos que no tocan la nave se prueban contra la celda donde están.
+ */
+static void detectar_golpes_nave(Simulacion *sim, ListaContactos *lista, int candidatos[])
+{
+    const Nave *nave = &sim->nave;
+    const Jefe *jefe = &sim->jefe_nivel;
+    int num_candidatos;
+    int choques = 0;
+    int fila, col;
+    int c;
+    int i;
+    int v;
+
+    num_candidatos = consultar_grid_objeto(&sim->grid_enemigos, nave->x, nave->y, nave->ancho, nave->largo, candidatos, NUM_ENEMIGOS);
+    for (c = 0; c < num_candidatos && choques < MAX_CONTACTOS_NAVE; c++)
+    {
+        i = candidatos[c];
+        if (i < sim->enemigos.num_enemigos && sim->enemigos.activo[i] && detectar_colision_nave_enemigo(nave, &sim->enemigos, i))
+        {
+            agregar_contacto(lista, PROYECTIL_CUERPO_ENEMIGO, i, BLANCO_NAVE, 0);
+            choques++;
+        }
+    }
+
+    for (v = 0; v < sim->pool_disparos_enemigos.num_vivos; v++)
+    {
+        i = sim->pool_disparos_enemigos.vivos[v];
+        if (!sim->disparos_enemigos[i].activo) continue;
+
+        if (detectar_colision_disparo_enemigo_nave(nave, sim->disparos_enemigos[i]))
+        {
+            agregar_contacto(lista, PROYECTIL_DISPARO_ENEMIGO, i, BLANCO_NAVE, 0);
+        }
+        else if (buscar_tile_en_area(&sim->tilemap, sim->disparos_enemigos[i].x, sim->disparos_enemigos[i].y, 1, 1, MASCARA_TILE_SOLIDO | MASCARA_TILE_ESCUDO, &fila, &col))
+        {
+            agregar_contacto(lista, PROYECTIL_DISPARO_ENEMIGO, i, BLANCO_TILE, fila * MAPA_COLUMNAS + col);
+        }
+    }
+
+    if (!jefe_golpeable(sim))
+    {
+        return;
+    }
+
+    for (v = 0; v < jefe->pool_ataques.num_vivos; v++)
+    {
+        i = jefe->pool_ataques.vivos[v];
+        if (jefe->ataques[i].activo && detectar_colision_ataque_jefe_nave(jefe->ataques[i], nave))
+        {
+            agregar_contacto(lista, PROYECTIL_ATAQUE_JEFE, i, BLANCO_NAVE, 0);
+        }
+    }
+}
+
+
+/**
+ * @brief Recorre una vez todos los proyectiles contra sus blancos y anota los impactos.
+ *
+ * No cambia el estado de la partida; las posiciones son las del final del movimiento
+ * del paso y la grilla de enemigos debe estar construida con ellas.
+ *
+ * @param sim Puntero a la simulación.
+ * @param lista Lista donde se anotan los contactos, se vacía al comenzar.
+ */
+void detectar_contactos(Simulacion *sim, ListaContactos *lista)
+{
+    int candidatos[NUM_ENEMIGOS];
+
+    lista->num_contactos = 0;
+
+    detectar_disparos(sim, lista, candidatos);
+    detectar_lasers(sim, lista, candidatos);
+    detectar_explosivos(sim, lista, candidatos);
+    detectar_misiles(sim, lista, candidatos);
+    detectar_golpes_nave(sim, lista, candidatos);
+}
+
+
+/**
+ * @brief Registra la derrota del jefe y avisa cuántos enemigos quedan.
+ *
+ * @param sim Puntero a la simulación.
+ * @param mostrar_restantes true para mostrar el mensaje de enemigos restantes.
+ */
+static void jefe_derrotado(Simulacion *sim, bool mostrar_restantes)
+{
+    int enemigos_restantes;
+
+    sim->puntaje += 2000; // Gran bonificación por derrotar al jefe
+    sim->hay_jefe_en_nivel = false;
+    sim->jefe_nivel.activo = false;
+
+    if (!mostrar_restantes)
+    {
+        agregar_mensaje_cola(&sim->cola_mensajes, "JEFE DERROTADO!", 5.0, al_map_rgb(255, 215, 0), true);
+        return;
+    }
+
+    enemigos_restantes = contar_enemigos_activos(sim);
+    agregar_mensaje_cola(&sim->cola_mensajes, "JEFE DERROTADO!", 3.0, al_map_rgb(255, 215, 0), true);
+
+    if (enemigos_restantes > 0)
+    {
+        agregar_mensaje_cola(&sim->cola_mensajes, formatear_arena_frame("Elimina los %d enemigos restantes", enemigos_restantes), 4.0, al_map_rgb(255, 255, 255), true);
+    }
+    else
+    {
+        agregar_mensaje_cola(&sim->cola_mensajes, "NIVEL COMPLETADO!", 3.0, al_map_rgb(0, 255, 0), true);
+    }
+}
+
+
+/**
+ * @brief Aplica un golpe al jefe y da los puntos, o lo da por derrotado.
+ *
+ * @param sim Puntero a la simulación.
+ * @param dano Daño del golpe.
+ * @param puntos Puntos por golpearlo sin derrotarlo.
+ * @param mostrar_restantes Se pasa a jefe_derrotado.
+ */
+static void golpear_jefe(Simulacion *sim, float dano, int puntos, bool mostrar_restantes)
+{
+    if (jefe_recibir_dano(&sim->jefe_nivel, dano, &sim->cola_mensajes))
+    {
+        sim->puntaje += puntos;
+    }
+    else
+    {
+        jefe_derrotado(sim, mostrar_restantes);
+    }
+}
+
+
+/**
+ * @brief Indica si el blanco de un contacto sigue ahí para recibir el golpe.
+ *
+ * Un contacto se anota antes de resolver los anteriores, así que su enemigo pudo morir,
+ * el jefe pudo ser derrotado, el bloque pudo romperse o el asteroide pudo reaparecer.
+ *
+ * @param sim Puntero a la simulación.
+ * @param contacto Contacto a revisar.
+ * @param asteroide_golpeado Asteroides que ya reaparecieron en este paso.
+ * @return true si se puede aplicar el contacto.
+ */
+static bool blanco_disponible(const Simulacion *sim, const Contacto *contacto, const bool asteroide_golpeado[])
+{
+    switch (contacto->blanco)
+    {
+        case BLANCO_ENEMIGO:
+            return sim->enemigos.activo[contacto->objetivo];
+
+        case BLANCO_JEFE:
+            return jefe_golpeable(sim);
+
+        case BLANCO_ASTEROIDE:
+            return !asteroide_golpeado[contacto->objetivo];
+
+        case BLANCO_TILE:
+            return tile_coincide_mascara(sim->tilemap.celdas[contacto->objetivo / MAPA_COLUMNAS][contacto->objetivo % MAPA_COLUMNAS], MASCARA_TILE_SOLIDO | MASCARA_TILE_ESCUDO);
+
+        default:
+            return true;
+    }
+}
+
+
+/**
+ * @brief Baja vida a un enemigo y avisa si murió, sin sacarlo del pool.
+ *
+ * @return true si la vida llegó a cero.
+ */
+static bool danar_enemigo(Simulacion *sim, int j, float dano)
+{
+    sim->enemigos.vida[j] -= dano;
+    return sim->enemigos.vida[j] <= 0;
+}
+
+
+/**
+ * @brief Tira el dado de powerup sobre un enemigo que murió.
+ */
+static void soltar_powerup_enemigo(Simulacion *sim, int j)
+{
+    GeneradorAleatorio *aleatorio = &sim->aleatorio[ALEATORIO_POWERUPS];
+
+    if (aleatorio_entero(aleatorio, 100) < POWERUP_PROB)
+    {
+        crear_powerup_aleatorio(sim->powerups, &sim->pool_powerups, sim->enemigos.x[j], sim->enemigos.y[j], aleatorio);
+    }
+}
+
+
+/**
+ * @brief Le resta vida a un escudo golpeado y lo rompe si llega a cero.
+ */
+static void golpear_escudo(Simulacion *sim, int fila, int col, int dano)
+{
+    danar_tile(&sim->tilemap, fila, col, dano);
+    marcar_tile_sucio(&sim->tiles_sucios, fila, col);
+    TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_DANO, col, fila);
+
+    if (sim->tilemap.celdas[fila][col].vida <= 0)
+    {
+        destruir_tile(&sim->tilemap, &sim->tiles_sucios, fila, col);
+        TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_DESTRUIDO, col, fila);
+    }
+}
+
+
+/**
+ * @brief Aplica el impacto de un disparo normal.
+ */
+static void resolver_disparo(Simulacion *sim, const Contacto *contacto, bool asteroide_golpeado[])
+{
+    Asteroide *asteroide;
+    int j = contacto->objetivo;
+
+    sim->disparos[contacto->indice].activo = false;
+
+    switch (contacto->blanco)
+    {
+        case BLANCO_ENEMIGO:
+            if (danar_enemigo(sim, j, 10))
+            {
+                eliminar_enemigo_pool(&sim->enemigos, j);
+                sim->puntaje += 10;
+
+                // AGREGAR PROGRESO DEL ARMA NORMAL
+                actualizar_progreso_arma(&sim->nave, Arma_normal);
+                verificar_mejora_arma(&sim->nave, Arma_normal, &sim->cola_mensajes);
+
+                soltar_powerup_enemigo(sim, j);
+            }
+            break;
+
+        case BLANCO_ASTEROIDE:
+            asteroide = &sim->asteroides[j];
+            asteroide->y = -asteroide->alto;
+            asteroide->x = aleatorio_entero(&sim->aleatorio[ALEATORIO_ASTEROIDES], 800 - (int)asteroide->ancho);
+            asteroide_golpeado[j] = true;
+            sim->puntaje++;
+            sim->nave.kills_para_mejora++;
+            verificar_mejora_disparo_radial(&sim->nave, &sim->cola_mensajes);
+            break;
+
+        case BLANCO_JEFE:
+            golpear_jefe(sim, 10, 50, true); // Puntos por golpear al jefe
+            break;
+
+        default: // Bloque sólido: solo detiene el disparo
+            break;
+    }
+}
+
+
+/**
+ * @brief Aplica el daño de un láser, que sigue encendido.
+ */
+static void resolver_laser(Simulacion *sim, const Contacto *contacto)
+{
+    DisparoLaser *laser = &sim->lasers[contacto->indice];
+    int j = contacto->objetivo;
+
+    laser->ultimo_dano = sim->tiempo;
+
+    if (contacto->blanco == BLANCO_JEFE)
+    {
+        golpear_jefe(sim, laser->poder * 2, 25, false);
+        return;
+    }
+
+    sim->puntaje += 5;
+    if (danar_enemigo(sim, j, laser->poder))
+    {
+        actualizar_progreso_arma(&sim->nave, Arma_laser);
+        soltar_powerup_enemigo(sim, j);
+        eliminar_enemigo_pool(&sim->enemigos, j);
+        sim->puntaje += 10;
+
+        verificar_mejora_arma(&sim->nave, Arma_laser, &sim->cola_mensajes);
+    }
+}
+
+
+/**
+ * @brief Hace explotar un explosivo que impactó; el daño de área llega en el paso siguiente.
+ */
+static void resolver_explosivo(Simulacion *sim, const Contacto *contacto)
+{
+    DisparoExplosivo *explosivo = &sim->explosivos[contacto->indice];
+    int fila = contacto->objetivo / MAPA_COLUMNAS;
+    int col = contacto->objetivo % MAPA_COLUMNAS;
+
+    explosivo->exploto = true;
+    explosivo->tiempo_vida = sim->tiempo; // Marcar tiempo de explosión
+
+    switch (contacto->blanco)
+    {
+        case BLANCO_ENEMIGO:
+            TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_EXPLOSIVO_IMPACTO_ENEMIGO, sim->enemigos.tipo[contacto->objetivo], 0);
+            explosivo->dano_aplicado = false; // Resetear para aplicar daño de área
+            break;
+
+        case BLANCO_TILE:
+            // Cualquier bloque activa la explosión
+            explosivo->dano_aplicado = false;
+
+            if (sim->tilemap.celdas[fila][col].tipo == 1) // BLOQUE SÓLIDO (NO DESTRUCTIBLE)
+            {
+                TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_IMPACTO_SOLIDO, col, fila);
+            }
+            else if (sim->tilemap.celdas[fila][col].tipo == 3) // BLOQUE INDESTRUCTIBLE
+            {
+                TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_REBOTE_MURO, col, fila);
+            }
+            else // ESCUDO DESTRUCTIBLE: dañar solo el bloque impactado directamente
+            {
+                golpear_escudo(sim, fila, col, explosivo->dano_directo);
+            }
+            break;
+
+        default:
+            golpear_jefe(sim, explosivo->dano_directo * 2, 100, false);
+            break;
+    }
+}
+
+
+/**
+ * @brief Aplica el impacto de un misil, que desaparece.
+ */
+static void resolver_misil(Simulacion *sim, const Contacto *contacto)
+{
+    MisilTeledirigido *misil = &sim->misiles[contacto->indice];
+    int j = contacto->objetivo;
+
+    misil->activo = false;
+
+    if (contacto->blanco == BLANCO_JEFE)
+    {
+        golpear_jefe(sim, misil->dano * 3, 150, false);
+        return;
+    }
+
+    TRAZA(TRAZA_ENEMIGOS, NIVEL_TRAZA_EVENTO, TRAZA_ENEMIGO_IMPACTO_MISIL, j, misil->dano);
+    if (danar_enemigo(sim, j, misil->dano))
+    {
+        eliminar_enemigo_pool(&sim->enemigos, j);
+        sim->puntaje++;
+        TRAZA(TRAZA_ENEMIGOS, NIVEL_TRAZA_EVENTO, TRAZA_ENEMIGO_ELIMINADO_MISIL, 0, 0);
+    }
+}
+
+
+/**
+ * @brief Aplica un golpe a la nave de un enemigo, un disparo enemigo o un ataque del jefe.
+ *
+ * El escudo de la nave absorbe el golpe entero si está activo.
+ */
+static void resolver_golpe_nave(Simulacion *sim, const Contacto *contacto)
+{
+    Disparo *disparo;
+    AtaqueJefe *ataque;
+    int dano;
+
+    switch (contacto->proyectil)
+    {
+        case PROYECTIL_CUERPO_ENEMIGO:
+            if (escudo_recibir_dano(&sim->nave.escudo))
+            {
+                TRAZA(TRAZA_NAVE, NIVEL_TRAZA_EVENTO, TRAZA_NAVE_ESCUDO_ABSORBE, 0, 0);
+            }
+            else
+            {
+                dano = 10;
+                sim->nave.vida -= dano;
+                TRAZA(TRAZA_NAVE, NIVEL_TRAZA_EVENTO, TRAZA_NAVE_DANO, dano, sim->nave.vida);
+            }
+            eliminar_enemigo_pool(&sim->enemigos, contacto->indice);
+            break;
+
+        case PROYECTIL_DISPARO_ENEMIGO:
+            disparo = &sim->disparos_enemigos[contacto->indice];
+            disparo->activo = false;
+
+            if (escudo_recibir_dano(&sim->nave.escudo))
+            {
+                TRAZA(TRAZA_NAVE, NIVEL_TRAZA_EVENTO, TRAZA_NAVE_ESCUDO_ABSORBE, 0, 0);
+                break;
+            }
+
+            dano = 15;
+            if (disparo->velocidad <= 2.5f)
+            {
+                dano = 25; // Tanques hacen más daño
+            }
+            else if (disparo->velocidad >= 4.0f)
+            {
+                dano = 20; // Francotiradores hacen daño medio-alto
+            }
+
+            sim->nave.vida -= dano;
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_EVENTO, TRAZA_NAVE_DANO, dano, sim->nave.vida);
+            break;
+
+        default:
+            ataque = &sim->jefe_nivel.ataques[contacto->indice];
+            if (escudo_recibir_dano(&sim->nave.escudo))
+            {
+                TRAZA(TRAZA_NAVE, NIVEL_TRAZA_EVENTO, TRAZA_NAVE_ESCUDO_ABSORBE, 0, 0);
+            }
+            else
+            {
+                sim->nave.vida -= ataque->dano;
+                TRAZA(TRAZA_JEFE, NIVEL_TRAZA_EVENTO, TRAZA_JEFE_IMPACTO_NAVE, ataque->dano, sim->nave.vida);
+                agregar_mensaje_cola(&sim->cola_mensajes, "Ataque del Jefe!", 2.0, al_map_rgb(255, 0, 0), false);
+            }
+            ataque->activo = false;
+            break;
+    }
+}
+
+
+/**
+ * @brief Aplica el impacto de un disparo enemigo contra un bloque.
+ */
+static void resolver_disparo_enemigo_tile(Simulacion *sim, const Contacto *contacto)
+{
+    int fila = contacto->objetivo / MAPA_COLUMNAS;
+    int col = contacto->objetivo % MAPA_COLUMNAS;
+
+    sim->disparos_enemigos[contacto->indice].activo = false;
+
+    if (sim->tilemap.celdas[fila][col].tipo == 2)
+    {
+        golpear_escudo(sim, fila, col, 1); // El escudo se destruye al quedarse sin vida
+    }
+    else if (sim->tilemap.celdas[fila][col].tipo == 3)
+    {
+        TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_REBOTE_MURO, col, fila);
+    }
+    else
+    {
+        TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_IMPACTO_ASTEROIDE, col, fila);
+    }
+}
+
+
+/**
+ * @brief Aplica los contactos en el orden en que se anotaron.
+ *
+ * Los contactos cuyo blanco ya no está se descartan sin consumir el proyectil.
+ *
+ * @param sim Puntero a la simulación.
+ * @param lista Contactos encontrados por detectar_contactos en el mismo paso.
+ */
+void resolver_contactos(Simulacion *sim, const ListaContactos *lista)
+{
+    bool asteroide_golpeado[NUM_ASTEROIDES] = {false};
+    const Contacto *contacto;
+    int c;
+
+    for (c = 0; c < lista->num_contactos; c++)
+    {
+        contacto = &lista->contactos[c];
+
+        if (contacto->proyectil == PROYECTIL_CUERPO_ENEMIGO ? !sim->enemigos.activo[contacto->indice] : !blanco_disponible(sim, contacto, asteroide_golpeado))
+        {
+            continue;
+        }
+
+        switch (contacto->proyectil)
+        {
+            case PROYECTIL_DISPARO:
+                resolver_disparo(sim, contacto, asteroide_golpeado);
+                break;
+
+            case PROYECTIL_LASER:
+                resolver_laser(sim, contacto);
+                break;
+
+            case PROYECTIL_EXPLOSIVO:
+                resolver_explosivo(sim, contacto);
+                break;
+
+            case PROYECTIL_MISIL:
+                resolver_misil(sim, contacto);
+                break;
+
+            default:
+                if (contacto->blanco == BLANCO_TILE)
+                {
+                    resolver_disparo_enemigo_tile(sim, contacto);
+                }
+                else
+                {
+                    resolver_golpe_nave(sim, contacto);
+                }
+                break;
+        }
+    }
+}
+
+
+/**
+ * @brief Etapa de colisiones de un paso: detecta todos los contactos y después los aplica.
+ *
+ * @param sim Puntero a la simulación.
+ */
+void procesar_colisiones(Simulacion *sim)
+{
+    ListaContactos lista;
+
+    detectar_contactos(sim, &lista);
+    resolver_contactos(sim, &lista);
+}
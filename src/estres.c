@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <string.h>
+#include "estres.h"
+
+/**
+ * @file estres.c
+ * @brief Este archivo contiene los mapas sintéticos de peor caso y el bucle que los mide.
+ */
+
+/**
+ * @brief Nombre de cada escenario, el mismo que se usa en la línea de comandos.
+ */
+static const char *nombres_escenarios[NUM_ESCENARIOS_ESTRES] =
+{
+    "enemigos", "escudos", "jefe"
+};
+
+/**
+ * @brief Letras de los enemigos normales en el archivo del nivel, una por tipo.
+ */
+static const char letras_enemigos[] = "EHSTK";
+
+
+/**
+ * @brief Devuelve el nombre de un escenario.
+ *
+ * @param escenario Escenario.
+ * @return Nombre del escenario.
+ */
+const char *nombre_escenario_estres(EscenarioEstres escenario)
+{
+    return nombres_escenarios[escenario];
+}
+
+
+/**
+ * @brief Busca un escenario por nombre.
+ *
+ * @param nombre Nombre del escenario.
+ * @return El escenario, o -1 si no existe.
+ */
+int buscar_escenario_estres(const char *nombre)
+{
+    int i;
+
+    for (i = 0; i < NUM_ESCENARIOS_ESTRES; i++)
+    {
+        if (strcmp(nombre, nombres_escenarios[i]) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+/**
+ * @brief Escribe el mapa de un escenario con el formato de los NivelN.txt.
+ *
+ * La nave siempre queda abajo en el centro con algo de lugar libre alrededor, para que
+ * no arranque dentro de un muro. El tipo de cada enemigo sale de la semilla.
+ *
+ * @param escenario Escenario a generar.
+ * @param ruta Archivo de salida.
+ * @param semilla Semilla para mezclar los tipos de enemigos.
+ * @return true si se pudo escribir el archivo.
+ */
+bool generar_nivel_estres(EscenarioEstres escenario, const char *ruta, uint64_t semilla)
+{
+    char mapa[MAPA_FILAS][MAPA_COLUMNAS + 1];
+    GeneradorAleatorio aleatorio;
+    FILE *archivo;
+    int fila;
+    int col;
+    char enemigo;
+
+    sembrar_generador(&aleatorio, semilla, NUM_FLUJOS_ALEATORIOS);
+
+    for (fila = 0; fila < MAPA_FILAS; fila++)
+    {
+        for (col = 0; col < MAPA_COLUMNAS; col++)
+        {
+            enemigo = letras_enemigos[aleatorio_entero(&aleatorio, (int)strlen(letras_enemigos))];
+
+            switch (escenario)
+            {
+                case ESTRES_ENEMIGOS:
+                    mapa[fila][col] = enemigo;
+                    break;
+
+                case ESTRES_ESCUDOS:
+                    if (fila < 8)
+                    {
+                        mapa[fila][col] = enemigo;
+                    }
+                    else
+                    {
+                        mapa[fila][col] = fila < MAPA_FILAS - 5 ? '2' : '0';
+                    }
+                    break;
+
+                default:
+                    // Celdas alternadas, así el jefe tiene lugares libres en el pool para invocar
+                    mapa[fila][col] = fila >= 6 && fila < MAPA_FILAS - 5 && (fila + col) % 2 == 0 ? enemigo : '0';
+                    break;
+            }
+        }
+        mapa[fila][MAPA_COLUMNAS] = '\0';
+    }
+
+    if (escenario == ESTRES_JEFE)
+    {
+        mapa[1][MAPA_COLUMNAS / 2 - 2] = 'C';
+    }
+
+    // En el peor caso de enemigos no queda lugar libre, la nave ocupa una de las celdas
+    mapa[MAPA_FILAS - 3][MAPA_COLUMNAS / 2] = 'P';
+
+    archivo = fopen(ruta, "w");
+    if (!archivo)
+    {
+        fprintf(stderr, "Error: No se pudo escribir el nivel de estrés %s\n", ruta);
+        return false;
+    }
+
+    for (fila = 0; fila < MAPA_FILAS; fila++)
+    {
+        fprintf(archivo, "%s\n", mapa[fila]);
+    }
+
+    fclose(archivo);
+    return true;
+}
+
+
+/**
+ * @brief Carga el mapa generado y deja todas las armas disponibles.
+ *
+ * @param sim Puntero a la simulación.
+ * @return true si se pudo cargar el mapa.
+ */
+static bool preparar_partida_estres(Simulacion *sim)
+{
+    int i;
+
+    if (!iniciar_partida_archivo(sim, NIVEL_ESTRES, ARCHIVO_NIVEL_ESTRES))
+    {
+        return false;
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        sim->nave.armas[i].desbloqueado = true;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Dispara con las cuatro armas en el mismo paso.
+ *
+ * Se cambia arma_actual directamente en vez de usar cambiar_arma para no escribir un
+ * mensaje por arma en cada paso, que se mediría junto con la simulación. El láser queda
+ * encendido porque nunca se suelta el disparo.
+ *
+ * @param sim Puntero a la simulación.
+ */
+static void disparar_todas_las_armas(Simulacion *sim)
+{
+    TipoArma arma_guardada = sim->nave.arma_actual;
+    int arma;
+
+    for (arma = 0; arma < 4; arma++)
+    {
+        sim->nave.arma_actual = (TipoArma)arma;
+        disparar_simulacion(sim);
+    }
+
+    sim->nave.arma_actual = arma_guardada;
+}
+
+
+/**
+ * @brief Corre un escenario sin ventana durante una cantidad fija de pasos.
+ *
+ * La nave dispara con todas las armas en cada paso y ni ella ni el jefe mueren. Si se
+ * eliminan todos los enemigos se vuelve a cargar el mismo mapa, para que la carga no
+ * baje durante la medición. Al final se escribe en stderr el tiempo por paso, la tabla del perfil y la
+ * máxima cantidad de entidades vivas que hubo a la vez.
+ *
+ * @param escenario Escenario a correr.
+ * @param ticks Pasos de simulación (TICKS_ESTRES_DEFECTO si es <= 0).
+ * @param semilla Semilla del mapa y de la partida.
+ * @return Pasos por segundo obtenidos, o -1 en caso de error.
+ */
+double ejecutar_estres(EscenarioEstres escenario, int ticks, uint64_t semilla)
+{
+    static Simulacion sim;
+    ConteoPerfil conteos[NUM_CONTEOS_SIMULACION];
+    int maximos[NUM_CONTEOS_SIMULACION];
+    int num_conteos;
+    int reinicios = 0;
+    int tick;
+    int i;
+    double inicio;
+    double inicio_paso;
+    double duracion;
+    double pasos_por_segundo;
+
+    if (!al_init())
+    {
+        fprintf(stderr, "Error al inicializar Allegro.\n");
+        return -1;
+    }
+
+    if (ticks <= 0)
+    {
+        ticks = TICKS_ESTRES_DEFECTO;
+    }
+
+    if (!generar_nivel_estres(escenario, ARCHIVO_NIVEL_ESTRES, semilla))
+    {
+        return -1;
+    }
+
+    init_simulacion(&sim, NULL, NULL, NULL, NULL, NULL, semilla);
+
+    if (!preparar_partida_estres(&sim))
+    {
+        fprintf(stderr, "Error: No se pudo cargar el nivel de estrés %s.\n", ARCHIVO_NIVEL_ESTRES);
+        remove(ARCHIVO_NIVEL_ESTRES);
+        return -1;
+    }
+
+    memset(maximos, 0, sizeof(maximos));
+    num_conteos = 0;
+    reiniciar_perfil();
+    inicio = al_get_time();
+
+    for (tick = 0; tick < ticks; tick++)
+    {
+        reiniciar_arena_frame();
+
+        if (!sim.estado_nivel.mostrar_transicion)
+        {
+            disparar_todas_las_armas(&sim);
+        }
+
+        inicio_paso = tiempo_telemetria();
+        actualizar_simulacion(&sim);
+        registrar_telemetria_simulacion(&sim, tick, inicio_paso, tiempo_telemetria() - inicio_paso, 0);
+        cerrar_frame_perfil();
+
+        num_conteos = contar_entidades_simulacion(&sim, conteos);
+        for (i = 0; i < num_conteos; i++)
+        {
+            if (conteos[i].cantidad > maximos[i])
+            {
+                maximos[i] = conteos[i].cantidad;
+            }
+        }
+
+        if (sim.nave.vida <= 0)
+        {
+            sim.nave.vida = 100.0f;
+        }
+
+        // Con todas las armas a la vez el jefe puede recibir más que vida_max en un paso,
+        // así que se le da vida de sobra; además queda en furia, donde invoca el doble
+        if (sim.hay_jefe_en_nivel && sim.jefe_nivel.activo)
+        {
+            sim.jefe_nivel.vida = VIDA_JEFE_ESTRES;
+            sim.jefe_nivel.en_furia = true;
+        }
+
+        if (sim.juego_terminado || sim.estado_nivel.nivel_actual != NIVEL_ESTRES)
+        {
+            reinicios++;
+            if (!preparar_partida_estres(&sim))
+            {
+                fprintf(stderr, "Error: No se pudo recargar el nivel de estrés %s.\n", ARCHIVO_NIVEL_ESTRES);
+                remove(ARCHIVO_NIVEL_ESTRES);
+                return -1;
+            }
+        }
+    }
+
+    duracion = al_get_time() - inicio;
+    pasos_por_segundo = duracion > 0 ? ticks / duracion : 0;
+    remove(ARCHIVO_NIVEL_ESTRES);
+
+    fprintf(stderr, "=== ESTRES: %s ===\n", nombre_escenario_estres(escenario));
+    fprintf(stderr, "Pasos simulados: %d (%.1f s de juego), mapa recargado %d veces\n", ticks, ticks / (double)FPS, reinicios);
+    fprintf(stderr, "Tiempo real: %.3f s (%.3f ms por paso, %.1f pasos por segundo)\n", duracion, duracion * 1000.0 / ticks, pasos_por_segundo);
+#ifndef SIN_PERFIL
+    escribir_resumen_perfil(stderr);
+    escribir_resumen_arena(stderr);
+#endif
+    fprintf(stderr, "Máximo de entidades vivas:");
+    for (i = 0; i < num_conteos; i++)
+    {
+        fprintf(stderr, " %s=%d", conteos[i].nombre, maximos[i]);
+    }
+    fprintf(stderr, "\n");
+
+    return pasos_por_segundo;
+}
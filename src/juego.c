@@ -6,6 +6,24 @@
  *
 */
 
+/**
+ * @brief Tamaño en pantalla de cada tipo de enemigo, en el orden de imagenes_enemigos.
+ */
+const TamanoSprite tamanos_enemigos[NUM_TIPOS_ENEMIGOS] = {{50, 40}, {45, 35}, {40, 30}, {70, 50}, {35, 30}};
+
+/**
+ * @brief Tamaño en pantalla de cada tipo de jefe, en el orden de imagenes_jefes.
+ */
+const TamanoSprite tamanos_jefes[NUM_TIPOS_JEFES] = {{120, 80}, {160, 100}};
+
+/**
+ * @brief Generador de los efectos visuales (chispas, partículas).
+ *
+ * Solo lo usan las funciones de dibujo, así que no forma parte del estado de la
+ * simulación ni cambia la secuencia de sus flujos. Arranca con un estado fijo.
+ */
+static GeneradorAleatorio aleatorio_dibujo = {0x853c49e6748fea9bULL, 0xda3e39cb94b95bdbULL};
+
 /**
  * @brief Inicializa la nave.
  *
@@ -58,15 +76,16 @@ Nave init_nave(float x, float y, float ancho, float largo, float vida, double ti
  * @param num_asteroides Numero de asteroides en el arreglo.
  * @param ancho_ventana Anchura de los asteroides.
  * @param imagen_asteroide Sprite de los asteroides.
+ * @param aleatorio Generador para las posiciones iniciales.
  */ 
-void init_asteroides(Asteroide asteroides[], int num_asteroides, int ancho_ventana, ALLEGRO_BITMAP* imagen_asteroide)
+void init_asteroides(Asteroide asteroides[], int num_asteroides, int ancho_ventana, ALLEGRO_BITMAP* imagen_asteroide, GeneradorAleatorio *aleatorio)
 {
     int i;
 
     for (i = 0; i < num_asteroides; i++)
     {
-        asteroides[i].x = rand() % (ancho_ventana - 50);
-        asteroides[i].y = rand() % 600 - 600;
+        asteroides[i].x = aleatorio_entero(aleatorio, ancho_ventana - 50);
+        asteroides[i].y = aleatorio_entero(aleatorio, 600) - 600;
         asteroides[i].velocidad = 1.5;
         asteroides[i].ancho = 50;
         asteroides[i].alto = 50;
@@ -82,29 +101,27 @@ void init_asteroides(Asteroide asteroides[], int num_asteroides, int ancho_venta
  *
  * @param asteroide Puntero al asteroide a actualizar.
  * @param tilemap Mapa de tiles del juego, usado para detectar colisiones.
+ * @param tiles_sucios Lista donde se marca el escudo dañado para redibujarlo.
  * @param nave Puntero a la nave, usado para detectar colisiones.
  * @param powerups Arreglo de powerups, usado para detectar colisiones.
- * @param max_powerups Tamaño del arreglo de powerups.
+ * @param pool_powerups Pool de índices de los powerups.
+ * @param aleatorio Generador para la posición de reaparición.
  */
-void actualizar_asteroide(Asteroide* asteroide, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Nave* nave, Powerup powerups[], int max_powerups)
+void actualizar_asteroide(Asteroide* asteroide, Tilemap *tilemap, TilesSucios *tiles_sucios, Nave* nave, Powerup powerups[], PoolIndices *pool_powerups, GeneradorAleatorio *aleatorio)
 {
     // Verifica colisión con la nave
     float centro_nave_x, centro_nave_y;
-    obtener_centro_nave(*nave, &centro_nave_x, &centro_nave_y);
-    float radio_nave = obtener_radio_nave(*nave);
+    obtener_centro_nave(nave, &centro_nave_x, &centro_nave_y);
+    float radio_nave = obtener_radio_nave(nave);
     float centro_asteroide_x = asteroide->x + asteroide->ancho / 2;
     float centro_asteroide_y = asteroide->y + asteroide->alto / 2;
     float radio_asteroide = asteroide->ancho / 2.0f;
 
-    // Verifica colisión con escudos del tilemap (MEJORADO)
-    int col_izquierda = (int)(asteroide->x / TILE_ANCHO);
-    int col_derecha = (int)((asteroide->x + asteroide->ancho - 1) / TILE_ANCHO);
-    int fila_superior = (int)(asteroide->y / TILE_ALTO);
-    int fila_inferior = (int)((asteroide->y + asteroide->alto - 1) / TILE_ALTO);
-
     int fila;
     int col;
     int i;
+    int k;
+    Tile *tile;
 
     asteroide->y += asteroide->velocidad;
 
@@ -112,22 +129,25 @@ void actualizar_asteroide(Asteroide* asteroide, Tile tilemap[MAPA_FILAS][MAPA_CO
     {
         if (escudo_recibir_dano(&nave->escudo))
         {
-            printf("El escudo absorbió el daño del asteroide\n");
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_EVENTO, TRAZA_NAVE_ESCUDO_ABSORBE, 0, 0);
         }
         else
         {
-            nave->vida -= 20.0f;
-            printf("La nave recibió 10 de daño, Vida restante: %.1f\n", nave->vida);
+            float dano = 20.0f;
+
+            nave->vida -= dano;
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_EVENTO, TRAZA_NAVE_DANO, dano, nave->vida);
         }
 
         // Asteroide desaparece tras impactar
         asteroide->y = -asteroide->alto;
-        asteroide->x = rand() % (800 - (int)asteroide->ancho);
+        asteroide->x = aleatorio_entero(aleatorio, 800 - (int)asteroide->ancho);
         return;
     }
 
-    for (i = 0; i < max_powerups; i++)
+    for (k = 0; k < pool_powerups->num_vivos; k++)
     {
+        i = pool_powerups->vivos[k];
         if (powerups[i].activo)
         {
             if (detectar_colision_generica(asteroide->x, asteroide->y, asteroide->ancho, asteroide->alto, powerups[i].x, powerups[i].y, 30, 30))
@@ -137,112 +157,101 @@ void actualizar_asteroide(Asteroide* asteroide, Tile tilemap[MAPA_FILAS][MAPA_CO
                 //asteroide->x = rand() % (800 - (int)asteroide->ancho);
 
                 //const char *tipo_powerup = (powerups[i].tipo == 0) ? "ESCUDO" : (powerups[i].tipo == 1) ? "VIDA" : "DESCONOCIDO";
-                printf("Asteroide destruyó powerup\n");
+                TRAZA(TRAZA_ASTEROIDES, NIVEL_TRAZA_EVENTO, TRAZA_ASTEROIDE_DESTRUYE_POWERUP, 0, 0);
             }
         }
     }
 
-    // Verifica TODAS las celdas que ocupa el asteroide
-    for (fila = fila_superior; fila <= fila_inferior; fila++)
+    // Verifica colisión con el tilemap solo en las celdas que ocupa el asteroide
+    if (buscar_tile_en_area(tilemap, asteroide->x, asteroide->y, asteroide->ancho, asteroide->alto, MASCARA_TILE_SOLIDO | MASCARA_TILE_ESCUDO, &fila, &col))
     {
-        for (col = col_izquierda; col <= col_derecha; col++)
-        {
-            if (fila >= 0 && fila < MAPA_FILAS && col >= 0 && col < MAPA_COLUMNAS)
-            {
-                Tile *tile = &tilemap[fila][col];
+        tile = &tilemap->celdas[fila][col];
 
-                if (tile->tipo == 3)
-                {
-                    asteroide->y = -asteroide->alto;
-                    asteroide->x = rand() % (800 - (int)asteroide->ancho);
-                    printf("Asteroide rebotó en bloque sólido\n");
-                    return;
-                }
-                else if (tile->tipo == 1)
-                {
-                    asteroide->y = -asteroide->alto;
-                    asteroide->x = rand() % (800 - (int)asteroide->ancho);
-                    printf("Asteroide rebotó en asteroide fijo\n");
-                    return;
-                }
-                else if (tile->tipo == 2 && tile->vida > 0)
-                {
-                    tile->vida--;
-                    printf("Asteroide dañó escudo en (%d, %d). Vida restante: %d\n", col, fila, tile->vida);
-                    
-                    if (tile->vida <= 0)
-                    {
-                        printf("Escudo del mapa destruido por asteroide en (%d, %d)\n", col, fila);
-                    }
+        if (tile->tipo == 3)
+        {
+            TRAZA(TRAZA_ASTEROIDES, NIVEL_TRAZA_EVENTO, TRAZA_ASTEROIDE_REBOTE_SOLIDO, col, fila);
+        }
+        else if (tile->tipo == 1)
+        {
+            TRAZA(TRAZA_ASTEROIDES, NIVEL_TRAZA_EVENTO, TRAZA_ASTEROIDE_REBOTE_ASTEROIDE, col, fila);
+        }
+        else
+        {
+            tile->vida--;
+            marcar_tile_sucio(tiles_sucios, fila, col);
+            TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_DANO, col, fila);
 
-                    asteroide->y = -asteroide->alto;
-                    asteroide->x = rand() % (800 - (int)asteroide->ancho);
-                    return;
-                }
+            if (tile->vida <= 0)
+            {
+                destruir_tile(tilemap, tiles_sucios, fila, col);
+                TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_DESTRUIDO, col, fila);
             }
         }
+
+        asteroide->y = -asteroide->alto;
+        asteroide->x = aleatorio_entero(aleatorio, 800 - (int)asteroide->ancho);
+        return;
     }
 
     // Si el asteroide sale de la pantalla, reaparece arriba
     if (asteroide->y > 600)
     {
         asteroide->y = -asteroide->alto;
-        asteroide->x = rand() % (800 - (int)asteroide->ancho);
+        asteroide->x = aleatorio_entero(aleatorio, 800 - (int)asteroide->ancho);
     }
 }
 
 
 /**
-   * @brief Maneja los eventos de teclado para mover la nave.
+   * @brief Maneja los eventos de teclado de la partida.
    *
-   * Esta función actualiza la posición de la nave en función de las teclas presionadas.
+   * Los eventos no modifican la nave directamente: se traducen en acciones que la
+   * simulación aplica al comienzo del próximo paso, para que una partida grabada se
+   * pueda repetir exactamente.
    *
    * @param evento El evento de teclado que se va a manejar.
-   * @param nave Puntero a la nave que se va a mover.
-   * @param teclas Arreglo de teclas presionadas.
-   * @param disparos Arreglo de disparos.
-   * @param num_disparos Número de disparos en el arreglo.
+   * @param entrada Entrada del próximo paso donde se agregan las acciones.
    */
-void manejar_eventos(ALLEGRO_EVENT evento, Nave* nave, bool teclas[])
+void manejar_eventos(ALLEGRO_EVENT evento, EntradaPaso *entrada)
 {
     if (evento.type == ALLEGRO_EVENT_KEY_DOWN)
     {
         switch (evento.keyboard.keycode)
         {
         case ALLEGRO_KEY_UP:
-            teclas[0] = true;
+            agregar_accion_entrada(entrada, ACCION_PRESIONAR_TECLA, 0);
             break;
 
         case ALLEGRO_KEY_DOWN:
-            teclas[1] = true;
+            agregar_accion_entrada(entrada, ACCION_PRESIONAR_TECLA, 1);
             break;
 
         case ALLEGRO_KEY_LEFT:
-            teclas[2] = true;
+            agregar_accion_entrada(entrada, ACCION_PRESIONAR_TECLA, 2);
             break;
 
         case ALLEGRO_KEY_RIGHT:
-            teclas[3] = true;
+            agregar_accion_entrada(entrada, ACCION_PRESIONAR_TECLA, 3);
             break;
 
         case ALLEGRO_KEY_SPACE:
-            // disparar_radial(disparos, num_disparos, *nave);
+            agregar_accion_entrada(entrada, ACCION_DISPARAR, 0);
             break;
 
         case ALLEGRO_KEY_1:
-            cambiar_arma(nave, Arma_normal);
+            agregar_accion_entrada(entrada, ACCION_CAMBIAR_ARMA, Arma_normal);
             break;
 
         case ALLEGRO_KEY_2:
-            cambiar_arma(nave, Arma_laser);
+            agregar_accion_entrada(entrada, ACCION_CAMBIAR_ARMA, Arma_laser);
             break;
 
         case ALLEGRO_KEY_3:
-            cambiar_arma(nave, Arma_explosiva);
+            agregar_accion_entrada(entrada, ACCION_CAMBIAR_ARMA, Arma_explosiva);
             break;
             
         case ALLEGRO_KEY_4:
-            cambiar_arma(nave, Arma_misil);
+            agregar_accion_entrada(entrada, ACCION_CAMBIAR_ARMA, Arma_misil);
             break;
         }
     }
@@ -251,45 +260,65 @@ void manejar_eventos(ALLEGRO_EVENT evento, Nave* nave, bool teclas[])
         switch (evento.keyboard.keycode)
         {
             case ALLEGRO_KEY_UP:
-                teclas[0] = false;
+                agregar_accion_entrada(entrada, ACCION_SOLTAR_TECLA, 0);
                 break;
             case ALLEGRO_KEY_DOWN:
-                teclas[1] = false;
+                agregar_accion_entrada(entrada, ACCION_SOLTAR_TECLA, 1);
                 break;
             case ALLEGRO_KEY_LEFT:
-                teclas[2] = false;
+                agregar_accion_entrada(entrada, ACCION_SOLTAR_TECLA, 2);
                 break;
             case ALLEGRO_KEY_RIGHT:
-                teclas[3] = false;
+                agregar_accion_entrada(entrada, ACCION_SOLTAR_TECLA, 3);
                 break;
             case ALLEGRO_KEY_SPACE:
-            break;
+                agregar_accion_entrada(entrada, ACCION_SOLTAR_DISPARO, 0);
+                break;
         }
     }
 }
 
+
+/**
+ * @brief Agrega una acción del jugador a la entrada del próximo paso.
+ *
+ * Si ya hay MAX_ACCIONES_PASO acciones esperando la acción se descarta.
+ *
+ * @param entrada Entrada del próximo paso.
+ * @param tipo Tipo de acción.
+ * @param dato Dato de la acción (arma o tecla), 0 si no usa.
+ */
+void agregar_accion_entrada(EntradaPaso *entrada, TipoAccion tipo, int dato)
+{
+    if (entrada->num_acciones >= MAX_ACCIONES_PASO)
+    {
+        return;
+    }
+
+    entrada->acciones[entrada->num_acciones].tipo = (uint8_t)tipo;
+    entrada->acciones[entrada->num_acciones].dato = (uint8_t)dato;
+    entrada->num_acciones++;
+}
+
 /**
  * @brief Dibuja la nave y los asteroides en la pantalla.
  *
  * Esta función dibuja la nave y todos los asteroides en sus posiciones actuales.
  *
- * Ahora se dibuja la imagen de la nave reescalada y rotada según su ángulo.
+ * Ahora se dibuja la imagen de la nave rotada según su ángulo. Los sprites y el fondo ya
+ * vienen escalados a su tamaño en pantalla desde la carga, así que se copian sin escalar.
  * @param nave La nave a dibujar.
  * @param asteroides Arreglo de asteroides a dibujar.
  * @param num_asteroides Número de asteroides en el arreglo.
  * @param imagen_fondo Imagen de fondo del juego.
  */
-void dibujar_juego(Nave nave, Asteroide asteroides[], int num_asteroides, int nivel_actual, ALLEGRO_BITMAP *imagen_fondo)
+void dibujar_juego(const Nave *nave, Asteroide asteroides[], int num_asteroides, int nivel_actual, ALLEGRO_BITMAP *imagen_fondo)
 {
-    float cx = al_get_bitmap_width(nave.imagen) / 2.0f;
-    float cy = al_get_bitmap_height(nave.imagen) / 2.0f;
-    float escala_x = nave.ancho / al_get_bitmap_width(nave.imagen);
-    float escala_y = nave.largo / al_get_bitmap_height(nave.imagen);
     int i;
 
     if (imagen_fondo)
     {
-        al_draw_scaled_bitmap(imagen_fondo, 0, 0, al_get_bitmap_width(imagen_fondo), al_get_bitmap_height(imagen_fondo), 0, 0, 800, 600, 0);
+        al_draw_bitmap(imagen_fondo, 0, 0, 0);
     }
     else
     {
@@ -297,16 +326,21 @@ void dibujar_juego(Nave nave, Asteroide asteroides[], int num_asteroides, int ni
         al_clear_to_color(al_map_rgb(0, 0, 0));
     }
 
+    // La nave y los asteroides salen del atlas, se envían en un solo lote
+    al_hold_bitmap_drawing(true);
+
     // Dibujar la nave
-    al_draw_scaled_rotated_bitmap(nave.imagen, cx, cy, nave.x + nave.ancho / 2, nave.y + nave.largo / 2, escala_x, escala_y, nave.angulo, 0);
+    al_draw_rotated_bitmap(nave->imagen, nave->ancho / 2, nave->largo / 2, nave->x + nave->ancho / 2, nave->y + nave->largo / 2, nave->angulo, 0);
 
     if (asteroides_activados(nivel_actual))
     {
         for (i = 0; i < num_asteroides; i++)
         {
-            al_draw_scaled_bitmap(asteroides[i].imagen, 0, 0, al_get_bitmap_width(asteroides[i].imagen), al_get_bitmap_height(asteroides[i].imagen), asteroides[i].x, asteroides[i].y, asteroides[i].ancho, asteroides[i].alto, 0);
+            al_draw_bitmap(asteroides[i].imagen, asteroides[i].x, asteroides[i].y, 0);
         }
     }
+
+    al_hold_bitmap_drawing(false);
 }
 
 /**
@@ -320,7 +354,7 @@ void dibujar_juego(Nave nave, Asteroide asteroides[], int num_asteroides, int ni
  * @param teclas Arreglo booleano que indica qué teclas están presionadas.
  * @param tilemap Mapa de tiles del juego para detección de colisiones.
  */
-void actualizar_nave(Nave* nave, bool teclas[], Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS])
+void actualizar_nave(Nave* nave, bool teclas[], Tilemap *tilemap)
 {
     float nueva_x = nave->x;
     float nueva_y = nave->y;
@@ -331,13 +365,13 @@ void actualizar_nave(Nave* nave, bool teclas[], Tile tilemap[MAPA_FILAS][MAPA_CO
         if (teclas[2])
         {
             nueva_x -= 5; // Izquierda
-            printf("Izquierda\n");
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_NAVE_IZQUIERDA, nueva_x, nave->y);
         } 
 
         if (teclas[3])
         {
             nueva_x += 5; // Derecha
-            printf("Derecha\n");
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_NAVE_DERECHA, nueva_x, nave->y);
         }
 
         // Limitar el movimiento de la nave dentro de la ventana
@@ -358,19 +392,19 @@ void actualizar_nave(Nave* nave, bool teclas[], Tile tilemap[MAPA_FILAS][MAPA_CO
         if(teclas[2]) 
         {
             nave->angulo -= 0.07f; // Izquierda
-            printf("Rotar a la izquierda\n");
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_NAVE_ROTAR_IZQUIERDA, nave->angulo, 0);
         }
         if(teclas[3]) 
         {
             nave->angulo += 0.07f; // Derecha
-            printf("Rotar a la derecha\n");
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_NAVE_ROTAR_DERECHA, nave->angulo, 0);
         }
 
         if (teclas[0]) // Arriba (avanzar)
         {
             nueva_x += cos(nave->angulo - ALLEGRO_PI/2) * 5;
             nueva_y += sin(nave->angulo - ALLEGRO_PI/2) * 5;
-            printf("Avanzando\n");
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_NAVE_AVANZAR, nueva_x, nueva_y);
         }
 
         // Limitar el movimiento de la nave dentro de la ventana
@@ -393,10 +427,10 @@ void actualizar_nave(Nave* nave, bool teclas[], Tile tilemap[MAPA_FILAS][MAPA_CO
  * 
  * @param nave Nave a la que se le va a dibujar la barra de vida.
  */
-void dibujar_barra_vida(Nave nave, ALLEGRO_FONT *fuente)
+void dibujar_barra_vida(const Nave *nave, ALLEGRO_FONT *fuente)
 {
     float vida_maxima = 100.0f; // Vida máxima de la nave
-    float porcentaje_vida = nave.vida / vida_maxima;
+    float porcentaje_vida = nave->vida / vida_maxima;
     ALLEGRO_COLOR color_vida;
     char texto_vida[50];
     
@@ -423,7 +457,7 @@ void dibujar_barra_vida(Nave nave, ALLEGRO_FONT *fuente)
     al_draw_rectangle(10, 10, 210, 30, al_map_rgb(255, 255, 255), 2);
     
     // Mostrar vida actual como texto
-    sprintf(texto_vida, "Vida: %.1f/%.1f", nave.vida, vida_maxima);
+    sprintf(texto_vida, "Vida: %.1f/%.1f", nave->vida, vida_maxima);
     
     al_draw_text(fuente, al_map_rgb(255, 255, 255), 220, 15, ALLEGRO_ALIGN_LEFT, texto_vida);
 }
@@ -436,78 +470,53 @@ void dibujar_barra_vida(Nave nave, ALLEGRO_FONT *fuente)
  * 
  * @param disparos Arreglo de disparos a inicializar.
  * @param num_disparos Cantidad total de disparos en el arreglo.
+ * @param pool_disparos Pool de índices de los disparos, queda con todas las posiciones libres.
  */
-void init_disparos(Disparo disparos[], int num_disparos)
+void init_disparos(Disparo disparos[], int num_disparos, PoolIndices *pool_disparos)
 {
     int i;
     for (i = 0; i < num_disparos; i++)
     {
         disparos[i].activo = false;
     }
+    init_pool_indices(pool_disparos, num_disparos);
 }
 
 /**
  * @brief Actualiza la posición de todos los disparos activos.
  * 
- * Mueve cada disparo activo en la dirección de su ángulo, verifica colisiones con bloques sólidos
- * y desactiva los disparos que salen de la pantalla o impactan bloques sólidos.
+ * Mueve cada disparo activo en la dirección de su ángulo y desactiva los que salen de la
+ * pantalla. Los impactos con bloques, enemigos, asteroides y el jefe se buscan después,
+ * en detectar_contactos.
  * 
  * @param disparos Arreglo de disparos.
- * @param num_disparos Número total de disparos.
- * @param tilemap Mapa de tiles para verificar colisiones con bloques sólidos.
+ * @param pool_disparos Pool de índices de los disparos.
  */
-void actualizar_disparos(Disparo disparos[], int num_disparos, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS])
+void actualizar_disparos(Disparo disparos[], PoolIndices *pool_disparos)
 {
     int i;
-    int col_izq, col_der, fila_sup, fila_inf;
-    int fila, col;
+    int k;
 
-    for (i = 0; i < num_disparos; i++)
+    // Se recorre al revés para poder liberar el disparo actual sin saltar ninguno
+    for (k = pool_disparos->num_vivos - 1; k >= 0; k--)
     {
-        if (disparos[i].activo)
-        {
-            disparos[i].x += cos(disparos[i].angulo) * disparos[i].velocidad;
-            disparos[i].y += sin(disparos[i].angulo) * disparos[i].velocidad;
-            
-            // Verificar si sale de la pantalla
-            if (disparos[i].x < 0 || disparos[i].x > 800 || disparos[i].y < 0 || disparos[i].y > 600)
-            {
-                disparos[i].activo = false;
-                continue;
-            }
+        i = pool_disparos->vivos[k];
 
-            // Verificar colisión con bloques sólidos del tilemap
-            col_izq = (int)(disparos[i].x / TILE_ANCHO);
-            col_der = (int)((disparos[i].x + 5 - 1) / TILE_ANCHO); // 5 es el ancho del disparo
-            fila_sup = (int)(disparos[i].y / TILE_ALTO);
-            fila_inf = (int)((disparos[i].y + 10 - 1) / TILE_ALTO); // 10 es el alto del disparo
-
-            // Asegurar que estamos dentro de los límites
-            if (col_izq < 0) col_izq = 0;
-            if (col_der >= MAPA_COLUMNAS) col_der = MAPA_COLUMNAS - 1;
-            if (fila_sup < 0) fila_sup = 0;
-            if (fila_inf >= MAPA_FILAS) fila_inf = MAPA_FILAS - 1;
-            
-            for (fila = fila_sup; fila <= fila_inf; fila++)
-            {
-                for (col = col_izq; col <= col_der; col++)
-                {
-                    // Los disparos normales NO pueden atravesar bloques sólidos (tipo 1) ni indestructibles (tipo 3)
-                    if (tilemap[fila][col].tipo == 1 || tilemap[fila][col].tipo == 3)
-                    {
-                        disparos[i].activo = false;
-                        goto siguiente_disparo; // Salir de ambos bucles for
-                    }
+        // Disparos que se desactivaron en una colisión desde el frame anterior
+        if (!disparos[i].activo)
+        {
+            liberar_indice_pool(pool_disparos, i);
+            continue;
+        }
 
-                    // Los disparos pueden atravesar escudos destructibles (tipo 2) pero los dañan
-                    if (tilemap[fila][col].tipo == 2 && tilemap[fila][col].vida > 0)
-                    {    
-                        printf("Disparo impactó escudo en (%d, %d). Vida restante: %d\n", col, fila, tilemap[fila][col].vida);
-                    }
-                }
-            }
-            
-            siguiente_disparo:;
+        disparos[i].x += cos(disparos[i].angulo) * disparos[i].velocidad;
+        disparos[i].y += sin(disparos[i].angulo) * disparos[i].velocidad;
+        
+        // Verificar si sale de la pantalla
+        if (disparos[i].x < 0 || disparos[i].x > 800 || disparos[i].y < 0 || disparos[i].y > 600)
+        {
+            disparos[i].activo = false;
+            liberar_indice_pool(pool_disparos, i);
         }
     }
 }
@@ -516,14 +525,16 @@ void actualizar_disparos(Disparo disparos[], int num_disparos, Tile tilemap[MAPA
  * @brief Dibuja todos los disparos activos en pantalla.
  * 
  * @param disparos Arreglo de disparos.
- * @param num_disparos Número total de disparos.
+ * @param pool_disparos Pool de índices de los disparos.
  */
-void dibujar_disparos(Disparo disparos[], int num_disparos)
+void dibujar_disparos(Disparo disparos[], PoolIndices *pool_disparos)
 {
     int i;
+    int k;
 
-    for (i = 0; i < num_disparos; i++)
+    for (k = 0; k < pool_disparos->num_vivos; k++)
     {
+        i = pool_disparos->vivos[k];
         if (disparos[i].activo)
         {
             al_draw_filled_rectangle(disparos[i].x, disparos[i].y, disparos[i].x + 5, disparos[i].y + 10, al_map_rgb(255, 0, 0));
@@ -534,14 +545,14 @@ void dibujar_disparos(Disparo disparos[], int num_disparos)
 /**
  * @brief Permite que la nave dispare proyectiles desde su punta en la dirección actual.
  *
- * Busca un disparo inactivo en el arreglo y lo activa, posicionándolo en la punta de la nave
+ * Toma un disparo libre del pool y lo activa, posicionándolo en la punta de la nave
  * y asignándole el ángulo actual de la nave. El disparo se moverá en la dirección en la que apunta la nave.
  *
  * @param disparos Arreglo de disparos
- * @param num_disparos Cantidad de disparos definida
+ * @param pool_disparos Pool de índices de los disparos.
  * @param nave Nave que ejecuta los disparos
  */
-void disparar(Disparo disparos[], int num_disparos, Nave nave)
+void disparar(Disparo disparos[], PoolIndices *pool_disparos, const Nave *nave)
 {
     int i;
     float centro_x;
@@ -549,25 +560,24 @@ void disparar(Disparo disparos[], int num_disparos, Nave nave)
     float punta_x;
     float punta_y;
 
-    for (i = 0; i < num_disparos; i++)
+    i = obtener_indice_pool(pool_disparos);
+    if (i < 0)
     {
-        if (!disparos[i].activo)
-        {
-            // Calcula el centro de la nave
-            centro_x = nave.x + nave.ancho / 2.0f;
-            centro_y = nave.y + nave.largo / 2.0f;
-            // Calcula la punta de la nave desde el centro, usando el ángulo y la mitad del largo
-            punta_x = centro_x + cos(nave.angulo - ALLEGRO_PI/2) * (nave.largo / 2.0f);
-            punta_y = centro_y + sin(nave.angulo - ALLEGRO_PI/2) * (nave.largo / 2.0f);
-
-            disparos[i].x = punta_x;
-            disparos[i].y = punta_y;
-            disparos[i].velocidad = 10;
-            disparos[i].angulo = nave.angulo - ALLEGRO_PI/2; // Asignar el ángulo de la nave al disparo
-            disparos[i].activo = true;
-            break;
-        }
+        return;
     }
+
+    // Calcula el centro de la nave
+    centro_x = nave->x + nave->ancho / 2.0f;
+    centro_y = nave->y + nave->largo / 2.0f;
+    // Calcula la punta de la nave desde el centro, usando el ángulo y la mitad del largo
+    punta_x = centro_x + cos(nave->angulo - ALLEGRO_PI/2) * (nave->largo / 2.0f);
+    punta_y = centro_y + sin(nave->angulo - ALLEGRO_PI/2) * (nave->largo / 2.0f);
+
+    disparos[i].x = punta_x;
+    disparos[i].y = punta_y;
+    disparos[i].velocidad = 10;
+    disparos[i].angulo = nave->angulo - ALLEGRO_PI/2; // Asignar el ángulo de la nave al disparo
+    disparos[i].activo = true;
 }
 
 /**
@@ -591,271 +601,82 @@ bool detectar_colision_disparo(Asteroide asteroide, Disparo disparo)
  * Esta función es el motor principal del juego que coordina la actualización de:
  * - Movimiento de la nave y validación de colisiones
  * - Actualización de asteroides y powerups
- * - Procesamiento de disparos de jugador y enemigos
- * - Detección de colisiones entre todos los elementos
+ * - Movimiento de los disparos de jugador y enemigos
  * - Manejo del escudo de la nave y sistema de mensajes
  * 
+ * Los impactos de los proyectiles y los choques con la nave no se resuelven acá: después
+ * de mover todo, la simulación los busca con detectar_contactos y los aplica con
+ * resolver_contactos.
+ * 
  * @param nave Puntero a la nave del jugador.
  * @param teclas Arreglo de teclas presionadas.
  * @param asteroides Arreglo de asteroides del juego.
  * @param num_asteroides Número total de asteroides.
  * @param disparos Arreglo de disparos del jugador.
- * @param num_disparos Número total de disparos del jugador.
- * @param puntaje Puntero al puntaje actual del jugador.
+ * @param pool_disparos Pool de índices de los disparos.
  * @param tilemap Mapa de tiles del nivel actual.
- * @param enemigos Arreglo de enemigos del juego.
- * @param num_enemigos Número total de enemigos.
+ * @param tiles_sucios Lista donde se marcan los escudos dañados para redibujarlos.
+ * @param enemigos Pool de enemigos del juego.
+ * @param grid Grilla espacial de enemigos, se reconstruye despues de moverlos.
  * @param disparos_enemigos Arreglo de disparos de los enemigos.
- * @param num_disparos_enemigos Número total de disparos enemigos.
+ * @param pool_disparos_enemigos Pool de índices de los disparos enemigos.
  * @param cola_mensajes Cola de mensajes para mostrar al jugador.
  * @param estado_nivel Estado actual del nivel.
  * @param tiempo_actual Tiempo actual del juego en segundos.
  * @param powerups Arreglo de powerups disponibles.
- * @param max_powerups Número máximo de powerups simultáneos.
+ * @param pool_powerups Pool de índices de los powerups.
+ * @param aleatorio Flujos aleatorios de la partida.
+ * @param agenda Agenda donde los perseguidores vuelven a programar su disparo.
+ * @param campo Campo de flujo hacia la nave, se recalcula si la nave cambió de celda.
  */
-void actualizar_juego(Nave *nave, bool teclas[], Asteroide asteroides[], int num_asteroides, Disparo disparos[], int num_disparos, int* puntaje, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Enemigo enemigos[], int num_enemigos, Disparo disparos_enemigos[], int num_disparos_enemigos, ColaMensajes *cola_mensajes, EstadoJuego *estado_nivel, double tiempo_actual, Powerup powerups[], int max_powerups)
+void actualizar_juego(Nave *nave, bool teclas[], Asteroide asteroides[], int num_asteroides, Disparo disparos[], PoolIndices *pool_disparos, Tilemap *tilemap, TilesSucios *tiles_sucios, PoolEnemigos *enemigos, GridEspacial *grid, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, ColaMensajes *cola_mensajes, EstadoJuego *estado_nivel, double tiempo_actual, Powerup powerups[], PoolIndices *pool_powerups, GeneradorAleatorio aleatorio[NUM_FLUJOS_ALEATORIOS], AgendaEventos *agenda, CampoFlujo *campo)
 {
     int i;
-    int j;
-    int fila;
-    int col;
-
-    float pos_enemigo_x;
-    float pos_enemigo_y;
-    int tipo_enemigo;
-    int dano;
-    bool disparo_procesado;
-    float tile_x;
-    float tile_y;
-
-
-    int probabilidad_powerup;
+    int v;
 
     if (estado_nivel->mostrar_transicion)
     {
-        actualizar_estado_nivel_sin_jefe(estado_nivel, enemigos, num_enemigos, tiempo_actual);
+        actualizar_estado_nivel_sin_jefe(estado_nivel, enemigos, tiempo_actual);
         return;
     }
 
+    PERFIL_INICIO(PERFIL_NAVE);
     actualizar_nave(nave, teclas, tilemap);
-    actualizar_disparos(disparos, num_disparos, tilemap);
-    actualizar_enemigos(enemigos, num_enemigos, disparos_enemigos, num_disparos_enemigos, tiempo_actual, *nave);
-    actualizar_disparos_enemigos(disparos_enemigos, num_disparos_enemigos);
-
+    actualizar_disparos(disparos, pool_disparos);
+    PERFIL_FIN(PERFIL_NAVE);
+
+    PERFIL_INICIO(PERFIL_ENEMIGOS);
+    actualizar_campo_flujo(campo, tilemap, tiles_sucios, nave);
+    actualizar_enemigos(enemigos, disparos_enemigos, pool_disparos_enemigos, tiempo_actual, nave, agenda, campo);
+    actualizar_disparos_enemigos(disparos_enemigos, pool_disparos_enemigos);
+    construir_grid_enemigos(grid, enemigos);
+    PERFIL_FIN(PERFIL_ENEMIGOS);
+
+    // Powerups y asteroides; los impactos de proyectiles se resuelven después en resolver_contactos
+    PERFIL_INICIO(PERFIL_COLISIONES);
     actualizar_escudo(&nave->escudo, tiempo_actual);
-    actualizar_powerups(powerups, max_powerups, tiempo_actual);
+    actualizar_powerups(powerups, pool_powerups, tiempo_actual);
 
-    for (i = 0; i < max_powerups; i++)
+    for (v = 0; v < pool_powerups->num_vivos; v++)
     {
-        if (powerups[i].activo && detectar_colision_powerup(*nave, powerups[i]))
+        i = pool_powerups->vivos[v];
+        if (powerups[i].activo && detectar_colision_powerup(nave, powerups[i]))
         {
             recoger_powerup(nave, &powerups[i], cola_mensajes);
         }
     }
 
-    for (i = 0; i < num_disparos; i++)
-    {
-        if (!disparos[i].activo) continue;
-    
-        for (j = 0; j < num_enemigos; j++)
-        {
-            if (!enemigos[j].activo) continue;
-        
-            if (detectar_colision_disparo_enemigo(disparos[i], enemigos[j]))
-            {
-                enemigos[j].vida -= 10;
-                disparos[i].activo = false;
-            
-                if (enemigos[j].vida <= 0)
-                {
-                    enemigos[j].activo = false;
-                    (*puntaje) += 10;
-                
-                    // AGREGAR PROGRESO DEL ARMA NORMAL
-                    actualizar_progreso_arma(nave, Arma_normal);
-                    verificar_mejora_arma(nave, Arma_normal, cola_mensajes);
-                
-                    // Crear powerup aleatorio
-                    probabilidad_powerup = rand() % 100;
-                    if (probabilidad_powerup < POWERUP_PROB)
-                    {
-                        crear_powerup_aleatorio(powerups, max_powerups, enemigos[j].x, enemigos[j].y);
-                    }
-                }
-                break;
-            }
-        }
-    }
-
     if (asteroides_activados(estado_nivel->nivel_actual))
     {
         for (i = 0; i < num_asteroides; i++)
         {
-            actualizar_asteroide(&asteroides[i], tilemap, nave, powerups, max_powerups);
-            
-            for (j = 0; j < num_disparos; j++)
-            {
-                if (disparos[j].activo && detectar_colision_disparo(asteroides[i], disparos[j]))
-                {
-                    disparos[j].activo = false;
-                    asteroides[i].y = -asteroides[i].alto;
-                    asteroides[i].x = rand() % (800 - (int)asteroides[i].ancho);
-                    (*puntaje)++;
-                    nave->kills_para_mejora++;
-                    verificar_mejora_disparo_radial(nave, cola_mensajes);
-                }
-            }
-        }
-    }
-    
-
-    // Colisiones con enemigos
-    for (i = 0; i < num_enemigos; i++)
-    {
-        if (!enemigos[i].activo) continue;
-        
-        // Disparos del jugador vs enemigos (USA LA NUEVA FUNCIÓN)
-        for (j = 0; j < num_disparos; j++)
-        {
-            if (disparos[j].activo && detectar_colision_disparo_enemigo(disparos[j], enemigos[i]))
-            {
-                disparos[j].activo = false;
-                enemigos[i].vida--;
-
-                if (enemigos[i].vida <= 0)
-                {
-                    pos_enemigo_x = enemigos[i].x;
-                    pos_enemigo_y = enemigos[i].y;
-                    tipo_enemigo = enemigos[i].tipo;
-
-                    enemigos[i].activo = false;
-                    (*puntaje) += 10; // Incrementa el puntaje por destruir un enemigo
-                    nave->kills_para_mejora++;
-                    verificar_mejora_disparo_radial(nave, cola_mensajes);
-
-                    if (rand() % 100 < POWERUP_PROB)
-                    {
-                        crear_powerup_aleatorio(powerups, max_powerups, pos_enemigo_x, pos_enemigo_y);
-                        printf("Powerup aleatorio generado tras eliminar enemigo tipo %d en (%.0f, %.0f)\n", tipo_enemigo, pos_enemigo_x, pos_enemigo_y);
-                    }
-                    else
-                    {
-                        printf("No se generó powerup (probabilidad %d%%)\n", POWERUP_PROB);
-                    }
-                }
-                else
-                {
-                    (*puntaje) += 2;
-                }
-                break;
-            }
-        }
-
-        // Nave vs enemigos (USA LA NUEVA FUNCIÓN)
-        if (detectar_colision_nave_enemigo(*nave, enemigos[i]))
-        {
-            if (escudo_recibir_dano(&nave->escudo))
-            {
-                printf("El escudo absorbió el daño del enemigo\n");
-            }
-            else
-            {
-                nave->vida -= 10.0f;
-                printf("La nave recibió 20 de daño directo, Vida restante: %.1f\n", nave->vida);
-            }
-            enemigos[i].activo = false;
-        }
-    }
-
-    actualizar_estado_nivel_sin_jefe(estado_nivel, enemigos, num_enemigos, tiempo_actual);
-
-    // Disparos de enemigos vs nave (USA LA NUEVA FUNCIÓN)
-    for (i = 0; i < num_disparos_enemigos; i++)
-    {
-        if (disparos_enemigos[i].activo && detectar_colision_disparo_enemigo_nave(*nave, disparos_enemigos[i]))
-        {
-            disparos_enemigos[i].activo = false;
-            
-           if (!escudo_recibir_dano(&nave->escudo))
-           {
-                dano = 15;
-                if (disparos_enemigos[i].velocidad <= 2.5f)
-                {
-                    dano = 25; // Tanques hacen más daño
-                }
-                else if (disparos_enemigos[i].velocidad >= 4.0f)
-                {
-                    dano = 20; // Francotiradores hacen daño medio-alto
-                }
-                
-                nave->vida -= dano;
-                printf("Nave recibio %d de daño por disparo enemigo. vida restante: %.1f\n", dano, nave->vida);
-           }
-           else
-           {
-                printf("El escudo absorbio el dano del disparo enemigo\n");
-           }
+            actualizar_asteroide(&asteroides[i], tilemap, tiles_sucios, nave, powerups, pool_powerups, &aleatorio[ALEATORIO_ASTEROIDES]);
         }
     }
 
-    for (i = 0; i < num_disparos_enemigos; i++)
-    {
-        if (disparos_enemigos[i].activo)
-        {
-            disparo_procesado = false;
-            for (fila = 0; fila < MAPA_FILAS && !disparo_procesado; fila++)
-            {
-                for (col = 0; col < MAPA_COLUMNAS && !disparo_procesado; col++)
-                {
-                    if (tilemap[fila][col].tipo == 2 && tilemap[fila][col].vida > 0)
-                    {
-                        tile_x = col * TILE_ANCHO;
-                        tile_y = fila * TILE_ALTO;
-
-                        if (detectar_colision_disparo_enemigo_escudo(disparos_enemigos[i], tile_x, tile_y))
-                        {
-                            disparos_enemigos[i].activo = false;
-                            tilemap[fila][col].vida--;
-
-                            printf("Disparo enemigo impactó escudo en (%d, %d)! Vida restante: %d\n", col, fila, tilemap[fila][col].vida);
-
-                            if (tilemap[fila][col].vida <= 0)
-                            {
-                                tilemap[fila][col].tipo = 0; // El escudo se destruye
-                                printf("Escudo en (%d, %d) destruido completamente!\n", col, fila);
-                            }
-
-                            disparo_procesado = true;
-                        }
-                    }
-                    else if (tilemap[fila][col].tipo == 3)
-                    {
-                        tile_x = col * TILE_ANCHO;
-                        tile_y = fila * TILE_ALTO;
-
-                        if (detectar_colision_disparo_enemigo_escudo(disparos_enemigos[i], tile_x, tile_y))
-                        {
-                            disparos_enemigos[i].activo = false;
-                            printf("Disparo enemigo rebotó en muro indestructible en (%d, %d)!\n", col, fila);
-                            disparo_procesado = true;
-                        }
-                    }
-                    else if (tilemap[fila][col].tipo == 1)
-                    {
-                        tile_x = col * TILE_ANCHO;
-                        tile_y = fila * TILE_ALTO;
+    actualizar_estado_nivel_sin_jefe(estado_nivel, enemigos, tiempo_actual);
 
-                        if (detectar_colision_disparo_enemigo_escudo(disparos_enemigos[i], tile_x, tile_y))
-                        {
-                            disparos_enemigos[i].activo = false;
-                            printf("Disparo enemigo impactó asteroide fijo en (%d, %d)!\n", col, fila);
-                            disparo_procesado = true;
-                        }
-                    }
-                }
-            }
-        }
-    }
+    PERFIL_FIN(PERFIL_COLISIONES);
 }
 
 
@@ -1288,84 +1109,947 @@ bool detectar_colision_generica(float x1, float y1, float ancho1, float alto1, f
 
 
 /**
- * @brief Carga un tilemap desde un archivo de texto y extrae enemigos.
+ * @brief Compara dos indices enteros, se usa con qsort para ordenar los resultados de la grilla.
  * 
- * Lee un archivo que contiene números que representan diferentes tipos de tiles:
- * - 0: vacío
- * - 1: asteroide fijo
- * - 2: escudo destructible
- * - 3: enemigo normal
- * - 4: enemigo perseguidor
- * 
- * Los enemigos (3 y 4) se extraen del tilemap y se almacenan en el arreglo de enemigos.
- * 
- * @param filename Nombre del archivo del tilemap.
- * @param tilemap Matriz de tiles a llenar.
- * @param enemigos Arreglo donde se almacenarán los enemigos extraídos.
- * @param num_enemigos Puntero al contador de enemigos cargados.
- * @param imagen_enemigo Imagen que se asignará a todos los enemigos.
+ * @param a Puntero al primer indice.
+ * @param b Puntero al segundo indice.
+ * @return Negativo, cero o positivo segun el orden de los indices.
  */
-void cargar_tilemap(const char* filename, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Enemigo enemigos[], int* num_enemigos, ALLEGRO_BITMAP* imagen_enemigo, float *nave_x, float *nave_y) 
+static int comparar_indices_grid(const void* a, const void* b)
 {
-    bool nave_encontrada;
-    char linea[50];
-    int longitud_linea;
-    char c;
+    return *(const int*)a - *(const int*)b;
+}
 
-    int fila;
-    int col;
 
+/**
+ * @brief Calcula el rectangulo que cubre la colision circular de un objeto.
+ * 
+ * detectar_colision_generica usa un circulo de radio ancho/2 centrado en el objeto,
+ * que puede salir del rectangulo cuando el objeto es mas ancho que alto.
+ * 
+ * @param x Posición x del objeto.
+ * @param y Posición y del objeto.
+ * @param ancho Ancho del objeto.
+ * @param alto Alto del objeto.
+ * @param margen Margen extra en pixeles por cada lado.
+ * @param x1 Borde izquierdo resultante.
+ * @param y1 Borde superior resultante.
+ * @param x2 Borde derecho resultante.
+ * @param y2 Borde inferior resultante.
+ */
+static void limites_colision_grid(float x, float y, float ancho, float alto, float margen, float *x1, float *y1, float *x2, float *y2)
+{
+    float mitad = (ancho > alto ? ancho : alto) / 2.0f;
+    float centro_y = y + alto / 2.0f;
 
-    FILE* archivo = fopen(filename, "r");
-    if (!archivo) 
-    {
-        fprintf(stderr, "ERROR: No se pudo abrir %s\n", filename);
-        *num_enemigos = 0;
-        *nave_x = 400;
-        *nave_y = 500;
-        return;
-    }
+    *x1 = x - margen;
+    *x2 = x + ancho + margen;
+    *y1 = centro_y - mitad - margen;
+    *y2 = centro_y + mitad + margen;
+}
 
-    *num_enemigos = 0;
-    nave_encontrada = false;
 
-    printf("=== CARGANDO: %s ===\n", filename);
+/**
+ * @brief Calcula el rango de celdas de la grilla que cubre un rectangulo, recortado a la grilla.
+ * 
+ * @param x1 Borde izquierdo del rectangulo.
+ * @param y1 Borde superior del rectangulo.
+ * @param x2 Borde derecho del rectangulo.
+ * @param y2 Borde inferior del rectangulo.
+ * @param col_ini Primera columna cubierta.
+ * @param fila_ini Primera fila cubierta.
+ * @param col_fin Ultima columna cubierta.
+ * @param fila_fin Ultima fila cubierta.
+ * @return true si el rectangulo sale de la grilla.
+ */
+static bool rango_celdas_grid(float x1, float y1, float x2, float y2, int *col_ini, int *fila_ini, int *col_fin, int *fila_fin)
+{
+    bool sale = false;
 
-    for (fila = 0; fila < MAPA_FILAS; fila++)
-    {
-        // Leer línea completa
-        if (fgets(linea, sizeof(linea), archivo) == NULL)
-        {
-            printf("ERROR: No se pudo leer la fila %d\n", fila);
-            break;
-        }
+    *col_ini = (int)floorf(x1 / TILE_ANCHO);
+    *fila_ini = (int)floorf(y1 / TILE_ALTO);
+    *col_fin = (int)floorf(x2 / TILE_ANCHO);
+    *fila_fin = (int)floorf(y2 / TILE_ALTO);
 
-        printf("Fila %d: %.10s... (primeros 10 chars)\n", fila, linea);
+    if (*col_ini < 0)
+    {
+        *col_ini = 0;
+        sale = true;
+    }
+    if (*fila_ini < 0)
+    {
+        *fila_ini = 0;
+        sale = true;
+    }
+    if (*col_fin >= GRID_COLUMNAS)
+    {
+        *col_fin = GRID_COLUMNAS - 1;
+        sale = true;
+    }
+    if (*fila_fin >= GRID_FILAS)
+    {
+        *fila_fin = GRID_FILAS - 1;
+        sale = true;
+    }
 
-        // Procesar cada columna de la línea
-        longitud_linea = (int)strlen(linea);
-        for (col = 0; col < MAPA_COLUMNAS && col < longitud_linea; col++)
-        {
-            c = linea[col];
+    return sale;
+}
 
-            // Inicializar tile por defecto
-            tilemap[fila][col].tipo = 0;
-            tilemap[fila][col].vida = 0;
+
+/**
+ * @brief Calcula las celdas que ocupa un enemigo e indica si cabe en la grilla.
+ * 
+ * @param enemigos Pool de enemigos.
+ * @param i Indice del enemigo a ubicar.
+ * @param col_ini Primera columna ocupada.
+ * @param fila_ini Primera fila ocupada.
+ * @param col_fin Ultima columna ocupada.
+ * @param fila_fin Ultima fila ocupada.
+ * @return true si el enemigo se guarda en las celdas, false si va a la lista de fuera.
+ */
+static bool celdas_enemigo_grid(PoolEnemigos *enemigos, int i, int *col_ini, int *fila_ini, int *col_fin, int *fila_fin)
+{
+    float x1, y1, x2, y2;
+    int num_celdas;
+
+    limites_colision_grid(enemigos->x[i], enemigos->y[i], enemigos->ancho[i], enemigos->alto[i], GRID_MARGEN, &x1, &y1, &x2, &y2);
+
+    if (rango_celdas_grid(x1, y1, x2, y2, col_ini, fila_ini, col_fin, fila_fin))
+    {
+        return false;
+    }
+
+    num_celdas = (*col_fin - *col_ini + 1) * (*fila_fin - *fila_ini + 1);
+    return num_celdas <= GRID_MAX_CELDAS_ENEMIGO;
+}
+
+
+/**
+ * @brief Agrega a los resultados los enemigos de una celda que no se hayan devuelto ya.
+ * 
+ * @param grid Grilla consultada.
+ * @param celda Indice de la celda.
+ * @param resultados Arreglo de resultados.
+ * @param num_resultados Cantidad de resultados ya guardados.
+ * @param max_resultados Capacidad del arreglo de resultados.
+ * @return Nueva cantidad de resultados.
+ */
+static int agregar_celda_grid(GridEspacial *grid, int celda, int resultados[], int num_resultados, int max_resultados)
+{
+    int k;
+    int indice;
+
+    for (k = grid->inicio_celda[celda]; k < grid->inicio_celda[celda + 1] && num_resultados < max_resultados; k++)
+    {
+        indice = grid->indices[k];
+        if (grid->marca[indice] != grid->marca_actual)
+        {
+            grid->marca[indice] = grid->marca_actual;
+            resultados[num_resultados++] = indice;
+        }
+    }
+
+    return num_resultados;
+}
+
+
+/**
+ * @brief Comienza una consulta: renueva la marca y agrega los enemigos que estan fuera de la grilla.
+ * 
+ * @param grid Grilla consultada.
+ * @param resultados Arreglo de resultados.
+ * @param max_resultados Capacidad del arreglo de resultados.
+ * @return Cantidad de resultados guardados.
+ */
+static int iniciar_consulta_grid(GridEspacial *grid, int resultados[], int max_resultados)
+{
+    int k;
+    int num_resultados = 0;
+
+    grid->marca_actual++;
+
+    for (k = 0; k < grid->num_fuera && num_resultados < max_resultados; k++)
+    {
+        grid->marca[grid->fuera[k]] = grid->marca_actual;
+        resultados[num_resultados++] = grid->fuera[k];
+    }
+
+    return num_resultados;
+}
+
+
+/**
+ * @brief Reparte los enemigos activos en la grilla espacial.
+ * 
+ * Se construye con un conteo por celda y una suma de prefijos, de modo que los indices
+ * de cada celda quedan contiguos. Debe llamarse cada vez que los enemigos se mueven.
+ * 
+ * @param grid Grilla a construir.
+ * @param enemigos Pool de enemigos.
+ */
+void construir_grid_enemigos(GridEspacial *grid, PoolEnemigos *enemigos)
+{
+    int i;
+    int celda;
+    int fila, col;
+    int col_ini, fila_ini, col_fin, fila_fin;
+
+    memset(grid->inicio_celda, 0, sizeof(grid->inicio_celda));
+    grid->num_fuera = 0;
+    grid->marca_actual = 0;
+
+    // Contar cuantos enemigos caen en cada celda
+    for (i = 0; i < enemigos->num_enemigos; i++)
+    {
+        grid->marca[i] = 0;
+
+        if (!enemigos->activo[i]) continue;
+
+        if (!celdas_enemigo_grid(enemigos, i, &col_ini, &fila_ini, &col_fin, &fila_fin))
+        {
+            grid->fuera[grid->num_fuera++] = i;
+            continue;
+        }
+
+        for (fila = fila_ini; fila <= fila_fin; fila++)
+        {
+            for (col = col_ini; col <= col_fin; col++)
+            {
+                grid->inicio_celda[fila * GRID_COLUMNAS + col + 1]++;
+            }
+        }
+    }
+
+    for (celda = 0; celda < GRID_FILAS * GRID_COLUMNAS; celda++)
+    {
+        grid->inicio_celda[celda + 1] += grid->inicio_celda[celda];
+        grid->siguiente[celda] = grid->inicio_celda[celda];
+    }
+
+    // Guardar los indices en el tramo de cada celda
+    for (i = 0; i < enemigos->num_enemigos; i++)
+    {
+        if (!enemigos->activo[i]) continue;
+
+        if (!celdas_enemigo_grid(enemigos, i, &col_ini, &fila_ini, &col_fin, &fila_fin)) continue;
+
+        for (fila = fila_ini; fila <= fila_fin; fila++)
+        {
+            for (col = col_ini; col <= col_fin; col++)
+            {
+                grid->indices[grid->siguiente[fila * GRID_COLUMNAS + col]++] = i;
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Obtiene los enemigos que pueden estar dentro de un rectangulo.
+ * 
+ * Devuelve candidatos sin repetir y en orden ascendente; el llamador debe revisar
+ * si siguen activos y hacer la prueba de colision exacta.
+ * 
+ * @param grid Grilla construida con construir_grid_enemigos.
+ * @param x1 Borde izquierdo del rectangulo.
+ * @param y1 Borde superior del rectangulo.
+ * @param x2 Borde derecho del rectangulo.
+ * @param y2 Borde inferior del rectangulo.
+ * @param resultados Arreglo donde se guardan los indices de los enemigos.
+ * @param max_resultados Capacidad del arreglo de resultados.
+ * @return Cantidad de indices guardados.
+ */
+int consultar_grid_area(GridEspacial *grid, float x1, float y1, float x2, float y2, int resultados[], int max_resultados)
+{
+    int fila, col;
+    int col_ini, fila_ini, col_fin, fila_fin;
+    int num_resultados;
+
+    num_resultados = iniciar_consulta_grid(grid, resultados, max_resultados);
+
+    rango_celdas_grid(x1, y1, x2, y2, &col_ini, &fila_ini, &col_fin, &fila_fin);
+
+    for (fila = fila_ini; fila <= fila_fin; fila++)
+    {
+        for (col = col_ini; col <= col_fin; col++)
+        {
+            num_resultados = agregar_celda_grid(grid, fila * GRID_COLUMNAS + col, resultados, num_resultados, max_resultados);
+        }
+    }
+
+    qsort(resultados, num_resultados, sizeof(int), comparar_indices_grid);
+    return num_resultados;
+}
+
+
+/**
+ * @brief Obtiene los enemigos que pueden chocar con un objeto según detectar_colision_generica.
+ * 
+ * @param grid Grilla construida con construir_grid_enemigos.
+ * @param x Posición x del objeto.
+ * @param y Posición y del objeto.
+ * @param ancho Ancho del objeto.
+ * @param alto Alto del objeto.
+ * @param resultados Arreglo donde se guardan los indices de los enemigos.
+ * @param max_resultados Capacidad del arreglo de resultados.
+ * @return Cantidad de indices guardados.
+ */
+int consultar_grid_objeto(GridEspacial *grid, float x, float y, float ancho, float alto, int resultados[], int max_resultados)
+{
+    float x1, y1, x2, y2;
+
+    limites_colision_grid(x, y, ancho, alto, 0.0f, &x1, &y1, &x2, &y2);
+    return consultar_grid_area(grid, x1, y1, x2, y2, resultados, max_resultados);
+}
+
+
+/**
+ * @brief Recorta el parametro de un segmento contra un borde (algoritmo de Liang-Barsky).
+ * 
+ * @param p Componente de la direccion perpendicular al borde.
+ * @param q Distancia con signo desde el origen al borde.
+ * @param t_ini Parametro inicial del segmento, se ajusta.
+ * @param t_fin Parametro final del segmento, se ajusta.
+ * @return false si el segmento queda completamente fuera.
+ */
+static bool recortar_borde_grid(float p, float q, float *t_ini, float *t_fin)
+{
+    float r;
+
+    if (p == 0.0f)
+    {
+        return q >= 0.0f;
+    }
+
+    r = q / p;
+    if (p < 0.0f)
+    {
+        if (r > *t_fin) return false;
+        if (r > *t_ini) *t_ini = r;
+    }
+    else
+    {
+        if (r < *t_ini) return false;
+        if (r < *t_fin) *t_fin = r;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Obtiene los enemigos cuyas celdas atraviesa un segmento.
+ * 
+ * Recorre solo las celdas que toca el segmento (paso a paso, al estilo de Amanatides y Woo),
+ * por lo que un laser largo no revisa la grilla completa.
+ * 
+ * @param grid Grilla construida con construir_grid_enemigos.
+ * @param x1 Coordenada x del inicio del segmento.
+ * @param y1 Coordenada y del inicio del segmento.
+ * @param x2 Coordenada x del final del segmento.
+ * @param y2 Coordenada y del final del segmento.
+ * @param resultados Arreglo donde se guardan los indices de los enemigos.
+ * @param max_resultados Capacidad del arreglo de resultados.
+ * @return Cantidad de indices guardados.
+ */
+int consultar_grid_segmento(GridEspacial *grid, float x1, float y1, float x2, float y2, int resultados[], int max_resultados)
+{
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float t_ini = 0.0f;
+    float t_fin = 1.0f;
+    float ini_x, ini_y, fin_x, fin_y;
+    float t_max_x, t_max_y;
+    float t_delta_x, t_delta_y;
+    int col, fila, col_fin, fila_fin;
+    int paso_col, paso_fila;
+    int paso;
+    int num_resultados;
+
+    num_resultados = iniciar_consulta_grid(grid, resultados, max_resultados);
+
+    // Recortar el segmento al area que cubre la grilla
+    if (!recortar_borde_grid(-dx, x1, &t_ini, &t_fin) ||
+        !recortar_borde_grid(dx, GRID_COLUMNAS * TILE_ANCHO - x1, &t_ini, &t_fin) ||
+        !recortar_borde_grid(-dy, y1, &t_ini, &t_fin) ||
+        !recortar_borde_grid(dy, GRID_FILAS * TILE_ALTO - y1, &t_ini, &t_fin))
+    {
+        qsort(resultados, num_resultados, sizeof(int), comparar_indices_grid);
+        return num_resultados;
+    }
+
+    ini_x = x1 + dx * t_ini;
+    ini_y = y1 + dy * t_ini;
+    fin_x = x1 + dx * t_fin;
+    fin_y = y1 + dy * t_fin;
+    dx = fin_x - ini_x;
+    dy = fin_y - ini_y;
+
+    rango_celdas_grid(ini_x, ini_y, ini_x, ini_y, &col, &fila, &col, &fila);
+    rango_celdas_grid(fin_x, fin_y, fin_x, fin_y, &col_fin, &fila_fin, &col_fin, &fila_fin);
+
+    // Distancia (en fraccion del segmento) hasta el siguiente borde de celda en cada eje
+    paso_col = (dx > 0.0f) ? 1 : ((dx < 0.0f) ? -1 : 0);
+    paso_fila = (dy > 0.0f) ? 1 : ((dy < 0.0f) ? -1 : 0);
+
+    if (paso_col != 0)
+    {
+        t_max_x = (((paso_col > 0) ? (col + 1) * TILE_ANCHO : col * TILE_ANCHO) - ini_x) / dx;
+        t_delta_x = TILE_ANCHO / fabsf(dx);
+    }
+    else
+    {
+        t_max_x = 2.0f;
+        t_delta_x = 2.0f;
+    }
+
+    if (paso_fila != 0)
+    {
+        t_max_y = (((paso_fila > 0) ? (fila + 1) * TILE_ALTO : fila * TILE_ALTO) - ini_y) / dy;
+        t_delta_y = TILE_ALTO / fabsf(dy);
+    }
+    else
+    {
+        t_max_y = 2.0f;
+        t_delta_y = 2.0f;
+    }
+
+    for (paso = 0; paso <= GRID_COLUMNAS + GRID_FILAS; paso++)
+    {
+        num_resultados = agregar_celda_grid(grid, fila * GRID_COLUMNAS + col, resultados, num_resultados, max_resultados);
+
+        if (col == col_fin && fila == fila_fin) break;
+
+        if (t_max_x < t_max_y)
+        {
+            col += paso_col;
+            t_max_x += t_delta_x;
+        }
+        else
+        {
+            fila += paso_fila;
+            t_max_y += t_delta_y;
+        }
+
+        if (col < 0 || col >= GRID_COLUMNAS || fila < 0 || fila >= GRID_FILAS) break;
+    }
+
+    qsort(resultados, num_resultados, sizeof(int), comparar_indices_grid);
+    return num_resultados;
+}
+
+
+/**
+ * @brief Calcula el rango de tiles del mapa que cubre un rectangulo, recortado al mapa.
+ * 
+ * El rectangulo se toma como [x, x + ancho) x [y, y + alto), igual que los recorridos
+ * por celdas que ya hacian los disparos, asteroides y explosivos.
+ * 
+ * @param x Posición x del rectangulo.
+ * @param y Posición y del rectangulo.
+ * @param ancho Ancho del rectangulo.
+ * @param alto Alto del rectangulo.
+ * @param fila_ini Primera fila cubierta.
+ * @param col_ini Primera columna cubierta.
+ * @param fila_fin Ultima fila cubierta.
+ * @param col_fin Ultima columna cubierta.
+ * @return false si el rectangulo queda completamente fuera del mapa.
+ */
+bool obtener_rango_tiles(float x, float y, float ancho, float alto, int *fila_ini, int *col_ini, int *fila_fin, int *col_fin)
+{
+    *col_ini = (int)floorf(x / TILE_ANCHO);
+    *fila_ini = (int)floorf(y / TILE_ALTO);
+    *col_fin = (int)floorf((x + ancho - 1) / TILE_ANCHO);
+    *fila_fin = (int)floorf((y + alto - 1) / TILE_ALTO);
+
+    if (*col_ini < 0) *col_ini = 0;
+    if (*fila_ini < 0) *fila_ini = 0;
+    if (*col_fin >= MAPA_COLUMNAS) *col_fin = MAPA_COLUMNAS - 1;
+    if (*fila_fin >= MAPA_FILAS) *fila_fin = MAPA_FILAS - 1;
+
+    return *col_ini <= *col_fin && *fila_ini <= *fila_fin;
+}
+
+
+/**
+ * @brief Indica si un tile pertenece a alguno de los tipos de una mascara.
+ * 
+ * Los escudos (tipo 2) solo cuentan mientras les quede vida.
+ * 
+ * @param tile Tile a revisar.
+ * @param mascara Combinacion de MASCARA_TILE_*.
+ * @return true si el tile coincide con la mascara.
+ */
+bool tile_coincide_mascara(Tile tile, int mascara)
+{
+    if (tile.tipo <= 0 || tile.tipo > 3 || !(mascara & (1 << tile.tipo)))
+    {
+        return false;
+    }
+
+    return tile.tipo != 2 || tile.vida > 0;
+}
+
+
+/**
+ * @brief Vuelve a calcular los bits de las máscaras de un tile a partir de su tipo y su vida.
+ * 
+ * @param tilemap Mapa de tiles del nivel.
+ * @param fila Fila del tile.
+ * @param col Columna del tile.
+ */
+void actualizar_mascara_tile(Tilemap *tilemap, int fila, int col)
+{
+    uint64_t bit = (uint64_t)1 << col;
+
+    tilemap->filas_solidas[fila] &= ~bit;
+    tilemap->filas_escudo[fila] &= ~bit;
+
+    if (tile_coincide_mascara(tilemap->celdas[fila][col], MASCARA_TILE_SOLIDO))
+    {
+        tilemap->filas_solidas[fila] |= bit;
+    }
+    else if (tile_coincide_mascara(tilemap->celdas[fila][col], MASCARA_TILE_ESCUDO))
+    {
+        tilemap->filas_escudo[fila] |= bit;
+    }
+}
+
+
+/**
+ * @brief Rehace las máscaras de todas las filas, después de cargar o generar un mapa.
+ * 
+ * @param tilemap Mapa de tiles del nivel.
+ */
+void actualizar_mascaras_tilemap(Tilemap *tilemap)
+{
+    int f, c;
+
+    for (f = 0; f < MAPA_FILAS; f++)
+    {
+        tilemap->filas_solidas[f] = 0;
+        tilemap->filas_escudo[f] = 0;
+
+        for (c = 0; c < MAPA_COLUMNAS; c++)
+        {
+            actualizar_mascara_tile(tilemap, f, c);
+        }
+    }
+}
+
+
+/**
+ * @brief Devuelve las columnas de una fila cuyos tiles coinciden con una mascara.
+ * 
+ * Los sólidos y los escudos salen de las máscaras por fila. Solo si se pide uno de los
+ * dos tipos sólidos sin el otro se revisan las celdas una por una.
+ * 
+ * @param tilemap Mapa de tiles del nivel.
+ * @param fila Fila a consultar.
+ * @param mascara Combinacion de MASCARA_TILE_*.
+ * @return Bit col prendido por cada columna que coincide.
+ */
+uint64_t mascara_fila_tilemap(const Tilemap *tilemap, int fila, int mascara)
+{
+    uint64_t bits = 0;
+    int c;
+
+    if ((mascara & MASCARA_TILE_SOLIDO) == MASCARA_TILE_SOLIDO)
+    {
+        bits = tilemap->filas_solidas[fila];
+    }
+    else if (mascara & MASCARA_TILE_SOLIDO)
+    {
+        for (c = 0; c < MAPA_COLUMNAS; c++)
+        {
+            if (tile_coincide_mascara(tilemap->celdas[fila][c], mascara & MASCARA_TILE_SOLIDO))
+            {
+                bits |= (uint64_t)1 << c;
+            }
+        }
+    }
+
+    if (mascara & MASCARA_TILE_ESCUDO)
+    {
+        bits |= tilemap->filas_escudo[fila];
+    }
+
+    return bits;
+}
+
+
+/**
+ * @brief Devuelve una máscara con los bits de las columnas col_ini a col_fin inclusive.
+ *
+ * Nunca tiene bits fuera del mapa, aunque el rango pedido se pase de MAPA_COLUMNAS.
+ */
+static uint64_t bits_columnas(int col_ini, int col_fin)
+{
+    const uint64_t columnas_mapa = ~(uint64_t)0 >> (64 - MAPA_COLUMNAS);
+
+    return (~(uint64_t)0 >> (63 - col_fin)) & (~(uint64_t)0 << col_ini) & columnas_mapa;
+}
+
+
+/**
+ * @brief Busca el primer tile de los tipos pedidos que toca un rectangulo.
+ * 
+ * Cada fila que cubre el rectangulo se revisa con su máscara recortada a las columnas del
+ * rectangulo, y se devuelve la primera columna de la primera fila que coincide.
+ * Es la consulta comun para disparos, asteroides y explosivos contra el mapa.
+ * 
+ * @param tilemap Mapa de tiles del nivel.
+ * @param x Posición x del rectangulo.
+ * @param y Posición y del rectangulo.
+ * @param ancho Ancho del rectangulo.
+ * @param alto Alto del rectangulo.
+ * @param mascara Combinacion de MASCARA_TILE_* con los tipos buscados.
+ * @param fila Fila del tile encontrado.
+ * @param col Columna del tile encontrado.
+ * @return true si se encontro un tile.
+ */
+bool buscar_tile_en_area(Tilemap *tilemap, float x, float y, float ancho, float alto, int mascara, int *fila, int *col)
+{
+    int f;
+    int fila_ini, col_ini, fila_fin, col_fin;
+    uint64_t rango;
+    uint64_t bits;
+
+    if (!obtener_rango_tiles(x, y, ancho, alto, &fila_ini, &col_ini, &fila_fin, &col_fin))
+    {
+        return false;
+    }
+
+    rango = bits_columnas(col_ini, col_fin);
+
+    for (f = fila_ini; f <= fila_fin; f++)
+    {
+        bits = mascara_fila_tilemap(tilemap, f, mascara) & rango;
+        if (bits)
+        {
+            *fila = f;
+            *col = __builtin_ctzll(bits);
+
+            // rango ya no tiene bits fuera del mapa, pero así el índice queda acotado para quien lo usa
+            if (*col >= MAPA_COLUMNAS)
+            {
+                return false;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Le resta vida a un escudo sin que la resta desborde su vida de un byte.
+ * 
+ * @param tilemap Mapa de tiles del nivel.
+ * @param fila Fila del tile.
+ * @param col Columna del tile.
+ * @param dano Vida a restar.
+ */
+void danar_tile(Tilemap *tilemap, int fila, int col, int dano)
+{
+    int vida = tilemap->celdas[fila][col].vida - dano;
+
+    tilemap->celdas[fila][col].vida = (int8_t)(vida < 0 ? 0 : vida);
+}
+
+
+/**
+ * @brief Deja vacío un tile destruido, lo saca de las máscaras y lo cuenta para el campo de flujo.
+ * 
+ * @param tilemap Mapa de tiles del nivel.
+ * @param tiles_sucios Lista de tiles sucios, puede ser NULL.
+ * @param fila Fila del tile.
+ * @param col Columna del tile.
+ */
+void destruir_tile(Tilemap *tilemap, TilesSucios *tiles_sucios, int fila, int col)
+{
+    tilemap->celdas[fila][col].tipo = 0;
+    tilemap->celdas[fila][col].vida = 0;
+    actualizar_mascara_tile(tilemap, fila, col);
+
+    if (tiles_sucios != NULL)
+    {
+        tiles_sucios->tiles_destruidos++;
+    }
+}
+
+
+/**
+ * @brief Obliga a recalcular el campo de flujo en la próxima actualización.
+ * 
+ * @param campo Campo de flujo.
+ */
+void invalidar_campo_flujo(CampoFlujo *campo)
+{
+    campo->valido = false;
+}
+
+
+/**
+ * @brief Obtiene la celda del mapa que contiene un punto, limitada a los bordes del mapa.
+ * 
+ * @param x Posición x del punto.
+ * @param y Posición y del punto.
+ * @param fila Fila de la celda.
+ * @param col Columna de la celda.
+ */
+static void celda_campo_flujo(float x, float y, int *fila, int *col)
+{
+    *col = (int)floorf(x / TILE_ANCHO);
+    *fila = (int)floorf(y / TILE_ALTO);
+
+    if (*col < 0) *col = 0;
+    if (*fila < 0) *fila = 0;
+    if (*col >= MAPA_COLUMNAS) *col = MAPA_COLUMNAS - 1;
+    if (*fila >= MAPA_FILAS) *fila = MAPA_FILAS - 1;
+}
+
+
+/**
+ * @brief Recalcula el campo de flujo si la nave cambió de celda o se destruyó algún tile.
+ * 
+ * La búsqueda en anchura usa las cuatro celdas vecinas, así cada celda guarda cuántos
+ * tiles la separan de la nave. Después cada celda apunta a la vecina más cercana a la
+ * nave, incluidas las diagonales cuando las dos celdas que cruzan están libres, para que
+ * los enemigos no corten esquinas de muros.
+ * 
+ * @param campo Campo de flujo a actualizar.
+ * @param tilemap Mapa de tiles del nivel.
+ * @param tiles_sucios Lista de tiles sucios, de donde sale la cantidad de tiles destruidos.
+ * @param nave Nave del jugador.
+ * @return true si se recalculó.
+ */
+bool actualizar_campo_flujo(CampoFlujo *campo, Tilemap *tilemap, const TilesSucios *tiles_sucios, const Nave *nave)
+{
+    static const int vecino_fila[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    static const int vecino_col[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+    int fila_nave;
+    int col_nave;
+    int destruidos = tiles_sucios != NULL ? tiles_sucios->tiles_destruidos : 0;
+    int inicio = 0;
+    int fin = 0;
+    int f, c;
+    int nf, nc;
+    int v;
+    int mejor;
+    int mejor_v;
+    float norma;
+
+    celda_campo_flujo(nave->x + nave->ancho / 2, nave->y + nave->largo / 2, &fila_nave, &col_nave);
+
+    if (campo->valido && campo->fila_nave == fila_nave && campo->col_nave == col_nave && campo->tiles_destruidos == destruidos)
+    {
+        return false;
+    }
+
+    campo->fila_nave = fila_nave;
+    campo->col_nave = col_nave;
+    campo->tiles_destruidos = destruidos;
+    campo->valido = true;
+
+    memset(campo->distancia, -1, sizeof(campo->distancia));
+    campo->distancia[fila_nave][col_nave] = 0;
+    campo->cola[fin++] = fila_nave * MAPA_COLUMNAS + col_nave;
+
+    while (inicio < fin)
+    {
+        f = campo->cola[inicio] / MAPA_COLUMNAS;
+        c = campo->cola[inicio] % MAPA_COLUMNAS;
+        inicio++;
+
+        for (v = 0; v < 4; v++)
+        {
+            nf = f + vecino_fila[v];
+            nc = c + vecino_col[v];
+
+            if (nf < 0 || nf >= MAPA_FILAS || nc < 0 || nc >= MAPA_COLUMNAS || campo->distancia[nf][nc] >= 0)
+            {
+                continue;
+            }
+
+            if (((tilemap->filas_solidas[nf] | tilemap->filas_escudo[nf]) >> nc) & 1)
+            {
+                continue;
+            }
+
+            campo->distancia[nf][nc] = campo->distancia[f][c] + 1;
+            campo->cola[fin++] = nf * MAPA_COLUMNAS + nc;
+        }
+    }
+
+    for (f = 0; f < MAPA_FILAS; f++)
+    {
+        for (c = 0; c < MAPA_COLUMNAS; c++)
+        {
+            campo->direccion_x[f][c] = 0;
+            campo->direccion_y[f][c] = 0;
+
+            if (campo->distancia[f][c] <= 0)
+            {
+                continue;
+            }
+
+            mejor = campo->distancia[f][c];
+            mejor_v = -1;
+
+            for (v = 0; v < 8; v++)
+            {
+                nf = f + vecino_fila[v];
+                nc = c + vecino_col[v];
+
+                if (nf < 0 || nf >= MAPA_FILAS || nc < 0 || nc >= MAPA_COLUMNAS || campo->distancia[nf][nc] < 0)
+                {
+                    continue;
+                }
+
+                // En diagonal solo si no se cruza por la esquina de un tile bloqueado
+                if (v >= 4 && (campo->distancia[nf][c] < 0 || campo->distancia[f][nc] < 0))
+                {
+                    continue;
+                }
+
+                if (campo->distancia[nf][nc] < mejor || (campo->distancia[nf][nc] == mejor && mejor_v >= 0 && mejor_v < 4 && v >= 4))
+                {
+                    mejor = campo->distancia[nf][nc];
+                    mejor_v = v;
+                }
+            }
+
+            if (mejor_v >= 0)
+            {
+                norma = mejor_v >= 4 ? 1.41421356f : 1.0f;
+                campo->direccion_x[f][c] = vecino_col[mejor_v] / norma;
+                campo->direccion_y[f][c] = vecino_fila[mejor_v] / norma;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Lee la dirección del campo de flujo en la celda de un punto.
+ * 
+ * Si el punto está en la celda de la nave o en una vecina, o si desde su celda no se
+ * llega a la nave, no hay dirección y quien llama va en línea recta.
+ * 
+ * @param campo Campo de flujo ya calculado.
+ * @param x Posición x del punto, normalmente el centro de un enemigo.
+ * @param y Posición y del punto.
+ * @param direccion_x Componente x de la dirección normalizada.
+ * @param direccion_y Componente y de la dirección normalizada.
+ * @return true si hay una dirección que seguir.
+ */
+bool direccion_campo_flujo(const CampoFlujo *campo, float x, float y, float *direccion_x, float *direccion_y)
+{
+    int fila;
+    int col;
+
+    if (!campo->valido || x < 0 || y < 0 || x >= MAPA_COLUMNAS * TILE_ANCHO || y >= MAPA_FILAS * TILE_ALTO)
+    {
+        return false;
+    }
+
+    celda_campo_flujo(x, y, &fila, &col);
+
+    if (campo->distancia[fila][col] <= 1)
+    {
+        return false;
+    }
+
+    *direccion_x = campo->direccion_x[fila][col];
+    *direccion_y = campo->direccion_y[fila][col];
+    return true;
+}
+
+
+/**
+ * @brief Carga un tilemap desde un archivo de texto y extrae enemigos.
+ * 
+ * Lee un archivo que contiene números que representan diferentes tipos de tiles:
+ * - 0: vacío
+ * - 1: asteroide fijo
+ * - 2: escudo destructible
+ * - 3: enemigo normal
+ * - 4: enemigo perseguidor
+ * 
+ * Los enemigos (3 y 4) se extraen del tilemap y se almacenan en el arreglo de enemigos.
+ * 
+ * @param filename Nombre del archivo del tilemap.
+ * @param tilemap Matriz de tiles a llenar.
+ * @param enemigos Arreglo donde se almacenarán los enemigos extraídos.
+ * @param num_enemigos Puntero al contador de enemigos cargados.
+ * @param imagen_enemigo Imagen que se asignará a todos los enemigos.
+ * @param aleatorio Generador para los intervalos de disparo de los enemigos.
+ */
+void cargar_tilemap(const char* filename, Tilemap *tilemap, Enemigo enemigos[], int* num_enemigos, ALLEGRO_BITMAP* imagen_enemigo, float *nave_x, float *nave_y, GeneradorAleatorio *aleatorio) 
+{
+    bool nave_encontrada;
+    char linea[50];
+    int longitud_linea;
+    char c;
+
+    int fila;
+    int col;
+
+
+    FILE* archivo = fopen(filename, "r");
+    if (!archivo) 
+    {
+        fprintf(stderr, "ERROR: No se pudo abrir %s\n", filename);
+        *num_enemigos = 0;
+        *nave_x = 400;
+        *nave_y = 500;
+        return;
+    }
+
+    *num_enemigos = 0;
+    nave_encontrada = false;
+
+    printf("=== CARGANDO: %s ===\n", filename);
+
+    for (fila = 0; fila < MAPA_FILAS; fila++)
+    {
+        // Leer línea completa
+        if (fgets(linea, sizeof(linea), archivo) == NULL)
+        {
+            printf("ERROR: No se pudo leer la fila %d\n", fila);
+            break;
+        }
+
+        printf("Fila %d: %.10s... (primeros 10 chars)\n", fila, linea);
+
+        // Procesar cada columna de la línea
+        longitud_linea = (int)strlen(linea);
+        for (col = 0; col < MAPA_COLUMNAS && col < longitud_linea; col++)
+        {
+            c = linea[col];
+
+            // Inicializar tile por defecto
+            tilemap->celdas[fila][col].tipo = 0;
+            tilemap->celdas[fila][col].vida = 0;
 
             switch (c) 
             {
                 case '1':
-                    tilemap[fila][col].tipo = 1;
+                    tilemap->celdas[fila][col].tipo = 1;
                     break;
 
                 case '2':
-                    tilemap[fila][col].tipo = 2;
-                    tilemap[fila][col].vida = 3;
+                    tilemap->celdas[fila][col].tipo = 2;
+                    tilemap->celdas[fila][col].vida = 3;
                     break;
 
                 case '3':
-                    tilemap[fila][col].tipo = 3;
-                    tilemap[fila][col].vida = 999;
+                    tilemap->celdas[fila][col].tipo = 3;
+                    tilemap->celdas[fila][col].vida = 0; // Indestructible, no usa vida
                     break;
 
                 case 'P':
@@ -1378,7 +2062,7 @@ void cargar_tilemap(const char* filename, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS
                 case 'E':
                     if (*num_enemigos < NUM_ENEMIGOS) 
                     {
-                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 0, imagen_enemigo);
+                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 0, imagen_enemigo, aleatorio);
                         printf("E: enemigo normal en (%d,%d)\n", col, fila);
                         (*num_enemigos)++;
                     }
@@ -1387,7 +2071,7 @@ void cargar_tilemap(const char* filename, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS
                 case 'H':
                     if (*num_enemigos < NUM_ENEMIGOS) 
                     {
-                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 1, imagen_enemigo);
+                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 1, imagen_enemigo, aleatorio);
                         printf("H: perseguidor en (%d,%d)\n", col, fila);
                         (*num_enemigos)++;
                     }
@@ -1396,7 +2080,7 @@ void cargar_tilemap(const char* filename, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS
                 case 'S':
                     if (*num_enemigos < NUM_ENEMIGOS)
                     {
-                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 2, imagen_enemigo);
+                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 2, imagen_enemigo, aleatorio);
                         printf("S: francotirador en (%d,%d)\n", col, fila);
                         (*num_enemigos)++;
                     }
@@ -1405,7 +2089,7 @@ void cargar_tilemap(const char* filename, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS
                 case 'T':
                     if (*num_enemigos < NUM_ENEMIGOS)
                     {
-                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 3, imagen_enemigo);
+                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 3, imagen_enemigo, aleatorio);
                         printf("T: tanque en (%d,%d)\n", col, fila);
                         (*num_enemigos)++;
                     }
@@ -1414,7 +2098,7 @@ void cargar_tilemap(const char* filename, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS
                 case 'K':
                     if (*num_enemigos < NUM_ENEMIGOS)
                     {
-                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 4, imagen_enemigo);
+                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 4, imagen_enemigo, aleatorio);
                         printf("K: kamikaze en (%d,%d)\n", col, fila);
                         (*num_enemigos)++;
                     }
@@ -1423,23 +2107,23 @@ void cargar_tilemap(const char* filename, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS
                 case 'B':
                     if (*num_enemigos < NUM_ENEMIGOS)
                     {
-                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 5, imagen_enemigo); // Tipo 5 = Jefe Destructor
+                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 5, imagen_enemigo, aleatorio); // Tipo 5 = Jefe Destructor
                         printf("B: Jefe Destructor en (%d,%d)\n", col, fila);
                         (*num_enemigos)++;
                     }
-                    tilemap[fila][col].tipo = 0;
-                    tilemap[fila][col].vida = 0;
+                    tilemap->celdas[fila][col].tipo = 0;
+                    tilemap->celdas[fila][col].vida = 0;
                     break;
 
                 case 'C':
                     if (*num_enemigos < NUM_ENEMIGOS)
                     {
-                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 6, imagen_enemigo); // Tipo 6 = Jefe Supremo
+                        init_enemigo_tipo(&enemigos[*num_enemigos], col, fila, 6, imagen_enemigo, aleatorio); // Tipo 6 = Jefe Supremo
                         printf("C: Jefe Supremo en (%d,%d)\n", col, fila);
                         (*num_enemigos)++;
                     }
-                    tilemap[fila][col].tipo = 0;
-                    tilemap[fila][col].vida = 0;
+                    tilemap->celdas[fila][col].tipo = 0;
+                    tilemap->celdas[fila][col].vida = 0;
                     break;
 
                 case '0':
@@ -1461,67 +2145,493 @@ void cargar_tilemap(const char* filename, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS
 
 
 /**
- * @brief Dibuja el tilemap en pantalla.
+ * @brief Dibuja un tile en su celda del mapa.
+ * 
+ * @param tile Tile a dibujar.
+ * @param fila Fila del tile.
+ * @param col Columna del tile.
+ * @param imagen_asteroide Imagen para los tiles de tipo asteroide, ya del tamaño de un tile.
+ */
+static void dibujar_tile(const Tile *tile, int fila, int col, ALLEGRO_BITMAP* imagen_asteroide)
+{
+    ALLEGRO_COLOR color;
+
+    if (tile->tipo == 1)
+    {
+        al_draw_bitmap(imagen_asteroide, col * TILE_ANCHO, fila * TILE_ALTO, 0);
+    }
+    else if (tile->tipo == 2) 
+    {
+        // Dibuja el escudo como un rectángulo azul (puedes usar una imagen si prefieres)
+        color = al_map_rgb(0, 128, 255);
+        if (tile->vida == 2) color = al_map_rgb(0, 200, 255);
+        if (tile->vida == 1) color = al_map_rgb(100, 100, 255);
+        al_draw_filled_rectangle(col * TILE_ANCHO, fila * TILE_ALTO, (col + 1) * TILE_ANCHO, (fila + 1) * TILE_ALTO, color);
+    }
+    else if (tile->tipo == 3)
+    {
+        al_draw_filled_rectangle(col * TILE_ANCHO, fila * TILE_ALTO, (col + 1) * TILE_ANCHO, (fila + 1) * TILE_ALTO, al_map_rgb(80, 80, 80));
+    }
+}
+
+
+/**
+ * @brief Dibuja todos los tiles del mapa.
+ * 
+ * Primero van los tiles con imagen, en un solo lote, y después los que son rectángulos:
+ * mientras el dibujo está retenido no se pueden usar primitivas. Los tiles no se tapan
+ * entre sí, así que el orden no cambia el resultado.
  * 
  * @param tilemap Matriz de tiles.
- * @param imagen_asteroide Imagen para los tiles de tipo asteroide.
+ * @param imagen_asteroide Imagen para los tiles de tipo asteroide, ya del tamaño de un tile.
  */
-void dibujar_tilemap(Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], ALLEGRO_BITMAP* imagen_asteroide) 
+static void dibujar_tiles_en_lote(Tilemap *tilemap, ALLEGRO_BITMAP* imagen_asteroide)
 {
     int fila;
     int col;
-    ALLEGRO_COLOR color;
 
+    al_hold_bitmap_drawing(true);
     for (fila = 0; fila < MAPA_FILAS; fila++)
     {
         for (col = 0; col < MAPA_COLUMNAS; col++)
         {
-            if (tilemap[fila][col].tipo == 1)
-            {
-                al_draw_scaled_bitmap(imagen_asteroide, 0, 0, al_get_bitmap_width(imagen_asteroide), al_get_bitmap_height(imagen_asteroide), col * TILE_ANCHO, fila * TILE_ALTO, TILE_ANCHO, TILE_ALTO, 0);
-            }
-            else if (tilemap[fila][col].tipo == 2) 
+            if (tilemap->celdas[fila][col].tipo == 1)
             {
-                // Dibuja el escudo como un rectángulo azul (puedes usar una imagen si prefieres)
-                color = al_map_rgb(0, 128, 255);
-                if (tilemap[fila][col].vida == 2) color = al_map_rgb(0, 200, 255);
-                if (tilemap[fila][col].vida == 1) color = al_map_rgb(100, 100, 255);
-                al_draw_filled_rectangle(col * TILE_ANCHO, fila * TILE_ALTO, (col + 1) * TILE_ANCHO, (fila + 1) * TILE_ALTO, color);
+                dibujar_tile(&tilemap->celdas[fila][col], fila, col, imagen_asteroide);
             }
-            else if (tilemap[fila][col].tipo == 3)
+        }
+    }
+    al_hold_bitmap_drawing(false);
+
+    for (fila = 0; fila < MAPA_FILAS; fila++)
+    {
+        for (col = 0; col < MAPA_COLUMNAS; col++)
+        {
+            if (tilemap->celdas[fila][col].tipo != 1)
             {
-                al_draw_filled_rectangle(col * TILE_ANCHO, fila * TILE_ALTO, (col + 1) * TILE_ANCHO, (fila + 1) * TILE_ALTO, al_map_rgb(80, 80, 80));
+                dibujar_tile(&tilemap->celdas[fila][col], fila, col, imagen_asteroide);
             }
         }
     }
-}
+}
+
+
+/**
+ * @brief Dibuja el tilemap en pantalla.
+ * 
+ * @param tilemap Matriz de tiles.
+ * @param imagen_asteroide Imagen para los tiles de tipo asteroide.
+ */
+void dibujar_tilemap(Tilemap *tilemap, ALLEGRO_BITMAP* imagen_asteroide) 
+{
+    dibujar_tiles_en_lote(tilemap, imagen_asteroide);
+}
+
+
+/**
+ * @brief Agrega un tile a la lista de tiles que hay que redibujar.
+ * 
+ * Ignora posiciones fuera del mapa y tiles que ya estaban en la lista.
+ * 
+ * @param tiles_sucios Lista de tiles sucios, puede ser NULL.
+ * @param fila Fila del tile.
+ * @param col Columna del tile.
+ */
+void marcar_tile_sucio(TilesSucios *tiles_sucios, int fila, int col)
+{
+    if (tiles_sucios == NULL || tiles_sucios->mapa_completo)
+    {
+        return;
+    }
+
+    if (fila < 0 || fila >= MAPA_FILAS || col < 0 || col >= MAPA_COLUMNAS || tiles_sucios->marcado[fila][col])
+    {
+        return;
+    }
+
+    tiles_sucios->marcado[fila][col] = true;
+    tiles_sucios->filas[tiles_sucios->num_tiles] = fila;
+    tiles_sucios->columnas[tiles_sucios->num_tiles] = col;
+    tiles_sucios->num_tiles++;
+}
+
+
+/**
+ * @brief Pide redibujar el mapa completo, por ejemplo al cargar un nivel.
+ * 
+ * @param tiles_sucios Lista de tiles sucios.
+ */
+void marcar_mapa_sucio(TilesSucios *tiles_sucios)
+{
+    tiles_sucios->mapa_completo = true;
+}
+
+
+/**
+ * @brief Crea el bitmap fuera de pantalla donde se guarda el tilemap dibujado.
+ * 
+ * @param capa Capa a crear.
+ * @param imagen_asteroide Imagen para los tiles de tipo asteroide.
+ * @return true si se pudo crear el bitmap.
+ */
+bool crear_capa_tilemap(CapaTilemap *capa, ALLEGRO_BITMAP *imagen_asteroide)
+{
+    capa->imagen_asteroide = imagen_asteroide;
+    capa->bitmap = al_create_bitmap(MAPA_COLUMNAS * TILE_ANCHO, MAPA_FILAS * TILE_ALTO);
+
+    if (!capa->bitmap)
+    {
+        printf("No se pudo crear la capa del tilemap, se dibujará tile por tile\n");
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Vuelve a pintar en la capa solo los tiles que cambiaron y vacía la lista.
+ * 
+ * Si se cargó un mapa nuevo se redibuja la capa completa. Cada tile sucio se limpia
+ * con un recorte a su celda, así un escudo destruido deja la celda transparente.
+ * 
+ * @param capa Capa del tilemap.
+ * @param tilemap Matriz de tiles.
+ * @param tiles_sucios Lista de tiles a redibujar.
+ */
+void actualizar_capa_tilemap(CapaTilemap *capa, Tilemap *tilemap, TilesSucios *tiles_sucios)
+{
+    ALLEGRO_BITMAP *destino_anterior;
+    int fila;
+    int col;
+    int i;
+
+    if (!capa->bitmap || (!tiles_sucios->mapa_completo && tiles_sucios->num_tiles == 0))
+    {
+        return;
+    }
+
+    destino_anterior = al_get_target_bitmap();
+    al_set_target_bitmap(capa->bitmap);
+
+    if (tiles_sucios->mapa_completo)
+    {
+        al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+        dibujar_tiles_en_lote(tilemap, capa->imagen_asteroide);
+    }
+    else
+    {
+        for (i = 0; i < tiles_sucios->num_tiles; i++)
+        {
+            fila = tiles_sucios->filas[i];
+            col = tiles_sucios->columnas[i];
+
+            al_set_clipping_rectangle(col * TILE_ANCHO, fila * TILE_ALTO, TILE_ANCHO, TILE_ALTO);
+            al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+            dibujar_tile(&tilemap->celdas[fila][col], fila, col, capa->imagen_asteroide);
+        }
+        al_reset_clipping_rectangle();
+    }
+
+    al_set_target_bitmap(destino_anterior);
+
+    memset(tiles_sucios->marcado, 0, sizeof(tiles_sucios->marcado));
+    tiles_sucios->num_tiles = 0;
+    tiles_sucios->mapa_completo = false;
+}
+
+
+/**
+ * @brief Dibuja el tilemap con un solo blit de la capa.
+ * 
+ * @param capa Capa del tilemap.
+ * @param tilemap Matriz de tiles, se usa si la capa no se pudo crear.
+ */
+void dibujar_capa_tilemap(CapaTilemap *capa, Tilemap *tilemap)
+{
+    if (!capa->bitmap)
+    {
+        dibujar_tilemap(tilemap, capa->imagen_asteroide);
+        return;
+    }
+
+    al_draw_bitmap(capa->bitmap, 0, 0, 0);
+}
+
+
+/**
+ * @brief Libera el bitmap de la capa del tilemap.
+ * 
+ * @param capa Capa del tilemap.
+ */
+void destruir_capa_tilemap(CapaTilemap *capa)
+{
+    if (capa->bitmap)
+    {
+        al_destroy_bitmap(capa->bitmap);
+        capa->bitmap = NULL;
+    }
+}
+
+
+
+/**
+ * @brief Inicializa los enemigos.
+ * 
+ * @param enemigos Arreglo de enemigos.
+ * @param num_enemigos Número de enemigos.
+ * @param imagen_enemigo Imagen del enemigo.
+ * @param aleatorio Generador para posiciones, velocidades e intervalos.
+ */
+void init_enemigos(Enemigo enemigos[], int num_enemigos, ALLEGRO_BITMAP* imagen_enemigo, GeneradorAleatorio *aleatorio)
+{
+    int i;
+
+    for (i = 0; i < num_enemigos; i++)
+    {
+        enemigos[i].x = aleatorio_entero(aleatorio, 800 - 60);
+        enemigos[i].y = aleatorio_entero(aleatorio, 200) + 50; // Aparecen en la parte superior
+        enemigos[i].ancho = 60;
+        enemigos[i].alto = 40;
+        enemigos[i].velocidad = 0.5f + (aleatorio_entero(aleatorio, 100)) / 100.0f; // Velocidad aleatoria
+        enemigos[i].vida = 2;
+        enemigos[i].activo = true;
+        enemigos[i].ultimo_disparo = 0;
+        enemigos[i].intervalo_disparo = 1.5 + (aleatorio_entero(aleatorio, 200)) / 100.0; // Dispara cada 1.5-3.5 segundos
+        enemigos[i].imagen = imagen_enemigo;
+    }
+}
+
+
+/**
+ * @brief Deja el pool de enemigos vacío, con todas las posiciones inactivas.
+ * 
+ * Los manejadores que hubiera de antes dejan de ser válidos.
+ * 
+ * @param enemigos Pool de enemigos.
+ */
+void vaciar_pool_enemigos(PoolEnemigos *enemigos)
+{
+    int i;
+
+    memset(enemigos->activo, 0, sizeof(enemigos->activo));
+
+    for (i = 0; i < NUM_ENEMIGOS; i++)
+    {
+        enemigos->manejador[i] = i;
+        enemigos->posicion[i] = i;
+        enemigos->generacion[i]++;
+    }
+
+    enemigos->num_enemigos = 0;
+    enemigos->num_activos = 0;
+}
+
+
+/**
+ * @brief Copia los campos de un enemigo a la posición i del pool.
+ * 
+ * @param enemigos Pool de enemigos.
+ * @param i Posición donde se guarda el enemigo.
+ * @param enemigo Enemigo a copiar.
+ */
+static void guardar_enemigo_pool(PoolEnemigos *enemigos, int i, const Enemigo *enemigo)
+{
+    enemigos->x[i] = enemigo->x;
+    enemigos->y[i] = enemigo->y;
+    enemigos->ancho[i] = enemigo->ancho;
+    enemigos->alto[i] = enemigo->alto;
+    enemigos->velocidad[i] = enemigo->velocidad;
+    enemigos->vida[i] = enemigo->vida;
+    enemigos->tipo[i] = enemigo->tipo;
+    enemigos->activo[i] = enemigo->activo;
+
+    enemigos->datos[i].vida_max = enemigo->vida_max;
+    enemigos->datos[i].ultimo_disparo = enemigo->ultimo_disparo;
+    enemigos->datos[i].intervalo_disparo = enemigo->intervalo_disparo;
+    enemigos->datos[i].imagen = enemigo->imagen;
+    enemigos->datos[i].disparo_listo = false;
+
+    enemigos->ia[i].vx = 0;
+    enemigos->ia[i].vy = 0;
+    enemigos->ia[i].distancia_nave = 0;
+}
+
+
+/**
+ * @brief Agrega un enemigo al final del rango usado del pool.
+ * 
+ * El enemigo recibe el primer índice de manejador libre, que es el que está guardado
+ * en la posición num_enemigos.
+ * 
+ * @param enemigos Pool de enemigos.
+ * @param enemigo Enemigo a copiar.
+ * @return Posición del enemigo, o -1 si el pool está lleno.
+ */
+int agregar_enemigo_pool(PoolEnemigos *enemigos, const Enemigo *enemigo)
+{
+    int i = enemigos->num_enemigos;
+
+    if (i >= NUM_ENEMIGOS)
+    {
+        return -1;
+    }
+
+    guardar_enemigo_pool(enemigos, i, enemigo);
+    enemigos->num_enemigos++;
+
+    if (enemigo->activo)
+    {
+        enemigos->num_activos++;
+    }
+
+    return i;
+}
+
+
+/**
+ * @brief Marca como muerto al enemigo de la posición i.
+ * 
+ * La posición queda ocupada hasta el próximo compactar_pool_enemigos, así los índices de
+ * la grilla y de los recorridos en curso siguen apuntando al mismo enemigo. El manejador
+ * deja de ser válido enseguida.
+ * 
+ * @param enemigos Pool de enemigos.
+ * @param i Posición del enemigo.
+ */
+void eliminar_enemigo_pool(PoolEnemigos *enemigos, int i)
+{
+    if (!enemigos->activo[i])
+    {
+        return;
+    }
+
+    enemigos->activo[i] = false;
+    enemigos->num_activos--;
+    enemigos->generacion[enemigos->manejador[i]]++;
+}
+
+
+/**
+ * @brief Quita los enemigos muertos moviendo el último enemigo a cada hueco.
+ * 
+ * Se recorre de atrás hacia adelante, así el último del rango siempre está vivo cuando
+ * se lo mueve. El índice de manejador del muerto pasa a la zona de libres.
+ * 
+ * @param enemigos Pool de enemigos.
+ */
+void compactar_pool_enemigos(PoolEnemigos *enemigos)
+{
+    int i;
+    int ultimo;
+    int manejador_muerto;
+
+    if (enemigos->num_activos == enemigos->num_enemigos)
+    {
+        return;
+    }
+
+    for (i = enemigos->num_enemigos - 1; i >= 0; i--)
+    {
+        if (enemigos->activo[i])
+        {
+            continue;
+        }
+
+        ultimo = enemigos->num_enemigos - 1;
+        manejador_muerto = enemigos->manejador[i];
+
+        if (i != ultimo)
+        {
+            enemigos->x[i] = enemigos->x[ultimo];
+            enemigos->y[i] = enemigos->y[ultimo];
+            enemigos->ancho[i] = enemigos->ancho[ultimo];
+            enemigos->alto[i] = enemigos->alto[ultimo];
+            enemigos->velocidad[i] = enemigos->velocidad[ultimo];
+            enemigos->vida[i] = enemigos->vida[ultimo];
+            enemigos->tipo[i] = enemigos->tipo[ultimo];
+            enemigos->activo[i] = true;
+            enemigos->datos[i] = enemigos->datos[ultimo];
+            enemigos->ia[i] = enemigos->ia[ultimo];
+            enemigos->activo[ultimo] = false;
+
+            enemigos->manejador[i] = enemigos->manejador[ultimo];
+            enemigos->posicion[enemigos->manejador[i]] = i;
+            enemigos->manejador[ultimo] = manejador_muerto;
+            enemigos->posicion[manejador_muerto] = ultimo;
+        }
+
+        enemigos->num_enemigos--;
+    }
+}
+
+
+/**
+ * @brief Devuelve el manejador del enemigo de la posición i.
+ * 
+ * El manejador junta el índice de manejador con su generación (15 bits, para que quede
+ * positivo), así uno guardado de un enemigo que ya murió no coincide con el enemigo que
+ * reuse el índice.
+ * 
+ * @param enemigos Pool de enemigos.
+ * @param i Posición del enemigo.
+ * @return Manejador del enemigo.
+ */
+int manejador_enemigo(const PoolEnemigos *enemigos, int i)
+{
+    int indice = enemigos->manejador[i];
+
+    return (enemigos->generacion[indice] & 0x7FFF) << 16 | indice;
+}
+
+
+/**
+ * @brief Busca la posición actual de un enemigo a partir de su manejador.
+ * 
+ * @param enemigos Pool de enemigos.
+ * @param manejador Manejador obtenido con manejador_enemigo, o -1.
+ * @return Posición del enemigo, o -1 si ya murió o el manejador es -1.
+ */
+int buscar_enemigo_manejador(const PoolEnemigos *enemigos, int manejador)
+{
+    int indice;
+
+    if (manejador < 0)
+    {
+        return -1;
+    }
+
+    indice = manejador & 0xFFFF;
+    if (indice >= NUM_ENEMIGOS || (enemigos->generacion[indice] & 0x7FFF) != manejador >> 16)
+    {
+        return -1;
+    }
 
+    return enemigos->posicion[indice];
+}
 
 
 /**
- * @brief Inicializa los enemigos.
+ * @brief Indica si un perseguidor o kamikaze decide su movimiento en este paso.
  * 
- * @param enemigos Arreglo de enemigos.
- * @param num_enemigos Número de enemigos.
- * @param imagen_enemigo Imagen del enemigo.
+ * Los que estaban cerca de la nave en su última decisión y dentro de la ventana deciden
+ * en todos los pasos; el resto, solo en el paso de su cubeta.
+ * 
+ * @param enemigos Pool de enemigos.
+ * @param i Posición del enemigo.
+ * @param paso Número de paso de la simulación.
+ * @return true si el enemigo decide en este paso.
  */
-void init_enemigos(Enemigo enemigos[], int num_enemigos, ALLEGRO_BITMAP* imagen_enemigo)
+static bool enemigo_decide_ia(const PoolEnemigos *enemigos, int i, uint32_t paso)
 {
-    int i;
+    bool en_pantalla = enemigos->x[i] + enemigos->ancho[i] > 0 && enemigos->x[i] < 800 && enemigos->y[i] + enemigos->alto[i] > 0 && enemigos->y[i] < 600;
 
-    for (i = 0; i < num_enemigos; i++)
+    if (en_pantalla && enemigos->ia[i].distancia_nave < DISTANCIA_IA_COMPLETA)
     {
-        enemigos[i].x = rand() % (800 - 60);
-        enemigos[i].y = rand() % 200 + 50; // Aparecen en la parte superior
-        enemigos[i].ancho = 60;
-        enemigos[i].alto = 40;
-        enemigos[i].velocidad = 0.5f + (rand() % 100) / 100.0f; // Velocidad aleatoria
-        enemigos[i].vida = 2;
-        enemigos[i].activo = true;
-        enemigos[i].ultimo_disparo = 0;
-        enemigos[i].intervalo_disparo = 1.5 + (rand() % 200) / 100.0; // Dispara cada 1.5-3.5 segundos
-        enemigos[i].imagen = imagen_enemigo;
+        return true;
     }
+
+    return ((uint32_t)enemigos->manejador[i] & (CUBETAS_IA - 1)) == (paso & (CUBETAS_IA - 1));
 }
 
 
@@ -1530,19 +2640,28 @@ void init_enemigos(Enemigo enemigos[], int num_enemigos, ALLEGRO_BITMAP* imagen_
  * 
  * Esta función maneja el comportamiento específico de cada tipo de enemigo:
  * - Tipo 0 (Normal): Movimiento horizontal rebotando en bordes
- * - Tipo 1 (Perseguidor): Sigue a la nave cuando está en rango
+ * - Tipo 1 (Perseguidor): Sigue a la nave cuando está en rango, rodeando los tiles con el campo de flujo
  * - Tipo 2 (Francotirador): Dispara con precisión hacia la nave
  * - Tipo 3 (Tanque): Movimiento lento, disparo en abanico
- * - Tipo 4 (Kamikaze): Se lanza directamente hacia la nave
+ * - Tipo 4 (Kamikaze): Se lanza hacia la nave por el camino del campo de flujo
  * 
- * @param enemigos Arreglo de enemigos a actualizar.
- * @param num_enemigos Número de enemigos en el arreglo.
+ * Los disparos periódicos no se revisan acá: los ejecuta la agenda con
+ * disparo_programado_enemigo. Solo el perseguidor, que además necesita tener la nave
+ * cerca, dispara desde acá cuando su disparo ya está listo.
+ * 
+ * Perseguidores y kamikazes lejanos o fuera de la ventana deciden su movimiento una vez
+ * cada CUBETAS_IA pasos (ver enemigo_decide_ia) y en los pasos intermedios repiten el
+ * último desplazamiento.
+ * 
+ * @param enemigos Pool de enemigos a actualizar.
  * @param disparos_enemigos Arreglo de disparos de enemigos para ataques.
- * @param num_disparos_enemigos Número máximo de disparos de enemigos.
+ * @param pool_disparos_enemigos Pool de índices de los disparos enemigos.
  * @param tiempo_actual Tiempo actual del juego en segundos.
  * @param nave Nave del jugador (para persecución y cálculo de disparos).
+ * @param agenda Agenda donde el perseguidor programa su próximo disparo; su paso reparte las cubetas.
+ * @param campo Campo de flujo hacia la nave, ya actualizado para este paso.
  */
-void actualizar_enemigos(Enemigo enemigos[], int num_enemigos, Disparo disparos_enemigos[], int num_disparos_enemigos, double tiempo_actual,Nave nave)
+void actualizar_enemigos(PoolEnemigos *enemigos, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, double tiempo_actual, const Nave *nave, AgendaEventos *agenda, const CampoFlujo *campo)
 {
     int i;
 
@@ -1550,97 +2669,114 @@ void actualizar_enemigos(Enemigo enemigos[], int num_enemigos, Disparo disparos_
     float dy;
     float distancia;
     float rango_vision;
-    float norm;
     float velocidad_persecucion;
+    float direccion_x;
+    float direccion_y;
 
-    for (i = 0; i < num_enemigos; i++)
+    for (i = 0; i < enemigos->num_enemigos; i++)
     {
-        if (!enemigos[i].activo) continue;
+        if (!enemigos->activo[i]) continue;
 
-        switch (enemigos[i].tipo)
+        switch (enemigos->tipo[i])
         {
             case 0: // Enemigo normal
                 // Movimiento horizontal (de lado a lado)
-                enemigos[i].x += enemigos[i].velocidad;
-    
-                if (enemigos[i].x <= 0 || enemigos[i].x >= 800 - enemigos[i].ancho)
-                {
-                    enemigos[i].velocidad *= -1;
-                }
+                enemigos->x[i] += enemigos->velocidad[i];
     
-                if (tiempo_actual - enemigos[i].ultimo_disparo >= enemigos[i].intervalo_disparo)
+                if (enemigos->x[i] <= 0 || enemigos->x[i] >= 800 - enemigos->ancho[i])
                 {
-                    enemigo_disparar(disparos_enemigos, num_disparos_enemigos, enemigos[i]);
-                    enemigos[i].ultimo_disparo = tiempo_actual;
+                    enemigos->velocidad[i] *= -1;
                 }
                 break;
 
             case 1: // Enemigo perseguidor
+                if (!enemigo_decide_ia(enemigos, i, agenda->paso))
+                {
+                    enemigos->x[i] += enemigos->ia[i].vx;
+                    enemigos->y[i] += enemigos->ia[i].vy;
+                    break;
+                }
+
                 {
-                    dx = nave.x + nave.ancho/2 - (enemigos[i].x + enemigos[i].ancho/2);
-                    dy = nave.y + nave.largo/2 - (enemigos[i].y + enemigos[i].alto/2);
+                    dx = nave->x + nave->ancho/2 - (enemigos->x[i] + enemigos->ancho[i]/2);
+                    dy = nave->y + nave->largo/2 - (enemigos->y[i] + enemigos->alto[i]/2);
                     distancia = sqrt(dx*dx + dy*dy);
                     rango_vision = 250.0f;
+                    enemigos->ia[i].distancia_nave = distancia;
+                    enemigos->ia[i].vx = 0;
+                    enemigos->ia[i].vy = 0;
                     
                     if (distancia < rango_vision)
                     {
-                        norm = sqrt(dx*dx + dy*dy);
-                        if (norm > 0.1f) 
+                        velocidad_persecucion = enemigos->velocidad[i] * 1.5f;
+                        if (direccion_campo_flujo(campo, enemigos->x[i] + enemigos->ancho[i]/2, enemigos->y[i] + enemigos->alto[i]/2, &direccion_x, &direccion_y))
+                        {
+                            enemigos->ia[i].vx = direccion_x * velocidad_persecucion;
+                            enemigos->ia[i].vy = direccion_y * velocidad_persecucion;
+                        }
+                        else if (distancia > 0.1f)
                         {
-                            velocidad_persecucion = enemigos[i].velocidad * 1.5f;
-                            enemigos[i].x += (dx / norm) * velocidad_persecucion;
-                            enemigos[i].y += (dy / norm) * velocidad_persecucion;
+                            enemigos->ia[i].vx = (dx / distancia) * velocidad_persecucion;
+                            enemigos->ia[i].vy = (dy / distancia) * velocidad_persecucion;
                         }
+                        enemigos->x[i] += enemigos->ia[i].vx;
+                        enemigos->y[i] += enemigos->ia[i].vy;
 
-                        if (distancia < 150.0f && tiempo_actual - enemigos[i].ultimo_disparo >= enemigos[i].intervalo_disparo * 1.5f)
+                        if (distancia < 150.0f && enemigos->datos[i].disparo_listo)
                         {
-                            enemigo_disparar(disparos_enemigos, num_disparos_enemigos, enemigos[i]);
-                            enemigos[i].ultimo_disparo = tiempo_actual;
+                            enemigo_disparar(disparos_enemigos, pool_disparos_enemigos, enemigos, i);
+                            enemigos->datos[i].ultimo_disparo = tiempo_actual;
+                            enemigos->datos[i].disparo_listo = false;
+                            programar_disparo_enemigo(agenda, enemigos, i, tiempo_actual);
                         }
                     }
                 }
                 break;
 
-            case 2: // Francotirador
-                if (tiempo_actual - enemigos[i].ultimo_disparo >= enemigos[i].intervalo_disparo)
-                {
-                    francotirador_disparar(disparos_enemigos, num_disparos_enemigos, enemigos[i], nave);
-                    enemigos[i].ultimo_disparo = tiempo_actual;
-                }
+            case 2: // Francotirador, no se mueve
                 break;
 
             case 3: // Tanque
-                enemigos[i].x += enemigos[i].velocidad;
-    
-                if (enemigos[i].x <= 0 || enemigos[i].x >= 800 - enemigos[i].ancho)
-                {
-                    enemigos[i].velocidad *= -1;
-                }
+                enemigos->x[i] += enemigos->velocidad[i];
     
-                if (tiempo_actual - enemigos[i].ultimo_disparo >= enemigos[i].intervalo_disparo)
+                if (enemigos->x[i] <= 0 || enemigos->x[i] >= 800 - enemigos->ancho[i])
                 {
-                    tanque_disparar(disparos_enemigos, num_disparos_enemigos, enemigos[i]);
-                    enemigos[i].ultimo_disparo = tiempo_actual;
+                    enemigos->velocidad[i] *= -1;
                 }
                 break;
 
             case 4: // Kamikaze
+                if (!enemigo_decide_ia(enemigos, i, agenda->paso))
+                {
+                    enemigos->x[i] += enemigos->ia[i].vx;
+                    enemigos->y[i] += enemigos->ia[i].vy;
+                    break;
+                }
+
                 {
-                    dx = nave.x + nave.ancho/2 - (enemigos[i].x + enemigos[i].ancho/2);
-                    dy = nave.y + nave.largo/2 - (enemigos[i].y + enemigos[i].alto/2);
+                    dx = nave->x + nave->ancho/2 - (enemigos->x[i] + enemigos->ancho[i]/2);
+                    dy = nave->y + nave->largo/2 - (enemigos->y[i] + enemigos->alto[i]/2);
                     distancia = sqrt(dx*dx + dy*dy);
+                    enemigos->ia[i].distancia_nave = distancia;
                     
                     if (distancia > 10.0f)
                     {
-                        float velocidad_kamikaze = enemigos[i].velocidad * 2.0f;
-                        enemigos[i].x += (dx / distancia) * velocidad_kamikaze;
-                        enemigos[i].y += (dy / distancia) * velocidad_kamikaze;
+                        float velocidad_kamikaze = enemigos->velocidad[i] * 2.0f;
+                        if (!direccion_campo_flujo(campo, enemigos->x[i] + enemigos->ancho[i]/2, enemigos->y[i] + enemigos->alto[i]/2, &direccion_x, &direccion_y))
+                        {
+                            direccion_x = dx / distancia;
+                            direccion_y = dy / distancia;
+                        }
+                        enemigos->ia[i].vx = direccion_x * velocidad_kamikaze;
+                        enemigos->ia[i].vy = direccion_y * velocidad_kamikaze;
+                        enemigos->x[i] += enemigos->ia[i].vx;
+                        enemigos->y[i] += enemigos->ia[i].vy;
                     }
                     else
                     {
-                        nave.vida -= 35;
-                        enemigos[i].activo = false;
-                        printf("Enemigo kamikaze impactó! Vida restante: %.1f\n", nave.vida);
+                        // El choque no le resta vida a la nave: siempre se restaba sobre una copia
+                        eliminar_enemigo_pool(enemigos, i);
+                        TRAZA(TRAZA_ENEMIGOS, NIVEL_TRAZA_EVENTO, TRAZA_ENEMIGO_KAMIKAZE, nave->vida, 0);
                     }
                 }
                 break;
@@ -1649,40 +2785,174 @@ void actualizar_enemigos(Enemigo enemigos[], int num_enemigos, Disparo disparos_
 }
 
 
+/**
+ * @brief Convierte segundos en pasos de simulación, redondeando hacia arriba.
+ * 
+ * Un evento que vence a los s segundos se ejecuta en el primer paso en que la condición
+ * por tiempo que reemplaza ya se habría cumplido.
+ * 
+ * @param segundos Segundos a convertir.
+ * @return Pasos, al menos 1.
+ */
+static int segundos_a_pasos(double segundos)
+{
+    int pasos = (int)ceil(segundos * FPS - 1e-6);
+
+    return pasos < 1 ? 1 : pasos;
+}
+
+
+/**
+ * @brief Programa el próximo disparo de un enemigo según su último disparo y su intervalo.
+ * 
+ * Los kamikazes no disparan y no programan nada. El perseguidor espera una vez y media
+ * su intervalo, como antes.
+ * 
+ * @param agenda Agenda de la simulación.
+ * @param enemigos Pool de enemigos.
+ * @param i Posición del enemigo.
+ * @param tiempo_actual Tiempo actual del juego en segundos.
+ */
+void programar_disparo_enemigo(AgendaEventos *agenda, PoolEnemigos *enemigos, int i, double tiempo_actual)
+{
+    double intervalo;
+
+    if (enemigos->tipo[i] > 3)
+    {
+        return;
+    }
+
+    intervalo = enemigos->datos[i].intervalo_disparo;
+    if (enemigos->tipo[i] == 1)
+    {
+        intervalo *= 1.5f;
+    }
+
+    programar_evento(agenda, segundos_a_pasos(enemigos->datos[i].ultimo_disparo + intervalo - tiempo_actual), EVENTO_DISPARO_ENEMIGO, manejador_enemigo(enemigos, i));
+}
+
+
+/**
+ * @brief Programa el primer disparo de los enemigos desde una posición del pool hasta el final.
+ * 
+ * Se usa al cargar un nivel (desde 0) y después de cada invocación del jefe, que agrega
+ * los enemigos al final del rango usado.
+ * 
+ * @param agenda Agenda de la simulación.
+ * @param enemigos Pool de enemigos.
+ * @param desde Primera posición a programar.
+ * @param tiempo_actual Tiempo actual del juego en segundos.
+ */
+void programar_disparos_enemigos(AgendaEventos *agenda, PoolEnemigos *enemigos, int desde, double tiempo_actual)
+{
+    int i;
+
+    for (i = desde; i < enemigos->num_enemigos; i++)
+    {
+        if (enemigos->activo[i])
+        {
+            programar_disparo_enemigo(agenda, enemigos, i, tiempo_actual);
+        }
+    }
+}
+
+
+/**
+ * @brief Ejecuta el disparo programado de un enemigo y programa el siguiente.
+ * 
+ * Si el enemigo es un perseguidor y la nave no está cerca, el disparo queda listo y lo
+ * hace actualizar_enemigos cuando la nave se acerque; hasta entonces no se programa otro.
+ * 
+ * @param agenda Agenda de la simulación.
+ * @param enemigos Pool de enemigos.
+ * @param i Posición del enemigo, obtenida de su manejador.
+ * @param disparos_enemigos Arreglo de disparos de enemigos.
+ * @param pool_disparos_enemigos Pool de índices de los disparos enemigos.
+ * @param nave Nave del jugador (para el francotirador y el perseguidor).
+ * @param tiempo_actual Tiempo actual del juego en segundos.
+ */
+void disparo_programado_enemigo(AgendaEventos *agenda, PoolEnemigos *enemigos, int i, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, const Nave *nave, double tiempo_actual)
+{
+    float dx;
+    float dy;
+
+    switch (enemigos->tipo[i])
+    {
+        case 0:
+            enemigo_disparar(disparos_enemigos, pool_disparos_enemigos, enemigos, i);
+            break;
+
+        case 1:
+            dx = nave->x + nave->ancho/2 - (enemigos->x[i] + enemigos->ancho[i]/2);
+            dy = nave->y + nave->largo/2 - (enemigos->y[i] + enemigos->alto[i]/2);
+            if (sqrt(dx*dx + dy*dy) >= 150.0f)
+            {
+                enemigos->datos[i].disparo_listo = true;
+                return;
+            }
+            enemigo_disparar(disparos_enemigos, pool_disparos_enemigos, enemigos, i);
+            break;
+
+        case 2:
+            francotirador_disparar(disparos_enemigos, pool_disparos_enemigos, enemigos, i, nave);
+            break;
+
+        case 3:
+            tanque_disparar(disparos_enemigos, pool_disparos_enemigos, enemigos, i);
+            break;
+
+        default:
+            return;
+    }
+
+    enemigos->datos[i].ultimo_disparo = tiempo_actual;
+    programar_disparo_enemigo(agenda, enemigos, i, tiempo_actual);
+}
+
+
 /**
  * @brief Dibuja todos los enemigos activos en pantalla con sus sprites específicos.
  * 
- * Renderiza cada enemigo usando su imagen correspondiente según su tipo,
- * aplicando escalado y rotación si es necesario.
+ * Renderiza cada enemigo usando su imagen correspondiente según su tipo. Las imágenes
+ * ya tienen el tamaño de cada tipo (empaquetar_sprites_juego), así que no se escalan.
  * 
- * @param enemigos Arreglo de enemigos a dibujar.
- * @param num_enemigos Número total de enemigos en el arreglo.
+ * @param enemigos Pool de enemigos a dibujar.
  */
-void dibujar_enemigos(Enemigo enemigos[], int num_enemigos)
+void dibujar_enemigos(PoolEnemigos *enemigos)
 {
     int i;
     float porcentaje_vida;
 
-    for (i = 0; i < num_enemigos; i++)
+    // Todos los sprites vienen del atlas: se envían en un solo lote
+    al_hold_bitmap_drawing(true);
+    for (i = 0; i < enemigos->num_enemigos; i++)
     {
-        if (enemigos[i].activo)
+        if (enemigos->activo[i])
         {
             // Dibujar enemigo base
-            al_draw_scaled_bitmap(enemigos[i].imagen, 0, 0, al_get_bitmap_width(enemigos[i].imagen), al_get_bitmap_height(enemigos[i].imagen), enemigos[i].x, enemigos[i].y, enemigos[i].ancho, enemigos[i].alto, 0);
-            
+            al_draw_bitmap(enemigos->datos[i].imagen, enemigos->x[i], enemigos->y[i], 0);
+        }
+    }
+    al_hold_bitmap_drawing(false);
+
+    // Las barras son primitivas, van después de soltar el lote
+    for (i = 0; i < enemigos->num_enemigos; i++)
+    {
+        if (enemigos->activo[i])
+        {
             // Mostrar barra de vida para tanques
-            if (enemigos[i].tipo == 3)
+            if (enemigos->tipo[i] == 3)
             {
-                porcentaje_vida = enemigos[i].vida / enemigos[i].vida_max;
+                porcentaje_vida = enemigos->vida[i] / enemigos->datos[i].vida_max;
                 
                 // Fondo de la barra
-                al_draw_filled_rectangle(enemigos[i].x, enemigos[i].y - 8, enemigos[i].x + enemigos[i].ancho, enemigos[i].y - 4, al_map_rgba(100, 0, 0, 150));
+                al_draw_filled_rectangle(enemigos->x[i], enemigos->y[i] - 8, enemigos->x[i] + enemigos->ancho[i], enemigos->y[i] - 4, al_map_rgba(100, 0, 0, 150));
                 
                 // Vida actual
-                al_draw_filled_rectangle(enemigos[i].x, enemigos[i].y - 8, enemigos[i].x + (enemigos[i].ancho * porcentaje_vida), enemigos[i].y - 4, al_map_rgba(0, 255, 0, 200));
+                al_draw_filled_rectangle(enemigos->x[i], enemigos->y[i] - 8, enemigos->x[i] + (enemigos->ancho[i] * porcentaje_vida), enemigos->y[i] - 4, al_map_rgba(0, 255, 0, 200));
                 
                 // Borde
-                al_draw_rectangle(enemigos[i].x, enemigos[i].y - 8, enemigos[i].x + enemigos[i].ancho, enemigos[i].y - 4, al_map_rgba(255, 255, 255, 180), 1);
+                al_draw_rectangle(enemigos->x[i], enemigos->y[i] - 8, enemigos->x[i] + enemigos->ancho[i], enemigos->y[i] - 4, al_map_rgba(255, 255, 255, 180), 1);
             }
         }
     }
@@ -1696,24 +2966,32 @@ void dibujar_enemigos(Enemigo enemigos[], int num_enemigos)
  * los disparos que salen de los límites de la pantalla.
  * 
  * @param disparos Arreglo de disparos de enemigos.
- * @param num_disparos Número de disparos en el arreglo.
+ * @param pool_disparos Pool de índices de los disparos.
  */
-void actualizar_disparos_enemigos(Disparo disparos[], int num_disparos)
+void actualizar_disparos_enemigos(Disparo disparos[], PoolIndices *pool_disparos)
 {
     int i;
+    int k;
 
-    for(i = 0; i < num_disparos; i++)
+    // Se recorre al revés para poder liberar el disparo actual sin saltar ninguno
+    for (k = pool_disparos->num_vivos - 1; k >= 0; k--)
     {
-        if(disparos[i].activo)
+        i = pool_disparos->vivos[k];
+
+        if (!disparos[i].activo)
         {
-            disparos[i].x += cos(disparos[i].angulo) * disparos[i].velocidad;
-            disparos[i].y += sin(disparos[i].angulo) * disparos[i].velocidad;
+            liberar_indice_pool(pool_disparos, i);
+            continue;
+        }
 
-            // Desactivar si sale de la pantalla
-            if (disparos[i].y > 600 || disparos[i].x < 0 || disparos[i].x > 800)
-            {
-                disparos[i].activo = false;
-            }
+        disparos[i].x += cos(disparos[i].angulo) * disparos[i].velocidad;
+        disparos[i].y += sin(disparos[i].angulo) * disparos[i].velocidad;
+
+        // Desactivar si sale de la pantalla
+        if (disparos[i].y > 600 || disparos[i].x < 0 || disparos[i].x > 800)
+        {
+            disparos[i].activo = false;
+            liberar_indice_pool(pool_disparos, i);
         }
     }
 }
@@ -1723,14 +3001,16 @@ void actualizar_disparos_enemigos(Disparo disparos[], int num_disparos)
  * @brief Dibuja todos los disparos activos de los enemigos en pantalla.
  * 
  * @param disparos Arreglo de disparos de enemigos.
- * @param num_disparos Número total de disparos de enemigos.
+ * @param pool_disparos Pool de índices de los disparos.
  */
-void dibujar_disparos_enemigos(Disparo disparos[], int num_disparos)
+void dibujar_disparos_enemigos(Disparo disparos[], PoolIndices *pool_disparos)
 {
     int i;
+    int k;
 
-    for (i = 0; i < num_disparos; i++)
+    for (k = 0; k < pool_disparos->num_vivos; k++)
     {
+        i = pool_disparos->vivos[k];
         if (disparos[i].activo)
         {
             al_draw_filled_rectangle(disparos[i].x, disparos[i].y, disparos[i].x + 4, disparos[i].y + 8, al_map_rgb(255, 255, 0)); // Disparos amarillos
@@ -1742,28 +3022,28 @@ void dibujar_disparos_enemigos(Disparo disparos[], int num_disparos)
 /**
  * @brief Hace que un enemigo dispare un proyectil.
  * 
- * Busca un disparo inactivo en el arreglo y lo activa, posicionándolo en la parte inferior del enemigo.
+ * Toma un disparo libre del pool y lo activa, posicionándolo en la parte inferior del enemigo.
  * 
  * @param disparos Arreglo de disparos de enemigos.
- * @param num_disparos Número total de disparos de enemigos.
- * @param enemigo Enemigo que realiza el disparo.
+ * @param pool_disparos Pool de índices de los disparos.
+ * @param enemigos Pool de enemigos.
+ * @param e Indice del enemigo que realiza el disparo.
  */
-void enemigo_disparar(Disparo disparos[], int num_disparos, Enemigo enemigo)
+void enemigo_disparar(Disparo disparos[], PoolIndices *pool_disparos, PoolEnemigos *enemigos, int e)
 {
     int i;
 
-    for(i = 0; i < num_disparos; i++)
+    i = obtener_indice_pool(pool_disparos);
+    if (i < 0)
     {
-        if (!disparos[i].activo)
-        {
-            disparos[i].x = enemigo.x + enemigo.ancho / 2;
-            disparos[i].y = enemigo.y + enemigo.alto;
-            disparos[i].velocidad = 3.0f; // Disparan hacia abajo
-            disparos[i].angulo = ALLEGRO_PI / 2; // Disparan hacia abajo
-            disparos[i].activo = true;
-            break;
-        }
+        return;
     }
+
+    disparos[i].x = enemigos->x[e] + enemigos->ancho[e] / 2;
+    disparos[i].y = enemigos->y[e] + enemigos->alto[e];
+    disparos[i].velocidad = 3.0f; // Disparan hacia abajo
+    disparos[i].angulo = ALLEGRO_PI / 2; // Disparan hacia abajo
+    disparos[i].activo = true;
 }
 
 
@@ -1771,12 +3051,13 @@ void enemigo_disparar(Disparo disparos[], int num_disparos, Enemigo enemigo)
  * @brief Detecta colisión entre disparo del jugador y enemigo.
  * 
  * @param disparo Disparo del jugador.
- * @param enemigo Enemigo a verificar.
+ * @param enemigos Pool de enemigos.
+ * @param i Indice del enemigo a verificar.
  * @return true si hay colisión.
  */
-bool detectar_colision_disparo_enemigo(Disparo disparo, Enemigo enemigo)
+bool detectar_colision_disparo_enemigo(Disparo disparo, PoolEnemigos *enemigos, int i)
 {
-    return detectar_colision_generica(disparo.x, disparo.y, 5, 10, enemigo.x, enemigo.y, enemigo.ancho, enemigo.alto);
+    return detectar_colision_generica(disparo.x, disparo.y, 5, 10, enemigos->x[i], enemigos->y[i], enemigos->ancho[i], enemigos->alto[i]);
 }
 
 
@@ -1784,12 +3065,13 @@ bool detectar_colision_disparo_enemigo(Disparo disparo, Enemigo enemigo)
  * @brief Detecta colisión entre nave del jugador y enemigo.
  * 
  * @param nave Nave del jugador.
- * @param enemigo Enemigo a verificar.
+ * @param enemigos Pool de enemigos.
+ * @param i Indice del enemigo a verificar.
  * @return true si hay colisión.
  */
-bool detectar_colision_nave_enemigo(Nave nave, Enemigo enemigo)
+bool detectar_colision_nave_enemigo(const Nave *nave, PoolEnemigos *enemigos, int i)
 {
-    return detectar_colision_generica(nave.x, nave.y, nave.ancho, nave.largo, enemigo.x, enemigo.y, enemigo.ancho, enemigo.alto);
+    return detectar_colision_generica(nave->x, nave->y, nave->ancho, nave->largo, enemigos->x[i], enemigos->y[i], enemigos->ancho[i], enemigos->alto[i]);
 }
 
 
@@ -1800,9 +3082,9 @@ bool detectar_colision_nave_enemigo(Nave nave, Enemigo enemigo)
  * @param disparo Disparo del enemigo.
  * @return true si hay colisión.
  */
-bool detectar_colision_disparo_enemigo_nave(Nave nave, Disparo disparo)
+bool detectar_colision_disparo_enemigo_nave(const Nave *nave, Disparo disparo)
 {
-    return detectar_colision_generica(disparo.x, disparo.y, 4, 8, nave.x, nave.y, nave.ancho, nave.largo);
+    return detectar_colision_generica(disparo.x, disparo.y, 4, 8, nave->x, nave->y, nave->ancho, nave->largo);
 }
 
 
@@ -1819,10 +3101,10 @@ bool detectar_colision_disparo_enemigo_nave(Nave nave, Disparo disparo)
  * - Nivel 2: 5 disparos con separación de 15 grados
  * 
  * @param disparos Arreglo de disparos disponibles.
- * @param num_disparos Número total de disparos en el arreglo.
+ * @param pool_disparos Pool de índices de los disparos.
  * @param nave Nave que ejecuta el disparo radial.
  */
-void disparar_radial(Disparo disparos[], int num_disparos, Nave nave)
+void disparar_radial(Disparo disparos[], PoolIndices *pool_disparos, const Nave *nave)
 {
     float centro_x;
     float centro_y;
@@ -1836,26 +3118,26 @@ void disparar_radial(Disparo disparos[], int num_disparos, Nave nave)
     float punta_y;
     int indice_angulo;
 
-    if (nave.nivel_disparo_radial == 0) 
+    if (nave->nivel_disparo_radial == 0) 
     {
-        disparar(disparos, num_disparos, nave);
+        disparar(disparos, pool_disparos, nave);
         return;
     }
 
     // Calcular el centro de la nave
-    centro_x = nave.x + nave.ancho / 2.0f;
-    centro_y = nave.y + nave.largo / 2.0f;
+    centro_x = nave->x + nave->ancho / 2.0f;
+    centro_y = nave->y + nave->largo / 2.0f;
 
     //num_disparos_radiales;
     //separacion_angular;
 
     // Determinar número de disparos según el nivel
-    if (nave.nivel_disparo_radial == 1) 
+    if (nave->nivel_disparo_radial == 1) 
     {
         num_disparos_radiales = 3; // Cambiar a 3 disparos para mejor distribución
         separacion_angular = ALLEGRO_PI / 8; // 22.5 grados entre disparos
     } 
-    else if (nave.nivel_disparo_radial == 2) 
+    else if (nave->nivel_disparo_radial == 2) 
     {
         num_disparos_radiales = 5;
         separacion_angular = ALLEGRO_PI / 12; // 15 grados entre disparos (más cerrado)
@@ -1864,36 +3146,36 @@ void disparar_radial(Disparo disparos[], int num_disparos, Nave nave)
     if (num_disparos_radiales == 3)
     {
         // 3 disparos: izquierda, centro, derecha
-        angulos[0] = nave.angulo - ALLEGRO_PI/2 - separacion_angular; // Izquierda
-        angulos[1] = nave.angulo - ALLEGRO_PI/2;                     // Centro
-        angulos[2] = nave.angulo - ALLEGRO_PI/2 + separacion_angular; // Derecha
+        angulos[0] = nave->angulo - ALLEGRO_PI/2 - separacion_angular; // Izquierda
+        angulos[1] = nave->angulo - ALLEGRO_PI/2;                     // Centro
+        angulos[2] = nave->angulo - ALLEGRO_PI/2 + separacion_angular; // Derecha
     }
     else
     {
         for (j = 0; j < 5; j++)
         {
             offset = j - 2;
-            angulos[j] = nave.angulo - ALLEGRO_PI/2 + offset * separacion_angular;
+            angulos[j] = nave->angulo - ALLEGRO_PI/2 + offset * separacion_angular;
         }
     }
 
     // Calcular posición de disparo desde la punta de la nave
-    punta_x = centro_x + cos(nave.angulo - ALLEGRO_PI/2) * (nave.largo / 2.0f);
-    punta_y = centro_y + sin(nave.angulo - ALLEGRO_PI/2) * (nave.largo / 2.0f);
+    punta_x = centro_x + cos(nave->angulo - ALLEGRO_PI/2) * (nave->largo / 2.0f);
+    punta_y = centro_y + sin(nave->angulo - ALLEGRO_PI/2) * (nave->largo / 2.0f);
 
-    indice_angulo = 0;
-    for (i = 0; i < num_disparos && indice_angulo < num_disparos_radiales; i++)
+    for (indice_angulo = 0; indice_angulo < num_disparos_radiales; indice_angulo++)
     {
-        if (!disparos[i].activo)
+        i = obtener_indice_pool(pool_disparos);
+        if (i < 0)
         {
-            disparos[i].x = punta_x;
-            disparos[i].y = punta_y;
-            disparos[i].velocidad = 10;
-            disparos[i].angulo = angulos[indice_angulo]; // Usar el ángulo precalculado
-            disparos[i].activo = true;
-            
-            indice_angulo++; // Avanzar al siguiente ángulo
+            break; // No quedan disparos libres
         }
+
+        disparos[i].x = punta_x;
+        disparos[i].y = punta_y;
+        disparos[i].velocidad = 10;
+        disparos[i].angulo = angulos[indice_angulo]; // Usar el ángulo precalculado
+        disparos[i].activo = true;
     }
 }
 
@@ -1927,22 +3209,53 @@ void verificar_mejora_disparo_radial(Nave *nave, ColaMensajes* cola_mensajes)
 
 
 
-void dibujar_nivel_powerup(Nave nave, ALLEGRO_FONT* fuente)
+void dibujar_nivel_powerup(const Nave *nave, ALLEGRO_FONT* fuente)
 {
     char texto_powerup[50];
-    if (nave.nivel_disparo_radial == 0)
+    if (nave->nivel_disparo_radial == 0)
     {
-        sprintf(texto_powerup, "Radial: Desactivado (%d/16)", nave.kills_para_mejora);
+        sprintf(texto_powerup, "Radial: Desactivado (%d/16)", nave->kills_para_mejora);
     }
     else
     {
-        sprintf(texto_powerup, "Radial Nv.%d (%d/16)", nave.nivel_disparo_radial, nave.kills_para_mejora);
+        sprintf(texto_powerup, "Radial Nv.%d (%d/16)", nave->nivel_disparo_radial, nave->kills_para_mejora);
     }
 
     al_draw_text(fuente, al_map_rgb(255, 255, 0), 10, 70, ALLEGRO_ALIGN_LEFT, texto_powerup);
 }
 
 
+/**
+ * @brief Reloj de la simulación, avanza DT_SIMULACION por paso y no depende del tiempo real.
+ */
+static double reloj_juego = TIEMPO_INICIAL_SIMULACION;
+
+
+/**
+ * @brief Devuelve el tiempo de juego actual.
+ * 
+ * Todo lo que mide duraciones de la partida (cooldowns, powerups, mensajes, explosiones)
+ * usa este reloj en vez de al_get_time(), así una caída de frames no cambia el juego.
+ * 
+ * @return Tiempo de juego en segundos.
+ */
+double tiempo_juego(void)
+{
+    return reloj_juego;
+}
+
+
+/**
+ * @brief Fija el tiempo de juego, lo llama la simulación en cada paso.
+ * 
+ * @param tiempo Nuevo tiempo de juego en segundos.
+ */
+void fijar_tiempo_juego(double tiempo)
+{
+    reloj_juego = tiempo;
+}
+
+
 void init_mensaje(Mensaje *mensaje)
 {
     mensaje->activo = false;
@@ -1960,7 +3273,7 @@ void mostrar_mensaje(Mensaje *mensaje, const char *texto, float x, float y, doub
 
     mensaje->x = x;
     mensaje->y = y;
-    mensaje->tiempo_inicio = al_get_time();
+    mensaje->tiempo_inicio = tiempo_juego();
     mensaje->duracion = duracion;
     mensaje->activo = true;
     mensaje->color = color;
@@ -1982,7 +3295,7 @@ void dibujar_mensaje(Mensaje mensaje, ALLEGRO_FONT* fuente)
     int alto_texto = al_get_font_line_height(fuente);
     float x_final;
     float y_final;
-    double tiempo_transcurrido = al_get_time() - mensaje.tiempo_inicio;
+    double tiempo_transcurrido = tiempo_juego() - mensaje.tiempo_inicio;
     double progreso = tiempo_transcurrido / mensaje.duracion;
     float alpha = 1.0f;
     unsigned char r;
@@ -2051,14 +3364,12 @@ void init_estado_juego(EstadoJuego *estado)
 /**
  * @brief Verifica si todos los enemigos del nivel han sido eliminados.
  * 
- * @param enemigos Arreglo de enemigos del nivel.
- * @param num_enemigos Número de enemigos en el arreglo.
+ * @param enemigos Pool de enemigos del nivel.
  * @return true si todos los enemigos están inactivos, false en caso contrario.
  */
-bool verificar_nivel_completado(Enemigo enemigos[], int num_enemigos, bool hay_jefe_en_nivel, Jefe *jefe)
+bool verificar_nivel_completado(PoolEnemigos *enemigos, bool hay_jefe_en_nivel, Jefe *jefe)
 {
-    int i;
-    int enemigos_activos = 0;
+    int enemigos_activos = enemigos->num_activos;
     bool jefe_activo = false;
 
     if (hay_jefe_en_nivel && jefe != NULL) 
@@ -2066,32 +3377,24 @@ bool verificar_nivel_completado(Enemigo enemigos[], int num_enemigos, bool hay_j
         if (jefe->activo)
         {
             jefe->activo = true;
-            printf("Jefe sigue activo\n");
+            TRAZA(TRAZA_NIVEL, NIVEL_TRAZA_DETALLE, TRAZA_NIVEL_JEFE_ACTIVO, 1, 0);
         }
         else
         {
-            printf("Jefe ha sido derrotado\n");
+            TRAZA(TRAZA_NIVEL, NIVEL_TRAZA_DETALLE, TRAZA_NIVEL_JEFE_ACTIVO, 0, 0);
         }
     }
 
-    for (i = 0; i < num_enemigos; i++)
-    {
-        if (enemigos[i].activo)
-        {
-            enemigos_activos++;
-        }
-    }
-    
     if (hay_jefe_en_nivel)
     {
         if (jefe_activo || enemigos_activos > 0)
         {
-            printf("DEBUG: Nivel no completado - Jefe: %s, Enemigos: %d\n", jefe_activo ? "VIVO" : "MUERTO", enemigos_activos);
+            TRAZA(TRAZA_NIVEL, NIVEL_TRAZA_DETALLE, TRAZA_NIVEL_PENDIENTE, enemigos_activos, 0);
             return false; // Nivel no completado
         }
         else
         {
-            printf("DEBUG: NIVEL CON JEFE COMPLETADO! Jefe y todos los enemigos eliminados\n");
+            TRAZA(TRAZA_NIVEL, NIVEL_TRAZA_EVENTO, TRAZA_NIVEL_COMPLETADO, 0, 0);
             return true; // Nivel completado: ni jefe ni enemigos
         }
     }
@@ -2100,12 +3403,12 @@ bool verificar_nivel_completado(Enemigo enemigos[], int num_enemigos, bool hay_j
         // En niveles sin jefe, solo verificar enemigos normales
         if (enemigos_activos > 0)
         {
-            printf("DEBUG: Nivel normal no completado - Enemigos restantes: %d\n", enemigos_activos);
+            TRAZA(TRAZA_NIVEL, NIVEL_TRAZA_DETALLE, TRAZA_NIVEL_PENDIENTE, enemigos_activos, 0);
             return false;
         }
         else
         {
-            printf("DEBUG: NIVEL NORMAL COMPLETADO! Todos los enemigos eliminados\n");
+            TRAZA(TRAZA_NIVEL, NIVEL_TRAZA_EVENTO, TRAZA_NIVEL_COMPLETADO, 0, 0);
             return true;
         }
     }
@@ -2230,24 +3533,22 @@ void mostrar_pantalla_transicion(int nivel_completado, int siguiente_nivel, ALLE
 
 
 /**
- * @brief Carga el siguiente nivel del juego.
+ * @brief Carga un nivel desde un archivo con el formato de los NivelN.txt.
  * 
- * @param nivel Número del nivel a cargar.
+ * @param nombre_archivo Archivo del nivel.
  * @param tilemap Matriz de tiles del nivel.
  * @param enemigos_mapa Arreglo donde se cargarán los enemigos del nivel.
  * @param num_enemigos_cargados Puntero al número de enemigos cargados.
  * @param imagen_enemigo Imagen del enemigo.
  * @param nave_x Puntero a la coordenada x inicial de la nave.
  * @param nave_y Puntero a la coordenada y inicial de la nave.
- * @return true si se cargó correctamente, false si no existe el nivel.
+ * @param aleatorio Generador para los intervalos de disparo de los enemigos.
+ * @return true si se cargó correctamente, false si no existe el archivo.
  */
-bool cargar_siguiente_nivel(int nivel, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Enemigo enemigos_mapa[], int* num_enemigos_cargados, ALLEGRO_BITMAP* imagen_enemigo, float* nave_x, float* nave_y) {
-    char nombre_archivo[50];
+bool cargar_nivel_archivo(const char *nombre_archivo, Tilemap *tilemap, Enemigo enemigos_mapa[], int* num_enemigos_cargados, ALLEGRO_BITMAP* imagen_enemigo, float* nave_x, float* nave_y, GeneradorAleatorio *aleatorio) {
     int f;
     int c;
 
-    sprintf(nombre_archivo, "Nivel%d.txt", nivel);
-    
     // Verificar si el archivo existe
     FILE* test = fopen(nombre_archivo, "r");
     if (!test) {
@@ -2259,13 +3560,38 @@ bool cargar_siguiente_nivel(int nivel, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS],
     // Limpiar el tilemap anterior
     for (f = 0; f < MAPA_FILAS; f++) {
         for (c = 0; c < MAPA_COLUMNAS; c++) {
-            tilemap[f][c].tipo = 0;
-            tilemap[f][c].vida = 0;
+            tilemap->celdas[f][c].tipo = 0;
+            tilemap->celdas[f][c].vida = 0;
         }
     }
     
     // Cargar el nuevo nivel
-    cargar_tilemap(nombre_archivo, tilemap, enemigos_mapa, num_enemigos_cargados, imagen_enemigo, nave_x, nave_y);
+    cargar_tilemap(nombre_archivo, tilemap, enemigos_mapa, num_enemigos_cargados, imagen_enemigo, nave_x, nave_y, aleatorio);
+    actualizar_mascaras_tilemap(tilemap);
+    return true;
+}
+
+/**
+ * @brief Carga el siguiente nivel del juego.
+ * 
+ * @param nivel Número del nivel a cargar.
+ * @param tilemap Matriz de tiles del nivel.
+ * @param enemigos_mapa Arreglo donde se cargarán los enemigos del nivel.
+ * @param num_enemigos_cargados Puntero al número de enemigos cargados.
+ * @param imagen_enemigo Imagen del enemigo.
+ * @param nave_x Puntero a la coordenada x inicial de la nave.
+ * @param nave_y Puntero a la coordenada y inicial de la nave.
+ * @param aleatorio Generador para los intervalos de disparo de los enemigos.
+ * @return true si se cargó correctamente, false si no existe el nivel.
+ */
+bool cargar_siguiente_nivel(int nivel, Tilemap *tilemap, Enemigo enemigos_mapa[], int* num_enemigos_cargados, ALLEGRO_BITMAP* imagen_enemigo, float* nave_x, float* nave_y, GeneradorAleatorio *aleatorio) {
+    char nombre_archivo[50];
+
+    sprintf(nombre_archivo, "Nivel%d.txt", nivel);
+
+    if (!cargar_nivel_archivo(nombre_archivo, tilemap, enemigos_mapa, num_enemigos_cargados, imagen_enemigo, nave_x, nave_y, aleatorio)) {
+        return false;
+    }
     
     printf("Nivel %d cargado: %d enemigos encontrados.\n", nivel, *num_enemigos_cargados);
     return true;
@@ -2275,13 +3601,12 @@ bool cargar_siguiente_nivel(int nivel, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS],
  * @brief Actualiza el estado del nivel y maneja las transiciones.
  * 
  * @param estado Puntero al estado del juego.
- * @param enemigos Arreglo de enemigos del nivel actual.
- * @param num_enemigos Número de enemigos en el arreglo.
+ * @param enemigos Pool de enemigos del nivel actual.
  * @param tiempo_actual Tiempo actual del juego.
  */
-void actualizar_estado_nivel(EstadoJuego* estado, Enemigo enemigos[], int num_enemigos, double tiempo_actual, bool hay_jefe_en_nivel, Jefe *jefe) {
+void actualizar_estado_nivel(EstadoJuego* estado, PoolEnemigos *enemigos, double tiempo_actual, bool hay_jefe_en_nivel, Jefe *jefe) {
     // Verificar si todos los enemigos han sido eliminados
-    if (!estado->todos_enemigos_eliminados && verificar_nivel_completado(enemigos, num_enemigos, hay_jefe_en_nivel, jefe)) 
+    if (!estado->todos_enemigos_eliminados && verificar_nivel_completado(enemigos, hay_jefe_en_nivel, jefe)) 
     {
         estado->todos_enemigos_eliminados = true;
         estado->mostrar_transicion = true;
@@ -2323,8 +3648,9 @@ bool asteroides_activados(int nivel_actual)
  * @param fila Fila en el tilemap donde aparecerá.
  * @param tipo Tipo de enemigo (0-4).
  * @param imagen_enemigo Imagen temporal (se reemplazará por la específica después).
+ * @param aleatorio Generador para el intervalo de disparo.
  */
-void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BITMAP* imagen_enemigo)
+void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BITMAP* imagen_enemigo, GeneradorAleatorio *aleatorio)
 {
     enemigo->x = col * TILE_ANCHO;
     enemigo->y = fila * TILE_ALTO;
@@ -2336,17 +3662,17 @@ void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BI
     switch (tipo)
     {
         case 0: // Enemigo normal
-            enemigo->ancho = 50;
-            enemigo->alto = 40;
+            enemigo->ancho = tamanos_enemigos[0].ancho;
+            enemigo->alto = tamanos_enemigos[0].alto;
             enemigo->velocidad = 1.0f;
             enemigo->vida = 2.0f;
             enemigo->vida_max = 2;
-            enemigo->intervalo_disparo = 2.0 + (rand() % 100) / 100.0;
+            enemigo->intervalo_disparo = 2.0 + (aleatorio_entero(aleatorio, 100)) / 100.0;
             break;
             
         case 1: // Perseguidor
-            enemigo->ancho = 45;
-            enemigo->alto = 35;
+            enemigo->ancho = tamanos_enemigos[1].ancho;
+            enemigo->alto = tamanos_enemigos[1].alto;
             enemigo->velocidad = 0.8f;
             enemigo->vida = 2.0f;
             enemigo->vida_max = 2;
@@ -2354,8 +3680,8 @@ void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BI
             break;
             
         case 2: // Francotirador
-            enemigo->ancho = 40;
-            enemigo->alto = 30;
+            enemigo->ancho = tamanos_enemigos[2].ancho;
+            enemigo->alto = tamanos_enemigos[2].alto;
             enemigo->velocidad = 0; // Inmóvil
             enemigo->vida = 1.0f;
             enemigo->vida_max = 1;
@@ -2363,8 +3689,8 @@ void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BI
             break;
             
         case 3: // Tanque
-            enemigo->ancho = 70;
-            enemigo->alto = 50;
+            enemigo->ancho = tamanos_enemigos[3].ancho;
+            enemigo->alto = tamanos_enemigos[3].alto;
             enemigo->velocidad = 0.3f;
             enemigo->vida = 6.0f;
             enemigo->vida_max = 6;
@@ -2372,8 +3698,8 @@ void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BI
             break;
             
         case 4: // Kamikaze
-            enemigo->ancho = 35;
-            enemigo->alto = 30;
+            enemigo->ancho = tamanos_enemigos[4].ancho;
+            enemigo->alto = tamanos_enemigos[4].alto;
             enemigo->velocidad = 1.5f;
             enemigo->vida = 1.0f;
             enemigo->vida_max = 1;
@@ -2381,8 +3707,8 @@ void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BI
             break;
 
         case 5: // Jefe Destructor
-            enemigo->ancho = 120;
-            enemigo->alto = 80;
+            enemigo->ancho = tamanos_jefes[0].ancho;
+            enemigo->alto = tamanos_jefes[0].alto;
             enemigo->velocidad = 1.0f;
             enemigo->vida = 150.0f;
             enemigo->vida_max = 150.0f;
@@ -2390,8 +3716,8 @@ void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BI
             break;
     
         case 6: // Jefe Supremo
-            enemigo->ancho = 160;
-            enemigo->alto = 100;
+            enemigo->ancho = tamanos_jefes[1].ancho;
+            enemigo->alto = tamanos_jefes[1].alto;
             enemigo->velocidad = 1.5f;
             enemigo->vida = 250.0f;
             enemigo->vida_max = 250.0f;
@@ -2400,8 +3726,8 @@ void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BI
             
         default:
             // Valores por defecto
-            enemigo->ancho = 50;
-            enemigo->alto = 40;
+            enemigo->ancho = tamanos_enemigos[0].ancho;
+            enemigo->alto = tamanos_enemigos[0].alto;
             enemigo->velocidad = 1.0f;
             enemigo->vida = 1.0f;
             enemigo->vida_max = 1;
@@ -2409,7 +3735,7 @@ void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BI
             break;
     }
 
-    printf("Enemigo tipo %d inicializado: vel=%.1f, vida=%.1f, tamaño=%dx%d\n", tipo, enemigo->velocidad, enemigo->vida, (int)enemigo->ancho, (int)enemigo->alto);
+    TRAZA(TRAZA_ENEMIGOS, NIVEL_TRAZA_EVENTO, TRAZA_ENEMIGO_CREADO, tipo, enemigo->vida);
 }
 
 
@@ -2420,34 +3746,34 @@ void init_enemigo_tipo(Enemigo* enemigo, int col, int fila, int tipo, ALLEGRO_BI
  * dirigido con alta precisión.
  * 
  * @param disparos Arreglo de disparos de enemigos.
- * @param num_disparos Número total de disparos disponibles.
- * @param enemigo Enemigo francotirador que realiza el disparo.
+ * @param pool_disparos Pool de índices de los disparos.
+ * @param enemigos Pool de enemigos.
+ * @param e Indice del francotirador que realiza el disparo.
  * @param nave Nave objetivo para calcular la trayectoria.
  */
-void francotirador_disparar(Disparo disparos[], int num_disparos, Enemigo enemigo, Nave nave)
+void francotirador_disparar(Disparo disparos[], PoolIndices *pool_disparos, PoolEnemigos *enemigos, int e, const Nave *nave)
 {
     int i;
     float dx;
     float dy;
     float angulo_hacia_nave;
 
-    for(i = 0; i < num_disparos; i++)
+    i = obtener_indice_pool(pool_disparos);
+    if (i < 0)
     {
-        if (!disparos[i].activo)
-        {
-            // Calcular ángulo hacia la nave
-            dx = nave.x + nave.ancho/2 - (enemigo.x + enemigo.ancho/2);
-            dy = nave.y + nave.largo/2 - (enemigo.y + enemigo.alto/2);
-            angulo_hacia_nave = atan2(dy, dx);
-            
-            disparos[i].x = enemigo.x + enemigo.ancho / 2;
-            disparos[i].y = enemigo.y + enemigo.alto;
-            disparos[i].velocidad = 4.0f; // Más rápido que disparos normales
-            disparos[i].angulo = angulo_hacia_nave;
-            disparos[i].activo = true;
-            break;
-        }
+        return;
     }
+
+    // Calcular ángulo hacia la nave
+    dx = nave->x + nave->ancho/2 - (enemigos->x[e] + enemigos->ancho[e]/2);
+    dy = nave->y + nave->largo/2 - (enemigos->y[e] + enemigos->alto[e]/2);
+    angulo_hacia_nave = atan2(dy, dx);
+    
+    disparos[i].x = enemigos->x[e] + enemigos->ancho[e] / 2;
+    disparos[i].y = enemigos->y[e] + enemigos->alto[e];
+    disparos[i].velocidad = 4.0f; // Más rápido que disparos normales
+    disparos[i].angulo = angulo_hacia_nave;
+    disparos[i].activo = true;
 }
 
 
@@ -2458,10 +3784,11 @@ void francotirador_disparar(Disparo disparos[], int num_disparos, Enemigo enemig
  * para cubrir un área más amplia de ataque.
  * 
  * @param disparos Arreglo de disparos de enemigos.
- * @param num_disparos Número total de disparos disponibles.
- * @param enemigo Enemigo tanque que realiza el disparo.
+ * @param pool_disparos Pool de índices de los disparos.
+ * @param enemigos Pool de enemigos.
+ * @param e Indice del tanque que realiza el disparo.
  */
-void tanque_disparar(Disparo disparos[], int num_disparos, Enemigo enemigo)
+void tanque_disparar(Disparo disparos[], PoolIndices *pool_disparos, PoolEnemigos *enemigos, int e)
 {
     // El tanque dispara 3 proyectiles en abanico
     float angulos[3] = {
@@ -2470,20 +3797,22 @@ void tanque_disparar(Disparo disparos[], int num_disparos, Enemigo enemigo)
         ALLEGRO_PI / 2 + 0.3f  // Derecha
     };
     
-    int disparos_creados = 0;
+    int disparos_creados;
     int i;
 
-    for(i = 0; i < num_disparos && disparos_creados < 3; i++)
+    for (disparos_creados = 0; disparos_creados < 3; disparos_creados++)
     {
-        if (!disparos[i].activo)
+        i = obtener_indice_pool(pool_disparos);
+        if (i < 0)
         {
-            disparos[i].x = enemigo.x + enemigo.ancho / 2;
-            disparos[i].y = enemigo.y + enemigo.alto;
-            disparos[i].velocidad = 2.5f; // Más lento pero más daño
-            disparos[i].angulo = angulos[disparos_creados];
-            disparos[i].activo = true;
-            disparos_creados++;
+            break; // No quedan disparos libres
         }
+
+        disparos[i].x = enemigos->x[e] + enemigos->ancho[e] / 2;
+        disparos[i].y = enemigos->y[e] + enemigos->alto[e];
+        disparos[i].velocidad = 2.5f; // Más lento pero más daño
+        disparos[i].angulo = angulos[disparos_creados];
+        disparos[i].activo = true;
     }
 }
 
@@ -2506,68 +3835,78 @@ void init_powerup(Powerup *powerup)
 }
 
 
-void crear_powerup_escudo(Powerup powerups[], int max_powerups, float x, float y)
+void crear_powerup_escudo(Powerup powerups[], PoolIndices *pool_powerups, float x, float y)
 {
     int i;
 
-    for (i = 0; i < max_powerups; i++)
+    i = obtener_indice_pool(pool_powerups);
+    if (i < 0)
     {
-        if (!powerups[i].activo)
-        {
-            powerups[i].x = x;
-            powerups[i].y = y;
-            powerups[i].tipo = 0;
-            powerups[i].activo = true;
-            powerups[i].tiempo_aparicion = al_get_time();
-            powerups[i].duracion_vida = 20.0;
-            powerups[i].color = al_map_rgb(0, 255, 255);
-            printf("Powerup de escudo creado en (%.0f, %.0f)\n", x, y);
-            break;
-        }
+        return;
     }
+
+    powerups[i].x = x;
+    powerups[i].y = y;
+    powerups[i].tipo = 0;
+    powerups[i].activo = true;
+    powerups[i].tiempo_aparicion = tiempo_juego();
+    powerups[i].duracion_vida = 20.0;
+    powerups[i].color = al_map_rgb(0, 255, 255);
+    TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_CREADO, powerups[i].tipo, i);
 }
 
 
-void actualizar_powerups(Powerup powerups[], int max_powerups, double tiempo_actual)
+void actualizar_powerups(Powerup powerups[], PoolIndices *pool_powerups, double tiempo_actual)
 {
     int i;
+    int k;
     static double ultimo_debug = 0;
     double tiempo_restante;
 
-    for (i = 0; i < max_powerups; i++)
+    // Se recorre al revés para poder liberar el powerup actual sin saltar ninguno
+    for (k = pool_powerups->num_vivos - 1; k >= 0; k--)
     {
-        if (powerups[i].activo)
+        i = pool_powerups->vivos[k];
+
+        // Powerups recogidos o destruidos desde el frame anterior
+        if (!powerups[i].activo)
         {
-            powerups[i].y += 1.5f;
+            liberar_indice_pool(pool_powerups, i);
+            continue;
+        }
 
-            if (powerups[i].y > 600) // Sale por la parte inferior
-            {
-                powerups[i].activo = false;
-                printf("Powerup se perdió al salir de la pantalla.\n");
-            }
-            else if (tiempo_actual - powerups[i].tiempo_aparicion >= powerups[i].duracion_vida)
-            {
-                powerups[i].activo = false;
-                printf("Powerup expirado por tiempo.\n");
-            }
-            else
+        powerups[i].y += 1.5f;
+
+        if (powerups[i].y > 600) // Sale por la parte inferior
+        {
+            powerups[i].activo = false;
+            liberar_indice_pool(pool_powerups, i);
+            TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_PERDIDO, 0, 0);
+        }
+        else if (tiempo_actual - powerups[i].tiempo_aparicion >= powerups[i].duracion_vida)
+        {
+            powerups[i].activo = false;
+            liberar_indice_pool(pool_powerups, i);
+            TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_EXPIRADO, 0, 0);
+        }
+        else
+        {
+            if (tiempo_actual - ultimo_debug >= 3.0)
             {
-                if (tiempo_actual - ultimo_debug >= 3.0)
-                {
-                    tiempo_restante = powerups[i].duracion_vida - (tiempo_actual - powerups[i].tiempo_aparicion);
-                    printf("Powerup %d activo: pos(%.1f, %.1f), tiempo restante: %.1fs\n", i, powerups[i].x, powerups[i].y, tiempo_restante);
-                    ultimo_debug = tiempo_actual;
-                }
+                tiempo_restante = powerups[i].duracion_vida - (tiempo_actual - powerups[i].tiempo_aparicion);
+                TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_DETALLE, TRAZA_POWERUP_ACTIVO, i, tiempo_restante);
+                ultimo_debug = tiempo_actual;
             }
         }
     }
 }
 
 
-void dibujar_powerups(Powerup powerups[], int max_powerups, int *contador_parpadeo, int *contador_debug, ALLEGRO_FONT *fuente)
+void dibujar_powerups(Powerup powerups[], PoolIndices *pool_powerups, int *contador_parpadeo, int *contador_debug, ALLEGRO_FONT *fuente)
 {
     int i;
     int j;
+    int k;
     int powerups_activos;
     float cx;
     float cy;
@@ -2581,19 +3920,20 @@ void dibujar_powerups(Powerup powerups[], int max_powerups, int *contador_parpad
     {
         powerups_activos = 0;
 
-        for (i = 0; i < max_powerups; i++)
+        for (k = 0; k < pool_powerups->num_vivos; k++)
         {
-            if (powerups[i].activo)
+            if (powerups[pool_powerups->vivos[k]].activo)
             {
                 powerups_activos++;
             }
         }
-        printf("Powerups activos: %d\n", powerups_activos);
+        TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_DETALLE, TRAZA_POWERUPS_ACTIVOS, powerups_activos, 0);
     }
     
 
-    for (i = 0; i < max_powerups; i++)
+    for (k = 0; k < pool_powerups->num_vivos; k++)
     {
+        i = pool_powerups->vivos[k];
         if (powerups[i].activo)
         {
             cx = powerups[i].x + 15;
@@ -2704,9 +4044,9 @@ void dibujar_powerups(Powerup powerups[], int max_powerups, int *contador_parpad
 }
 
 
-bool detectar_colision_powerup(Nave nave, Powerup powerup)
+bool detectar_colision_powerup(const Nave *nave, Powerup powerup)
 {
-    return detectar_colision_generica(nave.x, nave.y, nave.ancho, nave.largo, powerup.x, powerup.y, 30, 30);
+    return detectar_colision_generica(nave->x, nave->y, nave->ancho, nave->largo, powerup.x, powerup.y, 30, 30);
 }
 
 
@@ -2736,7 +4076,7 @@ void recoger_powerup(Nave *nave, Powerup *powerup, ColaMensajes *cola_mensajes)
             agregar_mensaje_cola(cola_mensajes, "NUEVO ARMA DESBLOQUEADA!", 3.0, al_map_rgb(255, 215, 0), true);
             agregar_mensaje_cola(cola_mensajes, "Laser Continuo", 2.5, al_map_rgb(0, 255, 255), true);
             agregar_mensaje_cola(cola_mensajes, "Presiona [2] para usar", 3.0, al_map_rgb(255, 255, 255), true);
-            printf("Arma laser desbloqueada!\n");
+            TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_ARMA_DESBLOQUEADA, Arma_laser, 0);
         }
         else
         {
@@ -2751,7 +4091,7 @@ void recoger_powerup(Nave *nave, Powerup *powerup, ColaMensajes *cola_mensajes)
             agregar_mensaje_cola(cola_mensajes, "NUEVO ARMA DESBLOQUEADA!", 3.0, al_map_rgb(255, 215, 0), true);
             agregar_mensaje_cola(cola_mensajes, "Cañón Explosivo", 2.5, al_map_rgb(255, 100, 0), true);
             agregar_mensaje_cola(cola_mensajes, "Presiona [3] para usar", 3.0, al_map_rgb(255, 255, 255), true);
-            printf("Arma explosiva desbloqueada!\n");
+            TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_ARMA_DESBLOQUEADA, Arma_explosiva, 0);
         }
         else
         {
@@ -2766,7 +4106,7 @@ void recoger_powerup(Nave *nave, Powerup *powerup, ColaMensajes *cola_mensajes)
             agregar_mensaje_cola(cola_mensajes, "NUEVO ARMA DESBLOQUEADA!", 3.0, al_map_rgb(255, 215, 0), true);
             agregar_mensaje_cola(cola_mensajes, "Misiles Teledirigidos", 2.5, al_map_rgb(255, 0, 255), true);
             agregar_mensaje_cola(cola_mensajes, "Presiona [4] para usar", 3.0, al_map_rgb(255, 255, 255), true);
-            printf("Arma de misiles desbloqueada!\n");
+            TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_ARMA_DESBLOQUEADA, Arma_misil, 0);
         }
         else
         {
@@ -2775,7 +4115,7 @@ void recoger_powerup(Nave *nave, Powerup *powerup, ColaMensajes *cola_mensajes)
     }
     
     powerup->activo = false;
-    printf("Powerup recogido y desactivado correctamente\n");
+    TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_RECOGIDO, powerup->tipo, 0);
 }
 
 
@@ -2795,7 +4135,7 @@ void activar_escudo(Escudo* escudo, int hits_maximos)
     escudo->activo = true;
     escudo->hits_max = hits_maximos;
     escudo->hits_restantes = hits_maximos;
-    escudo->tiempo_activacion = al_get_time();
+    escudo->tiempo_activacion = tiempo_juego();
     escudo->intensidad = 1.0f;
     escudo->color = al_map_rgb(0, 255, 255);
 }
@@ -2819,28 +4159,28 @@ void actualizar_escudo(Escudo *escudo, double tiempo_actual)
 }
 
 
-void dibujar_escudo(Nave nave)
+void dibujar_escudo(const Nave *nave)
 {
-    float centro_x = nave.x + nave.ancho / 2;
-    float centro_y = nave.y + nave.largo / 2;
-    float radio = (nave.ancho + nave.largo) / 3.0f + 10;
+    float centro_x = nave->x + nave->ancho / 2;
+    float centro_y = nave->y + nave->largo / 2;
+    float radio = (nave->ancho + nave->largo) / 3.0f + 10;
     unsigned char r, g, b, a;
     ALLEGRO_COLOR color_escudo;
 
-    if (!nave.escudo.activo) return;
+    if (!nave->escudo.activo) return;
     
-    al_unmap_rgba(nave.escudo.color, &r, &g, &b, &a);
+    al_unmap_rgba(nave->escudo.color, &r, &g, &b, &a);
     
-    color_escudo = al_map_rgba(r, g, b, (int)(nave.escudo.intensidad * 150));
+    color_escudo = al_map_rgba(r, g, b, (int)(nave->escudo.intensidad * 150));
     
     al_draw_circle(centro_x, centro_y, radio, color_escudo, 3);
     al_draw_circle(centro_x, centro_y, radio - 2, color_escudo, 2);
 }
 
 
-bool escudo_activo(Nave nave)
+bool escudo_activo(const Nave *nave)
 {
-    return nave.escudo.activo && nave.escudo.hits_restantes > 0;
+    return nave->escudo.activo && nave->escudo.hits_restantes > 0;
 }
 
 
@@ -2848,24 +4188,24 @@ bool escudo_recibir_dano(Escudo* escudo)
 {
     if (!escudo->activo || escudo->hits_restantes <= 0) 
     {
-        printf("Escudo no disponible para absorver dano\n");
+        TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_ESCUDO_NO_DISPONIBLE, 0, 0);
         return false;
     }
     
     escudo->hits_restantes--;
-    printf("Escudo recibió daño. Hits restantes: %d\n", escudo->hits_restantes);
+    TRAZA(TRAZA_NAVE, NIVEL_TRAZA_EVENTO, TRAZA_ESCUDO_DANO, escudo->hits_restantes, 0);
     
     if (escudo->hits_restantes <= 0)
     {
         escudo->activo = false;
-        printf("Escudo destruido!\n");
+        TRAZA(TRAZA_NAVE, NIVEL_TRAZA_EVENTO, TRAZA_ESCUDO_DESTRUIDO, 0, 0);
     }
 
     return true;
 }
 
 
-bool verificar_colision_nave_muro(float x, float y, float ancho, float largo, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS])
+bool verificar_colision_nave_muro(float x, float y, float ancho, float largo, Tilemap *tilemap)
 {
     int fila;
     int col;
@@ -2877,32 +4217,40 @@ bool verificar_colision_nave_muro(float x, float y, float ancho, float largo, Ti
     float tile_centro_y;
     float tile_radio;
     
-    // Calcular qué tiles ocupa la nave
+    uint64_t rango;
+    uint64_t bits;
+    
+    // Calcular qué tiles ocupa la nave, recortados al mapa
     int col_izquierda = (int)(x / TILE_ANCHO);
     int col_derecha = (int)((x + ancho - 1) / TILE_ANCHO);
     int fila_superior = (int)(y / TILE_ALTO);
     int fila_inferior = (int)((y + largo - 1) / TILE_ALTO);
 
-    // Verificar todos los tiles que ocuparía la nave
+    if (col_izquierda < 0) col_izquierda = 0;
+    if (fila_superior < 0) fila_superior = 0;
+    if (col_derecha >= MAPA_COLUMNAS) col_derecha = MAPA_COLUMNAS - 1;
+    if (fila_inferior >= MAPA_FILAS) fila_inferior = MAPA_FILAS - 1;
+
+    if (col_izquierda > col_derecha)
+    {
+        return false;
+    }
+
+    rango = bits_columnas(col_izquierda, col_derecha);
+
+    // Solo se prueban los muros indestructibles (tipo 3) y asteroides fijos (tipo 1) de cada fila
     for (fila = fila_superior; fila <= fila_inferior; fila++)
     {
-        for (col = col_izquierda; col <= col_derecha; col++)
+        for (bits = tilemap->filas_solidas[fila] & rango; bits; bits &= bits - 1)
         {
-            // Verificar si el tile está dentro del mapa
-            if (fila >= 0 && fila < MAPA_FILAS && col >= 0 && col < MAPA_COLUMNAS)
+            col = __builtin_ctzll(bits);
+            tile_centro_x = col * TILE_ANCHO + TILE_ANCHO / 2;
+            tile_centro_y = fila * TILE_ALTO + TILE_ALTO / 2;
+            tile_radio = TILE_ANCHO / 2.0f; // Radio del tile
+            
+            if (detectar_colision_circular(centro_x, centro_y, radio, tile_centro_x, tile_centro_y, tile_radio))
             {
-                // Verificar colisión con muros indestructibles (tipo 3), escudos (tipo 2) o asteroides fijos (tipo 1)
-                if (tilemap[fila][col].tipo == 3 || tilemap[fila][col].tipo == 1)
-                {
-                    tile_centro_x = col * TILE_ANCHO + TILE_ANCHO / 2;
-                    tile_centro_y = fila * TILE_ALTO + TILE_ALTO / 2;
-                    tile_radio = TILE_ANCHO / 2.0f; // Radio del tile
-                    
-                    if (detectar_colision_circular(centro_x, centro_y, radio, tile_centro_x, tile_centro_y, tile_radio))
-                    {
-                        return true; // Hay colisión
-                    }
-                }
+                return true; // Hay colisión
             }
         }
     }
@@ -2925,7 +4273,7 @@ void agregar_mensaje_cola(ColaMensajes *cola, const char *texto, double duracion
 {
     if (cola->cantidad >= MAX_COLA_MENSAJES)
     {
-        printf("Cola de mensajes llena! No se puede agregar el mensaje: %s\n", texto);
+        TRAZA(TRAZA_MENSAJES, NIVEL_TRAZA_EVENTO, TRAZA_MENSAJE_COLA_LLENA, cola->cantidad, 0);
         return;
     }
 
@@ -2938,7 +4286,7 @@ void agregar_mensaje_cola(ColaMensajes *cola, const char *texto, double duracion
     cola->fin = (cola->fin + 1) % MAX_COLA_MENSAJES;
     cola->cantidad++;
     
-    printf("Mensaje agregado a la cola: %s (Total en cola: %d)\n", texto, cola->cantidad);
+    TRAZA(TRAZA_MENSAJES, NIVEL_TRAZA_EVENTO, TRAZA_MENSAJE_AGREGADO, cola->cantidad, 0);
 }
 
 
@@ -2968,7 +4316,7 @@ void actualizar_cola_mensajes(ColaMensajes* cola, double tiempo_actual)
         
         if (++debug_counter % 30 == 0) 
         {
-            printf("Procesando mensaje: %s (Restantes en cola: %d)\n", siguiente.texto, cola->cantidad);
+            TRAZA(TRAZA_MENSAJES, NIVEL_TRAZA_EVENTO, TRAZA_MENSAJE_PROCESADO, cola->cantidad, 0);
         }
     }
     
@@ -3000,7 +4348,7 @@ void mostrar_mensaje_centrado(Mensaje* mensaje, const char* texto, double duraci
 
     mensaje->x = 400; // Centro de la pantalla (800/2)
     mensaje->y = 200; // Posición vertical centrada
-    mensaje->tiempo_inicio = al_get_time();
+    mensaje->tiempo_inicio = tiempo_juego();
     mensaje->duracion = duracion;
     mensaje->activo = true;
     mensaje->color = color;
@@ -3012,26 +4360,26 @@ void mostrar_mensaje_centrado(Mensaje* mensaje, const char* texto, double duraci
  * @brief Dibuja las hitboxes de todos los objetos para depuración.
  * 
  * @param nave Nave del jugador.
- * @param enemigos Arreglo de enemigos.
- * @param num_enemigos Número de enemigos.
+ * @param enemigos Pool de enemigos.
  * @param disparos Disparos del jugador.
- * @param num_disparos Número de disparos del jugador.
+ * @param pool_disparos Pool de índices de los disparos.
  * @param disparos_enemigos Disparos de enemigos.
- * @param num_disparos_enemigos Número de disparos de enemigos.
+ * @param pool_disparos_enemigos Pool de índices de los disparos enemigos.
  * @param asteroides Arreglo de asteroides.
  * @param num_asteroides Número de asteroides.
  * @param tilemap Mapa de tiles.
  */
-void dibujar_hitboxes_debug(Nave nave, Enemigo enemigos[], int num_enemigos, Disparo disparos[], int num_disparos, Disparo disparos_enemigos[], int num_disparos_enemigos, Asteroide asteroides[], int num_asteroides, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], ALLEGRO_FONT *fuente)
+void dibujar_hitboxes_debug(const Nave *nave, PoolEnemigos *enemigos, Disparo disparos[], PoolIndices *pool_disparos, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, Asteroide asteroides[], int num_asteroides, Tilemap *tilemap, ALLEGRO_FONT *fuente)
 {
-    float centro_nave_x = nave.x + nave.ancho / 2;
-    float centro_nave_y = nave.y + nave.largo / 2;
+    float centro_nave_x = nave->x + nave->ancho / 2;
+    float centro_nave_y = nave->y + nave->largo / 2;
     obtener_centro_nave(nave, &centro_nave_x, &centro_nave_y);
     float radio_nave = obtener_radio_nave(nave);
     float radio_visual;
     char radio_texto[30];
     float radio_escudo;
     int i;
+    int k;
     ALLEGRO_COLOR color_enemigo;
     float centro_x;
     float centro_y;
@@ -3051,7 +4399,7 @@ void dibujar_hitboxes_debug(Nave nave, Enemigo enemigos[], int num_enemigos, Dis
     al_draw_circle(centro_nave_x, centro_nave_y, radio_nave, al_map_rgb(0, 255, 0), 2);
     
     // MOSTRAR HITBOX VISUAL VS HITBOX REAL
-    radio_visual = (nave.ancho * 0.7f) / 2.0f; // Hitbox visual anterior
+    radio_visual = (nave->ancho * 0.7f) / 2.0f; // Hitbox visual anterior
     al_draw_circle(centro_nave_x, centro_nave_y, radio_visual, al_map_rgb(100, 255, 100), 1); // Más tenue
     
     // Centro de la nave
@@ -3061,18 +4409,18 @@ void dibujar_hitboxes_debug(Nave nave, Enemigo enemigos[], int num_enemigos, Dis
     al_draw_text(fuente, al_map_rgb(0, 255, 0), centro_nave_x + radio_nave + 5, centro_nave_y - 10, ALLEGRO_ALIGN_LEFT, radio_texto);
 
     // Hitbox del escudo si está activo - Cian
-    if (nave.escudo.activo)
+    if (nave->escudo.activo)
     {
-        radio_escudo = (nave.ancho + nave.largo) / 3.0f + 10;
+        radio_escudo = (nave->ancho + nave->largo) / 3.0f + 10;
         al_draw_circle(centro_nave_x, centro_nave_y, radio_escudo, al_map_rgb(0, 255, 255), 1);
     }
 
     // Hitboxes de enemigos - Rojo con diferentes tonos según tipo
-    for (i = 0; i < num_enemigos; i++)
+    for (i = 0; i < enemigos->num_enemigos; i++)
     {
-        if (enemigos[i].activo)
+        if (enemigos->activo[i])
         {
-            switch (enemigos[i].tipo)
+            switch (enemigos->tipo[i])
             {
                 case 0: color_enemigo = al_map_rgb(255, 0, 0); break;     // Normal - rojo
                 case 1: color_enemigo = al_map_rgb(255, 100, 0); break;   // Perseguidor - naranja
@@ -3082,22 +4430,23 @@ void dibujar_hitboxes_debug(Nave nave, Enemigo enemigos[], int num_enemigos, Dis
                 default: color_enemigo = al_map_rgb(255, 0, 0); break;
             }
             
-            al_draw_rectangle(enemigos[i].x, enemigos[i].y, enemigos[i].x + enemigos[i].ancho, enemigos[i].y + enemigos[i].alto, color_enemigo, 2);
+            al_draw_rectangle(enemigos->x[i], enemigos->y[i], enemigos->x[i] + enemigos->ancho[i], enemigos->y[i] + enemigos->alto[i], color_enemigo, 2);
             
             // Centro del enemigo
-            centro_x = enemigos[i].x + enemigos[i].ancho / 2;
-            centro_y = enemigos[i].y + enemigos[i].alto / 2;
+            centro_x = enemigos->x[i] + enemigos->ancho[i] / 2;
+            centro_y = enemigos->y[i] + enemigos->alto[i] / 2;
             al_draw_filled_circle(centro_x, centro_y, 2, color_enemigo);
             
             // Texto con tipo de enemigo
-            sprintf(tipo_texto, "T%d", enemigos[i].tipo);
+            sprintf(tipo_texto, "T%d", enemigos->tipo[i]);
             al_draw_text(fuente, al_map_rgb(255, 255, 255), centro_x, centro_y - 15, ALLEGRO_ALIGN_CENTER, tipo_texto);
         }
     }
 
     // Hitboxes de disparos del jugador - Azul
-    for (i = 0; i < num_disparos; i++)
+    for (k = 0; k < pool_disparos->num_vivos; k++)
     {
+        i = pool_disparos->vivos[k];
         if (disparos[i].activo)
         {
             al_draw_rectangle(disparos[i].x, disparos[i].y, disparos[i].x + 5, disparos[i].y + 10, al_map_rgb(0, 0, 255), 1);
@@ -3105,8 +4454,9 @@ void dibujar_hitboxes_debug(Nave nave, Enemigo enemigos[], int num_enemigos, Dis
     }
 
     // Hitboxes de disparos de enemigos - Amarillo
-    for (i = 0; i < num_disparos_enemigos; i++)
+    for (k = 0; k < pool_disparos_enemigos->num_vivos; k++)
     {
+        i = pool_disparos_enemigos->vivos[k];
         if (disparos_enemigos[i].activo)
         {
             al_draw_rectangle(disparos_enemigos[i].x, disparos_enemigos[i].y, disparos_enemigos[i].x + 4, disparos_enemigos[i].y + 8, al_map_rgb(255, 255, 0), 1);
@@ -3124,12 +4474,12 @@ void dibujar_hitboxes_debug(Nave nave, Enemigo enemigos[], int num_enemigos, Dis
     {
         for (col = 0; col < MAPA_COLUMNAS; col++)
         {
-            if (tilemap[fila][col].tipo > 0)
+            if (tilemap->celdas[fila][col].tipo > 0)
             {
                 x = col * TILE_ANCHO;
                 y = fila * TILE_ALTO;
                 
-                switch (tilemap[fila][col].tipo)
+                switch (tilemap->celdas[fila][col].tipo)
                 {
                     case 1: color_tile = al_map_rgb(128, 128, 128); break; // Asteroide fijo - gris
                     case 2: color_tile = al_map_rgb(0, 128, 255); break;   // Escudo - azul
@@ -3140,13 +4490,13 @@ void dibujar_hitboxes_debug(Nave nave, Enemigo enemigos[], int num_enemigos, Dis
                 al_draw_rectangle(x, y, x + TILE_ANCHO, y + TILE_ALTO, color_tile, 1);
                 
                 // Mostrar vida del tile si es aplicable
-                if (tilemap[fila][col].tipo == 2 && tilemap[fila][col].vida > 0)\
+                if (tilemap->celdas[fila][col].tipo == 2 && tilemap->celdas[fila][col].vida > 0)\
                 {
-                    sprintf(vida_texto, "%d", tilemap[fila][col].vida);
+                    sprintf(vida_texto, "%d", tilemap->celdas[fila][col].vida);
                     al_draw_text(fuente, al_map_rgb(255, 255, 255), x + TILE_ANCHO/2, y + TILE_ALTO/2, ALLEGRO_ALIGN_CENTER, vida_texto);
                     al_draw_text(fuente, al_map_rgb(150, 255, 150), x + TILE_ANCHO/2, y + TILE_ALTO/2 - 8, ALLEGRO_ALIGN_CENTER, "T");
                 } 
-                else if (tilemap[fila][col].tipo == 1 || tilemap[fila][col].tipo == 3) 
+                else if (tilemap->celdas[fila][col].tipo == 1 || tilemap->celdas[fila][col].tipo == 3) 
                 {
                     al_draw_text(fuente, al_map_rgb(255, 255, 255), x + TILE_ANCHO/2, y + TILE_ALTO/2, ALLEGRO_ALIGN_CENTER, "S");
                 }
@@ -3167,28 +4517,32 @@ void dibujar_hitboxes_debug(Nave nave, Enemigo enemigos[], int num_enemigos, Dis
 /**
  * @brief Limpia recursos y memoria del juego.
  */
-void limpiar_memoria_juego(Disparo disparos[], int num_disparos, Disparo disparos_enemigos[], int num_disparos_enemigos, Powerup powerups[], int max_powerups, Enemigo enemigos[], int num_enemigos, ColaMensajes* cola_mensajes)
+void limpiar_memoria_juego(Disparo disparos[], PoolIndices *pool_disparos, Disparo disparos_enemigos[], PoolIndices *pool_disparos_enemigos, Powerup powerups[], PoolIndices *pool_powerups, PoolEnemigos *enemigos, ColaMensajes* cola_mensajes)
 {
     int i;
 
-    // Limpiar disparos
-    for (i = 0; i < num_disparos; i++) {
+    // Limpiar disparos, liberando del último vivo al primero
+    while (pool_tiene_vivos(pool_disparos)) {
+        i = pool_disparos->vivos[pool_disparos->num_vivos - 1];
         disparos[i].activo = false;
+        liberar_indice_pool(pool_disparos, i);
     }
     
-    for (i = 0; i < num_disparos_enemigos; i++) {
+    while (pool_tiene_vivos(pool_disparos_enemigos)) {
+        i = pool_disparos_enemigos->vivos[pool_disparos_enemigos->num_vivos - 1];
         disparos_enemigos[i].activo = false;
+        liberar_indice_pool(pool_disparos_enemigos, i);
     }
     
     // Limpiar powerups
-    for (i = 0; i < max_powerups; i++) {
+    while (pool_tiene_vivos(pool_powerups)) {
+        i = pool_powerups->vivos[pool_powerups->num_vivos - 1];
         powerups[i].activo = false;
+        liberar_indice_pool(pool_powerups, i);
     }
     
     // Limpiar enemigos
-    for (i = 0; i < num_enemigos; i++) {
-        enemigos[i].activo = false;
-    }
+    vaciar_pool_enemigos(enemigos);
     
     // Limpiar cola de mensajes
     if (cola_mensajes)
@@ -3206,28 +4560,37 @@ void limpiar_memoria_juego(Disparo disparos[], int num_disparos, Disparo disparo
 
 /**
  * @brief Verifica si la nave está atravesando un escudo.
+ * @param aleatorio Generador para elegir el tipo de powerup.
  */
-bool nave_atravesando_escudo(float x, float y, float ancho, float largo, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS])
+bool nave_atravesando_escudo(float x, float y, float ancho, float largo, Tilemap *tilemap)
 {
     int fila;
-    int col;
+
+    int fila_ini, col_ini, fila_fin, col_fin;
+    uint64_t rango;
 
     int col_izquierda = (int)(x / TILE_ANCHO);
     int col_derecha = (int)((x + ancho - 1) / TILE_ANCHO);
     int fila_superior = (int)(y / TILE_ALTO);
     int fila_inferior = (int)((y + largo - 1) / TILE_ALTO);
 
-    for (fila = fila_superior; fila <= fila_inferior; fila++)
+    col_ini = col_izquierda < 0 ? 0 : col_izquierda;
+    fila_ini = fila_superior < 0 ? 0 : fila_superior;
+    col_fin = col_derecha >= MAPA_COLUMNAS ? MAPA_COLUMNAS - 1 : col_derecha;
+    fila_fin = fila_inferior >= MAPA_FILAS ? MAPA_FILAS - 1 : fila_inferior;
+
+    if (col_ini > col_fin)
+    {
+        return false;
+    }
+
+    rango = bits_columnas(col_ini, col_fin);
+
+    for (fila = fila_ini; fila <= fila_fin; fila++)
     {
-        for (col = col_izquierda; col <= col_derecha; col++)
+        if (tilemap->filas_escudo[fila] & rango)
         {
-            if (fila >= 0 && fila < MAPA_FILAS && col >= 0 && col < MAPA_COLUMNAS)
-            {
-                if (tilemap[fila][col].tipo == 2 && tilemap[fila][col].vida > 0)
-                {
-                    return true;
-                }
-            }
+            return true;
         }
     }
     
@@ -3235,87 +4598,72 @@ bool nave_atravesando_escudo(float x, float y, float ancho, float largo, Tile ti
 }
 
 
-void crear_powerup_vida(Powerup powerups[], int max_powerups, float x, float y)
+void crear_powerup_vida(Powerup powerups[], PoolIndices *pool_powerups, float x, float y)
 {
     int i;
 
-    for (i = 0; i < max_powerups; i++)
+    i = obtener_indice_pool(pool_powerups);
+    if (i < 0)
     {
-        if (!powerups[i].activo)
-        {
-            powerups[i].x = x;
-            powerups[i].y = y;
-            powerups[i].tipo = 1; // Tipo de powerup de vida
-            powerups[i].activo = true;
-            powerups[i].tiempo_aparicion = al_get_time();
-            powerups[i].duracion_vida = 20.0;
-            powerups[i].color = al_map_rgb(255, 0, 0); // Rojo para vida
-            printf("Powerup de vida creado en (%.0f, %.0f)\n", x, y);
-            break;
-
-            printf("POWERUP DE VIDA CREADO EXITOSAMENTE:\n");
-            printf("   - Slot: %d\n", i);
-            printf("   - Posición: (%.1f, %.1f)\n", x, y);
-            printf("   - Tipo: VIDA\n");
-            printf("   - Color: ROJO\n");
-            printf("   - Duración: %.1f segundos\n", powerups[i].duracion_vida);
-            
-            return;
-        }
+        TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_SIN_ESPACIO, 1, 0);
+        return;
     }
 
-    printf("ERROR: No hay slots disponibles para powerup de vida\n");
+    powerups[i].x = x;
+    powerups[i].y = y;
+    powerups[i].tipo = 1; // Tipo de powerup de vida
+    powerups[i].activo = true;
+    powerups[i].tiempo_aparicion = tiempo_juego();
+    powerups[i].duracion_vida = 20.0;
+    powerups[i].color = al_map_rgb(255, 0, 0); // Rojo para vida
+    TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_CREADO, powerups[i].tipo, i);
 }
 
 
-void crear_powerup_aleatorio(Powerup powerups[], int max_powerups, float x, float y)
+void crear_powerup_aleatorio(Powerup powerups[], PoolIndices *pool_powerups, float x, float y, GeneradorAleatorio *aleatorio)
 {
-    int probabilidad = rand() % 100;
+    int probabilidad = aleatorio_entero(aleatorio, 100);
+
+    TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_SORTEO, probabilidad, 0);
     
     if (probabilidad < POWERUP_ESCUDO_PROB)
     {
-        crear_powerup_escudo(powerups, max_powerups, x, y);
-        printf("Powerup aleatorio: ESCUDO (probabilidad: %d%%)\n", probabilidad);
+        crear_powerup_escudo(powerups, pool_powerups, x, y);
     } 
     else if (probabilidad < POWERUP_ESCUDO_PROB + POWERUP_VIDA_PROB)
     {
-        crear_powerup_vida(powerups, max_powerups, x, y);
-        printf("Powerup aleatorio: VIDA (probabilidad: %d%%)\n", probabilidad);
+        crear_powerup_vida(powerups, pool_powerups, x, y);
     }
     else if (probabilidad < POWERUP_ESCUDO_PROB + POWERUP_VIDA_PROB + POWERUP_LASER_PROB)
     {
-        crear_powerup_laser(powerups, max_powerups, x, y);
-        printf("Powerup aleatorio: LASER\n");
+        crear_powerup_laser(powerups, pool_powerups, x, y);
     }
     else if (probabilidad < POWERUP_ESCUDO_PROB + POWERUP_VIDA_PROB + POWERUP_LASER_PROB + 30)
     {
-        crear_powerup_explosivo(powerups, max_powerups, x, y);
-        printf("Powerup aleatorio: EXPLOSIVO\n");
+        crear_powerup_explosivo(powerups, pool_powerups, x, y);
     }
     else if (probabilidad < POWERUP_ESCUDO_PROB + POWERUP_VIDA_PROB + POWERUP_LASER_PROB + POWERUP_EXPLOSIVO_PROB + POWERUP_MISIL_PROB)
     {
-        crear_powerup_misil(powerups, max_powerups, x, y);
-        printf("Powerup aleatorio: MISIL\n");
+        crear_powerup_misil(powerups, pool_powerups, x, y);
     }
     else
     {
         // Por ahora, crear escudo como fallback
-        crear_powerup_escudo(powerups, max_powerups, x, y);
-        printf("Powerup aleatorio: ESCUDO (fallback, probabilidad: %d%%)\n", probabilidad);
+        crear_powerup_escudo(powerups, pool_powerups, x, y);
     }
 }
 
 
-float obtener_radio_nave(Nave nave)
+float obtener_radio_nave(const Nave *nave)
 {
-    return (nave.ancho * 0.7f) / 2.0f;
+    return (nave->ancho * 0.7f) / 2.0f;
 }
 
 
-void obtener_centro_nave(Nave nave, float* centro_x, float* centro_y)
+void obtener_centro_nave(const Nave *nave, float* centro_x, float* centro_y)
 {
-    *centro_x = nave.x + nave.ancho / 2;
-    *centro_y = nave.y + nave.largo / 2;
+    *centro_x = nave->x + nave->ancho / 2;
+    *centro_y = nave->y + nave->largo / 2;
 }
 
 
@@ -3337,11 +4685,11 @@ void obtener_centro_nave(Nave nave, float* centro_x, float* centro_y)
  */
 void init_sistema_armas(Nave *nave)
 {
-    nave->armas[0] = (SistemaArma){Arma_normal, 1, 0, 0, true, 0.0, "Cañon normal", "Disparo en linea recta"};
+    nave->armas[0] = (SistemaArma){Arma_normal, 1, 0, 0, true, 0.0};
 
-    nave->armas[1] = (SistemaArma){Arma_laser, 1, 0, 10, false, 0.0, "Laser Continuo", "Rayo de energía sostenido"};
-    nave->armas[2] = (SistemaArma){Arma_explosiva, 1, 0, 15, false, 0.0, "Cañon Explosivo", "Proyectiles con daño en área"};
-    nave->armas[3] = (SistemaArma){Arma_misil, 1, 0, 20, false, 0.0, "Misiles Teledirigidos", "Misiles que persiguen enemigos"};
+    nave->armas[1] = (SistemaArma){Arma_laser, 1, 0, 10, false, 0.0};
+    nave->armas[2] = (SistemaArma){Arma_explosiva, 1, 0, 15, false, 0.0};
+    nave->armas[3] = (SistemaArma){Arma_misil, 1, 0, 20, false, 0.0};
 
     nave->arma_actual = Arma_normal;
     nave->arma_seleccionada = 0;
@@ -3350,6 +4698,40 @@ void init_sistema_armas(Nave *nave)
 }
 
 
+/**
+ * @brief Devuelve el nombre de un tipo de arma.
+ * 
+ * @param tipo Tipo de arma.
+ * @return Nombre del arma.
+ */
+const char *nombre_arma(TipoArma tipo)
+{
+    static const char *nombres[4] =
+    {
+        "Cañon normal", "Laser Continuo", "Cañon Explosivo", "Misiles Teledirigidos"
+    };
+
+    return tipo >= 0 && tipo < 4 ? nombres[tipo] : "Desconocida";
+}
+
+
+/**
+ * @brief Devuelve la descripción de un tipo de arma.
+ * 
+ * @param tipo Tipo de arma.
+ * @return Descripción del arma.
+ */
+const char *descripcion_arma(TipoArma tipo)
+{
+    static const char *descripciones[4] =
+    {
+        "Disparo en linea recta", "Rayo de energía sostenido", "Proyectiles con daño en área", "Misiles que persiguen enemigos"
+    };
+
+    return tipo >= 0 && tipo < 4 ? descripciones[tipo] : "";
+}
+
+
 /**
  * @brief Cambia el arma activa de la nave.
  * 
@@ -3371,11 +4753,11 @@ void cambiar_arma(Nave *nave, TipoArma nueva_arma)
     {
         nave->arma_actual = nueva_arma;
         nave->arma_seleccionada = nueva_arma;
-        printf("Arma cambiada a: %s\n", nave->armas[nueva_arma].nombre);
+        printf("Arma cambiada a: %s\n", nombre_arma(nueva_arma));
     }
     else
     {
-        printf("Arma %s no desbloqueada aún.\n", nave->armas[nueva_arma].nombre);   
+        printf("Arma %s no desbloqueada aún.\n", nombre_arma(nueva_arma));   
     }
 }
 
@@ -3399,7 +4781,7 @@ void actualizar_progreso_arma(Nave *nave, TipoArma tipo_arma)
     SistemaArma *arma = &nave->armas[tipo_arma];
     arma->kills_mejora++;
 
-    printf("Progreso arma %s: %d/%d kills\n", arma->nombre, arma->kills_mejora, arma->kills_necesarias);
+    TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_ARMA_PROGRESO, arma->kills_mejora, arma->kills_necesarias);
 }
 
 
@@ -3467,7 +4849,7 @@ void verificar_mejora_arma(Nave *nave, TipoArma tipo_arma, ColaMensajes *cola_me
             agregar_mensaje_cola(cola_mensajes, mensaje_secundario, 2.5, al_map_rgb(255, 255, 255), true);
         }
         
-        printf("Arma %s subió a nivel %d\n", arma->nombre, arma->nivel);
+        printf("Arma %s subió a nivel %d\n", nombre_arma(arma->tipo), arma->nivel);
     }
 }
 
@@ -3481,7 +4863,7 @@ void verificar_mejora_arma(Nave *nave, TipoArma tipo_arma, ColaMensajes *cola_me
  * @param nave Nave del jugador con información de armas.
  * @param fuente Fuente de texto para renderizar la información.
  */
-void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
+void dibujar_info_armas(const Nave *nave, ALLEGRO_FONT *fuente)
 {
     // POSICIÓN BASE PARA TODO EL HUD DE ARMAS
     int hud_x = 580;  // Movido más a la izquierda para evitar solapamiento
@@ -3512,7 +4894,7 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
 
     int i;
 
-    SistemaArma arma;
+    const SistemaArma *arma;
     ALLEGRO_COLOR color_fondo, color_borde, color_texto;
 
     int centro_x;
@@ -3522,7 +4904,7 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
 
     char tecla[3];
     
-    SistemaArma arma_actual = nave.armas[nave.arma_seleccionada];
+    const SistemaArma *arma_actual = &nave->armas[nave->arma_seleccionada];
 
     int nivel;
     
@@ -3530,7 +4912,7 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
     al_draw_rectangle(cuadro_x, cuadro_y, cuadro_x + cuadro_ancho, cuadro_y + cuadro_alto, al_map_rgb(255, 215, 0), 2);
     
     // Nombre corto del arma activa
-    switch (nave.arma_seleccionada)
+    switch (nave->arma_seleccionada)
     {
         case 0: strcpy(nombre_corto, "NORMAL"); break;
         case 1: strcpy(nombre_corto, "LASER"); break;
@@ -3543,14 +4925,14 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
                 ALLEGRO_ALIGN_LEFT, nombre_corto);
     
     // Nivel del arma activa
-    sprintf(nivel_texto, "LV%d", arma_actual.nivel);
+    sprintf(nivel_texto, "LV%d", arma_actual->nivel);
     al_draw_text(fuente, al_map_rgb(255, 215, 0), cuadro_x + 110, cuadro_y + 8, 
                 ALLEGRO_ALIGN_LEFT, nivel_texto);
     
     // Barra de progreso de mejora
-    if (arma_actual.nivel < 3 && arma_actual.kills_necesarias > 0)
+    if (arma_actual->nivel < 3 && arma_actual->kills_necesarias > 0)
     {
-        progreso = (float)arma_actual.kills_mejora / arma_actual.kills_necesarias;
+        progreso = (float)arma_actual->kills_mejora / arma_actual->kills_necesarias;
         if (progreso > 1.0f) progreso = 1.0f;
         
         // Barra de progreso en el medio del cuadro
@@ -3572,11 +4954,11 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
                         al_map_rgb(150, 150, 150), 1);
         
         // Texto de progreso debajo de la barra
-        sprintf(prog_texto, "%d/%d kills", arma_actual.kills_mejora, arma_actual.kills_necesarias);
+        sprintf(prog_texto, "%d/%d kills", arma_actual->kills_mejora, arma_actual->kills_necesarias);
         al_draw_text(fuente, al_map_rgb(200, 200, 200), cuadro_x + 10, barra_y + 12, 
                     ALLEGRO_ALIGN_LEFT, prog_texto);
     }
-    else if (arma_actual.nivel == 3)
+    else if (arma_actual->nivel == 3)
     {
         // Barra completa para nivel máximo
         barra_x = cuadro_x + 10;
@@ -3602,17 +4984,17 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
     {
         slot_x = hud_x + (i * (slot_size + slot_spacing));
         
-        arma = nave.armas[i];
+        arma = &nave->armas[i];
         
         // Colores según estado del arma
-        if (!arma.desbloqueado)
+        if (!arma->desbloqueado)
         {
             // Arma bloqueada - gris oscuro
             color_fondo = al_map_rgba(50, 50, 50, 150);
             color_borde = al_map_rgb(80, 80, 80);
             color_texto = al_map_rgb(100, 100, 100);
         }
-        else if (nave.arma_seleccionada == i)
+        else if (nave->arma_seleccionada == i)
         {
             // Arma activa - dorado brillante
             color_fondo = al_map_rgba(255, 215, 0, 100);
@@ -3636,7 +5018,7 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
         al_draw_text(fuente, color_texto, slot_x + 5, slots_y + 3, ALLEGRO_ALIGN_LEFT, tecla);
         
         // Icono del arma
-        if (arma.desbloqueado)
+        if (arma->desbloqueado)
         {
             centro_x = slot_x + slot_size/2;
             centro_y = slots_y + slot_size/2;
@@ -3664,7 +5046,7 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
         }
         
         // Indicadores de nivel del arma
-        if (arma.desbloqueado)
+        if (arma->desbloqueado)
         {
             // Dibujar 3 puntos en la parte inferior para mostrar el nivel
             for (nivel = 1; nivel <= 3; nivel++)
@@ -3672,7 +5054,7 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
                 punto_x = slot_x + 10 + ((nivel - 1) * 10);  // Distribuir en 3 columnas
                 punto_y = slots_y + slot_size - 10;           // En la parte inferior
                 
-                if (nivel <= arma.nivel) 
+                if (nivel <= arma->nivel) 
                 {
                     // Punto lleno para nivel alcanzado
                     al_draw_filled_circle(punto_x, punto_y, 3, al_map_rgb(0, 255, 0));
@@ -3706,105 +5088,95 @@ void dibujar_info_armas(Nave nave, ALLEGRO_FONT *fuente)
  * la tecla, con propiedades que mejoran según el nivel del arma.
  * 
  * @param lasers Arreglo de láseres disponibles.
- * @param max_lasers Número máximo de láseres simultáneos.
+ * @param pool_lasers Pool de índices de los láseres.
  * @param nave Nave que dispara el láser.
  */
-void disparar_laser(DisparoLaser lasers[], int max_lasers, Nave nave)
+void disparar_laser(DisparoLaser lasers[], PoolIndices *pool_lasers, const Nave *nave)
 {
-    double tiempo_actual = al_get_time();
-    SistemaArma arma_laser = nave.armas[Arma_laser];
+    double tiempo_actual = tiempo_juego();
+    const SistemaArma *arma_laser = &nave->armas[Arma_laser];
     int i;
     float centro_x;
     float centro_y;
     float punta_x;
     float punta_y;
     
-    for (i = 0; i < max_lasers; i++)
+    i = obtener_indice_pool(pool_lasers);
+    if (i < 0)
     {
-        if (!lasers[i].activo)
-        {
-            centro_x = nave.x + nave.ancho / 2.0f;
-            centro_y = nave.y + nave.largo / 2.0f;
-            punta_x = centro_x + cos(nave.angulo - ALLEGRO_PI / 2) * (nave.largo / 2.0f);
-            punta_y = centro_y + sin(nave.angulo - ALLEGRO_PI / 2) * (nave.largo / 2.0f);
-
-            lasers[i].x_nave = punta_x;
-            lasers[i].y_nave = punta_y;
-            lasers[i].x = punta_x;
-            lasers[i].y = punta_y;
-            lasers[i].ancho = 6 + (arma_laser.nivel * 2);
-            lasers[i].alto = nave.y;
-            lasers[i].angulo = nave.angulo - ALLEGRO_PI / 2;
-            lasers[i].alcance = 600;
-            lasers[i].activo = true;
-            lasers[i].tiempo_inicio = tiempo_actual;
-            lasers[i].ultimo_dano = 0.0;
-            
-            lasers[i].duracion_max = 0;
-            lasers[i].poder = 1.0f + arma_laser.nivel;
+        TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_LASER_SIN_ESPACIO, 0, 0);
+        return;
+    }
 
-            switch(arma_laser.nivel)
-            {
-                case 1:
-                    lasers[i].dano_por_segundo = 15.0f;
-                    lasers[i].color = al_map_rgba(255, 0, 0, 150); 
-                    break;
-                case 2:
-                    lasers[i].dano_por_segundo = 25.0f;
-                    lasers[i].color = al_map_rgba(255, 100, 0, 180); 
-                    break;
-                case 3:
-                    lasers[i].dano_por_segundo = 40.0f; 
-                    lasers[i].color = al_map_rgba(255, 255, 0, 220); 
-                    break;
-                default:
-                    lasers[i].dano_por_segundo = 10.0f;
-                    lasers[i].color = al_map_rgba(255, 0, 0, 150); 
-                    break;
-            }
+    centro_x = nave->x + nave->ancho / 2.0f;
+    centro_y = nave->y + nave->largo / 2.0f;
+    punta_x = centro_x + cos(nave->angulo - ALLEGRO_PI / 2) * (nave->largo / 2.0f);
+    punta_y = centro_y + sin(nave->angulo - ALLEGRO_PI / 2) * (nave->largo / 2.0f);
 
-            nave.armas[Arma_laser].ultimo_uso = tiempo_actual;
-            printf("Laser disparado - Nivel %d, Poder %d, Duración %.1fs\n", arma_laser.nivel, lasers[i].poder, lasers[i].duracion_max);
-            return;
-        }   
+    lasers[i].x_nave = punta_x;
+    lasers[i].y_nave = punta_y;
+    lasers[i].x = punta_x;
+    lasers[i].y = punta_y;
+    lasers[i].ancho = 6 + (arma_laser->nivel * 2);
+    lasers[i].alto = nave->y;
+    lasers[i].angulo = nave->angulo - ALLEGRO_PI / 2;
+    lasers[i].alcance = 600;
+    lasers[i].alcance_real = lasers[i].alcance; // Se recorta contra el mapa en actualizar_lasers
+    lasers[i].activo = true;
+    lasers[i].tiempo_inicio = tiempo_actual;
+    lasers[i].ultimo_dano = 0.0;
+    
+    lasers[i].duracion_max = 0;
+    lasers[i].poder = 1.0f + arma_laser->nivel;
+
+    switch(arma_laser->nivel)
+    {
+        case 1:
+            lasers[i].dano_por_segundo = 15.0f;
+            lasers[i].color = al_map_rgba(255, 0, 0, 150); 
+            break;
+        case 2:
+            lasers[i].dano_por_segundo = 25.0f;
+            lasers[i].color = al_map_rgba(255, 100, 0, 180); 
+            break;
+        case 3:
+            lasers[i].dano_por_segundo = 40.0f; 
+            lasers[i].color = al_map_rgba(255, 255, 0, 220); 
+            break;
+        default:
+            lasers[i].dano_por_segundo = 10.0f;
+            lasers[i].color = al_map_rgba(255, 0, 0, 150); 
+            break;
     }
 
-    printf("No hay espacio para más laseres activos.\n");
+    TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_LASER_DISPARADO, arma_laser->nivel, lasers[i].poder);
 }
 
 
 /**
  * @brief Actualiza todos los láseres activos.
  * 
- * Actualiza la posición, verifica colisiones con tilemap y enemigos,
- * aplica daño según intervalos y maneja el alcance limitado por obstáculos.
+ * Apunta cada láser desde la punta de la nave y calcula una sola vez por paso su alcance
+ * real, cortado por el primer bloque sólido. El daño a enemigos y al jefe se aplica en
+ * resolver_contactos, y dibujar_lasers usa el mismo alcance.
  * 
  * @param lasers Arreglo de láseres a actualizar.
- * @param max_lasers Número máximo de láseres.
- * @param enemigos Arreglo de enemigos para detectar colisiones.
- * @param num_enemigos Número de enemigos.
- * @param puntaje Puntero al puntaje del jugador.
+ * @param pool_lasers Pool de índices de los láseres.
  * @param nave Nave que dispara (para posicionamiento).
  * @param tilemap Mapa de tiles para detectar obstáculos.
  * @param contador_debug Contador para mensajes de debug.
  */
-void actualizar_lasers(DisparoLaser lasers[], int max_lasers, Enemigo enemigos[], int num_enemigos, int *puntaje, Nave *nave, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], int *contador_debug, Powerup powerups[], int max_powerups, ColaMensajes *cola_mensajes)
+void actualizar_lasers(DisparoLaser lasers[], PoolIndices *pool_lasers, const Nave *nave, Tilemap *tilemap, int *contador_debug)
 {
-    double tiempo_actual = al_get_time();
     int i;
-    int j;
     int k;
     float centro_x;
     float centro_y;
     int lasers_activos;
-    float alcance_real;
-    float dano_aplicado;
-    //double var_tiempo;
     float punta_x;
     float punta_y;
-    //int prob_powerup;
 
-    obtener_centro_nave(*nave, &centro_x, &centro_y);
+    obtener_centro_nave(nave, &centro_x, &centro_y);
 
     punta_x = centro_x + cos(nave->angulo - ALLEGRO_PI / 2) * (nave->largo / 2.0f);
     punta_y = centro_y + sin(nave->angulo - ALLEGRO_PI / 2) * (nave->largo / 2.0f);
@@ -3812,52 +5184,29 @@ void actualizar_lasers(DisparoLaser lasers[], int max_lasers, Enemigo enemigos[]
     if (++(*contador_debug) % 300 == 0)
     {
         lasers_activos = 0;
-        for (k = 0; k < max_lasers; k++)
+        for (k = 0; k < pool_lasers->num_vivos; k++)
         {
-            if (lasers[k].activo) lasers_activos++;
+            if (lasers[pool_lasers->vivos[k]].activo) lasers_activos++;
         }
-        printf("DEBUG: %d laseres activos\n", lasers_activos);
+        TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_DETALLE, TRAZA_LASERS_ACTIVOS, lasers_activos, 0);
     }
 
-    for (i = 0; i < max_lasers; i++)
+    // Se recorre al revés para poder liberar el láser actual sin saltar ninguno
+    for (k = pool_lasers->num_vivos - 1; k >= 0; k--)
     {
-        if (!lasers[i].activo) continue;
+        i = pool_lasers->vivos[k];
+
+        // Láseres que se apagaron al soltar la tecla
+        if (!lasers[i].activo)
+        {
+            liberar_indice_pool(pool_lasers, i);
+            continue;
+        }
 
         lasers[i].x_nave = punta_x;
         lasers[i].y_nave = punta_y;
         lasers[i].angulo = nave->angulo - ALLEGRO_PI/2;
-
-        alcance_real = verificar_colision_laser_tilemap(lasers[i], tilemap);
-        
-        for (j = 0; j < num_enemigos; j++)
-        {
-            if (!enemigos[j].activo) continue;
-            
-            if (laser_intersecta_enemigo_limitado(lasers[i], enemigos[j], alcance_real))
-            {
-                if (tiempo_actual - lasers[i].ultimo_dano >= 0.1)
-                {
-                    dano_aplicado = lasers[i].poder;
-                    enemigos[j].vida -= dano_aplicado;
-                    *puntaje += 5;
-                    lasers[i].ultimo_dano = tiempo_actual;
-
-                    if (enemigos[j].vida <= 0)
-                    {
-                        actualizar_progreso_arma(nave, Arma_laser);
-                        
-                        if ((rand() % 100) < POWERUP_PROB)
-                        {
-                            crear_powerup_aleatorio(powerups, max_powerups, enemigos[j].x, enemigos[j].y);
-                        }
-                        enemigos[j].activo = false;
-                        *puntaje += 10;
-                        
-                        verificar_mejora_arma(nave, Arma_laser, cola_mensajes);
-                    }
-                }
-            }
-        }
+        lasers[i].alcance_real = verificar_colision_laser_tilemap(lasers[i], tilemap);
     }
 }
 
@@ -3865,16 +5214,16 @@ void actualizar_lasers(DisparoLaser lasers[], int max_lasers, Enemigo enemigos[]
 /**
  * @brief Dibuja todos los láseres activos con efectos visuales.
  * 
- * Renderiza los láseres con alcance limitado por obstáculos, efectos
- * de destello en el origen y chispas en puntos de impacto.
+ * Renderiza los láseres con el alcance limitado por obstáculos que calculó actualizar_lasers,
+ * efectos de destello en el origen y chispas en puntos de impacto.
  * 
  * @param lasers Arreglo de láseres a dibujar.
- * @param max_lasers Número máximo de láseres.
- * @param tilemap Mapa de tiles para calcular alcance real.
+ * @param pool_lasers Pool de índices de los láseres.
  */
-void dibujar_lasers(DisparoLaser lasers[], int max_lasers, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS])
+void dibujar_lasers(DisparoLaser lasers[], PoolIndices *pool_lasers)
 {
     int i;
+    int k;
     int p;
     float final_x;
     float final_y;
@@ -3883,11 +5232,12 @@ void dibujar_lasers(DisparoLaser lasers[], int max_lasers, Tile tilemap[MAPA_FIL
     ALLEGRO_COLOR color_centro;
     float alcance_real;
 
-    for (i = 0; i < max_lasers; i++)
+    for (k = 0; k < pool_lasers->num_vivos; k++)
     {
+        i = pool_lasers->vivos[k];
         if (lasers[i].activo)
         {
-            alcance_real = verificar_colision_laser_tilemap(lasers[i], tilemap);
+            alcance_real = lasers[i].alcance_real;
             final_x = lasers[i].x_nave + cos(lasers[i].angulo) * alcance_real;
             final_y = lasers[i].y_nave + sin(lasers[i].angulo) * alcance_real;
 
@@ -3905,8 +5255,8 @@ void dibujar_lasers(DisparoLaser lasers[], int max_lasers, Tile tilemap[MAPA_FIL
             {
                 for (p = 0; p < 5; p++)
                 {
-                    offset_x = (rand() % 20 - 10) * 0.5f;
-                    offset_y = (rand() % 20 - 10) * 0.5f;
+                    offset_x = (aleatorio_entero(&aleatorio_dibujo, 20) - 10) * 0.5f;
+                    offset_y = (aleatorio_entero(&aleatorio_dibujo, 20) - 10) * 0.5f;
                     al_draw_filled_circle(final_x + offset_x, final_y + offset_y, 1, al_map_rgba(255, 100, 0, 150));
                 }
             }
@@ -3922,61 +5272,59 @@ void dibujar_lasers(DisparoLaser lasers[], int max_lasers, Tile tilemap[MAPA_FIL
  * por el jugador.
  * 
  * @param powerups Arreglo de powerups disponibles.
- * @param max_powerups Número máximo de powerups.
+ * @param pool_powerups Pool de índices de los powerups.
  * @param x Posición x donde crear el powerup.
  * @param y Posición y donde crear el powerup.
  */
-void crear_powerup_laser(Powerup powerups[], int max_powerups, float x, float y)
+void crear_powerup_laser(Powerup powerups[], PoolIndices *pool_powerups, float x, float y)
 {
     int i;
 
-    for (i = 0; i < max_powerups; i++)
+    i = obtener_indice_pool(pool_powerups);
+    if (i < 0)
     {
-        if (!powerups[i].activo)
-        {
-            powerups[i].x = x;
-            powerups[i].y = y;
-            powerups[i].tipo = 2;
-            powerups[i].activo = true;
-            powerups[i].tiempo_aparicion = al_get_time();
-            powerups[i].duracion_vida = 20.0;
-            powerups[i].color = al_map_rgb(255, 0, 0);
-
-            printf("POWERUP DE LASER CREADO en (%.1f, %.1f)\n", x, y);
-            return;
-        }
+        return;
     }
+
+    powerups[i].x = x;
+    powerups[i].y = y;
+    powerups[i].tipo = 2;
+    powerups[i].activo = true;
+    powerups[i].tiempo_aparicion = tiempo_juego();
+    powerups[i].duracion_vida = 20.0;
+    powerups[i].color = al_map_rgb(255, 0, 0);
+    TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_CREADO, powerups[i].tipo, i);
 }
 
 
 /**
  * @brief Dispara según el arma actual seleccionada.
  */
-void disparar_segun_arma(Nave nave, Disparo disparos[], int num_disparos, DisparoLaser lasers[], int max_lasers, DisparoExplosivo explosivos[], int max_explosivos, MisilTeledirigido misiles[], int max_misiles, Enemigo enemigos[], int num_enemigos)
+void disparar_segun_arma(const Nave *nave, Disparo disparos[], PoolIndices *pool_disparos, DisparoLaser lasers[], PoolIndices *pool_lasers, DisparoExplosivo explosivos[], PoolIndices *pool_explosivos, MisilTeledirigido misiles[], PoolIndices *pool_misiles, PoolEnemigos *enemigos)
 {
-    switch (nave.arma_actual)
+    switch (nave->arma_actual)
     {
         case Arma_normal:
-            if (nave.nivel_disparo_radial > 0)
+            if (nave->nivel_disparo_radial > 0)
             {
-                disparar_radial(disparos, num_disparos, nave);
+                disparar_radial(disparos, pool_disparos, nave);
             }
             else
             {
-                disparar(disparos, num_disparos, nave);
+                disparar(disparos, pool_disparos, nave);
             }
             break;
         case Arma_laser:
-            disparar_laser(lasers, max_lasers, nave);
+            disparar_laser(lasers, pool_lasers, nave);
             break;
         case Arma_explosiva:
-            disparar_explosivo(explosivos, max_explosivos, nave);
+            disparar_explosivo(explosivos, pool_explosivos, nave);
             break;
         case Arma_misil:
-            disparar_misil(misiles, max_misiles, nave, enemigos, num_enemigos);
+            disparar_misil(misiles, pool_misiles, nave, enemigos);
             break;
         default:
-            disparar(disparos, num_disparos, nave);
+            disparar(disparos, pool_disparos, nave);
             break;
     }
 }
@@ -3989,30 +5337,28 @@ void disparar_segun_arma(Nave nave, Disparo disparos[], int num_disparos, Dispar
  * por el jugador.
  * 
  * @param powerups Arreglo de powerups disponibles.
- * @param max_powerups Número máximo de powerups.
+ * @param pool_powerups Pool de índices de los powerups.
  * @param x Posición x donde crear el powerup.
  * @param y Posición y donde crear el powerup.
  */
-void crear_powerup_explosivo(Powerup powerups[], int max_powerups, float x, float y)
+void crear_powerup_explosivo(Powerup powerups[], PoolIndices *pool_powerups, float x, float y)
 {
     int i;
 
-    for (i = 0; i < max_powerups; i++)
+    i = obtener_indice_pool(pool_powerups);
+    if (i < 0)
     {
-        if (!powerups[i].activo)
-        {
-            powerups[i].x = x;
-            powerups[i].y = y;
-            powerups[i].tipo = 3; // Tipo de powerup explosivo
-            powerups[i].activo = true;
-            powerups[i].tiempo_aparicion = al_get_time();
-            powerups[i].duracion_vida = 20.0;
-            powerups[i].color = al_map_rgb(255, 165, 0); // Naranja para explosivo
-
-            printf("POWERUP EXPLOSIVO CREADO en (%.1f, %.1f)\n", x, y);
-            return;
-        }
+        return;
     }
+
+    powerups[i].x = x;
+    powerups[i].y = y;
+    powerups[i].tipo = 3; // Tipo de powerup explosivo
+    powerups[i].activo = true;
+    powerups[i].tiempo_aparicion = tiempo_juego();
+    powerups[i].duracion_vida = 20.0;
+    powerups[i].color = al_map_rgb(255, 165, 0); // Naranja para explosivo
+    TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_CREADO, powerups[i].tipo, i);
 }
 
 
@@ -4023,30 +5369,28 @@ void crear_powerup_explosivo(Powerup powerups[], int max_powerups, float x, floa
  * cuando es recogido por el jugador.
  * 
  * @param powerups Arreglo de powerups disponibles.
- * @param max_powerups Número máximo de powerups.
+ * @param pool_powerups Pool de índices de los powerups.
  * @param x Posición x donde crear el powerup.
  * @param y Posición y donde crear el powerup.
  */
-void crear_powerup_misil(Powerup powerups[], int max_powerups, float x, float y)
+void crear_powerup_misil(Powerup powerups[], PoolIndices *pool_powerups, float x, float y)
 {
     int i;
 
-    for (i = 0; i < max_powerups; i++)
+    i = obtener_indice_pool(pool_powerups);
+    if (i < 0)
     {
-        if (!powerups[i].activo)
-        {
-            powerups[i].x = x;
-            powerups[i].y = y;
-            powerups[i].tipo = 4; // Tipo misil
-            powerups[i].activo = true;
-            powerups[i].tiempo_aparicion = al_get_time();
-            powerups[i].duracion_vida = 20.0;
-            powerups[i].color = al_map_rgb(0, 255, 100); // Verde
-            
-            printf("POWERUP MISIL CREADO en (%.1f, %.1f)\n", x, y);
-            return;
-        }
+        return;
     }
+
+    powerups[i].x = x;
+    powerups[i].y = y;
+    powerups[i].tipo = 4; // Tipo misil
+    powerups[i].activo = true;
+    powerups[i].tiempo_aparicion = tiempo_juego();
+    powerups[i].duracion_vida = 20.0;
+    powerups[i].color = al_map_rgb(0, 255, 100); // Verde
+    TRAZA(TRAZA_POWERUPS, NIVEL_TRAZA_EVENTO, TRAZA_POWERUP_CREADO, powerups[i].tipo, i);
 }
 
 
@@ -4057,13 +5401,13 @@ void crear_powerup_misil(Powerup powerups[], int max_powerups, float x, float y)
  * causando daño en área con propiedades mejoradas según el nivel del arma.
  * 
  * @param explosivos Arreglo de proyectiles explosivos.
- * @param max_explosivos Número máximo de explosivos simultáneos.
+ * @param pool_explosivos Pool de índices de los explosivos.
  * @param nave Nave que dispara el explosivo.
  */
-void disparar_explosivo(DisparoExplosivo explosivos[], int max_explosivos, Nave nave)
+void disparar_explosivo(DisparoExplosivo explosivos[], PoolIndices *pool_explosivos, const Nave *nave)
 {
-    double tiempo_actual = al_get_time();
-    SistemaArma arma_explosiva = nave.armas[Arma_explosiva];
+    double tiempo_actual = tiempo_juego();
+    const SistemaArma *arma_explosiva = &nave->armas[Arma_explosiva];
     int i;
     float centro_x, centro_y;
     float punta_x, punta_y;
@@ -4071,67 +5415,64 @@ void disparar_explosivo(DisparoExplosivo explosivos[], int max_explosivos, Nave
 
     
     // Cooldown entre disparos
-    if (tiempo_actual - arma_explosiva.ultimo_uso < 0.5) return;
+    if (tiempo_actual - arma_explosiva->ultimo_uso < 0.5) return;
     
-    for (i = 0; i < max_explosivos; i++)
+    i = obtener_indice_pool(pool_explosivos);
+    if (i < 0)
     {
-        if (!explosivos[i].activo)
-        {
-            obtener_centro_nave(nave, &centro_x, &centro_y);
-            
-            // Calcular posición de disparo desde la punta de la nave
-            punta_x = centro_x + cos(nave.angulo - ALLEGRO_PI / 2) * (nave.largo / 2.0f);
-            punta_y = centro_y + sin(nave.angulo - ALLEGRO_PI / 2) * (nave.largo / 2.0f);
-            
-            // Inicializacion del explosivo
-            explosivos[i].x = punta_x;
-            explosivos[i].y = punta_y;
-            explosivos[i].ancho = 8;
-            explosivos[i].alto = 12;
-            explosivos[i].activo = true;
-            explosivos[i].exploto = false;
-            explosivos[i].dano_aplicado = false;
-            
-            // El disparo explosivo tiene la misma velocidad que un disparo normal
-            velocidad = 450.0f; // Misma velocidad que disparo normal
-            explosivos[i].vx = cos(nave.angulo - ALLEGRO_PI / 2) * velocidad;
-            explosivos[i].vy = sin(nave.angulo - ALLEGRO_PI / 2) * velocidad;
-            
-            // Propiedades según nivel del arma
-            explosivos[i].radio_explosion = 50 + (arma_explosiva.nivel * 20); // Radio aumenta con nivel
-            explosivos[i].dano_directo = 30 + (arma_explosiva.nivel * 15);    // Daño aumenta con nivel
-            explosivos[i].dano_area = 20 + (arma_explosiva.nivel * 10);       // Daño de área aumenta
-            explosivos[i].tiempo_vida = tiempo_actual + 3.0; // 3 segundos de vida máxima
-            
-            printf("Explosivo disparado: velocidad=450, radio=%d, daño_directo=%d, daño_área=%d\n", 
-                   explosivos[i].radio_explosion, explosivos[i].dano_directo, explosivos[i].dano_area);
-            
-            // Actualizar el último uso del arma explosiva
-            nave.armas[Arma_explosiva].ultimo_uso = tiempo_actual;
-            return;
-        }
+        TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_EXPLOSIVO_SIN_ESPACIO, 0, 0);
+        return;
     }
 
-    printf("No hay espacio para más explosivos\n");
+    obtener_centro_nave(nave, &centro_x, &centro_y);
+    
+    // Calcular posición de disparo desde la punta de la nave
+    punta_x = centro_x + cos(nave->angulo - ALLEGRO_PI / 2) * (nave->largo / 2.0f);
+    punta_y = centro_y + sin(nave->angulo - ALLEGRO_PI / 2) * (nave->largo / 2.0f);
+    
+    // Inicializacion del explosivo
+    explosivos[i].x = punta_x;
+    explosivos[i].y = punta_y;
+    explosivos[i].ancho = 8;
+    explosivos[i].alto = 12;
+    explosivos[i].activo = true;
+    explosivos[i].exploto = false;
+    explosivos[i].dano_aplicado = false;
+    
+    // El disparo explosivo tiene la misma velocidad que un disparo normal
+    velocidad = 450.0f; // Misma velocidad que disparo normal
+    explosivos[i].vx = cos(nave->angulo - ALLEGRO_PI / 2) * velocidad;
+    explosivos[i].vy = sin(nave->angulo - ALLEGRO_PI / 2) * velocidad;
+    
+    // Propiedades según nivel del arma
+    explosivos[i].radio_explosion = 50 + (arma_explosiva->nivel * 20); // Radio aumenta con nivel
+    explosivos[i].dano_directo = 30 + (arma_explosiva->nivel * 15);    // Daño aumenta con nivel
+    explosivos[i].dano_area = 20 + (arma_explosiva->nivel * 10);       // Daño de área aumenta
+    explosivos[i].tiempo_vida = tiempo_actual + 3.0; // 3 segundos de vida máxima
+    
+    TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_EXPLOSIVO_DISPARADO, explosivos[i].radio_explosion, explosivos[i].dano_directo);
 }
 
 
 /**
  * @brief Actualiza todos los proyectiles explosivos activos.
  * 
- * Maneja el movimiento, detección de colisiones, explosiones y daño en área
- * de todos los proyectiles explosivos activos.
+ * Maneja el movimiento, las explosiones y el daño en área de todos los proyectiles
+ * explosivos activos. El impacto directo contra enemigos, bloques o el jefe lo detecta
+ * detectar_contactos y lo aplica resolver_contactos, que marcan el explosivo como
+ * explotado; el daño de área se aplica en el paso siguiente.
  * 
  * @param explosivos Arreglo de explosivos a actualizar.
- * @param max_explosivos Número máximo de explosivos.
- * @param enemigos Arreglo de enemigos para detectar colisiones y daño.
- * @param num_enemigos Número de enemigos.
+ * @param pool_explosivos Pool de índices de los explosivos.
+ * @param enemigos Pool de enemigos para detectar colisiones y daño.
+ * @param grid Grilla espacial de enemigos.
  * @param puntaje Puntero al puntaje del jugador.
  * @param tilemap Mapa de tiles para detectar colisiones con obstáculos.
+ * @param tiles_sucios Lista donde se marcan los bloques dañados para redibujarlos.
  */
-void actualizar_explosivos(DisparoExplosivo explosivos[], int max_explosivos, Enemigo enemigos[], int num_enemigos, int* puntaje, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS], Nave *nave, ColaMensajes *cola_mensajes)
+void actualizar_explosivos(DisparoExplosivo explosivos[], PoolIndices *pool_explosivos, PoolEnemigos *enemigos, GridEspacial *grid, int* puntaje, Tilemap *tilemap, TilesSucios *tiles_sucios, Nave *nave, ColaMensajes *cola_mensajes)
 {
-    double tiempo_actual = al_get_time();
+    double tiempo_actual = tiempo_juego();
     int i;
     int j;
     int col_izq, col_der, fila_sup, fila_inf;
@@ -4143,101 +5484,43 @@ void actualizar_explosivos(DisparoExplosivo explosivos[], int max_explosivos, En
     float tile_centro_x;
     float tile_centro_y;
     int dano_bloque;
+    float radio_bloques;
+    int candidatos[NUM_ENEMIGOS];
+    int num_candidatos;
+    int c;
+    int k;
     
-    for (i = 0; i < max_explosivos; i++)
+    // Se recorre al revés para poder liberar el explosivo actual sin saltar ninguno
+    for (k = pool_explosivos->num_vivos - 1; k >= 0; k--)
     {
-        if (!explosivos[i].activo) continue;
+        i = pool_explosivos->vivos[k];
+
+        if (!explosivos[i].activo)
+        {
+            liberar_indice_pool(pool_explosivos, i);
+            continue;
+        }
         
         // Si no ha explotado el proyectil, se sigue moviendo
         if (!explosivos[i].exploto)
         {
             // Mover el proyectil
-            explosivos[i].x += explosivos[i].vx * (1.0f / 60.0f); // Asumiendo 60 FPS
-            explosivos[i].y += explosivos[i].vy * (1.0f / 60.0f);
-            
-            // Verificar colisiones con enemigos
-            for (j = 0; j < num_enemigos; j++)
-            {
-                if (enemigos[j].activo && detectar_colision_generica(explosivos[i].x, explosivos[i].y, explosivos[i].ancho, explosivos[i].alto, enemigos[j].x, enemigos[j].y, enemigos[j].ancho, enemigos[j].alto))
-                {
-                    printf("Explosivo impactó enemigo tipo %d\n", enemigos[j].tipo);
-                    
-                    // Activar explosion
-                    explosivos[i].exploto = true;
-                    explosivos[i].tiempo_vida = tiempo_actual; // Marcar tiempo de explosión
-                    explosivos[i].dano_aplicado = false; // Resetear para aplicar daño de área
-                    goto colision_detectada;
-                }
-            }
-            
-            // VERIFICAR COLISIÓN CON BLOQUES DEL TILEMAP
-            col_izq = (int)(explosivos[i].x / TILE_ANCHO);
-            col_der = (int)((explosivos[i].x + explosivos[i].ancho - 1) / TILE_ANCHO);
-            fila_sup = (int)(explosivos[i].y / TILE_ALTO);
-            fila_inf = (int)((explosivos[i].y + explosivos[i].alto - 1) / TILE_ALTO);
-            
-            for (fila = fila_sup; fila <= fila_inf; fila++)
-            {
-                for (col = col_izq; col <= col_der; col++)
-                {
-                    if (fila >= 0 && fila < MAPA_FILAS && col >= 0 && col < MAPA_COLUMNAS)
-                    {
-                        if (tilemap[fila][col].tipo == 1) // BLOQUE SÓLIDO (NO DESTRUCTIBLE)
-                        {
-                            printf("Explosivo impactó bloque SÓLIDO en (%d,%d) - Solo explota, no lo destruye\n", col, fila);
-                            
-                            // ACTIVAR EXPLOSIÓN PERO NO DAÑAR EL BLOQUE
-                            explosivos[i].exploto = true;
-                            explosivos[i].tiempo_vida = tiempo_actual;
-                            explosivos[i].dano_aplicado = false;
-                            goto colision_detectada;
-                        }
-                        else if (tilemap[fila][col].tipo == 3) // BLOQUE INDESTRUCTIBLE
-                        {
-                            printf("Explosivo impactó bloque INDESTRUCTIBLE en (%d,%d) - Solo explota, no lo afecta\n", col, fila);
-                            
-                            // ACTIVAR EXPLOSIÓN PERO NO DAÑAR EL BLOQUE INDESTRUCTIBLE
-                            explosivos[i].exploto = true;
-                            explosivos[i].tiempo_vida = tiempo_actual;
-                            explosivos[i].dano_aplicado = false;
-                            goto colision_detectada;
-                        }
-                        else if (tilemap[fila][col].tipo == 2) // ESCUDO DESTRUCTIBLE
-                        {
-                            printf("Explosivo impactó escudo DESTRUCTIBLE en (%d,%d) - Explota y lo daña\n", col, fila);
-                            
-                            // ACTIVAR EXPLOSIÓN Y DAÑAR EL BLOQUE DESTRUCTIBLE
-                            explosivos[i].exploto = true;
-                            explosivos[i].tiempo_vida = tiempo_actual;
-                            explosivos[i].dano_aplicado = false;
-                            
-                            // DAÑAR SOLO EL BLOQUE IMPACTADO DIRECTAMENTE
-                            tilemap[fila][col].vida -= explosivos[i].dano_directo;
-                            if (tilemap[fila][col].vida <= 0)
-                            {
-                                tilemap[fila][col].tipo = 0; // Destruir escudo
-                                printf("Escudo destruido por impacto directo de explosivo\n");
-                            }
-                            goto colision_detectada;
-                        }
-                    }
-                }
-            }
-            
-            colision_detectada:
+            explosivos[i].x += explosivos[i].vx * DT_SIMULACION;
+            explosivos[i].y += explosivos[i].vy * DT_SIMULACION;
             
             // Verificar si el explosivo salió de la pantalla
             if (explosivos[i].x < -20 || explosivos[i].x > 820 || explosivos[i].y < -20 || explosivos[i].y > 620)
             {
                 explosivos[i].activo = false;
-                printf("Explosivo salió de pantalla\n");
+                liberar_indice_pool(pool_explosivos, i);
+                TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_EXPLOSIVO_FUERA_PANTALLA, 0, 0);
                 continue;
             }
             
             // Verificar el tiempo de vida del explosivo
             if (tiempo_actual > explosivos[i].tiempo_vida)
             {
-                printf("Explosivo explotó por tiempo límite\n");
+                TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_EXPLOSIVO_TIEMPO_LIMITE, 0, 0);
                 explosivos[i].exploto = true;
                 explosivos[i].tiempo_vida = tiempo_actual;
                 explosivos[i].dano_aplicado = false;
@@ -4250,64 +5533,70 @@ void actualizar_explosivos(DisparoExplosivo explosivos[], int max_explosivos, En
             // Aplicar el dano de area una sola vez
             if (!explosivos[i].dano_aplicado)
             {
-                printf("Aplicando daño de explosión en área\n");
+                TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_EXPLOSION_AREA, 0, 0);
                 
                 // Dañar enemigos en el radio de explosión
-                for (j = 0; j < num_enemigos; j++)
+                num_candidatos = consultar_grid_area(grid, explosivos[i].x - explosivos[i].radio_explosion, explosivos[i].y - explosivos[i].radio_explosion, explosivos[i].x + explosivos[i].radio_explosion, explosivos[i].y + explosivos[i].radio_explosion, candidatos, NUM_ENEMIGOS);
+                for (c = 0; c < num_candidatos; c++)
                 {
-                    if (enemigos[j].activo)
+                    j = candidatos[c];
+                    if (j < enemigos->num_enemigos && enemigos->activo[j])
                     {
-                        distancia = sqrt((enemigos[j].x + enemigos[j].ancho/2 - explosivos[i].x) * (enemigos[j].x + enemigos[j].ancho/2 - explosivos[i].x) + (enemigos[j].y + enemigos[j].alto/2 - explosivos[i].y) * (enemigos[j].y + enemigos[j].alto/2 - explosivos[i].y));
+                        distancia = sqrt((enemigos->x[j] + enemigos->ancho[j]/2 - explosivos[i].x) * (enemigos->x[j] + enemigos->ancho[j]/2 - explosivos[i].x) + (enemigos->y[j] + enemigos->alto[j]/2 - explosivos[i].y) * (enemigos->y[j] + enemigos->alto[j]/2 - explosivos[i].y));
                         
                         if (distancia <= explosivos[i].radio_explosion)
                         {
                             // Verificar linea vista para evitar obstáculos
-                            if (verificar_linea_vista_explosion(explosivos[i].x, explosivos[i].y, enemigos[j].x + enemigos[j].ancho/2, enemigos[j].y + enemigos[j].alto/2, tilemap))
+                            if (verificar_linea_vista_explosion(explosivos[i].x, explosivos[i].y, enemigos->x[j] + enemigos->ancho[j]/2, enemigos->y[j] + enemigos->alto[j]/2, tilemap))
                             {
                                 factor_distancia = 1.0f - (distancia / explosivos[i].radio_explosion);
                                 dano_final = (int)(explosivos[i].dano_area * factor_distancia);
                                 
-                                enemigos[j].vida -= dano_final;
-                                printf("Enemigo tipo %d recibió %d de daño por explosión (distancia: %.1f)\n", enemigos[j].tipo, dano_final, distancia);
+                                enemigos->vida[j] -= dano_final;
+                                TRAZA(TRAZA_ENEMIGOS, NIVEL_TRAZA_EVENTO, TRAZA_ENEMIGO_DANO_EXPLOSION, dano_final, distancia);
                                 
-                                if (enemigos[j].vida <= 0)
+                                if (enemigos->vida[j] <= 0)
                                 {
-                                    enemigos[j].activo = false;
+                                    eliminar_enemigo_pool(enemigos, j);
                                     (*puntaje) += 15;
                                     
                                     // Verificar mejora para el arma explosiva
                                     actualizar_progreso_arma(nave, Arma_explosiva);
                                     verificar_mejora_arma(nave, Arma_explosiva, cola_mensajes);
                                     
-                                    printf("Enemigo eliminado por explosión\n");
+                                    TRAZA(TRAZA_ENEMIGOS, NIVEL_TRAZA_EVENTO, TRAZA_ENEMIGO_ELIMINADO_EXPLOSION, 0, 0);
                                 }
                             }
                         }
                     }
                 }
                 
-                // DAÑAR SOLO BLOQUES DESTRUCTIBLES EN EL RADIO DE EXPLOSIÓN
-                for (fila = 0; fila < MAPA_FILAS; fila++)
+                // DAÑAR SOLO BLOQUES DESTRUCTIBLES EN EL RADIO DE EXPLOSIÓN (celdas dentro del cuadro del radio)
+                radio_bloques = explosivos[i].radio_explosion * 0.7f;
+                obtener_rango_tiles(explosivos[i].x - radio_bloques - TILE_ANCHO / 2, explosivos[i].y - radio_bloques - TILE_ALTO / 2, 2 * radio_bloques + TILE_ANCHO + 1, 2 * radio_bloques + TILE_ALTO + 1, &fila_sup, &col_izq, &fila_inf, &col_der);
+
+                for (fila = fila_sup; fila <= fila_inf; fila++)
                 {
-                    for (col = 0; col < MAPA_COLUMNAS; col++)
+                    for (col = col_izq; col <= col_der; col++)
                     {
-                        if (tilemap[fila][col].tipo == 2) // SOLO ESCUDOS DESTRUCTIBLES
+                        if (tilemap->celdas[fila][col].tipo == 2) // SOLO ESCUDOS DESTRUCTIBLES
                         {
                             tile_centro_x = col * TILE_ANCHO + TILE_ANCHO/2;
                             tile_centro_y = fila * TILE_ALTO + TILE_ALTO/2;
                             
                             distancia = sqrt((tile_centro_x - explosivos[i].x) * (tile_centro_x - explosivos[i].x) + (tile_centro_y - explosivos[i].y) * (tile_centro_y - explosivos[i].y));
                             
-                            if (distancia <= explosivos[i].radio_explosion * 0.7f) // Radio menor para bloques
+                            if (distancia <= radio_bloques) // Radio menor para bloques
                             {
-                                factor_distancia = 1.0f - (distancia / (explosivos[i].radio_explosion * 0.7f));
+                                factor_distancia = 1.0f - (distancia / radio_bloques);
                                 dano_bloque = (int)(explosivos[i].dano_area * factor_distancia * 0.5f);
                                 
-                                tilemap[fila][col].vida -= dano_bloque;
-                                if (tilemap[fila][col].vida <= 0)
+                                danar_tile(tilemap, fila, col, dano_bloque);
+                                marcar_tile_sucio(tiles_sucios, fila, col);
+                                if (tilemap->celdas[fila][col].vida <= 0)
                                 {
-                                    tilemap[fila][col].tipo = 0; // Destruir bloque destructible
-                                    printf("Escudo destructible en (%d,%d) destruido por explosión en área\n", col, fila);
+                                    destruir_tile(tilemap, tiles_sucios, fila, col); // Destruir bloque destructible
+                                    TRAZA(TRAZA_TILES, NIVEL_TRAZA_EVENTO, TRAZA_TILE_DESTRUIDO, col, fila);
                                 }
                             }
                         }
@@ -4321,7 +5610,8 @@ void actualizar_explosivos(DisparoExplosivo explosivos[], int max_explosivos, En
             if (tiempo_explosion > 0.5)
             {
                 explosivos[i].activo = false;
-                printf("Animación de explosión terminada\n");
+                liberar_indice_pool(pool_explosivos, i);
+                TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_EXPLOSION_TERMINADA, 0, 0);
             }
         }
     }
@@ -4335,11 +5625,11 @@ void actualizar_explosivos(DisparoExplosivo explosivos[], int max_explosivos, En
  * visuales progresivos de expansión y desvanecimiento.
  * 
  * @param explosivos Arreglo de explosivos a dibujar.
- * @param max_explosivos Número máximo de explosivos.
+ * @param pool_explosivos Pool de índices de los explosivos.
  */
-void dibujar_explosivos(DisparoExplosivo explosivos[], int max_explosivos)
+void dibujar_explosivos(DisparoExplosivo explosivos[], PoolIndices *pool_explosivos)
 {
-    double tiempo_actual = al_get_time();
+    double tiempo_actual = tiempo_juego();
     int i;
     ALLEGRO_COLOR color_proyectil;
     double tiempo_explosion;
@@ -4362,9 +5652,11 @@ void dibujar_explosivos(DisparoExplosivo explosivos[], int max_explosivos)
     int size;
     ALLEGRO_COLOR color_particula;
     float alpha_destello;
+    int k;
 
-    for (i = 0; i < max_explosivos; i++)
+    for (k = 0; k < pool_explosivos->num_vivos; k++)
     {
+        i = pool_explosivos->vivos[k];
         if (!explosivos[i].activo) continue;
         
         // Si no ha explotado, dibujar el proyectil
@@ -4429,12 +5721,12 @@ void dibujar_explosivos(DisparoExplosivo explosivos[], int max_explosivos)
             for (p = 0; p < num_particulas; p++)
             {
                 angulo = (2.0f * ALLEGRO_PI * p) / num_particulas;
-                distancia_particula = radio_actual * (0.8f + (rand() % 40) / 100.0f);
+                distancia_particula = radio_actual * (0.8f + aleatorio_entero(&aleatorio_dibujo, 40) / 100.0f);
                 
                 px = explosivos[i].x + cos(angulo) * distancia_particula;
                 py = explosivos[i].y + sin(angulo) * distancia_particula;
                 
-                size = 2 + rand() % 3;
+                size = 2 + aleatorio_entero(&aleatorio_dibujo, 3);
                 color_particula = al_map_rgba(255, 150 - (int)(progreso * 100), 0, (int)(alpha * 200));
                 
                 al_draw_filled_circle(px, py, size, color_particula);
@@ -4460,15 +5752,14 @@ void dibujar_explosivos(DisparoExplosivo explosivos[], int max_explosivos)
  * más cercano, con propiedades mejoradas según el nivel del arma.
  * 
  * @param misiles Arreglo de misiles teledirigidos.
- * @param max_misiles Número máximo de misiles simultáneos.
+ * @param pool_misiles Pool de índices de los misiles.
  * @param nave Nave que dispara el misil.
- * @param enemigos Arreglo de enemigos para seleccionar objetivo.
- * @param num_enemigos Número de enemigos disponibles.
+ * @param enemigos Pool de enemigos para seleccionar objetivo.
  */
-void disparar_misil(MisilTeledirigido misiles[], int max_misiles, Nave nave, Enemigo enemigos[], int num_enemigos)
+void disparar_misil(MisilTeledirigido misiles[], PoolIndices *pool_misiles, const Nave *nave, PoolEnemigos *enemigos)
 {
-    double tiempo_actual = al_get_time();
-    SistemaArma arma_misil = nave.armas[Arma_misil];
+    double tiempo_actual = tiempo_juego();
+    const SistemaArma *arma_misil = &nave->armas[Arma_misil];
     int i, j;
     //float dx, dy;
     //float distancia;
@@ -4482,14 +5773,14 @@ void disparar_misil(MisilTeledirigido misiles[], int max_misiles, Nave nave, Ene
     float distancia_minima = 1000000;
     
     // Cooldown entre disparos
-    if (tiempo_actual - arma_misil.ultimo_uso < 1.0) return;
+    if (tiempo_actual - arma_misil->ultimo_uso < 1.0) return;
     
-    for (j = 0; j < num_enemigos; j++)
+    for (j = 0; j < enemigos->num_enemigos; j++)
     {
-        if (enemigos[j].activo)
+        if (enemigos->activo[j])
         {
-            float dx = enemigos[j].x - nave.x;
-            float dy = enemigos[j].y - nave.y;
+            float dx = enemigos->x[j] - nave->x;
+            float dy = enemigos->y[j] - nave->y;
             float distancia = sqrt(dx*dx + dy*dy);
             
             if (distancia < distancia_minima)
@@ -4500,54 +5791,52 @@ void disparar_misil(MisilTeledirigido misiles[], int max_misiles, Nave nave, Ene
         }
     }
 
-    for (i = 0; i < max_misiles; i++)
+    i = obtener_indice_pool(pool_misiles);
+    if (i < 0)
     {
-        if (!misiles[i].activo)
-        {
-            // Calcular posición de disparo
-            centro_x = nave.x + nave.ancho / 2.0f;
-            centro_y = nave.y + nave.largo / 2.0f;
-            punta_x = centro_x + cos(nave.angulo - ALLEGRO_PI/2) * (nave.largo / 2.0f);
-            punta_y = centro_y + sin(nave.angulo - ALLEGRO_PI/2) * (nave.largo / 2.0f);
-            
-            misiles[i].x = punta_x;
-            misiles[i].y = punta_y;
-            misiles[i].vx = cos(nave.angulo - ALLEGRO_PI/2) * 3.0f;
-            misiles[i].vy = sin(nave.angulo - ALLEGRO_PI/2) * 3.0f;
-            misiles[i].ancho = 6;
-            misiles[i].alto = 10;
-            misiles[i].activo = true;
-            misiles[i].tiempo_vida = 0;
-            misiles[i].enemigo_objetivo = enemigo_objetivo;
-            misiles[i].tiene_objetivo = (enemigo_objetivo != -1);
-            
-            // Propiedades según nivel
-            misiles[i].vel_max = 4.0f + (arma_misil.nivel * 1.0f);
-            misiles[i].fuerza_giro = 0.1f + (arma_misil.nivel * 0.05f);
-            misiles[i].dano = 4 + arma_misil.nivel;
+        return;
+    }
 
-            nave.armas[Arma_misil].ultimo_uso = tiempo_actual;
+    // Calcular posición de disparo
+    centro_x = nave->x + nave->ancho / 2.0f;
+    centro_y = nave->y + nave->largo / 2.0f;
+    punta_x = centro_x + cos(nave->angulo - ALLEGRO_PI/2) * (nave->largo / 2.0f);
+    punta_y = centro_y + sin(nave->angulo - ALLEGRO_PI/2) * (nave->largo / 2.0f);
+    
+    misiles[i].x = punta_x;
+    misiles[i].y = punta_y;
+    misiles[i].vx = cos(nave->angulo - ALLEGRO_PI/2) * 3.0f;
+    misiles[i].vy = sin(nave->angulo - ALLEGRO_PI/2) * 3.0f;
+    misiles[i].ancho = 6;
+    misiles[i].alto = 10;
+    misiles[i].activo = true;
+    misiles[i].tiempo_vida = 0;
+    misiles[i].enemigo_objetivo = enemigo_objetivo != -1 ? manejador_enemigo(enemigos, enemigo_objetivo) : -1;
+    misiles[i].tiene_objetivo = (enemigo_objetivo != -1);
+    
+    // Propiedades según nivel
+    misiles[i].vel_max = 4.0f + (arma_misil->nivel * 1.0f);
+    misiles[i].fuerza_giro = 0.1f + (arma_misil->nivel * 0.05f);
+    misiles[i].dano = 4 + arma_misil->nivel;
 
-            printf("Misil disparado - Nivel %d, Objetivo: %d, Vel: %.1f\n", arma_misil.nivel, enemigo_objetivo, misiles[i].vel_max);
-            break;
-        }
-    }
+
+    TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_MISIL_DISPARADO, arma_misil->nivel, enemigo_objetivo);
 }
 
 
 /**
  * @brief Actualiza todos los misiles teledirigidos activos.
  * 
- * Maneja el seguimiento de objetivos, cambio de trayectoria, búsqueda
- * de nuevos objetivos y detección de colisiones.
+ * Maneja el seguimiento de objetivos, cambio de trayectoria y búsqueda
+ * de nuevos objetivos. Los impactos se aplican en resolver_contactos y el misil
+ * desactivado se libera en el paso siguiente.
  * 
  * @param misiles Arreglo de misiles a actualizar.
- * @param max_misiles Número máximo de misiles.
- * @param enemigos Arreglo de enemigos para seguimiento.
- * @param num_enemigos Número de enemigos.
- * @param puntaje Puntero al puntaje del jugador.
+ * @param pool_misiles Pool de índices de los misiles.
+ * @param enemigos Pool de enemigos para seguimiento.
+ * @param grid Grilla espacial de enemigos.
  */
-void actualizar_misiles(MisilTeledirigido misiles[], int max_misiles, Enemigo enemigos[], int num_enemigos, int* puntaje)
+void actualizar_misiles(MisilTeledirigido misiles[], PoolIndices *pool_misiles, PoolEnemigos *enemigos, GridEspacial *grid)
 {
     int i;
     int j;
@@ -4556,22 +5845,28 @@ void actualizar_misiles(MisilTeledirigido misiles[], int max_misiles, Enemigo en
     float dir_x, dir_y;
     float vel_actual;
     float distancia_minima;
+    int candidatos[NUM_ENEMIGOS];
+    int num_candidatos;
+    int c;
+    int k;
 
 
-    for (i = 0; i < max_misiles; i++)
+    // Se recorre al revés para poder liberar el misil actual sin saltar ninguno
+    for (k = pool_misiles->num_vivos - 1; k >= 0; k--)
     {
+        i = pool_misiles->vivos[k];
         if (misiles[i].activo)
         {
-            misiles[i].tiempo_vida += 0.016;
+            misiles[i].tiempo_vida += DT_SIMULACION;
 
-            // Si tiene objetivo válido, dirigirse hacia él
-            if (misiles[i].tiene_objetivo && misiles[i].enemigo_objetivo != -1 && misiles[i].enemigo_objetivo < num_enemigos && enemigos[misiles[i].enemigo_objetivo].activo)
+            // Si tiene objetivo válido, dirigirse hacia él; el manejador solo se encuentra si sigue vivo
+            j = misiles[i].tiene_objetivo ? buscar_enemigo_manejador(enemigos, misiles[i].enemigo_objetivo) : -1;
+            if (j >= 0)
             {
-                Enemigo *objetivo = &enemigos[misiles[i].enemigo_objetivo];
                 
                 // Calcular dirección hacia el objetivo
-                dx = (objetivo->x + objetivo->ancho/2) - misiles[i].x;
-                dy = (objetivo->y + objetivo->alto/2) - misiles[i].y;
+                dx = (enemigos->x[j] + enemigos->ancho[j]/2) - misiles[i].x;
+                dy = (enemigos->y[j] + enemigos->alto[j]/2) - misiles[i].y;
                 distancia = sqrt(dx*dx + dy*dy);
                 
                 if (distancia > 5.0f)
@@ -4599,18 +5894,20 @@ void actualizar_misiles(MisilTeledirigido misiles[], int max_misiles, Enemigo en
                 misiles[i].tiene_objetivo = false;
                 distancia_minima = 300; // Rango de búsqueda
                 
-                for (j = 0; j < num_enemigos; j++)
+                num_candidatos = consultar_grid_area(grid, misiles[i].x - distancia_minima, misiles[i].y - distancia_minima, misiles[i].x + distancia_minima, misiles[i].y + distancia_minima, candidatos, NUM_ENEMIGOS);
+                for (c = 0; c < num_candidatos; c++)
                 {
-                    if (enemigos[j].activo)
+                    j = candidatos[c];
+                    if (j < enemigos->num_enemigos && enemigos->activo[j])
                     {
-                        dx = enemigos[j].x - misiles[i].x;
-                        dy = enemigos[j].y - misiles[i].y;
+                        dx = enemigos->x[j] - misiles[i].x;
+                        dy = enemigos->y[j] - misiles[i].y;
                         distancia = sqrt(dx*dx + dy*dy);
                         
                         if (distancia < distancia_minima)
                         {
                             distancia_minima = distancia;
-                            misiles[i].enemigo_objetivo = j;
+                            misiles[i].enemigo_objetivo = manejador_enemigo(enemigos, j);
                             misiles[i].tiene_objetivo = true;
                         }
                     }
@@ -4621,30 +5918,6 @@ void actualizar_misiles(MisilTeledirigido misiles[], int max_misiles, Enemigo en
             misiles[i].x += misiles[i].vx;
             misiles[i].y += misiles[i].vy;
             
-            // Verificar colisiones con enemigos
-            for (j = 0; j < num_enemigos; j++)
-            {
-                if (enemigos[j].activo)
-                {
-                    if (detectar_colision_generica(misiles[i].x, misiles[i].y, misiles[i].ancho, misiles[i].alto, enemigos[j].x, enemigos[j].y, enemigos[j].ancho, enemigos[j].alto))
-                    {
-                        // Impacto
-                        enemigos[j].vida -= misiles[i].dano;
-                        printf("Misil impactó enemigo %d: -%d HP\n", j, misiles[i].dano);
-                        
-                        if (enemigos[j].vida <= 0)
-                        {
-                            enemigos[j].activo = false;
-                            (*puntaje)++;
-                            printf("Enemigo eliminado por misil\n");
-                        }
-                        
-                        misiles[i].activo = false;
-                        break;
-                    }
-                }
-            }
-            
             // Desactivar si sale de pantalla o tiempo excedido
             if (misiles[i].x < -10 || misiles[i].x > 810 || misiles[i].y < -10 || misiles[i].y > 610 || 
                 misiles[i].tiempo_vida > 8.0)
@@ -4652,6 +5925,11 @@ void actualizar_misiles(MisilTeledirigido misiles[], int max_misiles, Enemigo en
                 misiles[i].activo = false;
             }
         }
+
+        if (!misiles[i].activo)
+        {
+            liberar_indice_pool(pool_misiles, i);
+        }
     }
 }
 
@@ -4663,17 +5941,19 @@ void actualizar_misiles(MisilTeledirigido misiles[], int max_misiles, Enemigo en
  * incluyendo efectos de estela y punta direccional.
  * 
  * @param misiles Arreglo de misiles a dibujar.
- * @param max_misiles Número máximo de misiles.
+ * @param pool_misiles Pool de índices de los misiles.
  */
-void dibujar_misiles(MisilTeledirigido misiles[], int max_misiles)
+void dibujar_misiles(MisilTeledirigido misiles[], PoolIndices *pool_misiles)
 {
     int i;
     float angulo;
     float punta_x, punta_y;
     float cola_x, cola_y;
+    int k;
 
-    for (i = 0; i < max_misiles; i++)
+    for (k = 0; k < pool_misiles->num_vivos; k++)
     {
+        i = pool_misiles->vivos[k];
         if (misiles[i].activo)
         {
             // Calcular ángulo de rotación del misil
@@ -4766,75 +6046,174 @@ bool linea_intersecta_rectangulo(float x1, float y1, float x2, float y2, float r
     {
         return true;
     }
-    
-    // Verificar intersección con cada lado del rectángulo
-    return (linea_intersecta_linea(x1, y1, x2, y2, rect_x1, rect_y1, rect_x2, rect_y1) || linea_intersecta_linea(x1, y1, x2, y2, rect_x2, rect_y1, rect_x2, rect_y2) || linea_intersecta_linea(x1, y1, x2, y2, rect_x2, rect_y2, rect_x1, rect_y2) || linea_intersecta_linea(x1, y1, x2, y2, rect_x1, rect_y2, rect_x1, rect_y1));
-}
+    
+    // Verificar intersección con cada lado del rectángulo
+    return (linea_intersecta_linea(x1, y1, x2, y2, rect_x1, rect_y1, rect_x2, rect_y1) || linea_intersecta_linea(x1, y1, x2, y2, rect_x2, rect_y1, rect_x2, rect_y2) || linea_intersecta_linea(x1, y1, x2, y2, rect_x2, rect_y2, rect_x1, rect_y2) || linea_intersecta_linea(x1, y1, x2, y2, rect_x1, rect_y2, rect_x1, rect_y1));
+}
+
+
+/**
+ * @brief Verifica si dos líneas se intersectan.
+ */
+bool linea_intersecta_linea(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4)
+{
+    float denom = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
+    float t, u;
+    if (fabs(denom) < 0.0001f)
+    {
+        return false; // Líneas paralelas
+    }
+    
+    t = ((x1 - x3) * (y3 - y4) - (y1 - y3) * (x3 - x4)) / denom;
+    u = -((x1 - x2) * (y1 - y3) - (y1 - y2) * (x1 - x3)) / denom;
+    
+    return (t >= 0 && t <= 1 && u >= 0 && u <= 1);
+}
+
+
+/**
+ * @brief Recorre las celdas del tilemap que atraviesa un rayo (algoritmo de Amanatides y Woo).
+ * 
+ * Avanza de celda en celda por el borde mas cercano, asi que cada celda del recorrido se
+ * visita una sola vez y no se salta ninguna en diagonal. Se detiene al salir del mapa o
+ * al superar la distancia maxima. Antes de recorrer se toman las máscaras de las filas
+ * que cubre el rayo: si ninguna tiene tiles de la mascara en sus columnas no se recorre,
+ * y durante el recorrido cada celda se prueba con un bit de su fila.
+ * 
+ * @param tilemap Mapa de tiles del nivel actual.
+ * @param x Coordenada x del origen del rayo.
+ * @param y Coordenada y del origen del rayo.
+ * @param dir_x Componente x de la direccion (vector unitario).
+ * @param dir_y Componente y de la direccion (vector unitario).
+ * @param distancia_max Distancia maxima a recorrer.
+ * @param mascara Combinacion de MASCARA_TILE_* que detiene el rayo.
+ * @param incluir_inicio Si es false no se revisa la celda donde empieza el rayo.
+ * @param distancia Distancia desde el origen hasta la entrada a la celda encontrada.
+ * @param fila Fila de la celda encontrada.
+ * @param col Columna de la celda encontrada.
+ * @return true si el rayo encuentra un tile de la mascara dentro de la distancia maxima.
+ */
+bool trazar_rayo_tilemap(Tilemap *tilemap, float x, float y, float dir_x, float dir_y, float distancia_max, int mascara, bool incluir_inicio, float *distancia, int *fila, int *col)
+{
+    int c = (int)floorf(x / TILE_ANCHO);
+    int f = (int)floorf(y / TILE_ALTO);
+    int paso_col = (dir_x > 0.0f) ? 1 : ((dir_x < 0.0f) ? -1 : 0);
+    int paso_fila = (dir_y > 0.0f) ? 1 : ((dir_y < 0.0f) ? -1 : 0);
+    float sin_limite = distancia_max + 1.0f; // Un eje sin movimiento nunca se elige
+    float t = 0.0f;
+    float t_max_x, t_max_y;
+    float t_delta_x, t_delta_y;
+    uint64_t rango;
+    uint64_t alguno = 0;
+    uint64_t usar_solidos = (mascara & MASCARA_TILE_SOLIDO) == MASCARA_TILE_SOLIDO ? ~(uint64_t)0 : 0;
+    uint64_t usar_escudos = (mascara & MASCARA_TILE_ESCUDO) ? ~(uint64_t)0 : 0;
+    bool por_bits = (mascara & MASCARA_TILE_SOLIDO) == 0 || usar_solidos;
+    int fila_ini, fila_fin, col_ini, col_fin;
+    int i;
+
+    if (c < 0 || c >= MAPA_COLUMNAS || f < 0 || f >= MAPA_FILAS)
+    {
+        return false;
+    }
+
+    // Caja de celdas que puede cruzar el rayo hasta su distancia maxima
+    col_ini = (int)floorf(fminf(x, x + dir_x * distancia_max) / TILE_ANCHO);
+    col_fin = (int)floorf(fmaxf(x, x + dir_x * distancia_max) / TILE_ANCHO);
+    fila_ini = (int)floorf(fminf(y, y + dir_y * distancia_max) / TILE_ALTO);
+    fila_fin = (int)floorf(fmaxf(y, y + dir_y * distancia_max) / TILE_ALTO);
+    if (col_ini < 0) col_ini = 0;
+    if (fila_ini < 0) fila_ini = 0;
+    if (col_fin >= MAPA_COLUMNAS) col_fin = MAPA_COLUMNAS - 1;
+    if (fila_fin >= MAPA_FILAS) fila_fin = MAPA_FILAS - 1;
+
+    rango = bits_columnas(col_ini, col_fin);
+    for (i = fila_ini; i <= fila_fin && !alguno; i++)
+    {
+        alguno = mascara_fila_tilemap(tilemap, i, mascara) & rango;
+    }
+
+    if (!alguno)
+    {
+        return false;
+    }
+
+    // Distancia hasta el primer borde de celda en cada eje y distancia entre bordes
+    if (paso_col != 0)
+    {
+        t_max_x = (((paso_col > 0) ? (c + 1) * TILE_ANCHO : c * TILE_ANCHO) - x) / dir_x;
+        t_delta_x = TILE_ANCHO / fabsf(dir_x);
+    }
+    else
+    {
+        t_max_x = sin_limite;
+        t_delta_x = sin_limite;
+    }
 
+    if (paso_fila != 0)
+    {
+        t_max_y = (((paso_fila > 0) ? (f + 1) * TILE_ALTO : f * TILE_ALTO) - y) / dir_y;
+        t_delta_y = TILE_ALTO / fabsf(dir_y);
+    }
+    else
+    {
+        t_max_y = sin_limite;
+        t_delta_y = sin_limite;
+    }
 
-/**
- * @brief Verifica si dos líneas se intersectan.
- */
-bool linea_intersecta_linea(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4)
-{
-    float denom = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
-    float t, u;
-    if (fabs(denom) < 0.0001f)
+    while (true)
     {
-        return false; // Líneas paralelas
+        if ((incluir_inicio || t > 0.0f) &&
+            (por_bits ? ((((tilemap->filas_solidas[f] & usar_solidos) | (tilemap->filas_escudo[f] & usar_escudos)) >> c) & 1)
+                      : tile_coincide_mascara(tilemap->celdas[f][c], mascara)))
+        {
+            *distancia = t;
+            *fila = f;
+            *col = c;
+            return true;
+        }
+
+        if (t_max_x < t_max_y)
+        {
+            c += paso_col;
+            t = t_max_x;
+            t_max_x += t_delta_x;
+        }
+        else
+        {
+            f += paso_fila;
+            t = t_max_y;
+            t_max_y += t_delta_y;
+        }
+
+        if (t > distancia_max || c < 0 || c >= MAPA_COLUMNAS || f < 0 || f >= MAPA_FILAS)
+        {
+            return false;
+        }
     }
-    
-    t = ((x1 - x3) * (y3 - y4) - (y1 - y3) * (x3 - x4)) / denom;
-    u = -((x1 - x2) * (y1 - y3) - (y1 - y2) * (x1 - x3)) / denom;
-    
-    return (t >= 0 && t <= 1 && u >= 0 && u <= 1);
 }
 
 
 /**
  * @brief Verifica y calcula el alcance real de un láser considerando obstáculos en el tilemap.
  * 
- * Esta función traza el recorrido del láser desde su origen hasta su alcance máximo,
- * verificando colisiones con bloques sólidos e indestructibles. Los escudos destructibles
+ * Recorre con trazar_rayo_tilemap las celdas que cruza el láser hasta su alcance máximo y
+ * se detiene en el primer bloque sólido o indestructible. Los escudos destructibles
  * no detienen el láser, permitiendo que los atraviese.
  * 
  * @param laser Estructura del disparo láser con posición, ángulo y alcance.
  * @param tilemap Mapa de tiles del nivel actual.
  * @return float Distancia real que puede alcanzar el láser antes de ser bloqueado.
  */
-float verificar_colision_laser_tilemap(DisparoLaser laser, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS])
+float verificar_colision_laser_tilemap(DisparoLaser laser, Tilemap *tilemap)
 {
-    float paso;
-    float distancia_actual;
-    float x_actual;
-    float y_actual;
+    float distancia;
     int fila;
     int col;
 
-    paso = laser.alcance > 400 ? 25.0f : laser.alcance > 200 ? 15.0f : 10.0f;
-    distancia_actual = 0.0f;
-
-    while (distancia_actual < laser.alcance)
+    // SOLO detener el láser en bloques sólidos (tipo 1) e indestructibles (tipo 3)
+    if (trazar_rayo_tilemap(tilemap, laser.x_nave, laser.y_nave, cos(laser.angulo), sin(laser.angulo), laser.alcance, MASCARA_TILE_SOLIDO, true, &distancia, &fila, &col))
     {
-        x_actual = laser.x_nave + cos(laser.angulo) * distancia_actual;
-        y_actual = laser.y_nave + sin(laser.angulo) * distancia_actual;
-
-        col = (int)(x_actual / TILE_ANCHO);
-        fila = (int)(y_actual / TILE_ALTO);
-
-        if (col < 0 || col >= MAPA_COLUMNAS || fila < 0 || fila >= MAPA_FILAS)
-        {
-            break;
-        }
-
-        // SOLO detener el láser en bloques sólidos (tipo 1) e indestructibles (tipo 3)
-        // Los escudos destructibles (tipo 2) permiten que el láser los atraviese
-        if (tilemap[fila][col].tipo == 1 || tilemap[fila][col].tipo == 3)
-        {
-            return distancia_actual; // Devolver distancia hasta el obstáculo
-        }
-
-        distancia_actual += paso;
+        return distancia; // Devolver distancia hasta el obstáculo
     }
 
     return laser.alcance; // Sin obstáculos, devolver alcance completo
@@ -4848,20 +6227,23 @@ float verificar_colision_laser_tilemap(DisparoLaser laser, Tile tilemap[MAPA_FIL
  * intersecta con un enemigo específico utilizando detección de línea-rectángulo.
  * 
  * @param laser Estructura del disparo láser.
- * @param enemigo Enemigo a verificar intersección.
+ * @param x Posición x del enemigo (o del jefe).
+ * @param y Posición y del enemigo.
+ * @param ancho Ancho del enemigo.
+ * @param alto Alto del enemigo.
  * @param alcance_real Alcance real del láser considerando obstáculos.
  * @return true si el láser intersecta con el enemigo, false en caso contrario.
  */
-bool laser_intersecta_enemigo_limitado(DisparoLaser laser, Enemigo enemigo, float alcance_real)
+bool laser_intersecta_enemigo_limitado(DisparoLaser laser, float x, float y, float ancho, float alto, float alcance_real)
 {
     float final_x = laser.x_nave + cos(laser.angulo) * alcance_real;
     float final_y = laser.y_nave + sin(laser.angulo) * alcance_real;
     
     float margen = 5.0f;
-    float enemigo_x1 = enemigo.x - margen;
-    float enemigo_y1 = enemigo.y - margen;
-    float enemigo_x2 = enemigo.x + enemigo.ancho + margen;
-    float enemigo_y2 = enemigo.y + enemigo.alto + margen;
+    float enemigo_x1 = x - margen;
+    float enemigo_y1 = y - margen;
+    float enemigo_x2 = x + ancho + margen;
+    float enemigo_y2 = y + alto + margen;
 
     return linea_intersecta_rectangulo(laser.x_nave, laser.y_nave, final_x, final_y, enemigo_x1, enemigo_y1, enemigo_x2, enemigo_y2);
 }
@@ -4882,17 +6264,12 @@ bool laser_intersecta_enemigo_limitado(DisparoLaser laser, Enemigo enemigo, floa
  * @return true si hay línea de vista libre.
  * @return false si hay obstáculos bloqueando.
  */
-bool verificar_linea_vista_explosion(float x1, float y1, float x2, float y2, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS])
+bool verificar_linea_vista_explosion(float x1, float y1, float x2, float y2, Tilemap *tilemap)
 {    
     float dx = x2 - x1;
     float dy = y2 - y1;
     float distancia = sqrt(dx * dx + dy * dy);
-    float paso;
-    float pasos;
-    int i;
-    float t;
-    float x_check;
-    float y_check;
+    float distancia_bloqueo;
     int col;
     int fila;
     
@@ -4901,29 +6278,8 @@ bool verificar_linea_vista_explosion(float x1, float y1, float x2, float y2, Til
         return true;
     }
     
-    paso = 5.0f; // Verificar cada 5 píxeles
-    pasos = (int)(distancia / paso);
-    
-    for (i = 1; i < pasos; i++)
-    {
-        t = (float)i / pasos;
-        x_check = x1 + dx * t;
-        y_check = y1 + dy * t;
-        
-        col = (int)(x_check / TILE_ANCHO);
-        fila = (int)(y_check / TILE_ALTO);
-        
-        if (fila >= 0 && fila < MAPA_FILAS && col >= 0 && col < MAPA_COLUMNAS)
-        {
-            // Si hay un tile sólido, bloquea la explosión
-            if (tilemap[fila][col].tipo == 3 || tilemap[fila][col].tipo == 1)
-            {
-                return false;
-            }
-        }
-    }
-    
-    return true; // Línea de vista libre
+    // La celda de la explosion no cuenta: el explosivo puede haber estallado contra ella
+    return !trazar_rayo_tilemap(tilemap, x1, y1, dx / distancia, dy / distancia, distancia, MASCARA_TILE_SOLIDO, false, &distancia_bloqueo, &fila, &col);
 }
 
 
@@ -5100,6 +6456,7 @@ void init_jefe(Jefe *jefe, int tipo, float x, float y, ALLEGRO_BITMAP *imagen)
     {
         jefe->ataques[i].activo = false;
     }
+    init_pool_indices(&jefe->pool_ataques, MAX_ATAQUES_JEFE);
     
     jefe->ultimo_ataque = 0.0;
     jefe->ultima_invocacion = 0.0;
@@ -5113,8 +6470,8 @@ void init_jefe(Jefe *jefe, int tipo, float x, float y, ALLEGRO_BITMAP *imagen)
     switch(tipo)
     {
         case 0:
-            jefe->ancho = 120;
-            jefe->alto = 80;
+            jefe->ancho = tamanos_jefes[0].ancho;
+            jefe->alto = tamanos_jefes[0].alto;
             jefe->vida = 150.0f;
             jefe->vida_max = 150.0f;
             jefe->intervalo_ataque = 2.5;
@@ -5124,8 +6481,8 @@ void init_jefe(Jefe *jefe, int tipo, float x, float y, ALLEGRO_BITMAP *imagen)
             break;
 
         case 1:
-            jefe->ancho = 160;
-            jefe->alto = 100;
+            jefe->ancho = tamanos_jefes[1].ancho;
+            jefe->alto = tamanos_jefes[1].alto;
             jefe->vida = 250.0f;
             jefe->vida_max = 250.0f;
             jefe->intervalo_ataque = 2.0;
@@ -5140,22 +6497,23 @@ void init_jefe(Jefe *jefe, int tipo, float x, float y, ALLEGRO_BITMAP *imagen)
 
 
 /**
- * @brief Actualiza el comportamiento del jefe.
+ * @brief Actualiza el movimiento del jefe y de sus ataques.
+ * 
+ * Los ataques nuevos y las invocaciones no se revisan acá: los ejecuta la agenda con
+ * ataque_programado_jefe e invocacion_programada_jefe.
  * 
  * @param jefe Puntero al jefe a actualizar.
  * @param nave Nave del jugador (para ataques dirigidos).
- * @param enemigos Array de enemigos para invocaciones.
- * @param num_enemigos Puntero al número de enemigos activos.
- * @param imagenes_enemigos Imágenes de enemigos para invocaciones.
  * @param tiempo_actual Tiempo actual del juego.
  */
-void actualizar_jefe(Jefe *jefe, Nave nave, Enemigo enemigos[], int *num_enemigos, ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS], double tiempo_actual)
+void actualizar_jefe(Jefe *jefe, const Nave *nave, double tiempo_actual)
 {
     float velocidad;
     float centro_x;
     float centro_y;
     float radio;
     int i;
+    int k;
     float dx;
     float dy;
     float distancia;
@@ -5173,7 +6531,7 @@ void actualizar_jefe(Jefe *jefe, Nave nave, Enemigo enemigos[], int *num_enemigo
         printf("Jefe entra en FURIA! Velocidad aumentada a %.2f\n", jefe->velocidad_movimiento);
     }
     
-    jefe->tiempo_animacion += 0.02;
+    jefe->tiempo_animacion += 1.2 * DT_SIMULACION; // 0.02 por paso a 60 pasos por segundo
     velocidad = jefe->en_furia ? jefe->velocidad_movimiento * 1.5f : jefe->velocidad_movimiento;
 
     if (jefe->tipo == 0)
@@ -5198,20 +6556,10 @@ void actualizar_jefe(Jefe *jefe, Nave nave, Enemigo enemigos[], int *num_enemigo
         jefe->y = centro_y + sin(jefe->tiempo_animacion * 0.3f) * 40 - jefe->alto / 2;
     }
 
-    if (tiempo_actual - jefe->ultimo_ataque >= jefe->intervalo_ataque)
-    {
-        jefe_atacar(jefe, nave, tiempo_actual);
-        jefe->ultimo_ataque = tiempo_actual;
-    }
-    
-    if (tiempo_actual - jefe->ultima_invocacion >= TIEMPO_INVOCACION_ENEMIGOS)
-    {
-        jefe_invocar_enemigos(jefe, enemigos, num_enemigos, imagenes_enemigos);
-        jefe->ultima_invocacion = tiempo_actual;
-    }
-    
-    for (i = 0; i < MAX_ATAQUES_JEFE; i++)
+    // Se recorre al revés para poder liberar el ataque actual sin saltar ninguno
+    for (k = jefe->pool_ataques.num_vivos - 1; k >= 0; k--)
     {
+        i = jefe->pool_ataques.vivos[k];
         if (jefe->ataques[i].activo)
         {
             AtaqueJefe *ataque = &jefe->ataques[i];
@@ -5219,8 +6567,8 @@ void actualizar_jefe(Jefe *jefe, Nave nave, Enemigo enemigos[], int *num_enemigo
             switch (ataque->tipo)
             {
                 case Ataque_perseguidor:
-                    dx = (nave.x + nave.ancho / 2) - ataque->x;
-                    dy = (nave.y + nave.largo / 2) - ataque->y;
+                    dx = (nave->x + nave->ancho / 2) - ataque->x;
+                    dy = (nave->y + nave->largo / 2) - ataque->y;
                     distancia = sqrt(dx * dx + dy * dy);
 
                     if (distancia > 0)
@@ -5248,6 +6596,81 @@ void actualizar_jefe(Jefe *jefe, Nave nave, Enemigo enemigos[], int *num_enemigo
                 ataque->activo = false;
             }
         }
+
+        // También libera los ataques que chocaron con la nave
+        if (!jefe->ataques[i].activo)
+        {
+            liberar_indice_pool(&jefe->pool_ataques, i);
+        }
+    }
+}
+
+
+/**
+ * @brief Programa el próximo ataque y la próxima invocación del jefe.
+ * 
+ * @param agenda Agenda de la simulación.
+ * @param jefe Jefe recién cargado.
+ * @param tiempo_actual Tiempo actual del juego.
+ */
+void programar_eventos_jefe(AgendaEventos *agenda, Jefe *jefe, double tiempo_actual)
+{
+    programar_evento(agenda, segundos_a_pasos(jefe->ultimo_ataque + jefe->intervalo_ataque - tiempo_actual), EVENTO_ATAQUE_JEFE, 0);
+    programar_evento(agenda, segundos_a_pasos(jefe->ultima_invocacion + TIEMPO_INVOCACION_ENEMIGOS - tiempo_actual), EVENTO_INVOCACION_JEFE, 0);
+}
+
+
+/**
+ * @brief Ejecuta el ataque programado del jefe y programa el siguiente.
+ * 
+ * @param agenda Agenda de la simulación.
+ * @param jefe Puntero al jefe.
+ * @param nave Nave del jugador (para ataques dirigidos).
+ * @param tiempo_actual Tiempo actual del juego.
+ * @param aleatorio Generador para la dispersión de los ataques.
+ */
+void ataque_programado_jefe(AgendaEventos *agenda, Jefe *jefe, const Nave *nave, double tiempo_actual, GeneradorAleatorio *aleatorio)
+{
+    if (!jefe->activo)
+    {
+        return;
+    }
+
+    jefe_atacar(jefe, nave, tiempo_actual, aleatorio);
+    jefe->ultimo_ataque = tiempo_actual;
+    programar_evento(agenda, segundos_a_pasos(jefe->intervalo_ataque), EVENTO_ATAQUE_JEFE, 0);
+}
+
+
+/**
+ * @brief Ejecuta la invocación programada del jefe y programa la siguiente.
+ * 
+ * Los enemigos invocados quedan al final del pool y se les programa el primer disparo.
+ * Cuando el jefe llega a su máximo de invocados ya no se programan más invocaciones.
+ * 
+ * @param agenda Agenda de la simulación.
+ * @param jefe Puntero al jefe.
+ * @param enemigos Pool de enemigos.
+ * @param imagenes_enemigos Imágenes de enemigos.
+ * @param tiempo_actual Tiempo actual del juego.
+ * @param aleatorio Generador para la posición y el tipo de los invocados.
+ */
+void invocacion_programada_jefe(AgendaEventos *agenda, Jefe *jefe, PoolEnemigos *enemigos, ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS], double tiempo_actual, GeneradorAleatorio *aleatorio)
+{
+    int desde = enemigos->num_enemigos;
+
+    if (!jefe->activo)
+    {
+        return;
+    }
+
+    jefe_invocar_enemigos(jefe, enemigos, imagenes_enemigos, aleatorio);
+    jefe->ultima_invocacion = tiempo_actual;
+    programar_disparos_enemigos(agenda, enemigos, desde, tiempo_actual);
+
+    if (jefe->enemigos_invocados < jefe->max_enemigos_invocacion)
+    {
+        programar_evento(agenda, segundos_a_pasos(TIEMPO_INVOCACION_ENEMIGOS), EVENTO_INVOCACION_JEFE, 0);
     }
 }
 
@@ -5258,8 +6681,9 @@ void actualizar_jefe(Jefe *jefe, Nave nave, Enemigo enemigos[], int *num_enemigo
  * @param jefe Puntero al jefe atacante.
  * @param nave Nave del jugador (para ataques dirigidos).
  * @param tiempo_actual Tiempo actual del juego.
+ * @param aleatorio Generador para la dispersión de los ataques.
  */
-void jefe_atacar(Jefe *jefe, Nave nave, double tiempo_actual)
+void jefe_atacar(Jefe *jefe, const Nave *nave, double tiempo_actual, GeneradorAleatorio *aleatorio)
 {
     int i;
     int j;
@@ -5281,75 +6705,72 @@ void jefe_atacar(Jefe *jefe, Nave nave, double tiempo_actual)
             case 0:
                 for (i = 0; i < 8; i++)
                 {
-                    for (j = 0; j < MAX_ATAQUES_JEFE; j++)
+                    j = obtener_indice_pool(&jefe->pool_ataques);
+                    if (j < 0)
                     {
-                        if (!jefe->ataques[j].activo)
-                        {
-                            AtaqueJefe *ataque = &jefe->ataques[j];
-
-                            angulo = (ALLEGRO_PI * 2 / 8) * i;
-                            ataque->x = jefe->x + jefe->ancho / 2;
-                            ataque->y = jefe->y + jefe->alto;
-                            ataque->vx = cos(angulo) * 4.0f;
-                            ataque->vy = sin(angulo) * 4.0f + 2.0f;
-                            ataque->tipo = Ataque_rafaga;
-                            ataque->activo = true;
-                            ataque->tiempo_vida = tiempo_actual;
-                            ataque->dano = 12;
-                            ataque->velocidad = 4.0f;
-                            ataque->color = al_map_rgb(255, 100, 100);
-                            break;
-                        }
+                        break; // No quedan ataques libres
                     }
+
+                    AtaqueJefe *ataque = &jefe->ataques[j];
+
+                    angulo = (ALLEGRO_PI * 2 / 8) * i;
+                    ataque->x = jefe->x + jefe->ancho / 2;
+                    ataque->y = jefe->y + jefe->alto;
+                    ataque->vx = cos(angulo) * 4.0f;
+                    ataque->vy = sin(angulo) * 4.0f + 2.0f;
+                    ataque->tipo = Ataque_rafaga;
+                    ataque->activo = true;
+                    ataque->tiempo_vida = tiempo_actual;
+                    ataque->dano = 12;
+                    ataque->velocidad = 4.0f;
+                    ataque->color = al_map_rgb(255, 100, 100);
                 }
                 break;
 
                 case 1:
                     for (i = 0; i < 5; i++)
                     {
-                        for (j = 0; j < MAX_ATAQUES_JEFE; j++)
+                        j = obtener_indice_pool(&jefe->pool_ataques);
+                        if (j < 0)
                         {
-                            if (!jefe->ataques[j].activo)
-                            {
-                                AtaqueJefe *ataque = &jefe->ataques[j];
-
-                                ataque->x = jefe->x + (rand() % (int)jefe->ancho);
-                                ataque->y = jefe->y + jefe->alto;
-                                ataque->vx = (rand() % 200 - 100) / 50.0f; // -2 a 2
-                                ataque->vy = 3.0f + (rand() % 100) / 100.0f; // 3 a 4
-                                ataque->tipo = Ataque_lluvia;
-                                ataque->activo = true;
-                                ataque->tiempo_vida = tiempo_actual;
-                                ataque->dano = 12;
-                                ataque->color = al_map_rgb(100, 255, 100);
-                                break;
-                            }
+                            break; // No quedan ataques libres
                         }
+
+                        AtaqueJefe *ataque = &jefe->ataques[j];
+
+                        ataque->x = jefe->x + aleatorio_entero(aleatorio, (int)jefe->ancho);
+                        ataque->y = jefe->y + jefe->alto;
+                        ataque->vx = (aleatorio_entero(aleatorio, 200) - 100) / 50.0f; // -2 a 2
+                        ataque->vy = 3.0f + (aleatorio_entero(aleatorio, 100)) / 100.0f; // 3 a 4
+                        ataque->tipo = Ataque_lluvia;
+                        ataque->activo = true;
+                        ataque->tiempo_vida = tiempo_actual;
+                        ataque->dano = 12;
+                        ataque->color = al_map_rgb(100, 255, 100);
                     }
                     break;
                 
                 case 2:
                     for (i = 0; i < 3; i++)
                     {
-                        for (j = 0; j < MAX_ATAQUES_JEFE; j++)
+                        j = obtener_indice_pool(&jefe->pool_ataques);
+                        if (j < 0)
                         {
-                            if (!jefe->ataques[j].activo)
-                            {
-                                AtaqueJefe* ataque = &jefe->ataques[j];
-                            
-                                ataque->x = jefe->x + jefe->ancho / 2;
-                                ataque->y = jefe->y + jefe->alto;
-                                ataque->vx = 0;
-                                ataque->vy = 1.0f;
-                                ataque->tipo = Ataque_perseguidor;
-                                ataque->activo = true;
-                                ataque->tiempo_vida = tiempo_actual;
-                                ataque->dano = 20;
-                                ataque->velocidad = 3.0f;
-                                ataque->color = al_map_rgb(255, 255, 100);
-                                break;
-                            }
+                            break; // No quedan ataques libres
                         }
+
+                        AtaqueJefe* ataque = &jefe->ataques[j];
+                    
+                        ataque->x = jefe->x + jefe->ancho / 2;
+                        ataque->y = jefe->y + jefe->alto;
+                        ataque->vx = 0;
+                        ataque->vy = 1.0f;
+                        ataque->tipo = Ataque_perseguidor;
+                        ataque->activo = true;
+                        ataque->tiempo_vida = tiempo_actual;
+                        ataque->dano = 20;
+                        ataque->velocidad = 3.0f;
+                        ataque->color = al_map_rgb(255, 255, 100);
                     }
 
                     break;
@@ -5362,25 +6783,24 @@ void jefe_atacar(Jefe *jefe, Nave nave, double tiempo_actual)
         case 0:
             for (k = 0; k < 3; k++)
             {
-                for (j = 0; j < MAX_ATAQUES_JEFE; j++)
+                j = obtener_indice_pool(&jefe->pool_ataques);
+                if (j < 0)
                 {
-                    if (!jefe->ataques[j].activo)
-                    {
-                        AtaqueJefe *ataque = &jefe->ataques[j];
-
-                        angulo_base = jefe->angulo_laser + (k * ALLEGRO_PI * 2 / 3);
-                        ataque->x = jefe->x + jefe->ancho / 2;
-                        ataque->y = jefe->y + jefe->alto / 2;
-                        ataque->vx = cos(angulo_base) * 5.0f;
-                        ataque->vy = sin(angulo_base) * 5.0f;
-                        ataque->tipo = Ataque_laser_giratorio;
-                        ataque->activo = true;
-                        ataque->tiempo_vida = tiempo_actual;
-                        ataque->dano = 18;
-                        ataque->color = al_map_rgb(100, 100, 255);
-                        break;
-                    }
+                    break; // No quedan ataques libres
                 }
+
+                AtaqueJefe *ataque = &jefe->ataques[j];
+
+                angulo_base = jefe->angulo_laser + (k * ALLEGRO_PI * 2 / 3);
+                ataque->x = jefe->x + jefe->ancho / 2;
+                ataque->y = jefe->y + jefe->alto / 2;
+                ataque->vx = cos(angulo_base) * 5.0f;
+                ataque->vy = sin(angulo_base) * 5.0f;
+                ataque->tipo = Ataque_laser_giratorio;
+                ataque->activo = true;
+                ataque->tiempo_vida = tiempo_actual;
+                ataque->dano = 18;
+                ataque->color = al_map_rgb(100, 100, 255);
             }
             
             jefe->angulo_laser += 0.2f;
@@ -5389,64 +6809,62 @@ void jefe_atacar(Jefe *jefe, Nave nave, double tiempo_actual)
         case 1:
             for (i = 0; i < 12; i++)
             {
-                for (j = 0; j < MAX_ATAQUES_JEFE; j++)
+                j = obtener_indice_pool(&jefe->pool_ataques);
+                if (j < 0)
                 {
-                    if (!jefe->ataques[j].activo)
-                    {
-                        AtaqueJefe *ataque = &jefe->ataques[j];
-
-                        angulo = (ALLEGRO_PI * 2 / 12) * i;
-                        ataque->x = jefe->x + jefe->ancho / 2;
-                        ataque->y = jefe->y + jefe->alto / 2;
-                        ataque->vx = cos(angulo) * 2.0f;
-                        ataque->vy = sin(angulo) * 2.0f;
-                        ataque->tipo = Ataque_ondas;
-                        ataque->activo = true;
-                        ataque->tiempo_vida = tiempo_actual;
-                        ataque->dano = 15;
-                        ataque->velocidad = 2.0f;
-                        ataque->color = al_map_rgb(255, 0, 255);
-                        break;
-                    }
+                    break; // No quedan ataques libres
                 }
+
+                AtaqueJefe *ataque = &jefe->ataques[j];
+
+                angulo = (ALLEGRO_PI * 2 / 12) * i;
+                ataque->x = jefe->x + jefe->ancho / 2;
+                ataque->y = jefe->y + jefe->alto / 2;
+                ataque->vx = cos(angulo) * 2.0f;
+                ataque->vy = sin(angulo) * 2.0f;
+                ataque->tipo = Ataque_ondas;
+                ataque->activo = true;
+                ataque->tiempo_vida = tiempo_actual;
+                ataque->dano = 15;
+                ataque->velocidad = 2.0f;
+                ataque->color = al_map_rgb(255, 0, 255);
             }
             break;
 
         case 2:
-            nave_x = nave.x + nave.ancho / 2;
-            nave_y = nave.y + nave.largo / 2;
+            nave_x = nave->x + nave->ancho / 2;
+            nave_y = nave->y + nave->largo / 2;
 
             for (i = 0; i < 6; i++)
             {
-                for (j = 0; j < MAX_ATAQUES_JEFE; j++)
+                j = obtener_indice_pool(&jefe->pool_ataques);
+                if (j < 0)
                 {
-                    if (!jefe->ataques[j].activo)
-                    {
-                        AtaqueJefe *ataque = &jefe->ataques[j];
-                        dx = nave_x - (jefe->x + jefe->ancho / 2);
-                        dy = nave_y - (jefe->y + jefe->alto / 2);
-                        distancia = sqrt(dx * dx + dy * dy);
+                    break; // No quedan ataques libres
+                }
 
-                        offset_x = (rand() % 100 - 50) / 10.0f;
-                        offset_y = (rand() % 100 - 50) / 10.0f;
+                AtaqueJefe *ataque = &jefe->ataques[j];
+                dx = nave_x - (jefe->x + jefe->ancho / 2);
+                dy = nave_y - (jefe->y + jefe->alto / 2);
+                distancia = sqrt(dx * dx + dy * dy);
 
-                        ataque->x = jefe->x + jefe->ancho / 2;
-                        ataque->y = jefe->x + jefe->alto;
+                offset_x = (aleatorio_entero(aleatorio, 100) - 50) / 10.0f;
+                offset_y = (aleatorio_entero(aleatorio, 100) - 50) / 10.0f;
 
-                        if (distancia > 0)
-                        {
-                            ataque->vx = ((dx / distancia) * 4.0f) + offset_x;
-                            ataque->vy = ((dy / distancia) * 4.0f) + offset_y;
-                        }
-                        
-                        ataque->tipo = Ataque_lluvia;
-                        ataque->activo = true;
-                        ataque->tiempo_vida = tiempo_actual;
-                        ataque->dano = 16;
-                        ataque->color = al_map_rgb(255, 150, 0);
-                        break;
-                    }
+                ataque->x = jefe->x + jefe->ancho / 2;
+                ataque->y = jefe->x + jefe->alto;
+
+                if (distancia > 0)
+                {
+                    ataque->vx = ((dx / distancia) * 4.0f) + offset_x;
+                    ataque->vy = ((dy / distancia) * 4.0f) + offset_y;
                 }
+                
+                ataque->tipo = Ataque_lluvia;
+                ataque->activo = true;
+                ataque->tiempo_vida = tiempo_actual;
+                ataque->dano = 16;
+                ataque->color = al_map_rgb(255, 150, 0);
             }
     
             break;
@@ -5454,25 +6872,24 @@ void jefe_atacar(Jefe *jefe, Nave nave, double tiempo_actual)
         case 3:
             for (i = 0; i < 5; i++)
             {
-                for (j = 0; j < MAX_ATAQUES_JEFE; j++)
+                j = obtener_indice_pool(&jefe->pool_ataques);
+                if (j < 0)
                 {
-                    if (!jefe->ataques[j].activo)
-                    {
-                        AtaqueJefe *ataque = &jefe->ataques[j];
-
-                        ataque->x = jefe->x + (rand() % (int)jefe->ancho);
-                        ataque->y = jefe->y + jefe->alto;
-                        ataque->vx = 0;
-                        ataque->vy = 2.0f;
-                        ataque->tipo = Ataque_perseguidor;
-                        ataque->activo = true;
-                        ataque->tiempo_vida = tiempo_actual;
-                        ataque->dano = 22;
-                        ataque->velocidad = 3.5f;
-                        ataque->color = al_map_rgb(255, 0, 100);
-                        break;
-                    }   
+                    break; // No quedan ataques libres
                 }
+
+                AtaqueJefe *ataque = &jefe->ataques[j];
+
+                ataque->x = jefe->x + aleatorio_entero(aleatorio, (int)jefe->ancho);
+                ataque->y = jefe->y + jefe->alto;
+                ataque->vx = 0;
+                ataque->vy = 2.0f;
+                ataque->tipo = Ataque_perseguidor;
+                ataque->activo = true;
+                ataque->tiempo_vida = tiempo_actual;
+                ataque->dano = 22;
+                ataque->velocidad = 3.5f;
+                ataque->color = al_map_rgb(255, 0, 100);
             }
             
             break;
@@ -5483,7 +6900,7 @@ void jefe_atacar(Jefe *jefe, Nave nave, double tiempo_actual)
 
     if (jefe->en_furia)
     {
-        printf("Jefe ataca en MODO FURIA - Fase %d\n", jefe->fase_ataque % (jefe->tipo == 0 ? 3 : 4));
+        TRAZA(TRAZA_JEFE, NIVEL_TRAZA_EVENTO, TRAZA_JEFE_ATAQUE_FURIA, jefe->fase_ataque % (jefe->tipo == 0 ? 3 : 4), 0);
     }   
 }
 
@@ -5501,10 +6918,6 @@ void dibujar_jefe(Jefe jefe)
     float centro_x = jefe.x + jefe.ancho / 2;
     float centro_y = jefe.y + jefe.alto / 2;
     
-    // Calcular escalado para que el sprite se ajuste al tamaño del jefe
-    float escala_x = jefe.ancho / (float)al_get_bitmap_width(jefe.imagen);
-    float escala_y = jefe.alto / (float)al_get_bitmap_height(jefe.imagen);
-    
     // Efecto de parpadeo cuando está herido
     bool mostrar_sprite = true;
     
@@ -5523,16 +6936,8 @@ void dibujar_jefe(Jefe jefe)
 
     if (mostrar_sprite)
     {
-        // Dibujar sprite del jefe escalado
-        al_draw_scaled_bitmap(
-            jefe.imagen,
-            0, 0,
-            al_get_bitmap_width(jefe.imagen),
-            al_get_bitmap_height(jefe.imagen),
-            jefe.x, jefe.y,
-            jefe.ancho, jefe.alto,
-            0
-        );
+        // El sprite del jefe ya tiene su tamaño desde la carga
+        al_draw_bitmap(jefe.imagen, jefe.x, jefe.y, 0);
         
         // Efecto de furia (contorno rojo)
         if (jefe.en_furia)
@@ -5581,8 +6986,8 @@ void dibujar_jefe(Jefe jefe)
             int i;
             for (i = 0; i < 3; i++)
             {
-                float spark_x = centro_x + (rand() % 40) - 20;
-                float spark_y = centro_y + (rand() % 40) - 20;
+                float spark_x = centro_x + aleatorio_entero(&aleatorio_dibujo, 40) - 20;
+                float spark_y = centro_y + aleatorio_entero(&aleatorio_dibujo, 40) - 20;
                 al_draw_filled_circle(spark_x, spark_y, 2, al_map_rgb(255, 255, 0));
             }
         }
@@ -5601,14 +7006,16 @@ void dibujar_jefe(Jefe jefe)
  * @brief Dibuja todos los ataques activos del jefe.
  * 
  * @param ataques Array de ataques del jefe.
- * @param max_ataques Número máximo de ataques.
+ * @param pool_ataques Pool de índices de los ataques.
  */
-void dibujar_ataques_jefe(AtaqueJefe ataques[], int max_ataques)
+void dibujar_ataques_jefe(AtaqueJefe ataques[], PoolIndices *pool_ataques)
 {
     int i;
+    int k;
 
-    for (i = 0; i < max_ataques; i++)
+    for (k = 0; k < pool_ataques->num_vivos; k++)
     {
+        i = pool_ataques->vivos[k];
         if (ataques[i].activo)
         {
             AtaqueJefe ataque = ataques[i];
@@ -5669,7 +7076,7 @@ void dibujar_ataques_jefe(AtaqueJefe ataques[], int max_ataques)
  * @param nave Nave del jugador.
  * @return true si hay colisión.
  */
-bool detectar_colision_ataque_jefe_nave(AtaqueJefe ataque, Nave nave)
+bool detectar_colision_ataque_jefe_nave(AtaqueJefe ataque, const Nave *nave)
 {
     float radio_ataque = 8.0f;
     float centro_nave_x, centro_nave_y;
@@ -5684,18 +7091,18 @@ bool detectar_colision_ataque_jefe_nave(AtaqueJefe ataque, Nave nave)
  * @brief Hace que el jefe invoque enemigos.
  * 
  * @param jefe Puntero al jefe.
- * @param enemigos Array de enemigos.
- * @param num_enemigos Puntero al número de enemigos activos.
+ * @param enemigos Pool de enemigos.
  * @param imagenes_enemigos Imágenes de enemigos.
+ * @param aleatorio Generador para la posición y el tipo de los invocados.
  */
-void jefe_invocar_enemigos(Jefe* jefe, Enemigo enemigos[], int* num_enemigos, ALLEGRO_BITMAP* imagenes_enemigos[NUM_TIPOS_ENEMIGOS])
+void jefe_invocar_enemigos(Jefe* jefe, PoolEnemigos *enemigos, ALLEGRO_BITMAP* imagenes_enemigos[NUM_TIPOS_ENEMIGOS], GeneradorAleatorio *aleatorio)
 {
     int enemigos_a_invocar;
     int invocados;
-    int i;
     float pos_x;
     float pos_y;
     int tipo_enemigo;
+    Enemigo nuevo;
 
     if (jefe->enemigos_invocados >= jefe->max_enemigos_invocacion)
     {
@@ -5705,38 +7112,32 @@ void jefe_invocar_enemigos(Jefe* jefe, Enemigo enemigos[], int* num_enemigos, AL
     enemigos_a_invocar = jefe->en_furia ? 4 : 2;
     invocados = 0;
 
-    for (i = 0; i < NUM_ENEMIGOS && invocados < enemigos_a_invocar; i++)
+    // Los invocados se agregan al final del pool, sin tocar las posiciones de la grilla
+    while (invocados < enemigos_a_invocar && enemigos->num_enemigos < NUM_ENEMIGOS)
     {
-        if (!enemigos[i].activo)
-        {
-            pos_x = 50 + (rand() % 700);
-            pos_y = 30 + (rand() % 100);
+        pos_x = 50 + (aleatorio_entero(aleatorio, 700));
+        pos_y = 30 + (aleatorio_entero(aleatorio, 100));
 
-            if (jefe->tipo == 0)
-            {
-                tipo_enemigo = rand() % 2; // Normal o Perseguidor
-            }
-            else
-            {
-                tipo_enemigo = 1 + (rand() % 3); // Perseguidor, Francotirador o Tanque
-            }
-
-            init_enemigo_tipo(&enemigos[i], (int)(pos_x / TILE_ANCHO), (int)(pos_y / TILE_ALTO), tipo_enemigo, imagenes_enemigos[tipo_enemigo]);
+        if (jefe->tipo == 0)
+        {
+            tipo_enemigo = aleatorio_entero(aleatorio, 2); // Normal o Perseguidor
+        }
+        else
+        {
+            tipo_enemigo = 1 + (aleatorio_entero(aleatorio, 3)); // Perseguidor, Francotirador o Tanque
+        }
 
-            asignar_imagen_enemigo(&enemigos[i], imagenes_enemigos);
+        init_enemigo_tipo(&nuevo, (int)(pos_x / TILE_ANCHO), (int)(pos_y / TILE_ALTO), tipo_enemigo, imagenes_enemigos[tipo_enemigo], aleatorio);
 
-            enemigos[i].activo = true;
-            invocados++;
-            jefe->enemigos_invocados++;
+        asignar_imagen_enemigo(&nuevo, imagenes_enemigos);
 
-            if (*num_enemigos < i + 1)
-            {
-                *num_enemigos = i + 1; // Asegurar que el número de enemigos activos se actualice
-            }
-        }
+        nuevo.activo = true;
+        agregar_enemigo_pool(enemigos, &nuevo);
+        invocados++;
+        jefe->enemigos_invocados++;
     }
 
-    printf("Jefe invocó %d enemigos (Total invocados: %d/%d)\n", invocados, jefe->enemigos_invocados, jefe->max_enemigos_invocacion);
+    TRAZA(TRAZA_JEFE, NIVEL_TRAZA_EVENTO, TRAZA_JEFE_INVOCACION, invocados, jefe->enemigos_invocados);
 }
 
 
@@ -5753,7 +7154,7 @@ bool jefe_recibir_dano(Jefe* jefe, float dano, ColaMensajes* cola_mensajes)
     char mensaje[100];
     jefe->vida -= dano;
 
-    printf("Jefe recibió %.2f de daño. Vida restante: %.2f/%.2f\n", dano, jefe->vida, jefe->vida_max);
+    TRAZA(TRAZA_JEFE, NIVEL_TRAZA_EVENTO, TRAZA_JEFE_DANO, dano, jefe->vida);
     
     if (jefe->vida <= 0.0f)
     {
@@ -5779,13 +7180,12 @@ bool jefe_recibir_dano(Jefe* jefe, float dano, ColaMensajes* cola_mensajes)
  * evitando tener que pasar false y NULL explícitamente.
  * 
  * @param estado Puntero al estado del juego.
- * @param enemigos Arreglo de enemigos del nivel actual.
- * @param num_enemigos Número de enemigos en el arreglo.
+ * @param enemigos Pool de enemigos del nivel actual.
  * @param tiempo_actual Tiempo actual del juego.
  */
-void actualizar_estado_nivel_sin_jefe(EstadoJuego* estado, Enemigo enemigos[], int num_enemigos, double tiempo_actual)
+void actualizar_estado_nivel_sin_jefe(EstadoJuego* estado, PoolEnemigos *enemigos, double tiempo_actual)
 {
-    actualizar_estado_nivel(estado, enemigos, num_enemigos, tiempo_actual, false, NULL);
+    actualizar_estado_nivel(estado, enemigos, tiempo_actual, false, NULL);
 }
 
 
@@ -5841,7 +7241,7 @@ void dibujar_boton_individual(Boton boton, ALLEGRO_FONT* fuente, int cursor_x, i
  * @param nave Nave del jugador con información del escudo.
  * @param fuente Fuente de texto para renderizar la información.
  */
-void dibujar_info_escudo(Nave nave, ALLEGRO_FONT *fuente)
+void dibujar_info_escudo(const Nave *nave, ALLEGRO_FONT *fuente)
 {
     int escudo_x = 10;
     int escudo_y = 500;
@@ -5859,7 +7259,7 @@ void dibujar_info_escudo(Nave nave, ALLEGRO_FONT *fuente)
     ALLEGRO_COLOR color_punto;
     ALLEGRO_COLOR color_fondo_inactivo;
     
-    if (nave.escudo.activo && nave.escudo.hits_restantes > 0)
+    if (nave->escudo.activo && nave->escudo.hits_restantes > 0)
     {
         // Fondo del cuadro del escudo
         ALLEGRO_COLOR color_fondo = al_map_rgba(0, 100, 150, 120);
@@ -5877,7 +7277,7 @@ void dibujar_info_escudo(Nave nave, ALLEGRO_FONT *fuente)
         barra_ancho = cuadro_ancho - 20;
         barra_alto = 8;
         
-        porcentaje_escudo = (float)nave.escudo.hits_restantes / nave.escudo.hits_max;
+        porcentaje_escudo = (float)nave->escudo.hits_restantes / nave->escudo.hits_max;
         
         // Color de la barra según la resistencia restante
         if (porcentaje_escudo > 0.66f)
@@ -5900,12 +7300,12 @@ void dibujar_info_escudo(Nave nave, ALLEGRO_FONT *fuente)
                         al_map_rgb(150, 150, 150), 1);
         
         // INDICADORES VISUALES DE HITS (puntos individuales)
-        for (i = 0; i < nave.escudo.hits_max; i++)
+        for (i = 0; i < nave->escudo.hits_max; i++)
         {
             punto_x = barra_x + 5 + (i * 20);
             punto_y = barra_y + barra_alto + 8;
             
-            color_punto = (i < nave.escudo.hits_restantes) ? al_map_rgb(0, 255, 255) : al_map_rgba(100, 100, 100, 100);
+            color_punto = (i < nave->escudo.hits_restantes) ? al_map_rgb(0, 255, 255) : al_map_rgba(100, 100, 100, 100);
             
             al_draw_filled_circle(punto_x, punto_y, 4, color_punto);
             al_draw_circle(punto_x, punto_y, 4, al_map_rgb(200, 200, 200), 1);
@@ -6216,16 +7616,46 @@ void manejar_eventos_joystick(ALLEGRO_EVENT evento)
     }
 }
 
+/**
+ * @brief Lee del joystick los ejes y botones que mueven la nave.
+ *
+ * @param joystick Puntero al joystick, si es NULL los ejes quedan en cero.
+ * @param ejes Estado leído.
+ */
+void leer_ejes_joystick(ALLEGRO_JOYSTICK *joystick, EjesJoystick *ejes)
+{
+    ALLEGRO_JOYSTICK_STATE estado_joystick;
+
+    memset(ejes, 0, sizeof(EjesJoystick));
+
+    if (!joystick) return;
+
+    al_get_joystick_state(joystick, &estado_joystick);
+
+    ejes->stick_x = estado_joystick.stick[0].axis[0];
+    ejes->stick_y = estado_joystick.stick[0].axis[1];
+    ejes->stick_rx = estado_joystick.stick[1].axis[0];
+
+    // Verificar si hay suficientes botones antes de acceder
+    if (al_get_joystick_num_buttons(joystick) > 4)
+    {
+        ejes->boton_l = estado_joystick.button[4]; // L1/LB
+    }
+    if (al_get_joystick_num_buttons(joystick) > 5)
+    {
+        ejes->boton_r = estado_joystick.button[5]; // R1/RB
+    }
+}
+
 /**
  * @brief Actualiza el movimiento de la nave usando joystick.
  * 
  * @param nave Puntero a la nave.
- * @param joystick Puntero al joystick.
+ * @param ejes Estado del joystick leído para este paso.
  * @param tilemap Mapa de tiles para colisiones.
  */
-void actualizar_nave_joystick(Nave* nave, ALLEGRO_JOYSTICK *joystick, Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS])
+void actualizar_nave_joystick(Nave* nave, const EjesJoystick *ejes, Tilemap *tilemap)
 {
-    ALLEGRO_JOYSTICK_STATE estado_joystick;
     float stick_x, stick_y;
     float nueva_x, nueva_y;
     const float velocidad_movimiento;
@@ -6233,18 +7663,14 @@ void actualizar_nave_joystick(Nave* nave, ALLEGRO_JOYSTICK *joystick, Tile tilem
     float stick_rx;
     bool boton_L, boton_R;
     
-    if (!joystick) return;
-    
-    al_get_joystick_state(joystick, &estado_joystick);
-    
     nueva_x = nave->x;
     nueva_y = nave->y;
     
     if (nave->tipo == 0) // Movimiento Space Invaders
     {
         // Stick izquierdo para movimiento horizontal
-        stick_x = estado_joystick.stick[0].axis[0]; // Horizontal del stick izquierdo
-        stick_y = estado_joystick.stick[0].axis[1]; // Vertical del stick izquierdo
+        stick_x = ejes->stick_x; // Horizontal del stick izquierdo
+        stick_y = ejes->stick_y; // Vertical del stick izquierdo
         
         // Movimiento horizontal (izquierda/derecha)
         if (fabs(stick_x) > DEADZONE_JOYSTICK)
@@ -6269,49 +7695,39 @@ void actualizar_nave_joystick(Nave* nave, ALLEGRO_JOYSTICK *joystick, Tile tilem
         const float velocidad_movimiento = 4.0f;
         
         // Stic
-        stick_rx = estado_joystick.stick[1].axis[0];
+        stick_rx = ejes->stick_rx;
         
         // Botones de hombro como alternativa para rotación
-        boton_L = false;
-        boton_R = false;
-        
-        // Verificar si hay suficientes botones antes de acceder
-        if (al_get_joystick_num_buttons(joystick) > 4)
-        {
-            boton_L = estado_joystick.button[4]; // L1/LB
-        }
-        if (al_get_joystick_num_buttons(joystick) > 5)
-        {
-            boton_R = estado_joystick.button[5]; // R1/RB
-        }
+        boton_L = ejes->boton_l;
+        boton_R = ejes->boton_r;
         
         // Rotación con stick derecho
         if (fabs(stick_rx) > DEADZONE_JOYSTICK)
         {
             nave->angulo += stick_rx * velocidad_rotacion;
-            printf("Rotando con stick derecho: %.2f\n", stick_rx); // Debug
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_NAVE_ROTAR_STICK, stick_rx, 0);
         }
         // Botones de hombro como backup
         else if (boton_L)
         {
             nave->angulo -= velocidad_rotacion;
-            printf("Rotando con L1\n"); // Debug
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_NAVE_ROTAR_L1, 0, 0);
         }
         else if (boton_R)
         {
             nave->angulo += velocidad_rotacion;
-            printf("Rotando con R1\n"); // Debug
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_NAVE_ROTAR_R1, 0, 0);
         }
         
         // Stick izquierdo para movimiento hacia adelante
-        stick_y = estado_joystick.stick[0].axis[1]; // Stick izquierdo vertical
+        stick_y = ejes->stick_y; // Stick izquierdo vertical
         
         // Solo permitir movimiento hacia adelante (valores negativos)
         if (stick_y < -DEADZONE_JOYSTICK)
         {
             nueva_x = nave->x + cos(nave->angulo - ALLEGRO_PI/2) * (-stick_y * velocidad_movimiento);
             nueva_y = nave->y + sin(nave->angulo - ALLEGRO_PI/2) * (-stick_y * velocidad_movimiento);
-            printf("Moviendo hacia adelante: %.2f\n", stick_y); // Debug
+            TRAZA(TRAZA_NAVE, NIVEL_TRAZA_DETALLE, TRAZA_NAVE_AVANZAR_STICK, stick_y, 0);
         }
         
         // Verificar colisiones y límites
@@ -6361,10 +7777,12 @@ bool obtener_boton_joystick_disparar(ALLEGRO_JOYSTICK *joystick)
 /**
  * @brief Maneja el cambio de armas con joystick (VERSIÓN MEJORADA).
  * 
- * @param nave Puntero a la nave.
+ * El arma elegida se agrega como acción a la entrada del próximo paso.
+ *
+ * @param entrada Entrada del próximo paso.
  * @param joystick Puntero al joystick.
  */
-void cambiar_arma_joystick(Nave *nave, ALLEGRO_JOYSTICK *joystick)
+void cambiar_arma_joystick(EntradaPaso *entrada, ALLEGRO_JOYSTICK *joystick)
 {
     ALLEGRO_JOYSTICK_STATE estado_joystick;
     static double ultimo_cambio = 0;
@@ -6387,8 +7805,6 @@ void cambiar_arma_joystick(Nave *nave, ALLEGRO_JOYSTICK *joystick)
     num_ejes = al_get_joystick_num_sticks(joystick);
     num_botones = al_get_joystick_num_buttons(joystick);
     
-    printf("Controlador: %d sticks, %d botones\n", num_ejes, num_botones);
-    
     // Intentar D-pad como ejes adicionales (PlayStation)
     if (num_ejes >= 2 && al_get_joystick_num_axes(joystick, 0) >= 8)
     {
@@ -6426,25 +7842,25 @@ void cambiar_arma_joystick(Nave *nave, ALLEGRO_JOYSTICK *joystick)
         switch (dpad_estado_actual)
         {
             case 1: // Arriba
-                cambiar_arma(nave, Arma_normal);
+                agregar_accion_entrada(entrada, ACCION_CAMBIAR_ARMA, Arma_normal);
                 cambio_realizado = true;
                 printf("Arma cambiada a Normal (D-pad Arriba)\n");
                 break;
                 
             case 2: // Derecha
-                cambiar_arma(nave, Arma_laser);
+                agregar_accion_entrada(entrada, ACCION_CAMBIAR_ARMA, Arma_laser);
                 cambio_realizado = true;
                 printf("Arma cambiada a Laser (D-pad Derecha)\n");
                 break;
                 
             case 3: // Abajo
-                cambiar_arma(nave, Arma_explosiva);
+                agregar_accion_entrada(entrada, ACCION_CAMBIAR_ARMA, Arma_explosiva);
                 cambio_realizado = true;
                 printf("Arma cambiada a Explosiva (D-pad Abajo)\n");
                 break;
                 
             case 4: // Izquierda
-                cambiar_arma(nave, Arma_misil);
+                agregar_accion_entrada(entrada, ACCION_CAMBIAR_ARMA, Arma_misil);
                 cambio_realizado = true;
                 printf("Arma cambiada a Misil (D-pad Izquierda)\n");
                 break;
@@ -6457,7 +7873,6 @@ void cambiar_arma_joystick(Nave *nave, ALLEGRO_JOYSTICK *joystick)
     if (cambio_realizado)
     {
         ultimo_cambio = tiempo_actual;
-        printf("Arma actual: %s (Nivel %d)\n", nave->armas[nave->arma_seleccionada].nombre, nave->armas[nave->arma_seleccionada].nivel);
     }
 }
 
@@ -6612,6 +8027,59 @@ void liberar_imagenes_jefes(ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES])
     printf("Imágenes de jefes liberadas correctamente\n");
 }
 
+
+/**
+ * @brief Copia al atlas todas las imágenes del juego, escaladas a su tamaño en pantalla.
+ * 
+ * Cada imagen se reemplaza por su sprite dentro del atlas. Si el atlas no se puede crear
+ * o se llena, las imágenes que no entraron se reemplazan por copias sueltas del mismo
+ * tamaño. De una forma u otra cada sprite queda del tamaño con que se dibuja, y las
+ * funciones de dibujo lo copian sin escalar.
+ * 
+ * @param atlas Atlas donde se copian las imágenes.
+ * @param imagen_nave Imagen de la nave.
+ * @param imagen_asteroide Imagen de los asteroides.
+ * @param imagen_tile_asteroide Devuelve el sprite de los tiles de asteroide, o NULL si no se pudo crear.
+ * @param imagen_enemigo Imagen genérica de los enemigos.
+ * @param imagenes_enemigos Array con las imágenes de cada tipo de enemigo.
+ * @param imagenes_jefes Array con las imágenes de cada tipo de jefe.
+ * @return bool true si todas las imágenes quedaron en el atlas.
+ */
+bool empaquetar_sprites_juego(AtlasSprites *atlas, ALLEGRO_BITMAP **imagen_nave, ALLEGRO_BITMAP **imagen_asteroide, ALLEGRO_BITMAP **imagen_tile_asteroide, ALLEGRO_BITMAP **imagen_enemigo, ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS], ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES])
+{
+    bool completo = true;
+    int i;
+
+    // Sin atlas cada imagen queda suelta, pero igual se escala acá
+    crear_atlas_sprites(atlas, ANCHO_ATLAS, ALTO_ATLAS);
+
+    // El tile se copia antes de que la imagen del asteroide pase al atlas
+    *imagen_tile_asteroide = agregar_sprite_atlas(atlas, *imagen_asteroide, TILE_ANCHO, TILE_ALTO);
+    if (!*imagen_tile_asteroide)
+    {
+        completo = false;
+        *imagen_tile_asteroide = crear_imagen_escalada(*imagen_asteroide, TILE_ANCHO, TILE_ALTO);
+    }
+
+    completo = mover_imagen_a_atlas(atlas, imagen_nave, 50, 50) && completo;
+    completo = mover_imagen_a_atlas(atlas, imagen_asteroide, 50, 50) && completo;
+    completo = mover_imagen_a_atlas(atlas, imagen_enemigo, tamanos_enemigos[0].ancho, tamanos_enemigos[0].alto) && completo;
+
+    for (i = 0; i < NUM_TIPOS_ENEMIGOS; i++)
+    {
+        completo = mover_imagen_a_atlas(atlas, &imagenes_enemigos[i], tamanos_enemigos[i].ancho, tamanos_enemigos[i].alto) && completo;
+    }
+
+    for (i = 0; i < NUM_TIPOS_JEFES; i++)
+    {
+        completo = mover_imagen_a_atlas(atlas, &imagenes_jefes[i], tamanos_jefes[i].ancho, tamanos_jefes[i].alto) && completo;
+    }
+
+    printf("Atlas de sprites armado (%dx%d)%s\n", ANCHO_ATLAS, ALTO_ATLAS, completo ? "" : ", algunas imágenes quedaron sueltas ya escaladas");
+
+    return completo;
+}
+
 /**
  * @brief Asigna la imagen correcta al jefe según su tipo.
  * 
@@ -1,27 +1,42 @@
 #include "ventana.h"
 #include "juego.h"
+#include "simulacion.h"
+#include "estres.h"
 
 /**
  * @file main.c 
  *
  * @brief Funcion main en donde se ejecutara todo el juego
+ *
+ * Opciones de linea de comandos:
+ * - --headless [frames]: ejecuta la simulación sin ventana y reporta los frames por segundo.
+ * - --nivel N: nivel con el que comienza la simulación headless.
+ * - --trace ARCHIVO: registra trazas binarias y las vuelca en ARCHIVO al salir o con F9.
+ * - --fps N: frecuencia de dibujo (por ejemplo 120 o 144); la simulación siempre avanza a FPS pasos por segundo.
+ * - --seed N: semilla de la partida; con la misma semilla la simulación se repite igual.
+ * - --record ARCHIVO: graba la entrada de la partida para repetirla después.
+ * - --replay ARCHIVO: repite una partida grabada; con --headless se repite sin ventana y lo más rápido posible.
+ * - --telemetry ARCHIVO: guarda un registro por frame (CSV, o eventos de Chrome si termina en .json).
+ * - --stress [escenario] [pasos]: corre sin ventana los mapas de peor caso (enemigos, escudos, jefe, o todos si no se indica).
  * 
  * @return int 
  */
 
-int main() 
+int main(int argc, char *argv[]) 
 {
-    srand(time(NULL)); // Inicializa el generador de números aleatorios
-    bool teclas[ALLEGRO_KEY_MAX] = {false};
     int i;
-    int j;
-    int k;
-    float nave_x_inicial;
-    float nave_y_inicial;
     bool debug_mode = false;
-    DisparoLaser lasers[5];
-    DisparoExplosivo explosivos[8];
-    MisilTeledirigido misil[6];
+    bool modo_headless = false;
+    int frames_headless = 0;
+    int nivel_headless = 1;
+    int fps_pantalla = FPS;
+    uint64_t semilla = (uint64_t)time(NULL);
+    const char *ruta_grabacion = NULL;
+    const char *ruta_repeticion = NULL;
+    const char *ruta_telemetria = NULL;
+    bool modo_estres = false;
+    int escenario_estres = -1;
+    int ticks_estres = 0;
 
     // Inicializar Allegro y sus addons
     ALLEGRO_DISPLAY *ventana = NULL;
@@ -36,6 +51,9 @@ int main()
     ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES];
     ALLEGRO_SAMPLE *musica_menu = NULL;
     ALLEGRO_SAMPLE_INSTANCE *instancia_musica = NULL;
+    CapaTilemap capa_tilemap;
+    AtlasSprites atlas_sprites;
+    ALLEGRO_BITMAP *imagen_tile_asteroide = NULL;
 
     // Variables del menu principal
     ALLEGRO_BITMAP *imagen_menu = NULL;
@@ -49,56 +67,26 @@ int main()
     int boton_clicado;
     bool musica_activa = false;
 
-    Tile tilemap[MAPA_FILAS][MAPA_COLUMNAS];
-
-    Enemigo enemigos_mapa[NUM_ENEMIGOS];
-    int num_enemigos_cargados = 0;
+    // Estado de la partida
+    static Simulacion sim;
+    static PosicionesSimulacion posiciones_actuales;
+    double tiempo_anterior;
+    double acumulador;
+    EntradaPaso entrada;
+    ConteoPerfil conteos_perfil[NUM_CONTEOS_SIMULACION];
+    Repeticion grabacion;
+    Repeticion repeticion;
+    uint32_t frame_telemetria = 0;
+    double inicio_frame;
+    double fin_simulacion;
 
     int contador_parpadeo_powerups = 0;
     int contador_debug_powerups = 0;
-    int contador_debug_lasers = 0;
-    Jefe jefe_final;
-    Jefe jefe_nivel;
-    bool hay_jefe_en_nivel = false;
     ALLEGRO_EVENT evento_temp;
     ALLEGRO_EVENT evento;
-    bool recargar_nivel;
-    bool juego_terminado;
-    Asteroide asteroides[NUM_ASTEROIDES];
-    EstadoJuego estado_nivel;
-    Nave nave;
-    Disparo disparos[MAX_DISPAROS];
-    Powerup powerups[MAX_POWERUPS];
-    Disparo disparos_enemigos[NUM_DISPAROS_ENEMIGOS];
-    Enemigo enemigos[NUM_ENEMIGOS];
-    int tipo_jefe;
-    int puntaje;
-    ColaMensajes cola_mensajes;
     double tiempo_cache;
-    bool laser_activo;
-    int laser_desactivado;
-    int siguiente_nivel;
-    int nivel_disparo_radial_guardado;
-    int kills_para_mejora_guardado;
-    int tipo_nave_guardado;
-    SistemaArma armas_guardadas[4];
-    int clear_i;
-    TipoArma arma_actual_guardada;
-    int arma_seleccionada_guardada;
-    int enemigos_a_copiar;
-    bool hay_lasers_activos;
-    int laser_check;
-    bool hay_explosivos_activos;
-    int exp_check;
-    bool hay_misiles_activos;
-    int mis_check;
-    int enemigos_restantes;
-    int z;
-    char msg_enemigos[100];
-    float alcance_real;
     double tiempo_actual;
     double tiempo_transcurrido;
-    char texto_nivel[50];
     char nombre_jugador[MAX_NOMBRE];
     char texto_puntaje_final[100];
     bool esperando;
@@ -106,11 +94,111 @@ int main()
     int num_jugadores;
     ConfiguracionControl config_control;
 
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0)
+        {
+            modo_headless = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                frames_headless = atoi(argv[++i]);
+            }
+        }
+        else if (strcmp(argv[i], "--nivel") == 0 && i + 1 < argc)
+        {
+            nivel_headless = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+        {
+            fps_pantalla = atoi(argv[++i]);
+            if (fps_pantalla <= 0)
+            {
+                fps_pantalla = FPS;
+            }
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            activar_traza(argv[++i], NIVEL_TRAZA_DETALLE);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            semilla = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            ruta_grabacion = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            ruta_repeticion = argv[++i];
+        }
+        else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc)
+        {
+            ruta_telemetria = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stress") == 0)
+        {
+            modo_estres = true;
+            if (i + 1 < argc && buscar_escenario_estres(argv[i + 1]) >= 0)
+            {
+                escenario_estres = buscar_escenario_estres(argv[++i]);
+            }
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                ticks_estres = atoi(argv[++i]);
+            }
+        }
+    }
+
+    printf("Semilla: %llu\n", (unsigned long long)semilla);
+
+    // al_init va antes para que los tiempos de la telemetría tengan la misma referencia que el juego
+    if (ruta_telemetria && al_init())
+    {
+        iniciar_telemetria(ruta_telemetria);
+    }
+
+    if (modo_estres)
+    {
+        // Sin escenario se corren todos, uno detrás de otro con la misma semilla
+        for (i = 0; i < NUM_ESCENARIOS_ESTRES; i++)
+        {
+            if ((escenario_estres < 0 || escenario_estres == i) && ejecutar_estres((EscenarioEstres)i, ticks_estres, semilla) < 0)
+            {
+                terminar_telemetria();
+                volcar_traza();
+                return -1;
+            }
+        }
+        terminar_telemetria();
+        volcar_traza();
+        al_uninstall_system();
+        return 0;
+    }
+
+    if (modo_headless)
+    {
+        // Solo se simula: sin ventana, fuente, imágenes ni audio
+        if ((ruta_repeticion ? ejecutar_repeticion_headless(ruta_repeticion) : ejecutar_simulacion_headless(nivel_headless, frames_headless, semilla)) < 0)
+        {
+            terminar_telemetria();
+            volcar_traza();
+            return -1;
+        }
+        terminar_telemetria();
+        volcar_traza();
+        al_uninstall_system();
+        return 0;
+    }
+
     if (init_juego(&ventana, &cola_eventos, &temporizador, &fuente, &fondo_juego, &imagen_nave, &imagen_asteroide, &imagen_enemigo, &imagen_menu, &musica_menu) != 0)
     {
         return -1;
     }
 
+    // El temporizador solo marca cuándo dibujar, la simulación lleva su propio paso fijo
+    al_set_timer_speed(temporizador, 1.0 / fps_pantalla);
+
     if (musica_menu)
     {
         // Crear instancia para mejor control de reproducción
@@ -134,7 +222,12 @@ int main()
     printf("Estado del joystick: %s\n", config_control.joystick_disponible ? "Disponible" : "No disponible");
 
     // MOSTRAR MENÚ DE SELECCIÓN DE CONTROL
-    if (config_control.joystick_disponible)
+    if (ruta_repeticion)
+    {
+        // La repetición trae su propia entrada
+        config_control.tipo_control = CONTROL_TECLADO;
+    }
+    else if (config_control.joystick_disponible)
     {
         printf("Mostrando menú de selección de control...\n");
         mostrar_menu_seleccion_control(fuente, &config_control, cola_eventos);
@@ -204,6 +297,13 @@ int main()
         return -1;
     }
 
+    // Todos los sprites pasan a un solo atlas para dibujarlos por lotes
+    empaquetar_sprites_juego(&atlas_sprites, &imagen_nave, &imagen_asteroide, &imagen_tile_asteroide, &imagen_enemigo, imagenes_enemigos, imagenes_jefes);
+    // Los fondos no entran en el atlas: se escalan una vez a la ventana y se copian tal cual
+    escalar_imagen(&fondo_juego, ANCHO_VENTANA, ALTO_VENTANA);
+    escalar_imagen(&imagen_menu, ANCHO_VENTANA, ALTO_VENTANA);
+    crear_capa_tilemap(&capa_tilemap, imagen_tile_asteroide ? imagen_tile_asteroide : imagen_asteroide);
+
     if (instancia_musica && !musica_activa)
     {
         if (al_play_sample_instance(instancia_musica))
@@ -225,6 +325,16 @@ int main()
     mostrarRanking = false;
     volver_menu = false;
 
+    memset(&grabacion, 0, sizeof(Repeticion));
+    memset(&repeticion, 0, sizeof(Repeticion));
+
+    // Una repetición con ventana empieza directamente en la partida
+    if (ruta_repeticion)
+    {
+        en_menu = false;
+        jugando = true;
+    }
+
     cursor_x = 0;
     cursor_y = 0;
 
@@ -406,7 +516,7 @@ int main()
 
                 if (imagen_menu)
                 {
-                    al_draw_scaled_bitmap(imagen_menu, 0, 0, al_get_bitmap_width(imagen_menu), al_get_bitmap_height(imagen_menu), 0, 0, 800, 600, 0);
+                    al_draw_bitmap(imagen_menu, 0, 0, 0);
                 }
                 else
                 {
@@ -433,7 +543,7 @@ int main()
                 al_flip_display();
             }
         }
-    
+        
         if (jugando)
         {
             if (instancia_musica && musica_activa)
@@ -443,155 +553,62 @@ int main()
                 printf("Música del menú pausada durante el juego.\n");
             }
 
-            hay_jefe_en_nivel = false;
-            memset(&jefe_final, 0, sizeof(Jefe));
-            jefe_nivel.activo = false;
-
-            memset(teclas, false, sizeof(teclas)); // Reiniciar teclas
-
-            // Recargo el nivel 1 desde cero
-            cargar_tilemap("Nivel1.txt", tilemap, enemigos_mapa, &num_enemigos_cargados, imagen_enemigo, &nave_x_inicial, &nave_y_inicial);
-
-            // Inicializar estado del juego
-            init_estado_juego(&estado_nivel);
-
-            recargar_nivel = false;
-            juego_terminado = false;
-
-            // Inicializar asteroides
-            init_asteroides(asteroides, NUM_ASTEROIDES, 800, imagen_asteroide);
-
-            // Inicializar nave
-            nave = init_nave(nave_x_inicial, nave_y_inicial, 50, 50, 100.0f, 0.1, imagen_nave);
-
-            memset(teclas, false, sizeof(teclas)); // Reiniciar teclas
-
-            // Inicializar el sistema de armas
-            init_sistema_armas(&nave);
-
-            for (i = 0; i < 5; i++)
+            if (ruta_repeticion && !abrir_repeticion(&repeticion, ruta_repeticion))
             {
-                lasers[i].activo = false;
-            }
-
-            for (i = 0; i < 8; i++)
-            {
-                explosivos[i].activo = false;
-                explosivos[i].exploto = false;
-                explosivos[i].dano_aplicado = false;
-                explosivos[i].x = 0;
-                explosivos[i].y = 0;
-                explosivos[i].vx = 0;
-                explosivos[i].vy = 0;
-                explosivos[i].tiempo_vida = 0;
-            }
-
-            for (i = 0; i < 6; i++)
-            {
-                misil[i].activo = false;
+                jugando = false;
+                en_menu = false;
+                continue;
             }
 
-            // Inicializar disparos
-            init_disparos(disparos, MAX_DISPAROS);
+            init_simulacion(&sim, imagen_nave, imagen_asteroide, imagen_enemigo, imagenes_enemigos, imagenes_jefes, ruta_repeticion ? repeticion.encabezado.semilla : semilla);
 
-            // Inicializar Powerups
-            for (k = 0; k < MAX_POWERUPS; k++)
-            {
-                init_powerup(&powerups[k]);
-            }
-            
-            // Inicializar Enemigos
-            for (i = 0; i < num_enemigos_cargados && i < NUM_ENEMIGOS; i++)
+            if (ruta_repeticion)
             {
-                enemigos[i] = enemigos_mapa[i];
-                asignar_imagen_enemigo(&enemigos[i], imagenes_enemigos); // Asegurar que usen el sprite correcto
+                sim.control_joystick = repeticion.encabezado.control_joystick != 0;
             }
-            // Inicializar el resto como inactivos
-            for (i = num_enemigos_cargados; i < NUM_ENEMIGOS; i++) 
+            else if (config_control.tipo_control == CONTROL_JOYSTICK && config_control.joystick)
             {
-                enemigos[i].activo = false;
+                sim.control_joystick = true;
             }
 
-            hay_jefe_en_nivel = false;
-
-            printf("Verificando jefes para nivel %d con %d enemigos cargados\n", estado_nivel.nivel_actual, num_enemigos_cargados);
-
-            if (estado_nivel.nivel_actual >= 4)
-            {
-                for (i = 0; i < num_enemigos_cargados; i++)
-                {
-                    printf("Enemigo %d: tipo %d en (%.0f, %.0f)\n", i, enemigos_mapa[i].tipo, enemigos_mapa[i].x, enemigos_mapa[i].y);
-
-                    if (enemigos_mapa[i].tipo == 5 || enemigos_mapa[i].tipo == 6) 
-                    {
-                        tipo_jefe = enemigos_mapa[i].tipo == 5 ? 0 : 1; // 5=Destructor(0), 6=Supremo(1)
-                        init_jefe(&jefe_nivel, tipo_jefe, enemigos_mapa[i].x, enemigos_mapa[i].y, imagenes_jefes[tipo_jefe]);
-                        hay_jefe_en_nivel = true;
-                        printf("Jefe encontrado en nivel %d: tipo %d\n", estado_nivel.nivel_actual, tipo_jefe);
-                    
-                        // Remover jefe del array de enemigos normales
-                        for (k = i; k < num_enemigos_cargados - 1; k++) 
-                        {
-                            enemigos_mapa[k] = enemigos_mapa[k + 1];
-                        }
-                        num_enemigos_cargados--;
-                        break;
-                    }
-                }
-                if (!hay_jefe_en_nivel)
-                {
-                    printf("Nivel %d: Sin jefes encontrados\n", estado_nivel.nivel_actual);
-                }
-            }
-            else
+            // Recargo el nivel 1 desde cero
+            if (!iniciar_partida(&sim, ruta_repeticion ? repeticion.encabezado.nivel : 1))
             {
-                printf("Nivel %d: No debería tener jefes\n", estado_nivel.nivel_actual);
+                fprintf(stderr, "Error: No se pudo cargar el nivel 1.\n");
+                cerrar_repeticion(&repeticion);
+                jugando = false;
+                en_menu = !ruta_repeticion;
+                continue;
             }
 
-            for (i = 0; i < num_enemigos_cargados && i < NUM_ENEMIGOS; i++)
+            memset(&entrada, 0, sizeof(EntradaPaso));
+            if (ruta_grabacion && !ruta_repeticion)
             {
-                enemigos[i] = enemigos_mapa[i];
-                asignar_imagen_enemigo(&enemigos[i], imagenes_enemigos); // Asegurar que usen el sprite correcto
-                printf("Enemigo normal %d copiado: tipo %d\n", i, enemigos[i].tipo);
+                iniciar_grabacion(&grabacion, ruta_grabacion, semilla, 1, sim.control_joystick);
             }
             
-            for (i = num_enemigos_cargados; i < NUM_ENEMIGOS; i++)
-            {
-                enemigos[i].activo = false;
-            }
-            
-            printf("=== RESUMEN NIVEL %d ===\n", estado_nivel.nivel_actual);
-            printf("Jefe activo: %s\n", hay_jefe_en_nivel ? "SI" : "NO");
-            printf("Enemigos normales: %d\n", num_enemigos_cargados);
-            
-            init_disparos(disparos_enemigos, NUM_DISPAROS_ENEMIGOS);
-
-            // Inicializar puntaje en 0
-            puntaje = 0;
-
-            // Inicializar Mensajes
-            init_cola_mensajes(&cola_mensajes);
-            
             // ✅ MOSTRAR INSTRUCCIONES INICIALES SEGÚN TIPO DE CONTROL
             if (config_control.tipo_control == CONTROL_JOYSTICK && config_control.joystick_disponible)
             {
-                agregar_mensaje_cola(&cola_mensajes, "Controles de Joystick Activados!", 4.0, al_map_rgb(0, 255, 0), true);
-                agregar_mensaje_cola(&cola_mensajes, "Stick izquierdo: Mover", 3.0, al_map_rgb(255, 255, 255), true);
-                agregar_mensaje_cola(&cola_mensajes, "Stick derecho: Rotar", 3.0, al_map_rgb(255, 255, 255), true);
-                agregar_mensaje_cola(&cola_mensajes, "Botón A/X: DISPARAR", 3.0, al_map_rgb(255, 255, 0), true);
-                agregar_mensaje_cola(&cola_mensajes, "Cruceta/D-pad: Cambiar Arma", 3.0, al_map_rgb(255, 255, 255), true);
+                agregar_mensaje_cola(&sim.cola_mensajes, "Controles de Joystick Activados!", 4.0, al_map_rgb(0, 255, 0), true);
+                agregar_mensaje_cola(&sim.cola_mensajes, "Stick izquierdo: Mover", 3.0, al_map_rgb(255, 255, 255), true);
+                agregar_mensaje_cola(&sim.cola_mensajes, "Stick derecho: Rotar", 3.0, al_map_rgb(255, 255, 255), true);
+                agregar_mensaje_cola(&sim.cola_mensajes, "Botón A/X: DISPARAR", 3.0, al_map_rgb(255, 255, 0), true);
+                agregar_mensaje_cola(&sim.cola_mensajes, "Cruceta/D-pad: Cambiar Arma", 3.0, al_map_rgb(255, 255, 255), true);
             }
             else
             {
-                agregar_mensaje_cola(&cola_mensajes, "Stick izquierdo: Mover libremente", 3.5, al_map_rgb(255, 255, 255), true);
-                agregar_mensaje_cola(&cola_mensajes, "Stick derecho: Rotar nave", 3.5, al_map_rgb(255, 255, 255), true);
-                agregar_mensaje_cola(&cola_mensajes, "A/X: Disparo, D-pad: Cambiar Arma", 3.5, al_map_rgb(255, 255, 0), true);
+                agregar_mensaje_cola(&sim.cola_mensajes, "Stick izquierdo: Mover libremente", 3.5, al_map_rgb(255, 255, 255), true);
+                agregar_mensaje_cola(&sim.cola_mensajes, "Stick derecho: Rotar nave", 3.5, al_map_rgb(255, 255, 255), true);
+                agregar_mensaje_cola(&sim.cola_mensajes, "A/X: Disparo, D-pad: Cambiar Arma", 3.5, al_map_rgb(255, 255, 0), true);
             }
 
             tiempo_cache = 0;
+            tiempo_anterior = al_get_time();
+            acumulador = 0;
 
             /*Bucle del juego*/
-            while (jugando && !juego_terminado) 
+            while (jugando && !sim.juego_terminado) 
             {
                 al_wait_for_event(cola_eventos, &evento);
 
@@ -603,101 +620,57 @@ int main()
                     break;
                 }
 
-                if (evento.type == ALLEGRO_EVENT_KEY_DOWN || evento.type == ALLEGRO_EVENT_KEY_UP)
+                // El teclado se convierte en acciones que se aplican al comienzo del próximo paso
+                if ((evento.type == ALLEGRO_EVENT_KEY_DOWN || evento.type == ALLEGRO_EVENT_KEY_UP) && !ruta_repeticion)
                 {
-                    if (!estado_nivel.mostrar_transicion)
+                    manejar_eventos(evento, &entrada);
+                }
+
+                if (config_control.tipo_control == CONTROL_JOYSTICK && config_control.joystick)
+                {
+                    if (evento.type == ALLEGRO_EVENT_JOYSTICK_AXIS || evento.type == ALLEGRO_EVENT_JOYSTICK_BUTTON_DOWN || evento.type == ALLEGRO_EVENT_JOYSTICK_BUTTON_UP)
                     {
-                        if (evento.type == ALLEGRO_EVENT_KEY_DOWN && evento.keyboard.keycode == ALLEGRO_KEY_SPACE)
+                        if (!sim.estado_nivel.mostrar_transicion)
                         {
-                            if (nave.arma_actual == Arma_laser)
-                            {
-                                laser_activo = false;
-                                for (i = 0; i < 5; i++)
-                                {
-                                    if (lasers[i].activo)
-                                    {
-                                        laser_activo = true;
-                                        break;
-                                    }
-                                }
-
-                                if (!laser_activo)
-                                {
-                                    disparar_laser(lasers, 5, nave);
-                                    printf("Laser activado al presionar espacio\n");
-                                }
-                                else
-                                {
-                                    printf("Ya hay un laser activo\n");
-                                }
-                            }
-                            else
-                            {
-                                disparar_segun_arma(nave, disparos, MAX_DISPAROS, lasers, 5, explosivos, 8, misil, 6, enemigos, num_enemigos_cargados);
-                            }
-                        }
-                        
-                        // Se manejan los eventos de teclado que no tengan que ver con la tecla espacio
-                        if (evento.keyboard.keycode != ALLEGRO_KEY_SPACE)
-                        {
-                            manejar_eventos(evento, &nave, teclas);
+                            manejar_eventos_joystick(evento);
                         }
                     }
                 }
-                    
-                    if (evento.type == ALLEGRO_EVENT_KEY_UP && evento.keyboard.keycode == ALLEGRO_KEY_SPACE)
-                    {
-                        if (nave.arma_actual == Arma_laser)
-                        {
-                            laser_desactivado = 0;
-                            for (i = 0; i < 5; i++)
-                            {
-                                if (lasers[i].activo)
-                                {
-                                    lasers[i].activo = false;
-                                    laser_desactivado++;
-                                }
-                            }
-
-                            if (laser_desactivado > 0)
-                            {
-                                printf("Laser desactivado al soltar la tecla espacio\n");
-                            }
-                            else
-                            {
-                                printf("No hay lasers activos para desactivar\n");
-                            }
-                        }
-                    
 
-                        if (config_control.tipo_control == CONTROL_JOYSTICK && config_control.joystick)
-                        {
-                            if (evento.type == ALLEGRO_EVENT_JOYSTICK_AXIS || evento.type == ALLEGRO_EVENT_JOYSTICK_BUTTON_DOWN || evento.type == ALLEGRO_EVENT_JOYSTICK_BUTTON_UP)
-                            {
-                                if (!estado_nivel.mostrar_transicion)
-                                {
-                                    manejar_eventos_joystick(evento);
-                                }
-                            }
-                        }
+                // Manejo de eventos de debug
+                if (evento.type == ALLEGRO_EVENT_KEY_DOWN && evento.keyboard.keycode == ALLEGRO_KEY_F1)
+                {
+                    debug_mode = !debug_mode;
+                    printf("Modo debug %s\n", debug_mode ? "ACTIVADO" : "DESACTIVADO");
+                }
 
-                    // Manejo de eventos de debug
-                    if (evento.type == ALLEGRO_EVENT_KEY_DOWN && evento.keyboard.keycode == ALLEGRO_KEY_F1)
-                    {
-                        debug_mode = !debug_mode;
-                        printf("Modo debug %s\n", debug_mode ? "ACTIVADO" : "DESACTIVADO");
-                    }
+                if (evento.type == ALLEGRO_EVENT_KEY_DOWN && evento.keyboard.keycode == ALLEGRO_KEY_F9)
+                {
+                    volcar_traza();
                 }
 
                 if (evento.type == ALLEGRO_EVENT_TIMER)
                 {
+                    reiniciar_arena_frame();
                     tiempo_cache = al_get_time();
+                    acumulador += tiempo_cache - tiempo_anterior;
+                    tiempo_anterior = tiempo_cache;
+                    inicio_frame = tiempo_telemetria();
+
+                    // Después de una demora larga solo se recuperan algunos pasos
+                    if (acumulador > MAX_PASOS_POR_FRAME * DT_SIMULACION)
+                    {
+                        acumulador = MAX_PASOS_POR_FRAME * DT_SIMULACION;
+                    }
 
                     // DISPARO CON JOYSTICK
-                    if (config_control.tipo_control == CONTROL_JOYSTICK && config_control.joystick)
+                    if (config_control.tipo_control == CONTROL_JOYSTICK && config_control.joystick && !ruta_repeticion)
                     {
-                        debug_joystick_estado(config_control.joystick);
-                        cambiar_arma_joystick(&nave, config_control.joystick);
+                        if (debug_mode)
+                        {
+                            debug_joystick_estado(config_control.joystick);
+                        }
+                        cambiar_arma_joystick(&entrada, config_control.joystick);
 
                         static bool boton_disparar_presionado = false;
                         bool boton_actual = obtener_boton_joystick_disparar(config_control.joystick);
@@ -705,576 +678,153 @@ int main()
                         // Detectar cuando se presiona el botón (no mantener presionado)
                         if (boton_actual && !boton_disparar_presionado)
                         {
-                            if (nave.arma_actual == Arma_laser)
-                            {
-                                bool laser_activo = false;
-                                for (i = 0; i < 5; i++)
-                                {
-                                    if (lasers[i].activo)
-                                    {
-                                        laser_activo = true;
-                                        break;
-                                    }
-                                }
-
-                                if (!laser_activo)
-                                {
-                                    disparar_laser(lasers, 5, nave);
-                                    printf("Laser activado con joystick\n");
-                                }
-                            }
-                            else
-                            {
-                                disparar_segun_arma(nave, disparos, MAX_DISPAROS, lasers, 5, explosivos, 8, misil, 6, enemigos, num_enemigos_cargados);
-                            }
+                            agregar_accion_entrada(&entrada, ACCION_DISPARAR, 0);
                         }
                 
                         // Para láser continuo: desactivar cuando se suelta el botón
-                        if (!boton_actual && boton_disparar_presionado && nave.arma_actual == Arma_laser)
+                        if (!boton_actual && boton_disparar_presionado)
                         {
-                            for (i = 0; i < 5; i++)
-                            {
-                                if (lasers[i].activo)
-                                {
-                                    lasers[i].activo = false;
-                                }
-                            }
-                            printf("Laser desactivado con joystick\n");
+                            agregar_accion_entrada(&entrada, ACCION_SOLTAR_DISPARO, 0);
                         }
                 
                         boton_disparar_presionado = boton_actual;
                     }
 
-                    actualizar_cola_mensajes(&cola_mensajes, tiempo_cache);
-
-                    // Verificar si necesitamos cargar el siguiente nivel
-                    if (estado_nivel.nivel_completado && !estado_nivel.mostrar_transicion && !recargar_nivel)
+                    while (acumulador >= DT_SIMULACION && !sim.juego_terminado)
                     {
-                        recargar_nivel = true;
-                        estado_nivel.nivel_completado = false;
-                    }
-
-                    // Cargar siguiente nivel si es necesario
-                    if (recargar_nivel)
-                    {
-                        siguiente_nivel = estado_nivel.nivel_actual + 1;
-
-                        if (cargar_siguiente_nivel(siguiente_nivel, tilemap, enemigos_mapa, &num_enemigos_cargados, imagen_enemigo, &nave_x_inicial, &nave_y_inicial))
+                        if (ruta_repeticion)
                         {
-                            estado_nivel.nivel_actual = siguiente_nivel;
-                            estado_nivel.todos_enemigos_eliminados = false;
-
-                            for (k = 0; k < MAX_POWERUPS; k++)
+                            if (!leer_paso(&repeticion, &entrada))
                             {
-                                powerups[k].activo = false;
-                                powerups[k].x = 0;
-                                powerups[k].y = 0;
+                                jugando = false; // Se terminó la grabación
+                                break;
                             }
-
-                            for (clear_i = 0; clear_i < MAX_DISPAROS; clear_i++)
-                            {
-                                disparos[clear_i].activo = false;
-                            }
-
-                            for (clear_i = 0; clear_i < NUM_DISPAROS_ENEMIGOS; clear_i++)
-                            {
-                                disparos_enemigos[clear_i].activo = false;
-                            }
-
-                            for (clear_i = 0; clear_i < 5; clear_i++)
-                            {
-                                lasers[clear_i].activo = false;
-                            }
-
-                            for (clear_i = 0; clear_i < 8; clear_i++)
-                            {
-                                explosivos[clear_i].activo = false;
-                            }
-
-                            for (clear_i = 0; clear_i < 6; clear_i++)
-                            {
-                                misil[clear_i].activo = false;
-                            }
-
-                            // Guardar el estado de la nave antes de reinicializarla
-                            nivel_disparo_radial_guardado = nave.nivel_disparo_radial;
-                            kills_para_mejora_guardado = nave.kills_para_mejora;
-                            tipo_nave_guardado = nave.tipo;
-
-                            for (i = 0; i < 4; i++)
-                            {
-                                armas_guardadas[i] = nave.armas[i];
-                            }
-                            
-                            arma_actual_guardada = nave.arma_actual;
-                            arma_seleccionada_guardada = nave.arma_seleccionada;
-
-                            nave.escudo.activo = false;
-
-                            // Reinicializar la nave con los valores guardados
-                            nave = init_nave(nave_x_inicial, nave_y_inicial, 50, 50, 100, 0.1, imagen_nave);
-
-                            // Restaurar los valores guardados
-                            nave.nivel_disparo_radial = nivel_disparo_radial_guardado;
-                            nave.kills_para_mejora = kills_para_mejora_guardado;
-                            nave.tipo = tipo_nave_guardado;
-
-                            for (i = 0; i < 4; i++)
-                            {
-                                nave.armas[i] = armas_guardadas[i];
-                            }
-                            
-                            nave.arma_actual = arma_actual_guardada;
-                            nave.arma_seleccionada = arma_seleccionada_guardada;
-
-                            memset(teclas, false, sizeof(teclas)); // Reiniciar teclas
-
-                            if (asteroides_activados(estado_nivel.nivel_actual)) 
-                            {
-                                init_asteroides(asteroides, NUM_ASTEROIDES, 800, imagen_asteroide);
-                            }
-                            else
-                            {
-                                for (k = 0; k < NUM_ASTEROIDES; k++)
-                                {
-                                    asteroides[k].y = -2000;
-                                    asteroides[k].x = -2000;
-                                    asteroides[k].velocidad = 0;
-                                    asteroides[k].ancho = 0;
-                                    asteroides[k].alto = 0;
-                                }
-                                printf("Asteroides DESACTIVADOS en nivel %d\n", estado_nivel.nivel_actual);
-                            }
-
-                            // MANEJAR ASTEROIDES SEGÚN EL NIVEL
-                            if (asteroides_activados(estado_nivel.nivel_actual)) {
-                                // Reinicializar asteroides para el nuevo nivel
-                                init_asteroides(asteroides, NUM_ASTEROIDES, 800, imagen_asteroide);
-                                printf("Asteroides ACTIVADOS en nivel %d\n", estado_nivel.nivel_actual);
-                            }
-                            else
-                            {
-                                // Desactivar completamente los asteroides
-                                for (k = 0; k < NUM_ASTEROIDES; k++)
-                                {
-                                    asteroides[k].y = -1000; // Fuera de la pantalla
-                                    asteroides[k].x = -1000;
-                                    asteroides[k].velocidad = 0; // Sin movimiento
-                                }
-                                printf("Asteroides DESACTIVADOS en nivel %d\n", estado_nivel.nivel_actual);
-                            }
-
-                            // RECARGAR ENEMIGOS
-                            enemigos_a_copiar = (num_enemigos_cargados < NUM_ENEMIGOS) ? num_enemigos_cargados : NUM_ENEMIGOS;
-
-                            for (k = 0; k < enemigos_a_copiar; k++) 
-                            {
-                                enemigos[k] = enemigos_mapa[k];
-                                asignar_imagen_enemigo(&enemigos[k], imagenes_enemigos); // Asegurar que usen el sprite correcto
-                                enemigos[k].activo = true;
-                            }
-
-                            hay_jefe_en_nivel = false;
-                            memset(&jefe_nivel, 0, sizeof(Jefe));
-                            jefe_nivel.activo = false;
-
-                            for (k = 0; k < num_enemigos_cargados; k++)
-                            {
-                                printf("Enemigo recarga %d: tipo %d en (%.0f, %.0f)\n", k, enemigos_mapa[k].tipo, enemigos_mapa[k].x, enemigos_mapa[k].y);
-
-                                if (enemigos_mapa[k].tipo == 5 || enemigos_mapa[k].tipo == 6)
-                                {
-                                    tipo_jefe = enemigos_mapa[k].tipo == 5 ? 0 : 1;
-                                    init_jefe(&jefe_nivel, tipo_jefe, enemigos_mapa[k].x, enemigos_mapa[k].y, imagenes_jefes[tipo_jefe]);
-                                    hay_jefe_en_nivel = true;
-                                    printf("Jefe cargado en nivel %d: enemigo tipo %d -> jefe tipo %d\n", estado_nivel.nivel_actual, enemigos_mapa[k].tipo, tipo_jefe);
-
-                                    for (j = k; j < num_enemigos_cargados - 1; j++) 
-                                    {
-                                        enemigos_mapa[j] = enemigos_mapa[j + 1];
-                                    }
-                                    num_enemigos_cargados--;
-                                    break;
-                                }
-                            }
-                            if (!hay_jefe_en_nivel) 
-                            {
-                                printf("Nivel %d: Sin jefes en recarga\n", estado_nivel.nivel_actual);
-                            }
-
-                            enemigos_a_copiar = (num_enemigos_cargados < NUM_ENEMIGOS) ? num_enemigos_cargados : NUM_ENEMIGOS;
-
-                            for (k = 0; k < enemigos_a_copiar; k++)
-                            {
-                                enemigos[k] = enemigos_mapa[k];
-                                asignar_imagen_enemigo(&enemigos[k], imagenes_enemigos);
-                                enemigos[k].activo = true;
-                                printf("Enemigo normal %d recargado: tipo %d\n", k, enemigos[k].tipo);
-                            }
-
-                            // Inicializar el resto como inactivos
-                            for (k = enemigos_a_copiar; k < NUM_ENEMIGOS; k++)
-                            {
-                                enemigos[k].activo = false;
-                            }
-
-                            printf("=== RECARGA NIVEL %d COMPLETADA ===\n", estado_nivel.nivel_actual);
-                            printf("Jefe activo: %s\n", hay_jefe_en_nivel ? "SI" : "NO");
-                            printf("Enemigos normales activos: %d\n", enemigos_a_copiar);
-                        }
-                        else 
-                        {
-                            if (siguiente_nivel > 5)
-                            {
-                                // No hay más niveles
-                            juego_terminado = true;
-                            printf("Felicidades! Has completado todos los niveles.\n");
-                            }
-                        }
-
-                        for (k = 0; k < MAX_POWERUPS; k++)
-                        {
-                            init_powerup(&powerups[k]);
-                        }
-
-                        recargar_nivel = false;
-                    }
-
-                    // Cambiar movilidad si corresponde se puso en 30 para probar
-                    if (puntaje >= 30 && nave.tipo == 0)
-                    {
-                        nave.tipo = 1;
-                        for(k = 0; k < ALLEGRO_KEY_MAX; k++)
-                        {
-                            teclas[k] = false; // Reiniciar teclas para evitar problemas de movimiento
-                        }
-                        
-                        agregar_mensaje_cola(&cola_mensajes, "Nueva Movilidad Desbloqueada!", 4.0, al_map_rgb(0, 255, 0), true);
-                        
-                        // ✅ MOSTRAR INSTRUCCIONES SEGÚN TIPO DE CONTROL
-                        if (config_control.tipo_control == CONTROL_JOYSTICK && config_control.joystick_disponible)
-                        {
-                            agregar_mensaje_cola(&cola_mensajes, "Stick izquierdo: Mover libremente", 3.5, al_map_rgb(255, 255, 255), true);
-                            agregar_mensaje_cola(&cola_mensajes, "Stick derecho: Rotar nave", 3.5, al_map_rgb(255, 255, 255), true);
                         }
                         else
                         {
-                            agregar_mensaje_cola(&cola_mensajes, "Usa las flechas para rotar y avanzar", 3.0, al_map_rgb(255, 255, 255), true);
-                        }
-                    }
-
-                    hay_lasers_activos = false;
-                    for (laser_check = 0; laser_check < 5; laser_check++)
-                    {
-                        if (lasers[laser_check].activo)
-                        {
-                            hay_lasers_activos = true;
-                            break;
-                        }
-                    }
-
-                    if (hay_lasers_activos)
-                    {
-                        actualizar_lasers(lasers, 5, enemigos, num_enemigos_cargados, &puntaje, &nave, tilemap, &contador_debug_lasers, powerups, MAX_POWERUPS, &cola_mensajes);
-                    }
-                    
-                    hay_explosivos_activos = false;
-                    for (exp_check = 0; exp_check < 8; exp_check++)
-                    {
-                        if (explosivos[exp_check].activo)
-                        {
-                            hay_explosivos_activos = true;
-                            break;
-                        }
-                    }
-
-                    if (hay_explosivos_activos)
-                    {
-                        actualizar_explosivos(explosivos, 8, enemigos, num_enemigos_cargados, &puntaje, tilemap, &nave, &cola_mensajes);
-                    }
-                    
-                    hay_misiles_activos = false;
-                    for (mis_check = 0; mis_check < 6; mis_check++)
-                    {
-                        if (misil[mis_check].activo)
-                        {
-                            hay_misiles_activos = true;
-                            break;
-                        }
-                    }
-
-                    if (hay_misiles_activos)
-                    {
-                        actualizar_misiles(misil, 6, enemigos, num_enemigos_cargados, &puntaje);
-                    }
-                    
-                    if (hay_jefe_en_nivel && jefe_nivel.activo)
-                    {
-                        actualizar_jefe(&jefe_nivel, nave, enemigos, &num_enemigos_cargados, imagenes_enemigos, tiempo_cache);
-                        
-                        // Verificar colisiones ataques del jefe vs nave
-                        for (k = 0; k < MAX_ATAQUES_JEFE; k++)
-                        {
-                            if (jefe_nivel.ataques[k].activo && detectar_colision_ataque_jefe_nave(jefe_nivel.ataques[k], nave))
+                            if (sim.control_joystick)
                             {
-                                if (escudo_recibir_dano(&nave.escudo))
-                                {
-                                    printf("Escudo absorbió ataque del jefe\n");
-                                }
-                                else
-                                {
-                                    nave.vida -= jefe_nivel.ataques[k].dano;
-                                    printf("Jefe causo %.1f de daño. Vida restante: %.1f\n", jefe_nivel.ataques[k].dano, nave.vida);
-                                    agregar_mensaje_cola(&cola_mensajes, "Ataque del Jefe!", 2.0, al_map_rgb(255, 0, 0), false);
-                                }
-                                jefe_nivel.ataques[k].activo = false;
+                                leer_ejes_joystick(config_control.joystick, &entrada.ejes);
                             }
+                            grabar_paso(&grabacion, &entrada);
                         }
-                    }
 
-                    // ✅ ACTUALIZAR JUEGO CON SOPORTE DE JOYSTICK
-                    if (config_control.tipo_control == CONTROL_JOYSTICK && config_control.joystick)
-                    {
-                        actualizar_nave_joystick(&nave, config_control.joystick, tilemap);
+                        aplicar_entrada_simulacion(&sim, &entrada);
+                        actualizar_simulacion(&sim);
+                        acumulador -= DT_SIMULACION;
                     }
 
-                    actualizar_juego(&nave, teclas, asteroides, 10, disparos, MAX_DISPAROS, &puntaje, tilemap, enemigos, num_enemigos_cargados, disparos_enemigos, NUM_DISPAROS_ENEMIGOS, &cola_mensajes, &estado_nivel, tiempo_cache, powerups, MAX_POWERUPS);
-                    
-                    if (hay_jefe_en_nivel && jefe_nivel.activo)
-                    {
-                        actualizar_estado_nivel(&estado_nivel, enemigos, num_enemigos_cargados, tiempo_cache, hay_jefe_en_nivel, &jefe_nivel);
-
-                        enemigos_restantes = 0;
-
-                        for (z = 0; z < num_enemigos_cargados; z++)
-                        {
-                            if (enemigos[z].activo) 
-                            {
-                                enemigos_restantes++;
-                            }
-                        }
+                    fin_simulacion = tiempo_telemetria();
 
-                        printf("Estado nivel %d: Jefe activo, Enemigos restantes: %d\n", estado_nivel.nivel_actual, enemigos_restantes);
-                        
-                        // Disparos normales vs jefe
-                        for (j = 0; j < MAX_DISPAROS; j++) 
-                        {
-                            if (disparos[j].activo && detectar_colision_generica(disparos[j].x, disparos[j].y, 5, 10, jefe_nivel.x, jefe_nivel.y, jefe_nivel.ancho, jefe_nivel.alto))
-                            {
-                                if (jefe_recibir_dano(&jefe_nivel, 10, &cola_mensajes))
-                                {
-                                    puntaje += 50; // Puntos por golpear al jefe
-                                }
-                                else
-                                {
-                                    puntaje += 2000; // Gran bonificación por derrotar al jefe
-                                    hay_jefe_en_nivel = false;
-                                    jefe_nivel.activo = false;
-
-                                    enemigos_restantes = 0;
-
-                                    for (z = 0; z < num_enemigos_cargados; z++)
-                                    {
-                                        if (enemigos[z].activo) enemigos_restantes++;
-                                    }
-                                    
-                                    if (enemigos_restantes > 0)
-                                    {
-                                        agregar_mensaje_cola(&cola_mensajes, "JEFE DERROTADO!", 3.0, al_map_rgb(255, 215, 0), true);
-                                        sprintf(msg_enemigos, "Elimina los %d enemigos restantes", enemigos_restantes);
-                                        agregar_mensaje_cola(&cola_mensajes, msg_enemigos, 4.0, al_map_rgb(255, 255, 255), true);
-                                    }
-                                    else
-                                    {
-                                        agregar_mensaje_cola(&cola_mensajes, "JEFE DERROTADO!", 3.0, al_map_rgb(255, 215, 0), true);
-                                        agregar_mensaje_cola(&cola_mensajes, "NIVEL COMPLETADO!", 3.0, al_map_rgb(0, 255, 0), true);
-                                    }
-                                }
-                                disparos[j].activo = false;
-                            }
-                        }
-                        
-                        // Láseres vs jefe
-                        for (j = 0; j < 5; j++)
-                        {
-                            if (lasers[j].activo)
-                            {
-                                alcance_real = verificar_colision_laser_tilemap(lasers[j], tilemap);
-                                Enemigo enemigo_jefe_temp = 
-                                {
-                                    .x = jefe_nivel.x,
-                                    .y = jefe_nivel.y, 
-                                    .ancho = jefe_nivel.ancho,
-                                    .alto = jefe_nivel.alto,
-                                    .velocidad = 0,
-                                    .vida = 0,
-                                    .vida_max = 0,
-                                    .activo = true,
-                                    .ultimo_disparo = 0,
-                                    .intervalo_disparo = 0,
-                                    .imagen = NULL,
-                                    .tipo = 0
-                                };
-
-                                if (laser_intersecta_enemigo_limitado(lasers[j], enemigo_jefe_temp, alcance_real))
-                                {
-                                    tiempo_actual = al_get_time();
-                                    if (tiempo_actual - lasers[j].ultimo_dano >= 0.1)
-                                    {
-                                        if (jefe_recibir_dano(&jefe_nivel, lasers[j].poder * 2, &cola_mensajes))
-                                        {
-                                            puntaje += 25;
-                                        }
-                                        else
-                                        {
-                                            puntaje += 2000;
-                                            hay_jefe_en_nivel = false;
-                                            jefe_nivel.activo = false;
-                                            agregar_mensaje_cola(&cola_mensajes, "JEFE DERROTADO!", 5.0, al_map_rgb(255, 215, 0), true);
-                                        }
-                                        lasers[j].ultimo_dano = tiempo_actual;
-                                    }
-                                }
-                            }
-                        }
-                        
-                        // Explosivos vs jefe
-                        for (j = 0; j < 8; j++)
-                        {
-                            if (explosivos[j].activo && !explosivos[j].exploto)
-                            {
-                                if (detectar_colision_generica(explosivos[j].x, explosivos[j].y, explosivos[j].ancho, explosivos[j].alto, jefe_nivel.x, jefe_nivel.y, jefe_nivel.ancho, jefe_nivel.alto))
-                                {
-                                    if (jefe_recibir_dano(&jefe_nivel, explosivos[j].dano_directo * 2, &cola_mensajes))
-                                    {
-                                        puntaje += 100;
-                                    }
-                                    else
-                                    {
-                                        puntaje += 2000;
-                                        hay_jefe_en_nivel = false;
-                                        jefe_nivel.activo = false;
-                                        agregar_mensaje_cola(&cola_mensajes, "JEFE DERROTADO!", 5.0, al_map_rgb(255, 215, 0), true);
-                                    }
-                                    explosivos[j].exploto = true;
-                                    explosivos[j].tiempo_vida = al_get_time();
-                                }
-                            }
-                        }
-                        
-                        // Misiles vs jefe
-                        for (j = 0; j < 6; j++)
-                        {
-                            if (misil[j].activo && detectar_colision_generica(misil[j].x, misil[j].y, misil[j].ancho, misil[j].alto, jefe_nivel.x, jefe_nivel.y, jefe_nivel.ancho, jefe_nivel.alto))
-                            {
-                                if (jefe_recibir_dano(&jefe_nivel, misil[j].dano * 3, &cola_mensajes))
-                                {
-                                    puntaje += 150;
-                                }
-                                else
-                                {
-                                    puntaje += 2000;
-                                    hay_jefe_en_nivel = false;
-                                    jefe_nivel.activo = false;
-                                    agregar_mensaje_cola(&cola_mensajes, "JEFE DERROTADO!", 5.0, al_map_rgb(255, 215, 0), true);
-                                }
-                                misil[j].activo = false;
-                            }
-                        }
-                    }
-                    else if (hay_jefe_en_nivel && !jefe_nivel.activo)
-                    {
-                        actualizar_estado_nivel(&estado_nivel, enemigos, num_enemigos_cargados, tiempo_cache, hay_jefe_en_nivel, &jefe_nivel);
-
-                        enemigos_restantes = 0;
-
-                        for (z = 0; z < num_enemigos_cargados; z++)
-                        {
-                            if (enemigos[z].activo) enemigos_restantes++;
-                        }
-                        
-                        if (enemigos_restantes == 0)
-                        {
-                            printf("Nivel %d completado! Jefe derrotado y todos los enemigos eliminados\n", estado_nivel.nivel_actual);
-                        }
-                        else
-                        {
-                            printf("Jefe derrotado pero quedan %d enemigos en nivel %d\n", enemigos_restantes, estado_nivel.nivel_actual);
-                        }
-                    }
-                    else
-                    {
-                        actualizar_estado_nivel_sin_jefe(&estado_nivel, enemigos, num_enemigos_cargados, tiempo_cache);
-                    }
+                    // Se dibuja entre el paso anterior y el actual según el tiempo que sobró
+                    interpolar_simulacion(&sim, (float)(acumulador / DT_SIMULACION), &posiciones_actuales);
                     
                     al_clear_to_color(al_map_rgb(0, 0, 0));
                     
                     // Si estamos en transición, mostrar pantalla de transición
-                    if (estado_nivel.mostrar_transicion)
+                    if (sim.estado_nivel.mostrar_transicion)
                     {
-                        tiempo_transcurrido = al_get_time() - estado_nivel.tiempo_inicio_transicion;
-                        mostrar_pantalla_transicion(estado_nivel.nivel_actual, estado_nivel.nivel_actual + 1, fuente, tiempo_transcurrido, estado_nivel.duracion_transicion);
+                        tiempo_transcurrido = sim.tiempo - sim.estado_nivel.tiempo_inicio_transicion;
+                        mostrar_pantalla_transicion(sim.estado_nivel.nivel_actual, sim.estado_nivel.nivel_actual + 1, fuente, tiempo_transcurrido, sim.estado_nivel.duracion_transicion);
                     }
                     else
                     {
                         // Dibujar el juego normal
-                        dibujar_juego(nave, asteroides, 10, estado_nivel.nivel_actual, fondo_juego);
-                        dibujar_tilemap(tilemap, imagen_asteroide);
-                        dibujar_escudo(nave);
-                        dibujar_disparos(disparos, 10);
-
-                        dibujar_lasers(lasers, 5, tilemap);
-                        dibujar_explosivos(explosivos, 8);
-                        dibujar_misiles(misil, 6);
+                        PERFIL_INICIO(PERFIL_DIBUJAR_JUEGO);
+                        dibujar_juego(&sim.nave, sim.asteroides, NUM_ASTEROIDES, sim.estado_nivel.nivel_actual, fondo_juego);
+                        PERFIL_FIN(PERFIL_DIBUJAR_JUEGO);
+
+                        PERFIL_INICIO(PERFIL_DIBUJAR_TILEMAP);
+                        actualizar_capa_tilemap(&capa_tilemap, &sim.tilemap, &sim.tiles_sucios);
+                        dibujar_capa_tilemap(&capa_tilemap, &sim.tilemap);
+                        PERFIL_FIN(PERFIL_DIBUJAR_TILEMAP);
+
+                        PERFIL_INICIO(PERFIL_DIBUJAR_DISPAROS);
+                        dibujar_escudo(&sim.nave);
+                        dibujar_disparos(sim.disparos, &sim.pool_disparos);
+                        PERFIL_FIN(PERFIL_DIBUJAR_DISPAROS);
+
+                        PERFIL_INICIO(PERFIL_DIBUJAR_LASERS);
+                        dibujar_lasers(sim.lasers, &sim.pool_lasers);
+                        PERFIL_FIN(PERFIL_DIBUJAR_LASERS);
+
+                        PERFIL_INICIO(PERFIL_DIBUJAR_EXPLOSIVOS);
+                        dibujar_explosivos(sim.explosivos, &sim.pool_explosivos);
+                        PERFIL_FIN(PERFIL_DIBUJAR_EXPLOSIVOS);
+
+                        PERFIL_INICIO(PERFIL_DIBUJAR_MISILES);
+                        dibujar_misiles(sim.misiles, &sim.pool_misiles);
+                        PERFIL_FIN(PERFIL_DIBUJAR_MISILES);
                         
-                        dibujar_enemigos(enemigos, num_enemigos_cargados);
-                        dibujar_disparos_enemigos(disparos_enemigos, NUM_DISPAROS_ENEMIGOS);
+                        PERFIL_INICIO(PERFIL_DIBUJAR_ENEMIGOS);
+                        dibujar_enemigos(&sim.enemigos);
+                        PERFIL_FIN(PERFIL_DIBUJAR_ENEMIGOS);
+
+                        PERFIL_INICIO(PERFIL_DIBUJAR_DISPAROS_ENEMIGOS);
+                        dibujar_disparos_enemigos(sim.disparos_enemigos, &sim.pool_disparos_enemigos);
+                        PERFIL_FIN(PERFIL_DIBUJAR_DISPAROS_ENEMIGOS);
 
-                        if (hay_jefe_en_nivel && jefe_nivel.activo)
+                        if (sim.hay_jefe_en_nivel && sim.jefe_nivel.activo)
                         {
-                            dibujar_jefe(jefe_nivel);
-                            dibujar_ataques_jefe(jefe_nivel.ataques, MAX_ATAQUES_JEFE);
+                            PERFIL_INICIO(PERFIL_DIBUJAR_JEFE);
+                            dibujar_jefe(sim.jefe_nivel);
+                            dibujar_ataques_jefe(sim.jefe_nivel.ataques, &sim.jefe_nivel.pool_ataques);
+                            PERFIL_FIN(PERFIL_DIBUJAR_JEFE);
                         }
 
-                        dibujar_powerups(powerups, MAX_POWERUPS, &contador_parpadeo_powerups, &contador_debug_powerups, fuente);
+                        PERFIL_INICIO(PERFIL_DIBUJAR_POWERUPS);
+                        dibujar_powerups(sim.powerups, &sim.pool_powerups, &contador_parpadeo_powerups, &contador_debug_powerups, fuente);
+                        PERFIL_FIN(PERFIL_DIBUJAR_POWERUPS);
 
                         if (debug_mode)
                         {
-                            dibujar_hitboxes_debug(nave, enemigos, num_enemigos_cargados, disparos, MAX_DISPAROS, disparos_enemigos, NUM_DISPAROS_ENEMIGOS, asteroides, NUM_ASTEROIDES, tilemap, fuente);
+                            PERFIL_INICIO(PERFIL_DIBUJAR_HITBOXES);
+                            dibujar_hitboxes_debug(&sim.nave, &sim.enemigos, sim.disparos, &sim.pool_disparos, sim.disparos_enemigos, &sim.pool_disparos_enemigos, sim.asteroides, NUM_ASTEROIDES, &sim.tilemap, fuente);
+                            PERFIL_FIN(PERFIL_DIBUJAR_HITBOXES);
                         }
                         
 
-                        dibujar_puntaje(puntaje, fuente);
-                        dibujar_barra_vida(nave, fuente);
-                        dibujar_nivel_powerup(nave, fuente);
+                        PERFIL_INICIO(PERFIL_DIBUJAR_HUD);
+                        dibujar_puntaje(sim.puntaje, fuente);
+                        dibujar_barra_vida(&sim.nave, fuente);
+                        dibujar_nivel_powerup(&sim.nave, fuente);
 
-                        dibujar_info_armas(nave, fuente);
-                        dibujar_info_escudo(nave, fuente);
+                        dibujar_info_armas(&sim.nave, fuente);
+                        dibujar_info_escudo(&sim.nave, fuente);
                         
                         // ✅ MOSTRAR INDICADOR DE CONTROL
                         dibujar_indicador_control(config_control, fuente);
 
-                        dibujar_cola_mensajes(cola_mensajes, fuente);
+                        dibujar_cola_mensajes(sim.cola_mensajes, fuente);
                         
                         // Mostrar nivel actual
-                        sprintf(texto_nivel, "Nivel: %d", estado_nivel.nivel_actual);
-                        al_draw_text(fuente, al_map_rgb(255, 255, 255), 10, 120, ALLEGRO_ALIGN_LEFT, texto_nivel);
+                        al_draw_text(fuente, al_map_rgb(255, 255, 255), 10, 120, ALLEGRO_ALIGN_LEFT, formatear_arena_frame("Nivel: %d", sim.estado_nivel.nivel_actual));
+                        PERFIL_FIN(PERFIL_DIBUJAR_HUD);
+
+                        if (debug_mode)
+                        {
+                            dibujar_perfil(conteos_perfil, contar_entidades_simulacion(&sim, conteos_perfil));
+                        }
                     }
                     
+                    PERFIL_INICIO(PERFIL_FLIP);
                     al_flip_display();
+                    PERFIL_FIN(PERFIL_FLIP);
+                    cerrar_frame_perfil();
+                    registrar_telemetria_simulacion(&sim, frame_telemetria++, inicio_frame, fin_simulacion - inicio_frame, tiempo_telemetria() - fin_simulacion);
+                    restaurar_simulacion(&sim, &posiciones_actuales);
                     
-                    if (nave.vida <= 0)
+                    if (sim.nave.vida <= 0 && !ruta_repeticion)
                     {
                         jugando = false;
                         // Capturar nombre para el ranking
-                        char nombre_jugador[MAX_NOMBRE];
                         capturar_nombre(fuente, nombre_jugador, cola_eventos);
-                        guardar_puntaje(nombre_jugador, puntaje);
+                        guardar_puntaje(nombre_jugador, sim.puntaje);
                         volver_menu = true;
                     }
                     
                     // Si terminamos todos los niveles, salir del juego
-                    if (juego_terminado)
+                    if (sim.juego_terminado && !ruta_repeticion)
                     {
                         jugando = false;
                         
@@ -1282,7 +832,7 @@ int main()
                         al_clear_to_color(al_map_rgb(0, 0, 0));
                         al_draw_text(fuente, al_map_rgb(0, 255, 0), 400, 250, ALLEGRO_ALIGN_CENTER, "FELICIDADES!");
                         al_draw_text(fuente, al_map_rgb(255, 255, 255), 400, 300, ALLEGRO_ALIGN_CENTER, "Has completado todos los niveles!");
-                        sprintf(texto_puntaje_final, "Puntaje final: %d", puntaje);
+                        sprintf(texto_puntaje_final, "Puntaje final: %d", sim.puntaje);
                         al_draw_text(fuente, al_map_rgb(255, 255, 0), 400, 350, ALLEGRO_ALIGN_CENTER, texto_puntaje_final);
                         al_draw_text(fuente, al_map_rgb(255, 255, 255), 400, 400, ALLEGRO_ALIGN_CENTER, "Presiona cualquier tecla para continuar...");
                         al_flip_display();
@@ -1298,11 +848,21 @@ int main()
                         }
 
                         capturar_nombre(fuente, nombre_jugador, cola_eventos);
-                        guardar_puntaje(nombre_jugador, puntaje);
+                        guardar_puntaje(nombre_jugador, sim.puntaje);
                         volver_menu = true;
                     }
                 }
             }
+
+            terminar_grabacion(&grabacion);
+
+            if (ruta_repeticion)
+            {
+                printf("Repetición terminada: %u pasos, nivel %d, puntaje %d\n", repeticion.pasos_leidos, sim.estado_nivel.nivel_actual, sim.puntaje);
+                cerrar_repeticion(&repeticion);
+                jugando = false;
+                en_menu = false;
+            }
         }
 
         if (mostrarRanking)
@@ -1337,11 +897,11 @@ int main()
                 }
             }
 
-            hay_jefe_en_nivel = false;
-            memset(&jefe_nivel, 0, sizeof(Jefe));
-            jefe_nivel.activo = false;
+            sim.hay_jefe_en_nivel = false;
+            memset(&sim.jefe_nivel, 0, sizeof(Jefe));
+            sim.jefe_nivel.activo = false;
 
-            memset(teclas, false, sizeof(teclas)); // Reiniciar teclas
+            memset(sim.teclas, false, sizeof(sim.teclas)); // Reiniciar teclas
 
             cursor_x = 0;
             cursor_y = 0;
@@ -1366,9 +926,21 @@ int main()
         printf("Instancia de música destruida.\n");
     }
 
+    destruir_capa_tilemap(&capa_tilemap);
+    if (imagen_tile_asteroide)
+    {
+        al_destroy_bitmap(imagen_tile_asteroide);
+    }
     liberar_imagenes_enemigos(imagenes_enemigos);
     liberar_imagenes_jefes(imagenes_jefes);
     destruir_recursos(ventana, cola_eventos, temporizador, fuente, fondo_juego, imagen_nave, imagen_asteroide, imagen_enemigo, imagen_menu, musica_menu);
+    destruir_atlas_sprites(&atlas_sprites); // Después de sus sprites
+#ifndef SIN_PERFIL
+    escribir_resumen_arena(stdout);
+#endif
+    destruir_perfil();
+    terminar_telemetria();
+    volcar_traza();
 
     al_uninstall_system(); // Esto evita fugas de memoria y libera recursos evitando el segmentation fault en WSL
 
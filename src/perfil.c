@@ -0,0 +1,258 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro_primitives.h>
+#include "perfil.h"
+
+/**
+ * @file perfil.c
+ * @brief Este archivo contiene la medición por fases del frame y su overlay de debug.
+ */
+
+/**
+ * @brief Nombre de cada fase tal como se muestra en el overlay.
+ */
+static const char *nombres_fases[NUM_FASES_PERFIL] =
+{
+    "paso", "nave", "enemigos", "colisiones", "lasers", "explosivos", "misiles", "jefe", "agenda",
+    "dib juego", "dib tilemap", "dib disparos", "dib lasers", "dib explosivos", "dib misiles",
+    "dib enemigos", "dib disp enem", "dib jefe", "dib powerups", "dib hitboxes", "dib hud",
+    "flip"
+};
+
+static double acumulado_frame[NUM_FASES_PERFIL]; /**< Segundos medidos en el frame actual */
+static bool medida_frame[NUM_FASES_PERFIL]; /**< La fase se midió en el frame actual */
+static float muestras[NUM_FASES_PERFIL][PERFIL_VENTANA]; /**< Microsegundos por frame */
+static int num_muestras[NUM_FASES_PERFIL];
+static int siguiente_muestra[NUM_FASES_PERFIL];
+static float minimo[NUM_FASES_PERFIL];
+static float promedio[NUM_FASES_PERFIL];
+static float p99[NUM_FASES_PERFIL];
+static int frames_desde_refresco = PERFIL_FRAMES_REFRESCO;
+static double total_fase[NUM_FASES_PERFIL]; /**< Microsegundos acumulados desde reiniciar_perfil */
+static long frames_fase[NUM_FASES_PERFIL]; /**< Frames con muestra desde reiniciar_perfil */
+static float maximo_fase[NUM_FASES_PERFIL]; /**< Peor frame desde reiniciar_perfil */
+static ALLEGRO_FONT *fuente_perfil = NULL;
+
+
+/**
+ * @brief Suma tiempo medido a una fase del frame actual. La usa la macro PERFIL_FIN.
+ *
+ * @param fase Fase medida.
+ * @param segundos Tiempo que tardó.
+ */
+void registrar_tiempo_perfil(FasePerfil fase, double segundos)
+{
+    acumulado_frame[fase] += segundos;
+    medida_frame[fase] = true;
+}
+
+
+/**
+ * @brief Guarda lo medido en el frame como una muestra de cada fase.
+ *
+ * Las fases que no se ejecutaron en el frame (por ejemplo, ningún paso de simulación
+ * cuando se dibuja más rápido que FPS) no agregan muestra para no bajar el mínimo.
+ */
+void cerrar_frame_perfil(void)
+{
+    int i;
+
+    for (i = 0; i < NUM_FASES_PERFIL; i++)
+    {
+        if (!medida_frame[i])
+        {
+            continue;
+        }
+
+        muestras[i][siguiente_muestra[i]] = (float)(acumulado_frame[i] * 1000000.0);
+        total_fase[i] += muestras[i][siguiente_muestra[i]];
+        frames_fase[i]++;
+        if (muestras[i][siguiente_muestra[i]] > maximo_fase[i])
+        {
+            maximo_fase[i] = muestras[i][siguiente_muestra[i]];
+        }
+        siguiente_muestra[i] = (siguiente_muestra[i] + 1) % PERFIL_VENTANA;
+        if (num_muestras[i] < PERFIL_VENTANA)
+        {
+            num_muestras[i]++;
+        }
+
+        acumulado_frame[i] = 0;
+        medida_frame[i] = false;
+    }
+
+    frames_desde_refresco++;
+}
+
+
+/**
+ * @brief Compara dos float para qsort.
+ */
+static int comparar_muestras(const void *a, const void *b)
+{
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+
+    return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief Recalcula mínimo, promedio y percentil 99 de cada fase sobre la ventana.
+ */
+static void calcular_estadisticas_perfil(void)
+{
+    float ordenadas[PERFIL_VENTANA];
+    double suma;
+    int i;
+    int k;
+    int n;
+
+    for (i = 0; i < NUM_FASES_PERFIL; i++)
+    {
+        n = num_muestras[i];
+        if (n == 0)
+        {
+            continue;
+        }
+
+        suma = 0;
+        for (k = 0; k < n; k++)
+        {
+            ordenadas[k] = muestras[i][k];
+            suma += ordenadas[k];
+        }
+
+        qsort(ordenadas, n, sizeof(float), comparar_muestras);
+
+        minimo[i] = ordenadas[0];
+        promedio[i] = (float)(suma / n);
+        p99[i] = ordenadas[(n * 99 + 99) / 100 - 1];
+    }
+}
+
+
+/**
+ * @brief Descarta todas las muestras y los totales para empezar una medición nueva.
+ */
+void reiniciar_perfil(void)
+{
+    int i;
+
+    for (i = 0; i < NUM_FASES_PERFIL; i++)
+    {
+        acumulado_frame[i] = 0;
+        medida_frame[i] = false;
+        num_muestras[i] = 0;
+        siguiente_muestra[i] = 0;
+        total_fase[i] = 0;
+        frames_fase[i] = 0;
+        maximo_fase[i] = 0;
+    }
+
+    frames_desde_refresco = PERFIL_FRAMES_REFRESCO;
+}
+
+
+/**
+ * @brief Escribe una tabla con el tiempo de cada fase desde el último reiniciar_perfil.
+ *
+ * El promedio y el máximo cubren toda la medición; el mínimo y el percentil 99 salen de
+ * los últimos PERFIL_VENTANA frames, igual que en el overlay. Las fases que no se
+ * midieron no aparecen.
+ *
+ * @param salida Archivo donde se escribe, por ejemplo stderr.
+ */
+void escribir_resumen_perfil(FILE *salida)
+{
+    int i;
+
+    calcular_estadisticas_perfil();
+
+    fprintf(salida, "%-14s %8s %9s %9s %9s %9s\n", "fase (us)", "frames", "prom", "max", "min", "p99");
+    for (i = 0; i < NUM_FASES_PERFIL; i++)
+    {
+        if (frames_fase[i] == 0)
+        {
+            continue;
+        }
+
+        fprintf(salida, "%-14s %8ld %9.1f %9.1f %9.1f %9.1f\n", nombres_fases[i], frames_fase[i],
+                total_fase[i] / frames_fase[i], maximo_fase[i], minimo[i], p99[i]);
+    }
+}
+
+
+/**
+ * @brief Dibuja la tabla de tiempos por fase y la cantidad de entidades vivas.
+ *
+ * Usa la fuente incorporada de Allegro, que es chica y no depende de archivos.
+ *
+ * @param conteos Cantidad de entidades de cada tipo.
+ * @param num_conteos Cantidad de elementos de conteos.
+ */
+void dibujar_perfil(const ConteoPerfil conteos[], int num_conteos)
+{
+    const float x = 540;
+    const float alto_linea = 10;
+    float y = 140;
+    int i;
+
+    if (!fuente_perfil)
+    {
+        fuente_perfil = al_create_builtin_font();
+        if (!fuente_perfil)
+        {
+            return;
+        }
+    }
+
+    if (frames_desde_refresco >= PERFIL_FRAMES_REFRESCO)
+    {
+        calcular_estadisticas_perfil();
+        frames_desde_refresco = 0;
+    }
+
+    al_draw_filled_rectangle(x - 5, y - 5, 800, y + (NUM_FASES_PERFIL + num_conteos + 3) * alto_linea + 5, al_map_rgba(0, 0, 0, 180));
+
+#ifndef SIN_PERFIL
+    al_draw_text(fuente_perfil, al_map_rgb(255, 255, 0), x, y, ALLEGRO_ALIGN_LEFT, "fase (us)       min   avg   p99");
+    y += alto_linea;
+
+    for (i = 0; i < NUM_FASES_PERFIL; i++)
+    {
+        if (num_muestras[i] == 0)
+        {
+            al_draw_textf(fuente_perfil, al_map_rgb(120, 120, 120), x, y, ALLEGRO_ALIGN_LEFT, "%-14s     -     -     -", nombres_fases[i]);
+        }
+        else
+        {
+            al_draw_textf(fuente_perfil, al_map_rgb(255, 255, 255), x, y, ALLEGRO_ALIGN_LEFT, "%-14s %5.0f %5.0f %5.0f", nombres_fases[i], minimo[i], promedio[i], p99[i]);
+        }
+        y += alto_linea;
+    }
+#else
+    al_draw_text(fuente_perfil, al_map_rgb(120, 120, 120), x, y, ALLEGRO_ALIGN_LEFT, "perfil desactivado");
+    y += alto_linea * (NUM_FASES_PERFIL + 1);
+#endif
+
+    y += alto_linea;
+    for (i = 0; i < num_conteos; i++)
+    {
+        al_draw_textf(fuente_perfil, al_map_rgb(150, 255, 150), x, y, ALLEGRO_ALIGN_LEFT, "%-14s %5d", conteos[i].nombre, conteos[i].cantidad);
+        y += alto_linea;
+    }
+}
+
+
+/**
+ * @brief Libera la fuente del overlay.
+ */
+void destruir_perfil(void)
+{
+    if (fuente_perfil)
+    {
+        al_destroy_font(fuente_perfil);
+        fuente_perfil = NULL;
+    }
+}
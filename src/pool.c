@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include "pool.h"
+
+/**
+ * @file pool.c
+ * @brief Este archivo contiene las funciones del pool genérico de índices.
+ */
+
+
+/**
+ * @brief Deja todas las posiciones del pool libres.
+ *
+ * Las posiciones se apilan al revés para que la primera en entregarse sea la 0,
+ * igual que con la búsqueda lineal que reemplaza.
+ *
+ * @param pool Puntero al pool.
+ * @param capacidad Cantidad de posiciones del arreglo asociado.
+ */
+void init_pool_indices(PoolIndices *pool, int capacidad)
+{
+    int i;
+
+    if (capacidad > POOL_CAPACIDAD_MAX)
+    {
+        printf("Capacidad de pool %d mayor al maximo %d, se recorta\n", capacidad, POOL_CAPACIDAD_MAX);
+        capacidad = POOL_CAPACIDAD_MAX;
+    }
+
+    pool->capacidad = capacidad;
+    pool->num_vivos = 0;
+    pool->num_libres = capacidad;
+
+    for (i = 0; i < capacidad; i++)
+    {
+        pool->libres[i] = capacidad - 1 - i;
+        pool->posicion_viva[i] = -1;
+    }
+}
+
+
+/**
+ * @brief Saca una posición libre del pool y la agrega a la lista de vivos.
+ *
+ * @param pool Puntero al pool.
+ * @return La posición obtenida, o -1 si el pool está lleno.
+ */
+int obtener_indice_pool(PoolIndices *pool)
+{
+    int indice;
+
+    if (pool->num_libres == 0)
+    {
+        return -1;
+    }
+
+    indice = pool->libres[--pool->num_libres];
+    pool->posicion_viva[indice] = pool->num_vivos;
+    pool->vivos[pool->num_vivos++] = indice;
+
+    return indice;
+}
+
+
+/**
+ * @brief Devuelve una posición al pool.
+ *
+ * La última posición viva ocupa el lugar de la liberada. Liberar una posición que ya
+ * estaba libre no hace nada.
+ *
+ * @param pool Puntero al pool.
+ * @param indice Posición a liberar.
+ */
+void liberar_indice_pool(PoolIndices *pool, int indice)
+{
+    int lugar;
+    int ultimo;
+
+    if (indice < 0 || indice >= pool->capacidad || pool->posicion_viva[indice] < 0)
+    {
+        return;
+    }
+
+    lugar = pool->posicion_viva[indice];
+    ultimo = pool->vivos[--pool->num_vivos];
+    pool->vivos[lugar] = ultimo;
+    pool->posicion_viva[ultimo] = lugar;
+    pool->posicion_viva[indice] = -1;
+
+    pool->libres[pool->num_libres++] = indice;
+}
+
+
+/**
+ * @brief Indica si el pool tiene alguna posición en uso.
+ *
+ * @param pool Puntero al pool.
+ * @return true si hay al menos una posición viva.
+ */
+bool pool_tiene_vivos(const PoolIndices *pool)
+{
+    return pool->num_vivos > 0;
+}
@@ -0,0 +1,288 @@
+#include <string.h>
+#include "repeticion.h"
+
+/**
+ * @file repeticion.c
+ * @brief Este archivo contiene la grabación y la lectura de archivos de repetición.
+ */
+
+
+/**
+ * @brief Compara dos lecturas del joystick.
+ *
+ * @param a Primera lectura.
+ * @param b Segunda lectura.
+ * @return true si todos los ejes y botones coinciden.
+ */
+static bool ejes_iguales(const EjesJoystick *a, const EjesJoystick *b)
+{
+    return a->stick_x == b->stick_x && a->stick_y == b->stick_y && a->stick_rx == b->stick_rx &&
+           a->boton_l == b->boton_l && a->boton_r == b->boton_r;
+}
+
+
+/**
+ * @brief Escribe la racha de pasos sin cambios acumulada, si la hay.
+ *
+ * @param repeticion Grabación en curso.
+ */
+static void escribir_pasos_vacios(Repeticion *repeticion)
+{
+    uint8_t tipo = REGISTRO_PASOS_VACIOS;
+    uint16_t cantidad;
+
+    if (repeticion->pasos_vacios == 0)
+    {
+        return;
+    }
+
+    cantidad = (uint16_t)repeticion->pasos_vacios;
+    fwrite(&tipo, sizeof(tipo), 1, repeticion->archivo);
+    fwrite(&cantidad, sizeof(cantidad), 1, repeticion->archivo);
+    repeticion->pasos_vacios = 0;
+}
+
+
+/**
+ * @brief Crea el archivo de repetición y escribe un encabezado provisorio.
+ *
+ * @param repeticion Grabación a iniciar.
+ * @param ruta Archivo donde se graba.
+ * @param semilla Semilla de la partida.
+ * @param nivel Nivel con el que empieza la partida.
+ * @param control_joystick true si la nave se mueve con joystick.
+ * @return true si se pudo crear el archivo.
+ */
+bool iniciar_grabacion(Repeticion *repeticion, const char *ruta, uint64_t semilla, int nivel, bool control_joystick)
+{
+    memset(repeticion, 0, sizeof(Repeticion));
+
+    repeticion->archivo = fopen(ruta, "wb");
+    if (!repeticion->archivo)
+    {
+        printf("Error: No se pudo crear el archivo de repetición %s\n", ruta);
+        return false;
+    }
+
+    memcpy(repeticion->encabezado.magia, "RPLY", 4);
+    repeticion->encabezado.version = VERSION_REPETICION;
+    repeticion->encabezado.semilla = semilla;
+    repeticion->encabezado.nivel = nivel;
+    repeticion->encabezado.control_joystick = control_joystick ? 1 : 0;
+
+    fwrite(&repeticion->encabezado, sizeof(EncabezadoRepeticion), 1, repeticion->archivo);
+
+    return true;
+}
+
+
+/**
+ * @brief Graba la entrada que recibió un paso de simulación.
+ *
+ * Los pasos sin acciones y con los mismos ejes que el anterior solo se cuentan. Si no
+ * hay grabación en curso no hace nada.
+ *
+ * @param repeticion Grabación en curso.
+ * @param entrada Entrada que se aplicó en el paso.
+ */
+void grabar_paso(Repeticion *repeticion, const EntradaPaso *entrada)
+{
+    uint8_t registro[3];
+    uint8_t botones;
+    int i;
+    bool ejes_nuevos;
+
+    if (!repeticion->archivo)
+    {
+        return;
+    }
+
+    repeticion->encabezado.num_pasos++;
+    ejes_nuevos = !ejes_iguales(&entrada->ejes, &repeticion->ejes);
+
+    if (entrada->num_acciones == 0 && !ejes_nuevos)
+    {
+        repeticion->pasos_vacios++;
+        if (repeticion->pasos_vacios == MAX_PASOS_VACIOS_REGISTRO)
+        {
+            escribir_pasos_vacios(repeticion);
+        }
+        return;
+    }
+
+    escribir_pasos_vacios(repeticion);
+
+    for (i = 0; i < entrada->num_acciones; i++)
+    {
+        registro[0] = REGISTRO_ACCION;
+        registro[1] = entrada->acciones[i].tipo;
+        registro[2] = entrada->acciones[i].dato;
+        fwrite(registro, sizeof(registro), 1, repeticion->archivo);
+    }
+
+    if (ejes_nuevos)
+    {
+        registro[0] = REGISTRO_EJES;
+        botones = (entrada->ejes.boton_l ? 1 : 0) | (entrada->ejes.boton_r ? 2 : 0);
+        fwrite(registro, 1, 1, repeticion->archivo);
+        fwrite(&entrada->ejes.stick_x, sizeof(float), 1, repeticion->archivo);
+        fwrite(&entrada->ejes.stick_y, sizeof(float), 1, repeticion->archivo);
+        fwrite(&entrada->ejes.stick_rx, sizeof(float), 1, repeticion->archivo);
+        fwrite(&botones, sizeof(botones), 1, repeticion->archivo);
+        repeticion->ejes = entrada->ejes;
+    }
+
+    registro[0] = REGISTRO_FIN_PASO;
+    fwrite(registro, 1, 1, repeticion->archivo);
+}
+
+
+/**
+ * @brief Cierra la grabación y completa el encabezado con la cantidad de pasos.
+ *
+ * @param repeticion Grabación en curso, si no hay ninguna no hace nada.
+ */
+void terminar_grabacion(Repeticion *repeticion)
+{
+    uint8_t tipo = REGISTRO_FIN;
+    long tamano;
+
+    if (!repeticion->archivo)
+    {
+        return;
+    }
+
+    escribir_pasos_vacios(repeticion);
+    fwrite(&tipo, sizeof(tipo), 1, repeticion->archivo);
+    tamano = ftell(repeticion->archivo);
+
+    fseek(repeticion->archivo, 0, SEEK_SET);
+    fwrite(&repeticion->encabezado, sizeof(EncabezadoRepeticion), 1, repeticion->archivo);
+    fclose(repeticion->archivo);
+    repeticion->archivo = NULL;
+
+    printf("Repetición grabada: %u pasos en %ld bytes\n", repeticion->encabezado.num_pasos, tamano);
+}
+
+
+/**
+ * @brief Abre un archivo de repetición y valida su encabezado.
+ *
+ * @param repeticion Repetición a abrir.
+ * @param ruta Archivo grabado con iniciar_grabacion.
+ * @return true si el archivo existe y tiene un formato conocido.
+ */
+bool abrir_repeticion(Repeticion *repeticion, const char *ruta)
+{
+    memset(repeticion, 0, sizeof(Repeticion));
+
+    repeticion->archivo = fopen(ruta, "rb");
+    if (!repeticion->archivo)
+    {
+        printf("Error: No se pudo abrir el archivo de repetición %s\n", ruta);
+        return false;
+    }
+
+    if (fread(&repeticion->encabezado, sizeof(EncabezadoRepeticion), 1, repeticion->archivo) != 1 ||
+        memcmp(repeticion->encabezado.magia, "RPLY", 4) != 0 ||
+        repeticion->encabezado.version != VERSION_REPETICION)
+    {
+        printf("Error: %s no es un archivo de repetición válido\n", ruta);
+        cerrar_repeticion(repeticion);
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Lee la entrada del próximo paso.
+ *
+ * @param repeticion Repetición abierta.
+ * @param entrada Entrada que recibe las acciones y los ejes del paso.
+ * @return false si se terminaron los pasos o el archivo está dañado.
+ */
+bool leer_paso(Repeticion *repeticion, EntradaPaso *entrada)
+{
+    uint8_t tipo;
+    uint8_t accion[2];
+    uint8_t botones;
+    uint16_t cantidad;
+
+    entrada->num_acciones = 0;
+
+    if (!repeticion->archivo)
+    {
+        return false;
+    }
+
+    if (repeticion->pasos_vacios > 0)
+    {
+        repeticion->pasos_vacios--;
+        entrada->ejes = repeticion->ejes;
+        repeticion->pasos_leidos++;
+        return true;
+    }
+
+    while (fread(&tipo, sizeof(tipo), 1, repeticion->archivo) == 1)
+    {
+        switch (tipo)
+        {
+            case REGISTRO_PASOS_VACIOS:
+                if (fread(&cantidad, sizeof(cantidad), 1, repeticion->archivo) != 1 || cantidad == 0)
+                {
+                    return false;
+                }
+                repeticion->pasos_vacios = cantidad - 1;
+                entrada->ejes = repeticion->ejes;
+                repeticion->pasos_leidos++;
+                return true;
+
+            case REGISTRO_ACCION:
+                if (fread(accion, sizeof(accion), 1, repeticion->archivo) != 1)
+                {
+                    return false;
+                }
+                agregar_accion_entrada(entrada, (TipoAccion)accion[0], accion[1]);
+                break;
+
+            case REGISTRO_EJES:
+                if (fread(&repeticion->ejes.stick_x, sizeof(float), 1, repeticion->archivo) != 1 ||
+                    fread(&repeticion->ejes.stick_y, sizeof(float), 1, repeticion->archivo) != 1 ||
+                    fread(&repeticion->ejes.stick_rx, sizeof(float), 1, repeticion->archivo) != 1 ||
+                    fread(&botones, sizeof(botones), 1, repeticion->archivo) != 1)
+                {
+                    return false;
+                }
+                repeticion->ejes.boton_l = (botones & 1) != 0;
+                repeticion->ejes.boton_r = (botones & 2) != 0;
+                break;
+
+            case REGISTRO_FIN_PASO:
+                entrada->ejes = repeticion->ejes;
+                repeticion->pasos_leidos++;
+                return true;
+
+            default: // REGISTRO_FIN o un tipo desconocido
+                return false;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Cierra una repetición abierta con abrir_repeticion.
+ *
+ * @param repeticion Repetición a cerrar, si no está abierta no hace nada.
+ */
+void cerrar_repeticion(Repeticion *repeticion)
+{
+    if (repeticion->archivo)
+    {
+        fclose(repeticion->archivo);
+        repeticion->archivo = NULL;
+    }
+}
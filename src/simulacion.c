@@ -0,0 +1,1069 @@
+#include "simulacion.h"
+#include "colisiones.h"
+
+/**
+ * @file simulacion.c
+ * @brief Este archivo contiene las funciones que avanzan el estado de una partida
+ * sin depender de la ventana, la fuente ni los bitmaps.
+ */
+
+
+/**
+ * @brief Reinicia todos los proyectiles y powerups de la partida.
+ *
+ * @param sim Puntero a la simulación.
+ */
+static void limpiar_proyectiles(Simulacion *sim)
+{
+    int i;
+
+    init_disparos(sim->disparos, MAX_DISPAROS, &sim->pool_disparos);
+    init_disparos(sim->disparos_enemigos, NUM_DISPAROS_ENEMIGOS, &sim->pool_disparos_enemigos);
+
+    for (i = 0; i < MAX_LASERS; i++)
+    {
+        sim->lasers[i].activo = false;
+    }
+    init_pool_indices(&sim->pool_lasers, MAX_LASERS);
+
+    for (i = 0; i < MAX_EXPLOSIVOS; i++)
+    {
+        sim->explosivos[i].activo = false;
+        sim->explosivos[i].exploto = false;
+        sim->explosivos[i].dano_aplicado = false;
+        sim->explosivos[i].x = 0;
+        sim->explosivos[i].y = 0;
+        sim->explosivos[i].vx = 0;
+        sim->explosivos[i].vy = 0;
+        sim->explosivos[i].tiempo_vida = 0;
+    }
+    init_pool_indices(&sim->pool_explosivos, MAX_EXPLOSIVOS);
+
+    for (i = 0; i < MAX_MISILES; i++)
+    {
+        sim->misiles[i].activo = false;
+    }
+    init_pool_indices(&sim->pool_misiles, MAX_MISILES);
+
+    for (i = 0; i < MAX_POWERUPS; i++)
+    {
+        init_powerup(&sim->powerups[i]);
+    }
+    init_pool_indices(&sim->pool_powerups, MAX_POWERUPS);
+}
+
+
+/**
+ * @brief Activa o desactiva los asteroides según el nivel actual.
+ *
+ * @param sim Puntero a la simulación.
+ */
+static void preparar_asteroides(Simulacion *sim)
+{
+    int k;
+
+    if (asteroides_activados(sim->estado_nivel.nivel_actual))
+    {
+        init_asteroides(sim->asteroides, NUM_ASTEROIDES, 800, sim->imagen_asteroide, &sim->aleatorio[ALEATORIO_ASTEROIDES]);
+        printf("Asteroides ACTIVADOS en nivel %d\n", sim->estado_nivel.nivel_actual);
+    }
+    else
+    {
+        // Desactivar completamente los asteroides
+        for (k = 0; k < NUM_ASTEROIDES; k++)
+        {
+            sim->asteroides[k].y = -1000; // Fuera de la pantalla
+            sim->asteroides[k].x = -1000;
+            sim->asteroides[k].velocidad = 0; // Sin movimiento
+            sim->asteroides[k].ancho = 0;
+            sim->asteroides[k].alto = 0;
+        }
+        printf("Asteroides DESACTIVADOS en nivel %d\n", sim->estado_nivel.nivel_actual);
+    }
+}
+
+
+/**
+ * @brief Separa el jefe de los enemigos cargados y copia el resto al pool de juego.
+ *
+ * Los jefes vienen en el archivo del nivel como enemigos tipo 5 (Destructor) o 6 (Supremo).
+ * El campo de flujo se marca para recalcular, la agenda se vacía y se programan los
+ * primeros disparos y los ataques del jefe.
+ *
+ * @param sim Puntero a la simulación.
+ */
+static void preparar_enemigos(Simulacion *sim)
+{
+    int j;
+    int k;
+    int tipo_jefe;
+    int enemigos_a_copiar;
+
+    sim->hay_jefe_en_nivel = false;
+    memset(&sim->jefe_nivel, 0, sizeof(Jefe));
+    sim->jefe_nivel.activo = false;
+
+    for (k = 0; k < sim->num_enemigos_cargados; k++)
+    {
+        if (sim->enemigos_mapa[k].tipo == 5 || sim->enemigos_mapa[k].tipo == 6)
+        {
+            tipo_jefe = sim->enemigos_mapa[k].tipo == 5 ? 0 : 1; // 5=Destructor(0), 6=Supremo(1)
+            init_jefe(&sim->jefe_nivel, tipo_jefe, sim->enemigos_mapa[k].x, sim->enemigos_mapa[k].y, sim->imagenes_jefes[tipo_jefe]);
+            sim->hay_jefe_en_nivel = true;
+            printf("Jefe cargado en nivel %d: jefe tipo %d\n", sim->estado_nivel.nivel_actual, tipo_jefe);
+
+            // Remover jefe del array de enemigos normales
+            for (j = k; j < sim->num_enemigos_cargados - 1; j++)
+            {
+                sim->enemigos_mapa[j] = sim->enemigos_mapa[j + 1];
+            }
+            sim->num_enemigos_cargados--;
+            break;
+        }
+    }
+
+    enemigos_a_copiar = (sim->num_enemigos_cargados < NUM_ENEMIGOS) ? sim->num_enemigos_cargados : NUM_ENEMIGOS;
+
+    vaciar_pool_enemigos(&sim->enemigos);
+
+    for (k = 0; k < enemigos_a_copiar; k++)
+    {
+        asignar_imagen_enemigo(&sim->enemigos_mapa[k], sim->imagenes_enemigos); // Asegurar que usen el sprite correcto
+        sim->enemigos_mapa[k].activo = true;
+        agregar_enemigo_pool(&sim->enemigos, &sim->enemigos_mapa[k]);
+    }
+
+    invalidar_campo_flujo(&sim->campo_flujo);
+    init_agenda(&sim->agenda);
+    programar_disparos_enemigos(&sim->agenda, &sim->enemigos, 0, sim->tiempo);
+    if (sim->hay_jefe_en_nivel)
+    {
+        programar_eventos_jefe(&sim->agenda, &sim->jefe_nivel, sim->tiempo);
+    }
+
+    printf("=== NIVEL %d ===\n", sim->estado_nivel.nivel_actual);
+    printf("Jefe activo: %s\n", sim->hay_jefe_en_nivel ? "SI" : "NO");
+    printf("Enemigos normales: %d\n", enemigos_a_copiar);
+}
+
+
+/**
+ * @brief Ejecuta un evento de la agenda que venció.
+ *
+ * Los disparos de enemigos que murieron desde que se programaron se descartan: su
+ * manejador ya no encuentra al enemigo.
+ *
+ * @param contexto Puntero a la simulación.
+ * @param tipo Tipo del evento, uno de TipoEventoAgenda.
+ * @param dato Dato del evento.
+ */
+static void ejecutar_evento_simulacion(void *contexto, int tipo, int dato)
+{
+    Simulacion *sim = contexto;
+    int i;
+
+    switch (tipo)
+    {
+        case EVENTO_DISPARO_ENEMIGO:
+            i = buscar_enemigo_manejador(&sim->enemigos, dato);
+            if (i >= 0 && sim->enemigos.activo[i])
+            {
+                disparo_programado_enemigo(&sim->agenda, &sim->enemigos, i, sim->disparos_enemigos, &sim->pool_disparos_enemigos, &sim->nave, sim->tiempo);
+            }
+            break;
+
+        case EVENTO_ATAQUE_JEFE:
+            if (sim->hay_jefe_en_nivel)
+            {
+                ataque_programado_jefe(&sim->agenda, &sim->jefe_nivel, &sim->nave, sim->tiempo, &sim->aleatorio[ALEATORIO_JEFE]);
+            }
+            break;
+
+        case EVENTO_INVOCACION_JEFE:
+            if (sim->hay_jefe_en_nivel)
+            {
+                invocacion_programada_jefe(&sim->agenda, &sim->jefe_nivel, &sim->enemigos, sim->imagenes_enemigos, sim->tiempo, &sim->aleatorio[ALEATORIO_JEFE]);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/**
+ * @brief Guarda los recursos gráficos y deja la simulación en un estado vacío.
+ *
+ * Cualquiera de los bitmaps puede ser NULL (por ejemplo en modo headless).
+ *
+ * @param sim Puntero a la simulación.
+ * @param imagen_nave Imagen de la nave.
+ * @param imagen_asteroide Imagen de los asteroides.
+ * @param imagen_enemigo Imagen genérica de los enemigos.
+ * @param imagenes_enemigos Imágenes de cada tipo de enemigo, puede ser NULL.
+ * @param imagenes_jefes Imágenes de cada tipo de jefe, puede ser NULL.
+ * @param semilla Semilla de los generadores aleatorios de la partida.
+ */
+void init_simulacion(Simulacion *sim, ALLEGRO_BITMAP *imagen_nave, ALLEGRO_BITMAP *imagen_asteroide, ALLEGRO_BITMAP *imagen_enemigo, ALLEGRO_BITMAP *imagenes_enemigos[NUM_TIPOS_ENEMIGOS], ALLEGRO_BITMAP *imagenes_jefes[NUM_TIPOS_JEFES], uint64_t semilla)
+{
+    int i;
+
+    memset(sim, 0, sizeof(Simulacion));
+
+    sim->semilla = semilla;
+
+    sim->tiempo = TIEMPO_INICIAL_SIMULACION;
+    fijar_tiempo_juego(sim->tiempo);
+
+    sim->imagen_nave = imagen_nave;
+    sim->imagen_asteroide = imagen_asteroide;
+    sim->imagen_enemigo = imagen_enemigo;
+
+    for (i = 0; i < NUM_TIPOS_ENEMIGOS; i++)
+    {
+        sim->imagenes_enemigos[i] = imagenes_enemigos ? imagenes_enemigos[i] : NULL;
+    }
+
+    for (i = 0; i < NUM_TIPOS_JEFES; i++)
+    {
+        sim->imagenes_jefes[i] = imagenes_jefes ? imagenes_jefes[i] : NULL;
+    }
+
+    sim->control_joystick = false;
+}
+
+
+/**
+ * @brief Comienza una partida nueva desde el nivel indicado.
+ *
+ * @param sim Puntero a la simulación.
+ * @param nivel Nivel con el que comienza la partida.
+ * @return true si se pudo cargar el nivel, false si no existe.
+ */
+bool iniciar_partida(Simulacion *sim, int nivel)
+{
+    char nombre_archivo[50];
+
+    sprintf(nombre_archivo, "Nivel%d.txt", nivel);
+    return iniciar_partida_archivo(sim, nivel, nombre_archivo);
+}
+
+
+/**
+ * @brief Comienza una partida nueva con el mapa de un archivo cualquiera.
+ *
+ * Carga el nivel, reinicia la nave, el sistema de armas, los proyectiles, el puntaje
+ * y la cola de mensajes. Los generadores aleatorios se vuelven a sembrar con la semilla
+ * de la simulación, de modo que cada partida con la misma semilla se juega igual.
+ * El número de nivel se usa para los asteroides y para saber cuál sigue.
+ *
+ * @param sim Puntero a la simulación.
+ * @param nivel Número de nivel que se le da a la partida.
+ * @param nombre_archivo Archivo con el mapa del nivel.
+ * @return true si se pudo cargar el nivel, false si no existe.
+ */
+bool iniciar_partida_archivo(Simulacion *sim, int nivel, const char *nombre_archivo)
+{
+    int i;
+
+    memset(sim->teclas, false, sizeof(sim->teclas)); // Reiniciar teclas
+
+    for (i = 0; i < NUM_FLUJOS_ALEATORIOS; i++)
+    {
+        sembrar_generador(&sim->aleatorio[i], sim->semilla, i);
+    }
+
+    if (!cargar_nivel_archivo(nombre_archivo, &sim->tilemap, sim->enemigos_mapa, &sim->num_enemigos_cargados, sim->imagen_enemigo, &sim->nave_x_inicial, &sim->nave_y_inicial, &sim->aleatorio[ALEATORIO_ENEMIGOS]))
+    {
+        return false;
+    }
+    printf("Nivel %d cargado: %d enemigos encontrados.\n", nivel, sim->num_enemigos_cargados);
+    marcar_mapa_sucio(&sim->tiles_sucios);
+
+    // Inicializar estado del juego
+    init_estado_juego(&sim->estado_nivel);
+    sim->estado_nivel.nivel_actual = nivel;
+
+    sim->recargar_nivel = false;
+    sim->juego_terminado = false;
+
+    preparar_asteroides(sim);
+
+    // Inicializar nave y sistema de armas
+    sim->nave = init_nave(sim->nave_x_inicial, sim->nave_y_inicial, 50, 50, 100.0f, 0.1, sim->imagen_nave);
+    init_sistema_armas(&sim->nave);
+
+    limpiar_proyectiles(sim);
+    preparar_enemigos(sim);
+
+    sim->puntaje = 0;
+    sim->contador_debug_lasers = 0;
+
+    init_cola_mensajes(&sim->cola_mensajes);
+
+    return true;
+}
+
+
+/**
+ * @brief Carga el siguiente nivel conservando el progreso de la nave.
+ *
+ * Se mantienen las armas, la movilidad y el progreso del disparo radial. Si no hay
+ * más niveles se marca el juego como terminado.
+ *
+ * @param sim Puntero a la simulación.
+ * @return true si se cargó un nivel nuevo, false en caso contrario.
+ */
+bool avanzar_nivel(Simulacion *sim)
+{
+    int i;
+    int siguiente_nivel;
+    int nivel_disparo_radial_guardado;
+    int kills_para_mejora_guardado;
+    int tipo_nave_guardado;
+    SistemaArma armas_guardadas[4];
+    TipoArma arma_actual_guardada;
+    int arma_seleccionada_guardada;
+
+    siguiente_nivel = sim->estado_nivel.nivel_actual + 1;
+
+    if (!cargar_siguiente_nivel(siguiente_nivel, &sim->tilemap, sim->enemigos_mapa, &sim->num_enemigos_cargados, sim->imagen_enemigo, &sim->nave_x_inicial, &sim->nave_y_inicial, &sim->aleatorio[ALEATORIO_ENEMIGOS]))
+    {
+        if (siguiente_nivel > NUM_NIVELES)
+        {
+            // No hay más niveles
+            sim->juego_terminado = true;
+            printf("Felicidades! Has completado todos los niveles.\n");
+        }
+
+        for (i = 0; i < MAX_POWERUPS; i++)
+        {
+            init_powerup(&sim->powerups[i]);
+        }
+        init_pool_indices(&sim->pool_powerups, MAX_POWERUPS);
+        return false;
+    }
+
+    marcar_mapa_sucio(&sim->tiles_sucios);
+    sim->estado_nivel.nivel_actual = siguiente_nivel;
+    sim->estado_nivel.todos_enemigos_eliminados = false;
+
+    limpiar_proyectiles(sim);
+
+    // Guardar el estado de la nave antes de reinicializarla
+    nivel_disparo_radial_guardado = sim->nave.nivel_disparo_radial;
+    kills_para_mejora_guardado = sim->nave.kills_para_mejora;
+    tipo_nave_guardado = sim->nave.tipo;
+
+    for (i = 0; i < 4; i++)
+    {
+        armas_guardadas[i] = sim->nave.armas[i];
+    }
+
+    arma_actual_guardada = sim->nave.arma_actual;
+    arma_seleccionada_guardada = sim->nave.arma_seleccionada;
+
+    // Reinicializar la nave con los valores guardados
+    sim->nave = init_nave(sim->nave_x_inicial, sim->nave_y_inicial, 50, 50, 100, 0.1, sim->imagen_nave);
+
+    sim->nave.nivel_disparo_radial = nivel_disparo_radial_guardado;
+    sim->nave.kills_para_mejora = kills_para_mejora_guardado;
+    sim->nave.tipo = tipo_nave_guardado;
+
+    for (i = 0; i < 4; i++)
+    {
+        sim->nave.armas[i] = armas_guardadas[i];
+    }
+
+    sim->nave.arma_actual = arma_actual_guardada;
+    sim->nave.arma_seleccionada = arma_seleccionada_guardada;
+
+    memset(sim->teclas, false, sizeof(sim->teclas)); // Reiniciar teclas
+
+    preparar_asteroides(sim);
+    preparar_enemigos(sim);
+
+    printf("=== RECARGA NIVEL %d COMPLETADA ===\n", sim->estado_nivel.nivel_actual);
+    return true;
+}
+
+
+/**
+ * @brief Dispara con el arma actual de la nave.
+ *
+ * El láser es continuo, por lo que solo se activa si no hay otro láser activo.
+ *
+ * @param sim Puntero a la simulación.
+ */
+void disparar_simulacion(Simulacion *sim)
+{
+    if (sim->nave.arma_actual == Arma_laser)
+    {
+        // Los láseres solo se apagan al soltar el disparo, que también los libera del pool
+        if (!pool_tiene_vivos(&sim->pool_lasers))
+        {
+            disparar_laser(sim->lasers, &sim->pool_lasers, &sim->nave);
+        }
+        else
+        {
+            TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_LASER_YA_ACTIVO, 0, 0);
+        }
+    }
+    else
+    {
+        disparar_segun_arma(&sim->nave, sim->disparos, &sim->pool_disparos, sim->lasers, &sim->pool_lasers, sim->explosivos, &sim->pool_explosivos, sim->misiles, &sim->pool_misiles, &sim->enemigos);
+    }
+}
+
+
+/**
+ * @brief Maneja la liberación del botón de disparo.
+ *
+ * Si el arma actual es el láser, se desactivan todos los láseres activos.
+ *
+ * @param sim Puntero a la simulación.
+ */
+void soltar_disparo_simulacion(Simulacion *sim)
+{
+    int i;
+    int laser_desactivado;
+
+    if (sim->nave.arma_actual != Arma_laser)
+    {
+        return;
+    }
+
+    laser_desactivado = 0;
+    while (pool_tiene_vivos(&sim->pool_lasers))
+    {
+        i = sim->pool_lasers.vivos[sim->pool_lasers.num_vivos - 1];
+        if (sim->lasers[i].activo)
+        {
+            sim->lasers[i].activo = false;
+            laser_desactivado++;
+        }
+        liberar_indice_pool(&sim->pool_lasers, i);
+    }
+
+    if (laser_desactivado > 0)
+    {
+        TRAZA(TRAZA_ARMAS, NIVEL_TRAZA_EVENTO, TRAZA_LASER_SOLTADO, 0, 0);
+    }
+}
+
+
+/**
+ * @brief Aplica la entrada del jugador antes de avanzar un paso.
+ *
+ * Es el único lugar donde el teclado y el joystick modifican la partida, tanto al
+ * jugar como al repetir una grabación. Durante la transición entre niveles solo se
+ * atiende soltar el disparo, igual que se hacía con los eventos de teclado. Las
+ * acciones quedan consumidas; los ejes del joystick se conservan.
+ *
+ * @param sim Puntero a la simulación.
+ * @param entrada Entrada acumulada desde el paso anterior.
+ */
+void aplicar_entrada_simulacion(Simulacion *sim, EntradaPaso *entrada)
+{
+    int i;
+    AccionEntrada accion;
+
+    for (i = 0; i < entrada->num_acciones; i++)
+    {
+        accion = entrada->acciones[i];
+
+        if (accion.tipo == ACCION_SOLTAR_DISPARO)
+        {
+            soltar_disparo_simulacion(sim);
+            continue;
+        }
+
+        if (sim->estado_nivel.mostrar_transicion)
+        {
+            continue;
+        }
+
+        switch (accion.tipo)
+        {
+            case ACCION_DISPARAR:
+                disparar_simulacion(sim);
+                break;
+
+            case ACCION_CAMBIAR_ARMA:
+                cambiar_arma(&sim->nave, (TipoArma)accion.dato);
+                break;
+
+            case ACCION_PRESIONAR_TECLA:
+                if (accion.dato < NUM_TECLAS_MOVIMIENTO)
+                {
+                    sim->teclas[accion.dato] = true;
+                }
+                break;
+
+            case ACCION_SOLTAR_TECLA:
+                if (accion.dato < NUM_TECLAS_MOVIMIENTO)
+                {
+                    sim->teclas[accion.dato] = false;
+                }
+                break;
+        }
+    }
+
+    entrada->num_acciones = 0;
+    sim->ejes_joystick = entrada->ejes;
+}
+
+
+/**
+ * @brief Cuenta los enemigos normales que siguen activos.
+ *
+ * @param sim Puntero a la simulación.
+ * @return Número de enemigos activos.
+ */
+int contar_enemigos_activos(Simulacion *sim)
+{
+    return sim->enemigos.num_activos;
+}
+
+
+/**
+ * @brief Completa la cantidad de entidades vivas que muestra el overlay de debug.
+ *
+ * @param sim Puntero a la simulación.
+ * @param conteos Arreglo con lugar para NUM_CONTEOS_SIMULACION elementos.
+ * @return Cantidad de elementos completados.
+ */
+int contar_entidades_simulacion(Simulacion *sim, ConteoPerfil conteos[NUM_CONTEOS_SIMULACION])
+{
+    conteos[0].nombre = "enemigos";
+    conteos[0].cantidad = contar_enemigos_activos(sim);
+    conteos[1].nombre = "disparos";
+    conteos[1].cantidad = sim->pool_disparos.num_vivos;
+    conteos[2].nombre = "disp enemigos";
+    conteos[2].cantidad = sim->pool_disparos_enemigos.num_vivos;
+    conteos[3].nombre = "lasers";
+    conteos[3].cantidad = sim->pool_lasers.num_vivos;
+    conteos[4].nombre = "explosivos";
+    conteos[4].cantidad = sim->pool_explosivos.num_vivos;
+    conteos[5].nombre = "misiles";
+    conteos[5].cantidad = sim->pool_misiles.num_vivos;
+    conteos[6].nombre = "powerups";
+    conteos[6].cantidad = sim->pool_powerups.num_vivos;
+    conteos[7].nombre = "ataques jefe";
+    conteos[7].cantidad = sim->hay_jefe_en_nivel && sim->jefe_nivel.activo ? sim->jefe_nivel.pool_ataques.num_vivos : 0;
+    conteos[8].nombre = "eventos";
+    conteos[8].cantidad = sim->agenda.num_eventos;
+
+    return NUM_CONTEOS_SIMULACION;
+}
+
+
+/**
+ * @brief Agrega el registro de telemetría de un frame con el estado de la simulación.
+ *
+ * Si la telemetría no está activa no hace nada.
+ *
+ * @param sim Puntero a la simulación.
+ * @param frame Número de frame.
+ * @param inicio Momento en que empezó el frame, según tiempo_telemetria.
+ * @param segundos_simulacion Tiempo que tardaron los pasos de simulación del frame.
+ * @param segundos_dibujo Tiempo que tardó el dibujo del frame.
+ */
+void registrar_telemetria_simulacion(Simulacion *sim, uint32_t frame, double inicio, double segundos_simulacion, double segundos_dibujo)
+{
+    RegistroTelemetria registro;
+
+    if (!telemetria_activa())
+    {
+        return;
+    }
+
+    registro.frame = frame;
+    registro.nivel = sim->estado_nivel.nivel_actual;
+    registro.inicio = inicio;
+    registro.segundos_simulacion = (float)segundos_simulacion;
+    registro.segundos_dibujo = (float)segundos_dibujo;
+    registro.disparos = (uint16_t)sim->pool_disparos.num_vivos;
+    registro.disparos_enemigos = (uint16_t)sim->pool_disparos_enemigos.num_vivos;
+    registro.enemigos = (uint16_t)contar_enemigos_activos(sim);
+    registro.ataques_jefe = (uint16_t)(sim->hay_jefe_en_nivel && sim->jefe_nivel.activo ? sim->jefe_nivel.pool_ataques.num_vivos : 0);
+
+    registrar_telemetria(&registro);
+}
+
+
+/**
+ * @brief Copia las posiciones de los objetos que se mueven.
+ *
+ * @param sim Puntero a la simulación.
+ * @param posiciones Donde se guardan las posiciones.
+ */
+static void guardar_posiciones(const Simulacion *sim, PosicionesSimulacion *posiciones)
+{
+    int i;
+
+    posiciones->nave_x = sim->nave.x;
+    posiciones->nave_y = sim->nave.y;
+
+    for (i = 0; i < NUM_ASTEROIDES; i++)
+    {
+        posiciones->asteroides_x[i] = sim->asteroides[i].x;
+        posiciones->asteroides_y[i] = sim->asteroides[i].y;
+    }
+
+    posiciones->num_enemigos = sim->enemigos.num_enemigos;
+    for (i = 0; i < sim->enemigos.num_enemigos; i++)
+    {
+        posiciones->enemigos_x[i] = sim->enemigos.x[i];
+        posiciones->enemigos_y[i] = sim->enemigos.y[i];
+    }
+
+    for (i = 0; i < MAX_DISPAROS; i++)
+    {
+        posiciones->disparos_x[i] = sim->disparos[i].x;
+        posiciones->disparos_y[i] = sim->disparos[i].y;
+        posiciones->disparos_activos[i] = sim->disparos[i].activo;
+    }
+
+    for (i = 0; i < NUM_DISPAROS_ENEMIGOS; i++)
+    {
+        posiciones->disparos_enemigos_x[i] = sim->disparos_enemigos[i].x;
+        posiciones->disparos_enemigos_y[i] = sim->disparos_enemigos[i].y;
+        posiciones->disparos_enemigos_activos[i] = sim->disparos_enemigos[i].activo;
+    }
+
+    posiciones->jefe_x = sim->jefe_nivel.x;
+    posiciones->jefe_y = sim->jefe_nivel.y;
+}
+
+
+/**
+ * @brief Interpola una coordenada entre el paso anterior y el actual.
+ *
+ * @param previa Valor al comienzo del último paso.
+ * @param actual Valor al final del último paso.
+ * @param alfa Fracción del próximo paso que ya transcurrió, entre 0 y 1.
+ * @return Valor interpolado, o el actual si el objeto saltó.
+ */
+static float interpolar_coordenada(float previa, float actual, float alfa)
+{
+    if (fabsf(actual - previa) > SALTO_MAXIMO_INTERPOLACION)
+    {
+        return actual;
+    }
+
+    // alfa mide cuánto se avanzó hacia el paso siguiente: se dibuja entre el anterior y el actual
+    return previa + (actual - previa) * alfa;
+}
+
+
+/**
+ * @brief Mueve los objetos a su posición interpolada para dibujarlos.
+ *
+ * Las posiciones reales quedan en posiciones_actuales y deben devolverse con
+ * restaurar_simulacion antes del próximo paso. Los enemigos y disparos que aparecieron
+ * en el último paso no tienen posición previa propia y se dibujan donde están.
+ *
+ * @param sim Puntero a la simulación.
+ * @param alfa Fracción de paso acumulada que todavía no se simuló, entre 0 y 1.
+ * @param posiciones_actuales Donde se guardan las posiciones reales.
+ */
+void interpolar_simulacion(Simulacion *sim, float alfa, PosicionesSimulacion *posiciones_actuales)
+{
+    const PosicionesSimulacion *previas = &sim->posiciones_previas;
+    int i;
+
+    guardar_posiciones(sim, posiciones_actuales);
+
+    sim->nave.x = interpolar_coordenada(previas->nave_x, posiciones_actuales->nave_x, alfa);
+    sim->nave.y = interpolar_coordenada(previas->nave_y, posiciones_actuales->nave_y, alfa);
+
+    for (i = 0; i < NUM_ASTEROIDES; i++)
+    {
+        sim->asteroides[i].x = interpolar_coordenada(previas->asteroides_x[i], posiciones_actuales->asteroides_x[i], alfa);
+        sim->asteroides[i].y = interpolar_coordenada(previas->asteroides_y[i], posiciones_actuales->asteroides_y[i], alfa);
+    }
+
+    // Los enemigos agregados en el paso (invocaciones del jefe) quedan al final del pool
+    for (i = 0; i < sim->enemigos.num_enemigos && i < previas->num_enemigos; i++)
+    {
+        sim->enemigos.x[i] = interpolar_coordenada(previas->enemigos_x[i], posiciones_actuales->enemigos_x[i], alfa);
+        sim->enemigos.y[i] = interpolar_coordenada(previas->enemigos_y[i], posiciones_actuales->enemigos_y[i], alfa);
+    }
+
+    for (i = 0; i < MAX_DISPAROS; i++)
+    {
+        if (previas->disparos_activos[i])
+        {
+            sim->disparos[i].x = interpolar_coordenada(previas->disparos_x[i], posiciones_actuales->disparos_x[i], alfa);
+            sim->disparos[i].y = interpolar_coordenada(previas->disparos_y[i], posiciones_actuales->disparos_y[i], alfa);
+        }
+    }
+
+    for (i = 0; i < NUM_DISPAROS_ENEMIGOS; i++)
+    {
+        if (previas->disparos_enemigos_activos[i])
+        {
+            sim->disparos_enemigos[i].x = interpolar_coordenada(previas->disparos_enemigos_x[i], posiciones_actuales->disparos_enemigos_x[i], alfa);
+            sim->disparos_enemigos[i].y = interpolar_coordenada(previas->disparos_enemigos_y[i], posiciones_actuales->disparos_enemigos_y[i], alfa);
+        }
+    }
+
+    sim->jefe_nivel.x = interpolar_coordenada(previas->jefe_x, posiciones_actuales->jefe_x, alfa);
+    sim->jefe_nivel.y = interpolar_coordenada(previas->jefe_y, posiciones_actuales->jefe_y, alfa);
+}
+
+
+/**
+ * @brief Devuelve los objetos a sus posiciones reales después de dibujar.
+ *
+ * @param sim Puntero a la simulación.
+ * @param posiciones_actuales Posiciones guardadas por interpolar_simulacion.
+ */
+void restaurar_simulacion(Simulacion *sim, const PosicionesSimulacion *posiciones_actuales)
+{
+    int i;
+
+    sim->nave.x = posiciones_actuales->nave_x;
+    sim->nave.y = posiciones_actuales->nave_y;
+
+    for (i = 0; i < NUM_ASTEROIDES; i++)
+    {
+        sim->asteroides[i].x = posiciones_actuales->asteroides_x[i];
+        sim->asteroides[i].y = posiciones_actuales->asteroides_y[i];
+    }
+
+    for (i = 0; i < sim->enemigos.num_enemigos; i++)
+    {
+        sim->enemigos.x[i] = posiciones_actuales->enemigos_x[i];
+        sim->enemigos.y[i] = posiciones_actuales->enemigos_y[i];
+    }
+
+    for (i = 0; i < MAX_DISPAROS; i++)
+    {
+        sim->disparos[i].x = posiciones_actuales->disparos_x[i];
+        sim->disparos[i].y = posiciones_actuales->disparos_y[i];
+    }
+
+    for (i = 0; i < NUM_DISPAROS_ENEMIGOS; i++)
+    {
+        sim->disparos_enemigos[i].x = posiciones_actuales->disparos_enemigos_x[i];
+        sim->disparos_enemigos[i].y = posiciones_actuales->disparos_enemigos_y[i];
+    }
+
+    sim->jefe_nivel.x = posiciones_actuales->jefe_x;
+    sim->jefe_nivel.y = posiciones_actuales->jefe_y;
+}
+
+
+/**
+ * @brief Avanza la simulación un paso fijo de DT_SIMULACION segundos.
+ *
+ * Incluye la carga de niveles, las armas especiales, el jefe, la nave, los enemigos
+ * y todas las colisiones. No dibuja nada. El resultado no depende del tiempo real:
+ * quien llama decide cuántos pasos dar por frame.
+ *
+ * @param sim Puntero a la simulación.
+ */
+void actualizar_simulacion(Simulacion *sim)
+{
+    int k;
+    double tiempo_actual;
+
+    PERFIL_INICIO(PERFIL_PASO);
+
+    sim->tiempo += DT_SIMULACION;
+    tiempo_actual = sim->tiempo;
+    fijar_tiempo_juego(tiempo_actual);
+
+    avanzar_frame_traza();
+    actualizar_cola_mensajes(&sim->cola_mensajes, tiempo_actual);
+
+    // Verificar si necesitamos cargar el siguiente nivel
+    if (sim->estado_nivel.nivel_completado && !sim->estado_nivel.mostrar_transicion && !sim->recargar_nivel)
+    {
+        sim->recargar_nivel = true;
+        sim->estado_nivel.nivel_completado = false;
+    }
+
+    if (sim->recargar_nivel)
+    {
+        avanzar_nivel(sim);
+        sim->recargar_nivel = false;
+    }
+
+    // Los enemigos muertos en el paso anterior se quitan antes de guardar las posiciones,
+    // así las posiciones previas y las actuales de cada índice son del mismo enemigo
+    compactar_pool_enemigos(&sim->enemigos);
+
+    // Después de una posible carga de nivel, para no interpolar desde el nivel anterior
+    guardar_posiciones(sim, &sim->posiciones_previas);
+
+    // Cambiar movilidad si corresponde se puso en 30 para probar
+    if (sim->puntaje >= 30 && sim->nave.tipo == 0)
+    {
+        sim->nave.tipo = 1;
+        for (k = 0; k < ALLEGRO_KEY_MAX; k++)
+        {
+            sim->teclas[k] = false; // Reiniciar teclas para evitar problemas de movimiento
+        }
+
+        agregar_mensaje_cola(&sim->cola_mensajes, "Nueva Movilidad Desbloqueada!", 4.0, al_map_rgb(0, 255, 0), true);
+
+        if (sim->control_joystick)
+        {
+            agregar_mensaje_cola(&sim->cola_mensajes, "Stick izquierdo: Mover libremente", 3.5, al_map_rgb(255, 255, 255), true);
+            agregar_mensaje_cola(&sim->cola_mensajes, "Stick derecho: Rotar nave", 3.5, al_map_rgb(255, 255, 255), true);
+        }
+        else
+        {
+            agregar_mensaje_cola(&sim->cola_mensajes, "Usa las flechas para rotar y avanzar", 3.0, al_map_rgb(255, 255, 255), true);
+        }
+    }
+
+    // Los enemigos solo se mueven dentro de actualizar_juego, pero pudo cambiar el nivel
+    construir_grid_enemigos(&sim->grid_enemigos, &sim->enemigos);
+
+    // Los disparos y ataques programados salen de las posiciones del comienzo del paso
+    if (!sim->estado_nivel.mostrar_transicion)
+    {
+        PERFIL_INICIO(PERFIL_AGENDA);
+        avanzar_agenda(&sim->agenda, ejecutar_evento_simulacion, sim);
+        PERFIL_FIN(PERFIL_AGENDA);
+    }
+
+    if (pool_tiene_vivos(&sim->pool_lasers))
+    {
+        PERFIL_INICIO(PERFIL_LASERS);
+        actualizar_lasers(sim->lasers, &sim->pool_lasers, &sim->nave, &sim->tilemap, &sim->contador_debug_lasers);
+        PERFIL_FIN(PERFIL_LASERS);
+    }
+
+    if (pool_tiene_vivos(&sim->pool_explosivos))
+    {
+        PERFIL_INICIO(PERFIL_EXPLOSIVOS);
+        actualizar_explosivos(sim->explosivos, &sim->pool_explosivos, &sim->enemigos, &sim->grid_enemigos, &sim->puntaje, &sim->tilemap, &sim->tiles_sucios, &sim->nave, &sim->cola_mensajes);
+        PERFIL_FIN(PERFIL_EXPLOSIVOS);
+    }
+
+    if (pool_tiene_vivos(&sim->pool_misiles))
+    {
+        PERFIL_INICIO(PERFIL_MISILES);
+        actualizar_misiles(sim->misiles, &sim->pool_misiles, &sim->enemigos, &sim->grid_enemigos);
+        PERFIL_FIN(PERFIL_MISILES);
+    }
+
+    if (sim->hay_jefe_en_nivel && sim->jefe_nivel.activo)
+    {
+        PERFIL_INICIO(PERFIL_JEFE);
+        actualizar_jefe(&sim->jefe_nivel, &sim->nave, tiempo_actual);
+        PERFIL_FIN(PERFIL_JEFE);
+    }
+
+    if (sim->control_joystick)
+    {
+        PERFIL_INICIO(PERFIL_NAVE);
+        actualizar_nave_joystick(&sim->nave, &sim->ejes_joystick, &sim->tilemap);
+        PERFIL_FIN(PERFIL_NAVE);
+    }
+
+    actualizar_juego(&sim->nave, sim->teclas, sim->asteroides, NUM_ASTEROIDES, sim->disparos, &sim->pool_disparos, &sim->tilemap, &sim->tiles_sucios, &sim->enemigos, &sim->grid_enemigos, sim->disparos_enemigos, &sim->pool_disparos_enemigos, &sim->cola_mensajes, &sim->estado_nivel, tiempo_actual, sim->powerups, &sim->pool_powerups, sim->aleatorio, &sim->agenda, &sim->campo_flujo);
+
+    // Todo ya se movió: cada proyectil se prueba una vez contra sus blancos y recién
+    // después se aplican los impactos
+    if (!sim->estado_nivel.mostrar_transicion)
+    {
+        PERFIL_INICIO(PERFIL_COLISIONES);
+        procesar_colisiones(sim);
+        PERFIL_FIN(PERFIL_COLISIONES);
+    }
+
+    if (sim->hay_jefe_en_nivel)
+    {
+        actualizar_estado_nivel(&sim->estado_nivel, &sim->enemigos, tiempo_actual, sim->hay_jefe_en_nivel, &sim->jefe_nivel);
+
+        TRAZA(TRAZA_NIVEL, NIVEL_TRAZA_DETALLE, TRAZA_NIVEL_PENDIENTE, contar_enemigos_activos(sim), 0);
+    }
+    else
+    {
+        actualizar_estado_nivel_sin_jefe(&sim->estado_nivel, &sim->enemigos, tiempo_actual);
+    }
+
+    PERFIL_FIN(PERFIL_PASO);
+}
+
+
+/**
+ * @brief Ejecuta la simulación sin display durante una cantidad fija de frames.
+ *
+ * No se crea ventana, fuente ni bitmaps: solo se necesita al_init(). La simulación
+ * avanza tan rápido como sea posible con un tiempo simulado de 1/FPS por frame, y una
+ * nave automática dispara y cambia de arma para recorrer todos los sistemas de armas.
+ * Si la nave muere se restaura su vida, y al terminar el último nivel se vuelve a
+ * empezar, para que la carga se mantenga durante toda la medición.
+ *
+ * @param nivel Nivel con el que comienza la simulación.
+ * @param frames Cantidad de frames a simular (FRAMES_HEADLESS_DEFECTO si es <= 0).
+ * @param semilla Semilla de los generadores aleatorios.
+ * @return Frames por segundo obtenidos, o -1 en caso de error.
+ */
+double ejecutar_simulacion_headless(int nivel, int frames, uint64_t semilla)
+{
+    static Simulacion sim;
+    int frame;
+    int i;
+    double inicio;
+    double inicio_frame;
+    double duracion;
+    double fps;
+
+    if (!al_init())
+    {
+        fprintf(stderr, "Error al inicializar Allegro.\n");
+        return -1;
+    }
+
+    if (frames <= 0)
+    {
+        frames = FRAMES_HEADLESS_DEFECTO;
+    }
+
+    init_simulacion(&sim, NULL, NULL, NULL, NULL, NULL, semilla);
+
+    if (!iniciar_partida(&sim, nivel))
+    {
+        fprintf(stderr, "Error: No se pudo cargar el nivel %d.\n", nivel);
+        return -1;
+    }
+
+    // Todas las armas disponibles para que se ejerciten sus rutas de actualización
+    for (i = 0; i < 4; i++)
+    {
+        sim.nave.armas[i].desbloqueado = true;
+    }
+
+    inicio = al_get_time();
+
+    for (frame = 0; frame < frames; frame++)
+    {
+        if (frame % (FPS * 10) == 0)
+        {
+            soltar_disparo_simulacion(&sim);
+            cambiar_arma(&sim.nave, (TipoArma)((frame / (FPS * 10)) % 4));
+        }
+
+        if (!sim.estado_nivel.mostrar_transicion)
+        {
+            if (frame % 20 == 0)
+            {
+                disparar_simulacion(&sim);
+            }
+            else if (frame % 20 == 10)
+            {
+                soltar_disparo_simulacion(&sim);
+            }
+        }
+
+        reiniciar_arena_frame();
+        inicio_frame = tiempo_telemetria();
+        actualizar_simulacion(&sim);
+        registrar_telemetria_simulacion(&sim, frame, inicio_frame, tiempo_telemetria() - inicio_frame, 0);
+
+        if (sim.nave.vida <= 0)
+        {
+            sim.nave.vida = 100.0f;
+        }
+
+        if (sim.juego_terminado && !iniciar_partida(&sim, nivel))
+        {
+            fprintf(stderr, "Error: No se pudo reiniciar el nivel %d.\n", nivel);
+            return -1;
+        }
+    }
+
+    duracion = al_get_time() - inicio;
+    fps = duracion > 0 ? frames / duracion : 0;
+
+    fprintf(stderr, "=== SIMULACION HEADLESS ===\n");
+    fprintf(stderr, "Frames simulados: %d (%.1f s de juego)\n", frames, frames / (double)FPS);
+    fprintf(stderr, "Tiempo real: %.3f s\n", duracion);
+    fprintf(stderr, "Frames por segundo: %.1f (%.3f ms por frame)\n", fps, duracion * 1000.0 / frames);
+#ifndef SIN_PERFIL
+    escribir_resumen_arena(stderr);
+#endif
+    fprintf(stderr, "Nivel final: %d, Puntaje: %d, Enemigos activos: %d\n", sim.estado_nivel.nivel_actual, sim.puntaje, contar_enemigos_activos(&sim));
+
+    return fps;
+}
+
+
+/**
+ * @brief Repite una partida grabada sin ventana y tan rápido como sea posible.
+ *
+ * Cada paso recibe la entrada grabada por medio de aplicar_entrada_simulacion, el mismo
+ * camino que usa el juego con ventana, así que el resultado coincide con el de la
+ * partida original y sirve para comparar el costo por frame entre versiones.
+ *
+ * @param ruta Archivo de repetición.
+ * @return Frames por segundo obtenidos, o -1 en caso de error.
+ */
+double ejecutar_repeticion_headless(const char *ruta)
+{
+    static Simulacion sim;
+    Repeticion repeticion;
+    EntradaPaso entrada;
+    int pasos;
+    double inicio;
+    double inicio_frame;
+    double duracion;
+    double fps;
+
+    if (!abrir_repeticion(&repeticion, ruta))
+    {
+        return -1;
+    }
+
+    if (!al_init())
+    {
+        fprintf(stderr, "Error al inicializar Allegro.\n");
+        cerrar_repeticion(&repeticion);
+        return -1;
+    }
+
+    init_simulacion(&sim, NULL, NULL, NULL, NULL, NULL, repeticion.encabezado.semilla);
+    sim.control_joystick = repeticion.encabezado.control_joystick != 0;
+
+    if (!iniciar_partida(&sim, repeticion.encabezado.nivel))
+    {
+        fprintf(stderr, "Error: No se pudo cargar el nivel %d.\n", repeticion.encabezado.nivel);
+        cerrar_repeticion(&repeticion);
+        return -1;
+    }
+
+    memset(&entrada, 0, sizeof(EntradaPaso));
+    pasos = 0;
+    inicio = al_get_time();
+
+    while (!sim.juego_terminado && leer_paso(&repeticion, &entrada))
+    {
+        reiniciar_arena_frame();
+        inicio_frame = tiempo_telemetria();
+        aplicar_entrada_simulacion(&sim, &entrada);
+        actualizar_simulacion(&sim);
+        registrar_telemetria_simulacion(&sim, pasos, inicio_frame, tiempo_telemetria() - inicio_frame, 0);
+        pasos++;
+    }
+
+    duracion = al_get_time() - inicio;
+    fps = duracion > 0 ? pasos / duracion : 0;
+    cerrar_repeticion(&repeticion);
+
+    fprintf(stderr, "=== REPETICION HEADLESS ===\n");
+    fprintf(stderr, "Pasos repetidos: %d de %u (%.1f s de juego)\n", pasos, repeticion.encabezado.num_pasos, pasos / (double)FPS);
+    fprintf(stderr, "Tiempo real: %.3f s\n", duracion);
+    fprintf(stderr, "Frames por segundo: %.1f (%.3f ms por frame)\n", fps, pasos > 0 ? duracion * 1000.0 / pasos : 0.0);
+    fprintf(stderr, "Nivel final: %d, Puntaje: %d, Vida: %.1f, Enemigos activos: %d\n", sim.estado_nivel.nivel_actual, sim.puntaje, sim.nave.vida, contar_enemigos_activos(&sim));
+
+    return fps;
+}
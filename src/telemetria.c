@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <string.h>
+#include <allegro5/allegro.h>
+#include "telemetria.h"
+
+/**
+ * @file telemetria.c
+ * @brief Este archivo contiene el buffer de telemetría y el hilo que lo escribe en disco.
+ */
+
+static RegistroTelemetria buffer_telemetria[TAMANO_TELEMETRIA];
+static uint32_t escritos_telemetria; /**< Registros agregados por el juego */
+static uint32_t leidos_telemetria; /**< Registros tomados por el hilo escritor */
+static uint32_t perdidos_telemetria; /**< Registros descartados con el buffer lleno */
+static bool terminar_hilo_telemetria;
+static bool formato_chrome;
+static double inicio_telemetria;
+static FILE *archivo_telemetria = NULL;
+static ALLEGRO_THREAD *hilo_telemetria = NULL;
+static ALLEGRO_MUTEX *mutex_telemetria = NULL;
+static ALLEGRO_COND *cond_telemetria = NULL;
+
+
+/**
+ * @brief Escribe un registro en el formato elegido.
+ *
+ * @param registro Registro a escribir.
+ * @param primero true si es el primer registro del archivo.
+ */
+static void escribir_registro_telemetria(const RegistroTelemetria *registro, bool primero)
+{
+    double ts;
+    double dur_simulacion;
+    double dur_dibujo;
+
+    if (!formato_chrome)
+    {
+        fprintf(archivo_telemetria, "%u,%.6f,%d,%.4f,%.4f,%u,%u,%u,%u\n",
+                registro->frame, registro->inicio, registro->nivel,
+                registro->segundos_simulacion * 1000.0, registro->segundos_dibujo * 1000.0,
+                registro->disparos, registro->disparos_enemigos, registro->enemigos, registro->ataques_jefe);
+        return;
+    }
+
+    // Los tiempos de los eventos de Chrome van en microsegundos
+    ts = registro->inicio * 1000000.0;
+    dur_simulacion = registro->segundos_simulacion * 1000000.0;
+    dur_dibujo = registro->segundos_dibujo * 1000000.0;
+
+    fprintf(archivo_telemetria,
+            "%s{\"name\":\"simulacion\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.1f,\"dur\":%.1f,\"args\":{\"frame\":%u}},\n"
+            "{\"name\":\"dibujo\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.1f,\"dur\":%.1f,\"args\":{\"frame\":%u}},\n"
+            "{\"name\":\"entidades\",\"ph\":\"C\",\"pid\":1,\"ts\":%.1f,\"args\":{\"disparos\":%u,\"disparos_enemigos\":%u,\"enemigos\":%u,\"ataques_jefe\":%u}},\n"
+            "{\"name\":\"nivel\",\"ph\":\"C\",\"pid\":1,\"ts\":%.1f,\"args\":{\"nivel\":%d}}",
+            primero ? "" : ",\n",
+            ts, dur_simulacion, registro->frame,
+            ts + dur_simulacion, dur_dibujo, registro->frame,
+            ts, registro->disparos, registro->disparos_enemigos, registro->enemigos, registro->ataques_jefe,
+            ts, registro->nivel);
+}
+
+
+/**
+ * @brief Hilo escritor: espera registros nuevos y los pasa al archivo.
+ *
+ * Los registros se copian a un lote local con el mutex tomado y se escriben después de
+ * soltarlo, así el juego solo compite por el mutex durante la copia.
+ *
+ * @param hilo Hilo de Allegro.
+ * @param arg No se usa.
+ * @return NULL.
+ */
+static void *escribir_telemetria(ALLEGRO_THREAD *hilo, void *arg)
+{
+    static RegistroTelemetria lote[TAMANO_TELEMETRIA];
+    uint32_t cantidad;
+    uint32_t i;
+    bool terminar;
+    bool primero = true;
+
+    (void)hilo;
+    (void)arg;
+
+    do
+    {
+        al_lock_mutex(mutex_telemetria);
+        while (leidos_telemetria == escritos_telemetria && !terminar_hilo_telemetria)
+        {
+            al_wait_cond(cond_telemetria, mutex_telemetria);
+        }
+
+        cantidad = escritos_telemetria - leidos_telemetria;
+        for (i = 0; i < cantidad; i++)
+        {
+            lote[i] = buffer_telemetria[(leidos_telemetria + i) & (TAMANO_TELEMETRIA - 1)];
+        }
+        leidos_telemetria += cantidad;
+        terminar = terminar_hilo_telemetria && leidos_telemetria == escritos_telemetria;
+        al_unlock_mutex(mutex_telemetria);
+
+        for (i = 0; i < cantidad; i++)
+        {
+            escribir_registro_telemetria(&lote[i], primero);
+            primero = false;
+        }
+    } while (!terminar);
+
+    return NULL;
+}
+
+
+/**
+ * @brief Abre el archivo de telemetría y arranca el hilo escritor.
+ *
+ * @param ruta Archivo de salida; con extensión ".json" se usa el formato de Chrome.
+ * @return true si la telemetría quedó activa.
+ */
+bool iniciar_telemetria(const char *ruta)
+{
+    size_t largo = strlen(ruta);
+
+    archivo_telemetria = fopen(ruta, "w");
+    if (!archivo_telemetria)
+    {
+        printf("Error: No se pudo abrir el archivo de telemetría %s\n", ruta);
+        return false;
+    }
+
+    formato_chrome = largo >= 5 && strcmp(ruta + largo - 5, ".json") == 0;
+    if (formato_chrome)
+    {
+        fprintf(archivo_telemetria, "[\n");
+    }
+    else
+    {
+        fprintf(archivo_telemetria, "frame,tiempo_s,nivel,simulacion_ms,dibujo_ms,disparos,disparos_enemigos,enemigos,ataques_jefe\n");
+    }
+
+    escritos_telemetria = 0;
+    leidos_telemetria = 0;
+    perdidos_telemetria = 0;
+    terminar_hilo_telemetria = false;
+    inicio_telemetria = al_get_time();
+
+    mutex_telemetria = al_create_mutex();
+    cond_telemetria = al_create_cond();
+    hilo_telemetria = al_create_thread(escribir_telemetria, NULL);
+    if (!mutex_telemetria || !cond_telemetria || !hilo_telemetria)
+    {
+        printf("Error: No se pudo crear el hilo de telemetría\n");
+        terminar_telemetria();
+        return false;
+    }
+
+    al_start_thread(hilo_telemetria);
+    printf("Telemetría activa en %s (%s)\n", ruta, formato_chrome ? "eventos de Chrome" : "CSV");
+
+    return true;
+}
+
+
+/**
+ * @brief Indica si se están guardando registros.
+ *
+ * @return true si la telemetría está activa.
+ */
+bool telemetria_activa(void)
+{
+    return hilo_telemetria != NULL;
+}
+
+
+/**
+ * @brief Tiempo transcurrido desde que empezó la telemetría.
+ *
+ * @return Segundos, para el campo inicio de cada registro.
+ */
+double tiempo_telemetria(void)
+{
+    return al_get_time() - inicio_telemetria;
+}
+
+
+/**
+ * @brief Agrega el registro de un frame. Si el buffer está lleno el registro se descarta.
+ *
+ * @param registro Registro a guardar, se copia.
+ */
+void registrar_telemetria(const RegistroTelemetria *registro)
+{
+    if (!hilo_telemetria)
+    {
+        return;
+    }
+
+    al_lock_mutex(mutex_telemetria);
+    if (escritos_telemetria - leidos_telemetria < TAMANO_TELEMETRIA)
+    {
+        buffer_telemetria[escritos_telemetria & (TAMANO_TELEMETRIA - 1)] = *registro;
+        escritos_telemetria++;
+        al_signal_cond(cond_telemetria);
+    }
+    else
+    {
+        perdidos_telemetria++;
+    }
+    al_unlock_mutex(mutex_telemetria);
+}
+
+
+/**
+ * @brief Espera a que el hilo escriba los registros pendientes y cierra el archivo.
+ *
+ * Si la telemetría no está activa no hace nada.
+ */
+void terminar_telemetria(void)
+{
+    if (hilo_telemetria)
+    {
+        al_lock_mutex(mutex_telemetria);
+        terminar_hilo_telemetria = true;
+        al_signal_cond(cond_telemetria);
+        al_unlock_mutex(mutex_telemetria);
+
+        al_join_thread(hilo_telemetria, NULL);
+        al_destroy_thread(hilo_telemetria);
+        hilo_telemetria = NULL;
+
+        printf("Telemetría: %u frames guardados, %u descartados\n", escritos_telemetria, perdidos_telemetria);
+    }
+
+    if (cond_telemetria)
+    {
+        al_destroy_cond(cond_telemetria);
+        cond_telemetria = NULL;
+    }
+
+    if (mutex_telemetria)
+    {
+        al_destroy_mutex(mutex_telemetria);
+        mutex_telemetria = NULL;
+    }
+
+    if (archivo_telemetria)
+    {
+        if (formato_chrome)
+        {
+            fprintf(archivo_telemetria, "\n]\n");
+        }
+        fclose(archivo_telemetria);
+        archivo_telemetria = NULL;
+    }
+}
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <string.h>
+#include "traza.h"
+
+/**
+ * @file traza.c
+ * @brief Este archivo contiene el buffer circular de trazas y su volcado a archivo.
+ *
+ * Solo el hilo del juego escribe en el buffer, así que no hace falta ningún bloqueo: registrar
+ * un evento es copiar 16 bytes y avanzar un contador.
+ */
+
+uint8_t niveles_traza[NUM_CATEGORIAS_TRAZA];
+
+static EventoTraza eventos_traza[TAMANO_TRAZA];
+static uint32_t total_eventos_traza;
+static uint32_t frame_traza;
+static char ruta_traza[256];
+
+
+/**
+ * @brief Activa las trazas de todas las categorías y fija el archivo donde se vuelcan.
+ *
+ * @param ruta Archivo de salida.
+ * @param nivel Nivel para todas las categorías.
+ */
+void activar_traza(const char *ruta, NivelTraza nivel)
+{
+    int i;
+
+    snprintf(ruta_traza, sizeof(ruta_traza), "%s", ruta);
+    total_eventos_traza = 0;
+    frame_traza = 0;
+
+    for (i = 0; i < NUM_CATEGORIAS_TRAZA; i++)
+    {
+        niveles_traza[i] = (uint8_t)nivel;
+    }
+}
+
+
+/**
+ * @brief Cambia el nivel de una sola categoría.
+ *
+ * @param categoria Categoría a cambiar.
+ * @param nivel Nuevo nivel.
+ */
+void configurar_nivel_traza(CategoriaTraza categoria, NivelTraza nivel)
+{
+    niveles_traza[categoria] = (uint8_t)nivel;
+}
+
+
+/**
+ * @brief Indica si hay un archivo de trazas configurado.
+ *
+ * @return true si se llamó a activar_traza.
+ */
+bool traza_activa(void)
+{
+    return ruta_traza[0] != '\0';
+}
+
+
+/**
+ * @brief Avanza el contador de frames con el que se marcan los eventos.
+ */
+void avanzar_frame_traza(void)
+{
+    frame_traza++;
+}
+
+
+/**
+ * @brief Guarda un evento en el buffer, pisando el más antiguo si está lleno.
+ *
+ * Normalmente se llama a través de la macro TRAZA, que ya verificó el nivel.
+ *
+ * @param categoria Subsistema que genera el evento.
+ * @param nivel Nivel del evento.
+ * @param codigo Qué pasó.
+ * @param a Primer valor del evento.
+ * @param b Segundo valor del evento.
+ */
+void registrar_traza(CategoriaTraza categoria, NivelTraza nivel, CodigoTraza codigo, float a, float b)
+{
+    EventoTraza *evento = &eventos_traza[total_eventos_traza & (TAMANO_TRAZA - 1)];
+
+    evento->frame = frame_traza;
+    evento->categoria = (uint8_t)categoria;
+    evento->nivel = (uint8_t)nivel;
+    evento->codigo = (uint16_t)codigo;
+    evento->a = a;
+    evento->b = b;
+
+    total_eventos_traza++;
+}
+
+
+/**
+ * @brief Escribe el contenido del buffer en el archivo de trazas.
+ *
+ * Los eventos se escriben del más antiguo al más nuevo. El buffer no se vacía, así que
+ * volcar dos veces deja en el archivo la ventana más reciente.
+ *
+ * @return true si se pudo escribir el archivo.
+ */
+bool volcar_traza(void)
+{
+    FILE *archivo;
+    EncabezadoTraza encabezado;
+    uint32_t inicio;
+    uint32_t primera_parte;
+
+    if (!traza_activa())
+    {
+        return false;
+    }
+
+    archivo = fopen(ruta_traza, "wb");
+    if (!archivo)
+    {
+        printf("Error: No se pudo abrir el archivo de trazas %s\n", ruta_traza);
+        return false;
+    }
+
+    memcpy(encabezado.magia, "TRZA", 4);
+    encabezado.version = VERSION_TRAZA;
+    encabezado.num_eventos = total_eventos_traza < TAMANO_TRAZA ? total_eventos_traza : TAMANO_TRAZA;
+    encabezado.eventos_perdidos = total_eventos_traza - encabezado.num_eventos;
+
+    fwrite(&encabezado, sizeof(encabezado), 1, archivo);
+
+    // El evento más antiguo está justo donde se escribirá el próximo
+    inicio = encabezado.eventos_perdidos > 0 ? (total_eventos_traza & (TAMANO_TRAZA - 1)) : 0;
+    primera_parte = TAMANO_TRAZA - inicio;
+    if (primera_parte > encabezado.num_eventos)
+    {
+        primera_parte = encabezado.num_eventos;
+    }
+
+    fwrite(&eventos_traza[inicio], sizeof(EventoTraza), primera_parte, archivo);
+    fwrite(eventos_traza, sizeof(EventoTraza), encabezado.num_eventos - primera_parte, archivo);
+    fclose(archivo);
+
+    printf("Trazas volcadas en %s: %u eventos (%u perdidos)\n", ruta_traza, encabezado.num_eventos, encabezado.eventos_perdidos);
+
+    return true;
+}